@@ -0,0 +1,239 @@
+#include "Clock.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <QTimer>
+#include <QTimeZone>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+//
+//   CLOCK
+//
+
+Clock* Clock::system() {
+    static RealClock* clock = new RealClock(QCoreApplication::instance());
+    return clock;
+}
+
+Clock* Clock::fromEnvironment(QObject* parent) {
+    const QString spec = qEnvironmentVariable("RAILFLUX_CLOCK").trimmed().toLower();
+    if (spec.startsWith("scaled:")) {
+        bool ok = false;
+        const double rate = spec.mid(7).toDouble(&ok);
+        if (ok && rate > 0.0) {
+            qDebug() << "  Clock: scaled x" << rate;
+            return new ScaledClock(rate, parent);
+        }
+        qWarning() << " Clock: invalid RAILFLUX_CLOCK" << spec << "- using real time";
+    } else if (spec == "virtual") {
+        qDebug() << "  Clock: virtual - time advances only when driven";
+        return new VirtualClock(parent);
+    } else if (!spec.isEmpty() && spec != "real") {
+        qWarning() << " Clock: unknown RAILFLUX_CLOCK" << spec << "- using real time";
+    }
+    return system();
+}
+
+//
+//   SCALED CLOCK
+//
+
+ScaledClock::ScaledClock(double rate, QObject* parent)
+    : Clock(parent)
+    , m_rate(rate > 0.0 ? rate : 1.0)
+    , m_origin(QDateTime::currentDateTime())
+{
+    m_elapsed.start();
+}
+
+qint64 ScaledClock::elapsedMs() const {
+    return static_cast<qint64>(static_cast<double>(m_elapsed.elapsed()) * m_rate);
+}
+
+QDateTime ScaledClock::currentDateTime() const {
+    return m_origin.addMSecs(elapsedMs());
+}
+
+qint64 ScaledClock::toWallMs(qint64 clockMs) const {
+    return std::max<qint64>(0, static_cast<qint64>(std::ceil(static_cast<double>(clockMs) / m_rate)));
+}
+
+Clock::TimerId ScaledClock::schedule(qint64 delayMs, Callback callback) {
+    const TimerId id = m_nextId++;
+
+    QTimer* timer = new QTimer(this);
+    timer->setSingleShot(true);
+    timer->setTimerType(Qt::PreciseTimer);
+    connect(timer, &QTimer::timeout, this, [this, id, callback = std::move(callback)]() {
+        if (QTimer* fired = m_timers.take(id)) {
+            fired->deleteLater();
+            callback();
+        }
+    });
+
+    m_timers.insert(id, timer);
+    timer->start(static_cast<int>(std::min<qint64>(toWallMs(delayMs), std::numeric_limits<int>::max())));
+    return id;
+}
+
+void ScaledClock::cancel(TimerId id) {
+    if (QTimer* timer = m_timers.take(id)) {
+        timer->stop();
+        timer->deleteLater();
+    }
+}
+
+void ScaledClock::sleep(qint64 ms) {
+    QThread::msleep(static_cast<unsigned long>(toWallMs(ms)));
+}
+
+//
+//   VIRTUAL CLOCK
+//
+
+VirtualClock::VirtualClock(QObject* parent)
+    : VirtualClock(QDateTime(QDate(2024, 1, 1), QTime(0, 0), QTimeZone::UTC), parent) {
+}
+
+VirtualClock::VirtualClock(const QDateTime& epoch, QObject* parent)
+    : Clock(parent)
+    , m_epoch(epoch) {
+}
+
+Clock::TimerId VirtualClock::schedule(qint64 delayMs, Callback callback) {
+    const TimerId id = m_nextId++;
+    const qint64 dueMs = m_nowMs + std::max<qint64>(0, delayMs);
+    m_queue.emplace(QueueKey{dueMs, id}, std::move(callback));
+    m_dueById.insert(id, dueMs);
+    return id;
+}
+
+void VirtualClock::cancel(TimerId id) {
+    const auto due = m_dueById.constFind(id);
+    if (due == m_dueById.cend()) {
+        return;
+    }
+    m_queue.erase(QueueKey{*due, id});
+    m_dueById.erase(due);
+}
+
+void VirtualClock::sleep(qint64 ms) {
+    m_nowMs += std::max<qint64>(0, ms);
+}
+
+qint64 VirtualClock::nextDueMs() const {
+    return m_queue.empty() ? -1 : m_queue.begin()->first.first;
+}
+
+void VirtualClock::advance(qint64 ms) {
+    advanceTo(m_nowMs + std::max<qint64>(0, ms));
+}
+
+void VirtualClock::advanceTo(qint64 targetMs) {
+    if (m_advancing) {
+        //   NESTED: a callback advanced the clock; the outer advance fires whatever this makes due
+        m_nowMs = std::max(m_nowMs, targetMs);
+        return;
+    }
+
+    m_advancing = true;
+    while (!m_queue.empty() && m_queue.begin()->first.first <= targetMs) {
+        auto next = m_queue.begin();
+        const TimerId id = next->first.second;
+        m_nowMs = std::max(m_nowMs, next->first.first);
+        Callback callback = std::move(next->second);
+        m_queue.erase(next);
+        m_dueById.remove(id);
+        callback();
+    }
+    m_nowMs = std::max(m_nowMs, targetMs);
+    m_advancing = false;
+
+    emit advanced(m_nowMs);
+}
+
+int VirtualClock::runUntilIdle(qint64 limitMs) {
+    const qint64 deadline = m_nowMs + std::max<qint64>(0, limitMs);
+    int fired = 0;
+    while (!m_queue.empty() && m_queue.begin()->first.first <= deadline) {
+        const qint64 before = static_cast<qint64>(m_queue.size());
+        advanceTo(m_queue.begin()->first.first);
+        fired += static_cast<int>(std::max<qint64>(1, before - static_cast<qint64>(m_queue.size())));
+    }
+    return fired;
+}
+
+//
+//   CLOCK TIMER
+//
+
+ClockTimer::ClockTimer(QObject* parent)
+    : QObject(parent)
+    , m_clock(Clock::system()) {
+}
+
+ClockTimer::~ClockTimer() {
+    disarm();
+}
+
+void ClockTimer::setClock(Clock* clock) {
+    if (!clock || clock == m_clock) {
+        return;
+    }
+
+    disarm();
+    m_clock = clock;
+    if (m_active) {
+        arm();
+    }
+}
+
+void ClockTimer::setInterval(int ms) {
+    m_intervalMs = std::max(0, ms);
+    if (m_active) {
+        //   Like QTimer: a running timer restarts with the new interval
+        disarm();
+        arm();
+    }
+}
+
+void ClockTimer::start() {
+    disarm();
+    m_active = true;
+    arm();
+}
+
+void ClockTimer::start(int ms) {
+    m_intervalMs = std::max(0, ms);
+    start();
+}
+
+void ClockTimer::stop() {
+    m_active = false;
+    disarm();
+}
+
+void ClockTimer::arm() {
+    if (!m_clock) {
+        return;
+    }
+
+    m_pending = m_clock->schedule(m_intervalMs, [this]() {
+        m_pending = 0;
+        if (m_singleShot) {
+            m_active = false;
+        } else {
+            arm();
+        }
+        emit timeout();
+    });
+}
+
+void ClockTimer::disarm() {
+    if (m_pending != 0 && m_clock) {
+        m_clock->cancel(m_pending);
+    }
+    m_pending = 0;
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <QObject>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPointer>
+#include <functional>
+#include <map>
+#include <utility>
+
+class QTimer;
+
+//   CLOCK
+//
+//   Timed behaviour (polling, debounce wheels, processing delays, health checks) reads time and
+//   schedules callbacks through a Clock instead of QElapsedTimer / QTimer / msleep directly, so
+//   a scenario can run on something other than the wall clock:
+//     RealClock     - wall time, QTimer-driven (production default)
+//     ScaledClock   - wall time multiplied by a rate: a 30-minute scenario takes 18 s at 100x
+//     VirtualClock  - time moves only when advanced; timers fire in (due time, schedule order),
+//                     so a run is deterministic and as fast as the CPU allows
+//
+//   Clocks, and the ClockTimers driven by them, belong to the GUI thread.
+class Clock : public QObject {
+    Q_OBJECT
+
+public:
+    using TimerId = quint64;
+    using Callback = std::function<void()>;
+
+    explicit Clock(QObject* parent = nullptr) : QObject(parent) {}
+
+    //   Monotonic milliseconds since the clock was created
+    virtual qint64 elapsedMs() const = 0;
+    //   Calendar time on this clock, for timestamps and age comparisons
+    virtual QDateTime currentDateTime() const = 0;
+
+    //   One-shot callback after delayMs of this clock's time
+    virtual TimerId schedule(qint64 delayMs, Callback callback) = 0;
+    virtual void cancel(TimerId id) = 0;
+
+    //   Blocking delay on the calling thread, in this clock's time
+    virtual void sleep(qint64 ms) = 0;
+
+    //   Clock milliseconds per wall-clock millisecond (0 for a virtual clock)
+    virtual double rate() const = 0;
+
+    //   Process-wide RealClock; components use it until another clock is injected
+    static Clock* system();
+
+    //   RAILFLUX_CLOCK: "real" (default), "scaled:<rate>" or "virtual". A virtual clock stands
+    //   still until its driver (TrainSimulator::runFor) advances it.
+    static Clock* fromEnvironment(QObject* parent);
+};
+
+//   SCALED CLOCK: Wall time times rate(); timers are QTimers with intervals divided by the rate
+class ScaledClock : public Clock {
+    Q_OBJECT
+
+public:
+    explicit ScaledClock(double rate, QObject* parent = nullptr);
+
+    qint64 elapsedMs() const override;
+    QDateTime currentDateTime() const override;
+    TimerId schedule(qint64 delayMs, Callback callback) override;
+    void cancel(TimerId id) override;
+    void sleep(qint64 ms) override;
+    double rate() const override { return m_rate; }
+
+private:
+    qint64 toWallMs(qint64 clockMs) const;
+
+    double m_rate;
+    QElapsedTimer m_elapsed;
+    QDateTime m_origin;
+    TimerId m_nextId = 1;
+    QHash<TimerId, QTimer*> m_timers;
+};
+
+//   REAL CLOCK: Scale 1, calendar time straight from the system
+class RealClock : public ScaledClock {
+    Q_OBJECT
+
+public:
+    explicit RealClock(QObject* parent = nullptr) : ScaledClock(1.0, parent) {}
+
+    QDateTime currentDateTime() const override { return QDateTime::currentDateTime(); }
+};
+
+//   VIRTUAL CLOCK: Discrete time, advanced explicitly by a driver (simulator, regression scenario)
+class VirtualClock : public Clock {
+    Q_OBJECT
+
+public:
+    explicit VirtualClock(QObject* parent = nullptr);
+    explicit VirtualClock(const QDateTime& epoch, QObject* parent = nullptr);
+
+    qint64 elapsedMs() const override { return m_nowMs; }
+    QDateTime currentDateTime() const override { return m_epoch.addMSecs(m_nowMs); }
+    TimerId schedule(qint64 delayMs, Callback callback) override;
+    void cancel(TimerId id) override;
+    double rate() const override { return 0.0; }
+
+    //   Only moves time forward: timers made due fire, in order, on the driver's next advance,
+    //   never reentrantly inside the code that slept
+    void sleep(qint64 ms) override;
+
+    //   DRIVER
+    void advance(qint64 ms);
+    void advanceTo(qint64 targetMs);
+    //   Fires timers one by one until none is due within limitMs; returns the number fired
+    int runUntilIdle(qint64 limitMs);
+    int pendingTimers() const { return static_cast<int>(m_queue.size()); }
+    qint64 nextDueMs() const;
+
+signals:
+    void advanced(qint64 nowMs);
+
+private:
+    using QueueKey = std::pair<qint64, TimerId>;   //   (due time, schedule order)
+
+    QDateTime m_epoch;
+    qint64 m_nowMs = 0;
+    TimerId m_nextId = 1;
+    bool m_advancing = false;
+    std::map<QueueKey, Callback> m_queue;
+    QHash<TimerId, qint64> m_dueById;
+};
+
+//   CLOCK TIMER: The QTimer subset used in this codebase, driven by a Clock
+class ClockTimer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ClockTimer(QObject* parent = nullptr);
+    ~ClockTimer();
+
+    //   Re-arms on the new clock if active
+    void setClock(Clock* clock);
+
+    void setInterval(int ms);
+    int interval() const { return m_intervalMs; }
+    void setSingleShot(bool singleShot) { m_singleShot = singleShot; }
+    bool isActive() const { return m_active; }
+
+    void start();
+    void start(int ms);
+    void stop();
+
+signals:
+    void timeout();
+
+private:
+    void arm();
+    void disarm();
+
+    QPointer<Clock> m_clock;
+    Clock::TimerId m_pending = 0;
+    int m_intervalMs = 0;
+    bool m_singleShot = false;
+    bool m_active = false;
+};
@@ -0,0 +1,208 @@
+#pragma once
+#include <QtGlobal>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+template <typename T> class VersionedStore;
+
+//   PINNED VERSION: A reader's hold on one committed version. While it lives the version
+//   cannot be reclaimed; reads through it take no lock. Move-only, one slot per pin.
+template <typename T>
+class PinnedVersion {
+public:
+    PinnedVersion() = default;
+    PinnedVersion(const PinnedVersion&) = delete;
+    PinnedVersion& operator=(const PinnedVersion&) = delete;
+    PinnedVersion(PinnedVersion&& other) noexcept { swap(other); }
+    PinnedVersion& operator=(PinnedVersion&& other) noexcept {
+        if (this != &other) {
+            release();
+            swap(other);
+        }
+        return *this;
+    }
+    ~PinnedVersion() { release(); }
+
+    explicit operator bool() const { return m_value != nullptr; }
+    const T& operator*() const { return *m_value; }
+    const T* operator->() const { return m_value; }
+    const T* get() const { return m_value; }
+    quint64 version() const { return m_version; }
+
+    //   Unpins early; the object reads as empty afterwards
+    void release() {
+        if (m_slot) {
+            m_slot->store(0, std::memory_order_release);
+        }
+        m_slot = nullptr;
+        m_value = nullptr;
+        m_version = 0;
+    }
+
+private:
+    friend class VersionedStore<T>;
+    PinnedVersion(std::atomic<quint64>* slot, const T* value, quint64 version)
+        : m_slot(slot), m_value(value), m_version(version) {}
+
+    void swap(PinnedVersion& other) noexcept {
+        std::swap(m_slot, other.m_slot);
+        std::swap(m_value, other.m_value);
+        std::swap(m_version, other.m_version);
+    }
+
+    std::atomic<quint64>* m_slot = nullptr;
+    const T* m_value = nullptr;
+    quint64 m_version = 0;
+};
+
+//   MULTI-VERSION STORE WITH EPOCH-BASED RECLAMATION
+//
+//   Every commit copies the current value, applies the change to the copy and publishes it
+//   as a new immutable version with one atomic pointer store. Readers pin() whatever is
+//   current and read it without locks, however long they take; writers never wait for them.
+//
+//   RECLAMATION: A reader announces the global epoch in a slot before loading the version
+//   pointer. A commit retires the version it replaced at the epoch it advances from, and
+//   frees retired versions once every announced epoch is newer than theirs, since only
+//   readers that pinned no later than that epoch can still hold them. A reader parked on
+//   an old version therefore delays freeing (memory), never a write.
+//
+//   Writers are serialised by a mutex held only for copy + apply + publish. T should be
+//   cheap to copy (implicitly shared Qt containers), as every commit copies it once.
+template <typename T>
+class VersionedStore {
+public:
+    static constexpr int MAX_READERS = 128;     //   Concurrent pins; a pin waits for a free slot beyond this
+
+    explicit VersionedStore(T initial = T())
+        : m_current(new Version{1, std::move(initial)}) {}
+
+    ~VersionedStore() {
+        //   Owner guarantees no pins outlive the store
+        for (const Retired& retired : m_retired) {
+            delete retired.version;
+        }
+        delete m_current.load(std::memory_order_acquire);
+    }
+
+    VersionedStore(const VersionedStore&) = delete;
+    VersionedStore& operator=(const VersionedStore&) = delete;
+
+    //   READ SIDE: Wait-free unless all MAX_READERS slots are taken
+    PinnedVersion<T> pin() const {
+        const std::size_t start = std::hash<std::thread::id>{}(std::this_thread::get_id()) % MAX_READERS;
+        for (;;) {
+            for (int probe = 0; probe < MAX_READERS; ++probe) {
+                ReaderSlot& slot = m_readers[(start + static_cast<std::size_t>(probe)) % MAX_READERS];
+                quint64 idle = 0;
+                const quint64 epoch = m_globalEpoch.load(std::memory_order_seq_cst);
+                if (slot.epoch.compare_exchange_strong(idle, epoch, std::memory_order_seq_cst)) {
+                    const Version* version = m_current.load(std::memory_order_seq_cst);
+                    return PinnedVersion<T>(&slot.epoch, &version->value, version->number);
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    //   WRITE SIDE: mutate(T&) edits a private copy of the current value; returns the new version
+    template <typename Mutate>
+    quint64 commit(Mutate&& mutate) {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        const Version* previous = m_current.load(std::memory_order_acquire);
+        auto next = std::make_unique<Version>(Version{previous->number + 1, previous->value});
+        std::forward<Mutate>(mutate)(next->value);
+        return publishLocked(std::move(next));
+    }
+
+    //   WRITE SIDE: Replace the value outright
+    quint64 publish(T value) {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        const quint64 number = m_current.load(std::memory_order_acquire)->number + 1;
+        return publishLocked(std::make_unique<Version>(Version{number, std::move(value)}));
+    }
+
+    //   Frees whatever no reader can still hold (commits do this too)
+    void reclaim() {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        reclaimLocked();
+    }
+
+    //   MONITORING: Approximate when called concurrently with readers
+    quint64 currentVersion() const { return m_current.load(std::memory_order_acquire)->number; }
+    quint64 epoch() const { return m_globalEpoch.load(std::memory_order_acquire); }
+    int activeReaders() const {
+        int active = 0;
+        for (const ReaderSlot& slot : m_readers) {
+            active += slot.epoch.load(std::memory_order_relaxed) != 0 ? 1 : 0;
+        }
+        return active;
+    }
+    int retiredVersions() const {
+        std::lock_guard<std::mutex> lock(m_writerMutex);
+        return static_cast<int>(m_retired.size());
+    }
+    quint64 reclaimedVersions() const { return m_reclaimed.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    struct Version {
+        quint64 number;
+        T value;
+    };
+
+    struct Retired {
+        quint64 epoch;                  //   Global epoch when it stopped being current
+        const Version* version;
+    };
+
+    //   One cache line per reader so pins on different cores do not contend
+    struct alignas(CACHE_LINE_SIZE) ReaderSlot {
+        std::atomic<quint64> epoch{0};  //   0 = free, otherwise the epoch the reader pinned at
+    };
+
+    quint64 publishLocked(std::unique_ptr<Version> next) {
+        const quint64 number = next->number;
+        const Version* previous = m_current.exchange(next.release(), std::memory_order_seq_cst);
+        m_retired.push_back(Retired{m_globalEpoch.fetch_add(1, std::memory_order_seq_cst), previous});
+        reclaimLocked();
+        return number;
+    }
+
+    void reclaimLocked() {
+        quint64 oldestPinned = std::numeric_limits<quint64>::max();
+        for (const ReaderSlot& slot : m_readers) {
+            const quint64 pinned = slot.epoch.load(std::memory_order_seq_cst);
+            if (pinned != 0) {
+                oldestPinned = std::min(oldestPinned, pinned);
+            }
+        }
+
+        auto firstKept = std::partition(m_retired.begin(), m_retired.end(),
+                                        [oldestPinned](const Retired& retired) { return retired.epoch < oldestPinned; });
+        for (auto it = m_retired.begin(); it != firstKept; ++it) {
+            delete it->version;
+        }
+        m_reclaimed.fetch_add(static_cast<quint64>(firstKept - m_retired.begin()), std::memory_order_relaxed);
+        m_retired.erase(m_retired.begin(), firstKept);
+    }
+
+    mutable std::array<ReaderSlot, MAX_READERS> m_readers{};
+    alignas(CACHE_LINE_SIZE) std::atomic<quint64> m_globalEpoch{1};
+    alignas(CACHE_LINE_SIZE) std::atomic<const Version*> m_current;
+
+    //   WRITER-OWNED
+    mutable std::mutex m_writerMutex;
+    std::vector<Retired> m_retired;
+    std::atomic<quint64> m_reclaimed{0};
+};
@@ -0,0 +1,696 @@
+#include "CommandJournal.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <QHash>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#ifdef Q_OS_WIN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+const QString SHIPPER_CONNECTION_NAME = QStringLiteral("command_journal_connection");
+
+constexpr quint32 FILE_MAGIC = 0x4e524a52;      //   "RJRN"
+constexpr quint32 RECORD_MAGIC = 0x444d4352;    //   "RCMD"
+constexpr quint32 WRAP_MAGIC = 0x50525752;      //   "RWRP": rest of the file is unused, continue at DATA_START
+constexpr quint32 FORMAT_VERSION = 1;
+
+struct FileHeader {
+    quint32 magic;
+    quint32 formatVersion;
+    qint64 capacity;
+    qint64 shippedOffset;
+    quint64 shippedSeq;
+};
+
+struct RecordHeader {
+    quint32 magic;
+    quint32 length;
+    quint64 sequence;
+    quint32 checksum;
+    quint32 reserved;
+};
+
+constexpr qint64 DATA_START = 64;
+constexpr qint64 RECORD_HEADER_SIZE = static_cast<qint64>(sizeof(RecordHeader));
+static_assert(static_cast<qint64>(sizeof(FileHeader)) <= DATA_START, "File header must fit before the first record");
+
+qint64 alignedRecordSize(qint64 payloadLength) {
+    return (RECORD_HEADER_SIZE + payloadLength + 7) & ~qint64(7);
+}
+
+quint32 checksumOf(const char* data, qsizetype length) {
+    return qChecksum(QByteArrayView(data, length));
+}
+
+//   Applies one command through the same SQL functions the synchronous path uses, so the
+//   audit triggers and operator attribution are identical
+bool shipCommand(QSqlDatabase& db, const CommandJournal::Command& command, QString& error) {
+    //   Compare-and-set on the validated versions; NULL (records without one) writes unconditionally
+    auto version = [](int expected) { return expected >= 0 ? QVariant(expected) : QVariant(QMetaType::fromType<int>()); };
+
+    QSqlQuery query(db);
+    switch (command.kind) {
+    case CommandJournal::CommandKind::MainAspect:
+        query.prepare("SELECT railway_control.update_signal_aspect(?, ?, ?, FALSE, ?)");
+        query.addBindValue(command.entityId);
+        query.addBindValue(command.value);
+        query.addBindValue(command.operatorId);
+        query.addBindValue(version(command.expectedVersion));
+        break;
+    case CommandJournal::CommandKind::SubsidiaryAspect:
+        query.prepare("SELECT railway_control.update_subsidiary_signal_aspect(?, ?, ?, ?, ?)");
+        query.addBindValue(command.entityId);
+        query.addBindValue(command.aspectType);
+        query.addBindValue(command.value);
+        query.addBindValue(command.operatorId);
+        query.addBindValue(version(command.expectedVersion));
+        break;
+    case CommandJournal::CommandKind::PointPosition:
+        query.prepare("SELECT railway_control.update_point_position_paired(?, ?, ?, FALSE, ?, ?)");
+        query.addBindValue(command.entityId);
+        query.addBindValue(command.value);
+        query.addBindValue(command.operatorId);
+        query.addBindValue(version(command.expectedVersion));
+        query.addBindValue(version(command.expectedPairedVersion));
+        break;
+    }
+
+    if (!query.exec() || !query.next()) {
+        error = query.lastError().text();
+        return false;
+    }
+
+    const QJsonObject result = QJsonDocument::fromJson(query.value(0).toString().toUtf8()).object();
+    if (!result["success"].toBool()) {
+        error = result["message"].toString(result["reason"].toString("Rejected by database"));
+        if (result["stale"].toBool()) {
+            error = "STALE_VERSION: " + error;
+        }
+        return false;
+    }
+    return true;
+}
+}
+
+CommandJournal::CommandJournal(QObject* parent)
+    : QObject(parent) {
+}
+
+CommandJournal::~CommandJournal() {
+    close();
+}
+
+//
+//   LIFECYCLE
+//
+
+bool CommandJournal::open(const QString& filePath, const QString& databaseConnectionName, qint64 capacity) {
+    if (m_running.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    if (databaseConnectionName.isEmpty()) {
+        qWarning() << " Command journal not opened: no database connection to clone";
+        return false;
+    }
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qCritical() << " Command journal: cannot open" << filePath << ":" << m_file.errorString();
+        return false;
+    }
+
+    //   PREALLOCATE: The mapping never grows, so the ring is sized once at creation
+    if (m_file.size() < capacity && !m_file.resize(capacity)) {
+        qCritical() << " Command journal: cannot size" << filePath << ":" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    m_capacity = m_file.size();
+    m_map = m_file.map(0, m_capacity);
+    if (!m_map) {
+        qCritical() << " Command journal: cannot map" << filePath << ":" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    if (!recover()) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+        m_file.close();
+        return false;
+    }
+
+    m_sourceConnectionName = databaseConnectionName;
+    m_running.store(true, std::memory_order_release);
+    m_accepting.store(true, std::memory_order_release);
+    m_shipperThread = std::thread(&CommandJournal::runShipper, this);
+
+    qDebug() << "  Command journal open:" << filePath << "(" << m_capacity / 1024 << "KiB,"
+             << durableSequence() - shippedSequence() << "commands awaiting shipment)";
+    return true;
+}
+
+void CommandJournal::close() {
+    if (!m_running.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    m_accepting.store(false, std::memory_order_release);
+
+    //   DRAIN: Acknowledged commands should reach the database before the session ends;
+    //   whatever is left stays in the file and ships on the next open
+    QElapsedTimer timer;
+    timer.start();
+    while (shippedSequence() < durableSequence() && timer.elapsed() < CLOSE_DRAIN_MS) {
+        ring(m_shipDoorbell);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (shippedSequence() < durableSequence()) {
+        qWarning() << " Command journal closed with" << durableSequence() - shippedSequence()
+                   << "commands not yet shipped - they will be applied on the next open";
+    }
+
+    m_running.store(false, std::memory_order_release);
+    ring(m_shipDoorbell);
+    if (m_shipperThread.joinable()) {
+        m_shipperThread.join();
+    }
+
+    m_file.unmap(m_map);
+    m_map = nullptr;
+    m_file.close();
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pending.clear();
+}
+
+//
+//   RECOVERY
+//
+
+bool CommandJournal::recover() {
+    FileHeader header;
+    std::memcpy(&header, m_map, sizeof(header));
+
+    if (header.magic != FILE_MAGIC || header.formatVersion != FORMAT_VERSION || header.capacity != m_capacity
+        || header.shippedOffset < DATA_START || header.shippedOffset >= m_capacity) {
+        if (header.magic == FILE_MAGIC) {
+            qWarning() << " Command journal header does not match this build - starting a new journal";
+        }
+
+        header = FileHeader{FILE_MAGIC, FORMAT_VERSION, m_capacity, DATA_START, 0};
+        std::memcpy(m_map, &header, sizeof(header));
+        std::memset(m_map + DATA_START, 0, RECORD_HEADER_SIZE);
+        if (!flushRange(0, DATA_START + RECORD_HEADER_SIZE)) {
+            qCritical() << " Command journal: cannot initialise header";
+            return false;
+        }
+    }
+
+    //   Replay stops at the first record that is torn, out of sequence or from an earlier lap
+    qint64 offset = header.shippedOffset;
+    quint64 sequence = header.shippedSeq;
+    Command command;
+    while (readRecord(offset, sequence + 1, command)) {
+        ++sequence;
+        addPending(command);
+    }
+
+    m_shippedOffset.store(header.shippedOffset, std::memory_order_release);
+    m_shippedSeq.store(header.shippedSeq, std::memory_order_release);
+    m_appendOffset = offset;
+    m_appendedSeq = sequence;
+    m_durableOffset = offset;
+    m_durableSeq.store(sequence, std::memory_order_release);
+    return true;
+}
+
+bool CommandJournal::readRecord(qint64& offset, quint64 expectedSeq, Command& command) const {
+    qint64 position = offset;
+    if (m_capacity - position < RECORD_HEADER_SIZE) {
+        position = DATA_START;
+    }
+
+    RecordHeader header;
+    std::memcpy(&header, m_map + position, sizeof(header));
+    if (header.magic == WRAP_MAGIC) {
+        position = DATA_START;
+        std::memcpy(&header, m_map + position, sizeof(header));
+    }
+
+    if (header.magic != RECORD_MAGIC || header.sequence != expectedSeq
+        || static_cast<qint64>(header.length) > m_capacity - position - RECORD_HEADER_SIZE) {
+        return false;
+    }
+
+    const char* payload = reinterpret_cast<const char*>(m_map + position + RECORD_HEADER_SIZE);
+    if (checksumOf(payload, header.length) != header.checksum
+        || !decode(QByteArray(payload, header.length), command)) {
+        return false;
+    }
+
+    command.sequence = header.sequence;
+    offset = position + alignedRecordSize(header.length);
+    return true;
+}
+
+//
+//   APPEND + GROUP COMMIT
+//
+
+bool CommandJournal::reserve(qint64 recordSize, qint64& offset) {
+    const qint64 shipped = m_shippedOffset.load(std::memory_order_acquire);
+
+    if (m_appendOffset >= shipped) {
+        if (m_appendOffset + recordSize <= m_capacity) {
+            offset = m_appendOffset;
+            return true;
+        }
+
+        //   WRAP: Only once the shipper has moved past the start of the data region
+        if (DATA_START + recordSize >= shipped) {
+            return false;
+        }
+        if (m_capacity - m_appendOffset >= RECORD_HEADER_SIZE) {
+            const RecordHeader wrap{WRAP_MAGIC, 0, 0, 0, 0};
+            std::memcpy(m_map + m_appendOffset, &wrap, sizeof(wrap));
+        }
+        offset = DATA_START;
+        return true;
+    }
+
+    //   Strictly less: append catching up with the ship cursor would read as an empty ring
+    if (m_appendOffset + recordSize < shipped) {
+        offset = m_appendOffset;
+        return true;
+    }
+    return false;
+}
+
+quint64 CommandJournal::appendDurable(Command command) {
+    if (!isOpen()) {
+        return 0;
+    }
+
+    command.journaledAtMs = QDateTime::currentMSecsSinceEpoch();
+    const QByteArray payload = encode(command);
+    const qint64 recordSize = alignedRecordSize(payload.size());
+
+    quint64 sequence = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_appendMutex);
+
+        qint64 offset = 0;
+        if (!reserve(recordSize, offset)) {
+            qCritical() << " Command journal full:" << m_appendedSeq - shippedSequence()
+                        << "commands awaiting shipment - rejecting" << command.entityId;
+            return 0;
+        }
+
+        sequence = m_appendedSeq + 1;
+        const RecordHeader header{RECORD_MAGIC, static_cast<quint32>(payload.size()), sequence,
+                                  checksumOf(payload.constData(), payload.size()), 0};
+        std::memcpy(m_map + offset + RECORD_HEADER_SIZE, payload.constData(), payload.size());
+        std::memcpy(m_map + offset, &header, sizeof(header));
+
+        m_appendOffset = offset + recordSize;
+        m_appendedSeq = sequence;
+
+        command.sequence = sequence;
+        addPending(command);
+    }
+
+    std::unique_lock<std::mutex> lock(m_flushMutex);
+    while (m_durableSeq.load(std::memory_order_acquire) < sequence) {
+        if (!m_accepting.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        if (m_flushInProgress) {
+            m_flushDone.wait(lock);
+            continue;
+        }
+
+        //   LEADER: One flush covers everything appended up to this point
+        m_flushInProgress = true;
+        lock.unlock();
+        const bool flushed = flushAppended();
+        lock.lock();
+        m_flushInProgress = false;
+        m_flushDone.notify_all();
+
+        if (!flushed) {
+            //   STICKY: Records after the durable point may or may not be on disk, so stop accepting
+            qCritical() << " Command journal flush failed - journal closed for new commands";
+            m_accepting.store(false, std::memory_order_release);
+        }
+    }
+
+    if (m_durableSeq.load(std::memory_order_acquire) < sequence) {
+        removePending(command);
+        return 0;
+    }
+    return sequence;
+}
+
+bool CommandJournal::flushAppended() {
+    const qint64 from = m_durableOffset;
+    qint64 to = 0;
+    quint64 target = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_appendMutex);
+        to = m_appendOffset;
+        target = m_appendedSeq;
+    }
+
+    const bool flushed = to >= from
+        ? flushRange(from, to - from)
+        : flushRange(from, m_capacity - from) && flushRange(DATA_START, to - DATA_START);
+    if (!flushed) {
+        return false;
+    }
+
+    m_durableOffset = to;
+    m_durableSeq.store(target, std::memory_order_release);
+    m_groupFlushes.fetch_add(1, std::memory_order_relaxed);
+    ring(m_shipDoorbell);
+    return true;
+}
+
+bool CommandJournal::flushRange(qint64 offset, qint64 length) {
+    if (length <= 0) {
+        return true;
+    }
+
+#ifdef Q_OS_WIN
+    if (!FlushViewOfFile(m_map + offset, static_cast<SIZE_T>(length))) {
+        return false;
+    }
+    return FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(m_file.handle()))) != 0;
+#else
+    //   msync wants a page-aligned start
+    static const qint64 pageSize = sysconf(_SC_PAGESIZE);
+    const qint64 start = offset - offset % pageSize;
+    return msync(m_map + start, static_cast<size_t>(length + offset - start), MS_SYNC) == 0;
+#endif
+}
+
+//
+//   SHIPPER
+//
+
+void CommandJournal::runShipper() {
+    {
+        //   THREAD AFFINITY: QSqlDatabase handles may only be used by the thread that opened them
+        QSqlDatabase db = QSqlDatabase::cloneDatabase(m_sourceConnectionName, SHIPPER_CONNECTION_NAME);
+        if (!db.open()) {
+            qCritical() << " Command journal shipper connection failed:" << db.lastError().text();
+        }
+
+        qint64 offset = m_shippedOffset.load(std::memory_order_acquire);
+        quint64 sequence = m_shippedSeq.load(std::memory_order_acquire);
+
+        auto backOff = [this]() {
+            if (m_running.load(std::memory_order_acquire)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(SHIP_RETRY_MS));
+            }
+        };
+
+        while (m_running.load(std::memory_order_acquire)) {
+            const uint32_t observed = m_shipDoorbell.load(std::memory_order_acquire);
+            const quint64 durable = m_durableSeq.load(std::memory_order_acquire);
+
+            if (sequence >= durable) {
+                if (m_running.load(std::memory_order_acquire)) {
+                    m_shipDoorbell.wait(observed, std::memory_order_acquire);
+                }
+                continue;
+            }
+
+            //   BATCH: Everything durable (up to MAX_SHIP_BATCH) in one database transaction
+            std::vector<Command> batch;
+            qint64 batchEnd = offset;
+            while (sequence + batch.size() < durable && batch.size() < static_cast<size_t>(MAX_SHIP_BATCH)) {
+                Command command;
+                if (!readRecord(batchEnd, sequence + batch.size() + 1, command)) {
+                    qCritical() << " CRITICAL: Command journal record" << sequence + batch.size() + 1
+                                << "unreadable after it was made durable";
+                    break;
+                }
+                batch.push_back(std::move(command));
+            }
+
+            if (batch.empty()) {
+                backOff();
+                continue;
+            }
+
+            if ((!db.isOpen() && !db.open()) || !db.transaction()) {
+                qWarning() << " Command journal shipper: database unavailable -" << db.lastError().text();
+                backOff();
+                continue;
+            }
+
+            //   SAVEPOINT per command: a rejected command must not take the rest of the batch with it
+            QSqlQuery savepoint(db);
+            QHash<quint64, QString> rejections;
+            bool sessionFailed = false;
+            for (const Command& command : batch) {
+                if (!savepoint.exec("SAVEPOINT journal_command")) {
+                    sessionFailed = true;
+                    break;
+                }
+
+                QString error;
+                if (shipCommand(db, command, error)) {
+                    savepoint.exec("RELEASE SAVEPOINT journal_command");
+                } else if (savepoint.exec("ROLLBACK TO SAVEPOINT journal_command")) {
+                    rejections.insert(command.sequence, error);
+                } else {
+                    sessionFailed = true;
+                    break;
+                }
+            }
+
+            if (sessionFailed || !db.commit()) {
+                qWarning() << " Command journal shipper: batch not applied, retrying -" << db.lastError().text();
+                db.rollback();
+                backOff();
+                continue;
+            }
+
+            sequence += batch.size();
+            offset = batchEnd;
+            persistShipCursor(offset, sequence);
+
+            for (const Command& command : batch) {
+                removePending(command);
+
+                const auto rejection = rejections.constFind(command.sequence);
+                if (rejection != rejections.cend()) {
+                    qCritical() << " SAFETY: Journaled command" << command.sequence << "for" << command.entityId
+                                << "rejected by database:" << *rejection;
+                    emit commandRejected(command.sequence, command.kind, command.entityId, *rejection);
+                } else {
+                    emit commandShipped(command.sequence, command.entityId);
+                }
+            }
+        }
+
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(SHIPPER_CONNECTION_NAME);
+}
+
+void CommandJournal::persistShipCursor(qint64 offset, quint64 seq) {
+    //   A crash before this flush re-ships the batch on the next open; the commands already
+    //   applied then fail their compare-and-set and are reported stale, with the state unchanged
+    const FileHeader header{FILE_MAGIC, FORMAT_VERSION, m_capacity, offset, seq};
+    std::memcpy(m_map, &header, sizeof(header));
+    if (!flushRange(0, sizeof(header))) {
+        qWarning() << " Command journal: ship cursor not flushed - batch may be re-applied after a crash";
+    }
+
+    m_shippedSeq.store(seq, std::memory_order_release);
+    m_shippedOffset.store(offset, std::memory_order_release);
+}
+
+void CommandJournal::ring(std::atomic<uint32_t>& doorbell) {
+    doorbell.fetch_add(1, std::memory_order_release);
+    doorbell.notify_one();
+}
+
+//
+//   PENDING OVERLAY
+//
+
+QString CommandJournal::pendingKey(CommandKind kind, const QString& entityId, const QString& aspectType) {
+    switch (kind) {
+    case CommandKind::MainAspect: return "S:" + entityId + ":MAIN";
+    case CommandKind::SubsidiaryAspect: return "S:" + entityId + ":" + aspectType;
+    case CommandKind::PointPosition: return "P:" + entityId;
+    }
+    return QString();
+}
+
+QString CommandJournal::pendingRowKey(CommandKind kind, const QString& entityId) {
+    return (kind == CommandKind::PointPosition ? "P:" : "S:") + entityId;
+}
+
+void CommandJournal::addPending(const Command& command) {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    m_pending.insert(pendingKey(command.kind, command.entityId, command.aspectType),
+                     PendingValue{command.sequence, command.value, command.kind, command.entityId, command.aspectType});
+    if (command.kind == CommandKind::PointPosition && !command.pairedEntityId.isEmpty()) {
+        m_pending.insert(pendingKey(command.kind, command.pairedEntityId, QString()),
+                         PendingValue{command.sequence, command.value, command.kind, command.pairedEntityId, QString()});
+    }
+
+    //   Each applied command moves every row it writes on by one
+    if (command.expectedVersion >= 0) {
+        m_pendingVersions.insert(pendingRowKey(command.kind, command.entityId),
+                                 PendingVersion{command.sequence, command.expectedVersion + 1});
+    }
+    if (command.kind == CommandKind::PointPosition && !command.pairedEntityId.isEmpty()
+        && command.expectedPairedVersion >= 0) {
+        m_pendingVersions.insert(pendingRowKey(command.kind, command.pairedEntityId),
+                                 PendingVersion{command.sequence, command.expectedPairedVersion + 1});
+    }
+}
+
+void CommandJournal::removePending(const Command& command) {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+
+    //   Only clear entries this command still owns; a newer command for the entity keeps its value
+    auto release = [this, &command](const QString& key) {
+        const auto it = m_pending.constFind(key);
+        if (it != m_pending.cend() && it->sequence == command.sequence) {
+            m_pending.erase(it);
+        }
+    };
+
+    release(pendingKey(command.kind, command.entityId, command.aspectType));
+    if (command.kind == CommandKind::PointPosition && !command.pairedEntityId.isEmpty()) {
+        release(pendingKey(command.kind, command.pairedEntityId, QString()));
+    }
+
+    auto releaseVersion = [this, &command](const QString& key) {
+        const auto it = m_pendingVersions.constFind(key);
+        if (it != m_pendingVersions.cend() && it->sequence == command.sequence) {
+            m_pendingVersions.erase(it);
+        }
+    };
+
+    releaseVersion(pendingRowKey(command.kind, command.entityId));
+    if (command.kind == CommandKind::PointPosition && !command.pairedEntityId.isEmpty()) {
+        releaseVersion(pendingRowKey(command.kind, command.pairedEntityId));
+    }
+}
+
+std::optional<QString> CommandJournal::pendingSignalAspect(const QString& signalId, const QString& aspectType) const {
+    const CommandKind kind = aspectType == "MAIN" ? CommandKind::MainAspect : CommandKind::SubsidiaryAspect;
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    const auto it = m_pending.constFind(pendingKey(kind, signalId, aspectType));
+    return it != m_pending.cend() ? std::optional<QString>(it->value) : std::nullopt;
+}
+
+std::optional<QString> CommandJournal::pendingPointPosition(const QString& machineId) const {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    const auto it = m_pending.constFind(pendingKey(CommandKind::PointPosition, machineId, QString()));
+    return it != m_pending.cend() ? std::optional<QString>(it->value) : std::nullopt;
+}
+
+CommandJournal::PendingState CommandJournal::pendingState() const {
+    PendingState state;
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    for (const PendingValue& pending : m_pending) {
+        switch (pending.kind) {
+        case CommandKind::MainAspect:
+            state.mainAspects.insert(pending.entityId, pending.value);
+            break;
+        case CommandKind::SubsidiaryAspect:
+            (pending.aspectType == "CALLING_ON" ? state.callingOnAspects : state.loopAspects)
+                .insert(pending.entityId, pending.value);
+            break;
+        case CommandKind::PointPosition:
+            state.pointPositions.insert(pending.entityId, pending.value);
+            break;
+        }
+    }
+    return state;
+}
+
+std::optional<int> CommandJournal::pendingSignalVersion(const QString& signalId) const {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    const auto it = m_pendingVersions.constFind(pendingRowKey(CommandKind::MainAspect, signalId));
+    return it != m_pendingVersions.cend() ? std::optional<int>(it->version) : std::nullopt;
+}
+
+std::optional<int> CommandJournal::pendingPointVersion(const QString& machineId) const {
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    const auto it = m_pendingVersions.constFind(pendingRowKey(CommandKind::PointPosition, machineId));
+    return it != m_pendingVersions.cend() ? std::optional<int>(it->version) : std::nullopt;
+}
+
+//
+//   RECORD ENCODING
+//
+
+QByteArray CommandJournal::encode(const Command& command) {
+    QJsonObject object;
+    object["kind"] = static_cast<int>(command.kind);
+    object["id"] = command.entityId;
+    object["value"] = command.value;
+    object["operator"] = command.operatorId;
+    object["at"] = command.journaledAtMs;
+    if (!command.aspectType.isEmpty()) object["aspectType"] = command.aspectType;
+    if (!command.pairedEntityId.isEmpty()) object["paired"] = command.pairedEntityId;
+    if (command.expectedVersion >= 0) object["version"] = command.expectedVersion;
+    if (command.expectedPairedVersion >= 0) object["pairedVersion"] = command.expectedPairedVersion;
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+bool CommandJournal::decode(const QByteArray& payload, Command& command) {
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(payload, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        return false;
+    }
+
+    const QJsonObject object = document.object();
+    const int kind = object["kind"].toInt(-1);
+    if (kind < static_cast<int>(CommandKind::MainAspect) || kind > static_cast<int>(CommandKind::PointPosition)) {
+        return false;
+    }
+
+    command.kind = static_cast<CommandKind>(kind);
+    command.entityId = object["id"].toString();
+    command.aspectType = object["aspectType"].toString();
+    command.value = object["value"].toString();
+    command.pairedEntityId = object["paired"].toString();
+    command.operatorId = object["operator"].toString();
+    command.journaledAtMs = object["at"].toInteger();
+    command.expectedVersion = object["version"].toInt(-1);
+    command.expectedPairedVersion = object["pairedVersion"].toInt(-1);
+    return !command.entityId.isEmpty() && !command.value.isEmpty();
+}
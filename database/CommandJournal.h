@@ -0,0 +1,177 @@
+#pragma once
+#include <QObject>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+//   OPERATOR COMMAND JOURNAL
+//
+//   Append-only, memory-mapped ring file that makes operator commands durable before
+//   they reach PostgreSQL. A command is acknowledged once the local flush that covers
+//   it completes; a background shipper then applies journaled commands to the database
+//   in order, in batched transactions, so railway_audit is written by the usual triggers.
+//
+//   GROUP COMMIT: Appends are a memcpy under a short lock. The first appender that needs
+//   durability becomes the flush leader and flushes every record appended so far in one
+//   msync/FlushViewOfFile; appenders that arrive meanwhile wait for the next flush and
+//   share it. Under load, one fsync covers many concurrent commands.
+//
+//   READ-YOUR-WRITES: Until a command is shipped, its value is held in a pending overlay
+//   so interlocking reads see acknowledged state rather than the lagging database row.
+//
+//   COMPARE-AND-SET: Each command carries the row versions it was validated on (past any
+//   pending commands for the same rows) and ships against them; a row that moved on in
+//   between, e.g. to an occupancy enforcement, rejects it as STALE_VERSION.
+//
+//   RECOVERY: On open, records after the persisted ship cursor are re-read (sequence and
+//   checksum must match) and shipped before anything new.
+class CommandJournal : public QObject {
+    Q_OBJECT
+
+public:
+    enum class CommandKind : quint8 {
+        MainAspect,
+        SubsidiaryAspect,
+        PointPosition
+    };
+    Q_ENUM(CommandKind)
+
+    struct Command {
+        quint64 sequence = 0;           //   Assigned by append
+        CommandKind kind = CommandKind::MainAspect;
+        QString entityId;
+        QString aspectType;             //   CALLING_ON / LOOP for subsidiary aspects
+        QString value;                  //   Aspect or position code
+        QString pairedEntityId;         //   Point machines: the paired half moves with it
+        QString operatorId;
+        qint64 journaledAtMs = 0;
+        int expectedVersion = -1;       //   Row version the command was validated on; -1: unconditional
+        int expectedPairedVersion = -1;
+    };
+
+    //   Newest unshipped value per entity, by kind
+    struct PendingState {
+        QHash<QString, QString> mainAspects;        //   signalId -> aspect
+        QHash<QString, QString> callingOnAspects;
+        QHash<QString, QString> loopAspects;
+        QHash<QString, QString> pointPositions;     //   machineId -> position
+
+        bool isEmpty() const {
+            return mainAspects.isEmpty() && callingOnAspects.isEmpty() && loopAspects.isEmpty()
+                   && pointPositions.isEmpty();
+        }
+    };
+
+    static constexpr qint64 DEFAULT_CAPACITY = 8 * 1024 * 1024;
+
+    explicit CommandJournal(QObject* parent = nullptr);
+    ~CommandJournal();
+
+    //   LIFECYCLE: The connection is cloned so the shipper owns its own session
+    bool open(const QString& filePath, const QString& databaseConnectionName,
+              qint64 capacity = DEFAULT_CAPACITY);
+    void close();
+    bool isOpen() const { return m_accepting.load(std::memory_order_acquire); }
+
+    //   Appends the command and blocks until it is durable on local storage. Returns the
+    //   assigned sequence, or 0 if the journal is closed, full or the flush failed - the
+    //   command was then not accepted and must not be acknowledged. Any thread may append,
+    //   but not concurrently with close().
+    quint64 appendDurable(Command command);
+
+    //   PENDING OVERLAY: Value of the newest unshipped command for the entity, if any
+    std::optional<QString> pendingSignalAspect(const QString& signalId, const QString& aspectType) const;
+    std::optional<QString> pendingPointPosition(const QString& machineId) const;
+    PendingState pendingState() const;
+
+    //   Version the row will have once its newest unshipped command is applied: a command
+    //   validated on top of pending state expects this rather than the database row's version
+    std::optional<int> pendingSignalVersion(const QString& signalId) const;
+    std::optional<int> pendingPointVersion(const QString& machineId) const;
+
+    //   MONITORING
+    quint64 durableSequence() const { return m_durableSeq.load(std::memory_order_acquire); }
+    quint64 shippedSequence() const { return m_shippedSeq.load(std::memory_order_acquire); }
+    quint64 groupFlushes() const { return m_groupFlushes.load(std::memory_order_relaxed); }
+
+signals:
+    //   Emitted from the shipper thread; receivers on the GUI thread get queued delivery
+    void commandShipped(quint64 sequence, const QString& entityId);
+    //   Includes compare-and-set failures (STALE_VERSION): the row moved on after validation
+    void commandRejected(quint64 sequence, CommandJournal::CommandKind kind, const QString& entityId,
+                         const QString& error);
+
+private:
+    //   RING: [file header][records ...] - records never straddle the end of the file
+    bool recover();
+    bool reserve(qint64 recordSize, qint64& offset);
+    bool flushRange(qint64 offset, qint64 length);
+    bool flushAppended();
+    bool readRecord(qint64& offset, quint64 expectedSeq, Command& command) const;
+    void persistShipCursor(qint64 offset, quint64 seq);
+
+    //   SHIPPER
+    void runShipper();
+    static void ring(std::atomic<uint32_t>& doorbell);
+
+    //   PENDING OVERLAY
+    static QString pendingKey(CommandKind kind, const QString& entityId, const QString& aspectType);
+    static QString pendingRowKey(CommandKind kind, const QString& entityId);
+    void addPending(const Command& command);
+    void removePending(const Command& command);
+
+    static QByteArray encode(const Command& command);
+    static bool decode(const QByteArray& payload, Command& command);
+
+    static constexpr int MAX_SHIP_BATCH = 64;
+    static constexpr int SHIP_RETRY_MS = 500;
+    static constexpr int CLOSE_DRAIN_MS = 5000;
+
+    QFile m_file;
+    uchar* m_map = nullptr;
+    qint64 m_capacity = 0;
+    QString m_sourceConnectionName;
+
+    //   APPEND STATE (m_appendMutex)
+    std::mutex m_appendMutex;
+    qint64 m_appendOffset = 0;
+    quint64 m_appendedSeq = 0;
+
+    //   GROUP COMMIT STATE (m_flushMutex)
+    std::mutex m_flushMutex;
+    std::condition_variable m_flushDone;
+    bool m_flushInProgress = false;
+    qint64 m_durableOffset = 0;
+
+    //   SHIP CURSOR: Only the shipper advances it; appenders read it to find free space
+    std::atomic<qint64> m_shippedOffset{0};
+    std::atomic<quint64> m_shippedSeq{0};
+    std::atomic<quint64> m_durableSeq{0};
+    std::atomic<quint64> m_groupFlushes{0};
+    std::atomic<uint32_t> m_shipDoorbell{0};
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_accepting{false};
+
+    mutable std::mutex m_pendingMutex;
+    struct PendingValue {
+        quint64 sequence = 0;
+        QString value;
+        CommandKind kind = CommandKind::MainAspect;
+        QString entityId;
+        QString aspectType;
+    };
+    QHash<QString, PendingValue> m_pending;
+    struct PendingVersion {
+        quint64 sequence = 0;
+        int version = 0;
+    };
+    QHash<QString, PendingVersion> m_pendingVersions;  //   Per row: "S:" / "P:" + id
+
+    std::thread m_shipperThread;
+};
@@ -0,0 +1,48 @@
+#include "ConfigLookup.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDebug>
+
+namespace {
+
+template <size_t N>
+bool verifyTable(const QSqlDatabase& db, const QString& table, const QString& codeColumn,
+                 const std::array<const char*, N>& codes, QString& error) {
+    QSqlQuery query(db);
+    if (!query.exec(QString("SELECT id, %1 FROM railway_config.%2").arg(codeColumn, table))) {
+        error = QString("Failed to read %1: %2").arg(table, query.lastError().text());
+        return false;
+    }
+
+    size_t rows = 0;
+    while (query.next()) {
+        const int id = query.value(0).toInt();
+        const QString code = query.value(1).toString();
+        if (id <= 0 || static_cast<size_t>(id) >= N || code != QLatin1String(codes[id])) {
+            error = QString("%1 row %2 (%3) does not match the compiled lookup table").arg(table).arg(id).arg(code);
+            return false;
+        }
+        ++rows;
+    }
+
+    if (rows != N - 1) {
+        error = QString("%1 has %2 rows, expected %3").arg(table).arg(rows).arg(N - 1);
+        return false;
+    }
+    return true;
+}
+
+}
+
+bool ConfigLookup::verify(const QSqlDatabase& db, QString* error) {
+    QString message;
+    const bool ok = verifyTable(db, "signal_aspects", "aspect_code", ASPECT_CODES, message)
+                    && verifyTable(db, "point_positions", "position_code", POSITION_CODES, message)
+                    && verifyTable(db, "signal_types", "type_code", SIGNAL_TYPE_CODES, message);
+
+    if (!ok) {
+        qCritical() << " ConfigLookup:" << message;
+        if (error) *error = message;
+    }
+    return ok;
+}
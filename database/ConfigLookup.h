@@ -0,0 +1,78 @@
+#pragma once
+#include "../interlocking/PackedAspect.h"
+#include <QSqlDatabase>
+#include <QString>
+#include <array>
+
+//   CONFIGURATION LOOKUP TABLES
+//
+//   Aspect, point position and signal type codes as immutable in-process tables whose index
+//   is the railway_config row id. DatabaseInitializer seeds the config tables in exactly this
+//   order and generates the SQL helpers (railway_config.get_aspect_id etc.) from the same
+//   arrays, so code <-> id is an array index in C++ and an array subscript / array_position()
+//   in IMMUTABLE SQL functions - never a table lookup per call.
+//
+//   Index 0 is reserved for "not found"; SQL arrays are 1-based, so ids line up on both sides.
+class ConfigLookup {
+public:
+    static constexpr int NOT_FOUND = 0;
+
+    //   Index == railway_config.signal_aspects.id == AspectCode
+    static constexpr std::array<const char*, 9> ASPECT_CODES = {
+        "", "RED", "YELLOW", "GREEN", "SINGLE_YELLOW", "DOUBLE_YELLOW", "WHITE", "BLUE", "OFF"
+    };
+
+    //   Index == railway_config.point_positions.id
+    static constexpr std::array<const char*, 3> POSITION_CODES = { "", "NORMAL", "REVERSE" };
+
+    //   Index == railway_config.signal_types.id
+    static constexpr std::array<const char*, 5> SIGNAL_TYPE_CODES = {
+        "", "STARTER", "HOME", "OUTER", "ADVANCED_STARTER"
+    };
+
+    static_assert(static_cast<size_t>(AspectCode::OFF) + 1 == ASPECT_CODES.size(),
+                  "AspectCode values must index ASPECT_CODES");
+
+    //   CODE -> ID
+    static int aspectId(const QString& code) { return idOf(ASPECT_CODES, code); }
+    static int positionId(const QString& code) { return idOf(POSITION_CODES, code); }
+    static int signalTypeId(const QString& code) { return idOf(SIGNAL_TYPE_CODES, code); }
+
+    //   ID -> CODE (empty string when out of range)
+    static QString aspectCode(int id) { return codeOf(ASPECT_CODES, id); }
+    static QString positionCode(int id) { return codeOf(POSITION_CODES, id); }
+    static QString signalTypeCode(int id) { return codeOf(SIGNAL_TYPE_CODES, id); }
+
+    //   SQL: ARRAY['A', 'B', ...]::VARCHAR[] literal for the generated helper functions
+    static QString aspectSqlArray() { return sqlArray(ASPECT_CODES); }
+    static QString positionSqlArray() { return sqlArray(POSITION_CODES); }
+    static QString signalTypeSqlArray() { return sqlArray(SIGNAL_TYPE_CODES); }
+
+    //   STARTUP CHECK: Reads the three config tables once and confirms every row sits at its
+    //   index. A mismatch means the database was seeded by a different build.
+    static bool verify(const QSqlDatabase& db, QString* error = nullptr);
+
+private:
+    template <size_t N>
+    static int idOf(const std::array<const char*, N>& codes, const QString& code) {
+        for (size_t id = 1; id < N; ++id) {
+            if (code == QLatin1String(codes[id])) return static_cast<int>(id);
+        }
+        return NOT_FOUND;
+    }
+
+    template <size_t N>
+    static QString codeOf(const std::array<const char*, N>& codes, int id) {
+        return (id > 0 && static_cast<size_t>(id) < N) ? QString::fromLatin1(codes[id]) : QString();
+    }
+
+    template <size_t N>
+    static QString sqlArray(const std::array<const char*, N>& codes) {
+        QString literal = "ARRAY[";
+        for (size_t id = 1; id < N; ++id) {
+            if (id > 1) literal += ", ";
+            literal += QString("'%1'").arg(QLatin1String(codes[id]));
+        }
+        return literal + "]::VARCHAR[]";
+    }
+};
@@ -1,9 +1,13 @@
 #include "DatabaseInitializer.h"
+#include "StationData.h"
+#include "ConfigLookup.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QCoreApplication>
 #include <QThread>
 
+using namespace RailFlux::Station;
+
 DatabaseInitializer::DatabaseInitializer(QObject* parent)
     : QObject(parent)
     , resetTimer(new QTimer(this))
@@ -384,6 +388,11 @@ bool DatabaseInitializer::createControlTables() {
     qDebug() << "Creating control tables with route assignment integration...";
 
     QStringList controlTables = {
+        // Station-wide change sequence: every insert/update of a live entity row takes the next
+        // value and records its writing transaction (change_xid); get_station_snapshot resumes
+        // from a transaction watermark, since seq values commit out of order
+        R"(CREATE SEQUENCE railway_control.station_change_seq)",
+
         // Track circuits with pathfinding enhancements
         R"(CREATE TABLE railway_control.track_circuits (
             id SERIAL PRIMARY KEY,
@@ -399,6 +408,9 @@ bool DatabaseInitializer::createControlTables() {
             is_overlap BOOLEAN DEFAULT FALSE,
             length_meters NUMERIC(10,2),
             max_speed_kmh INTEGER,
+            change_seq BIGINT NOT NULL DEFAULT nextval('railway_control.station_change_seq'),
+            change_xid XID8 NOT NULL DEFAULT pg_current_xact_id(),
+            version INTEGER NOT NULL DEFAULT 0,
             created_at TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP,
             updated_at TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP
         ))",
@@ -421,6 +433,8 @@ bool DatabaseInitializer::createControlTables() {
             max_speed_kmh INTEGER,
             is_active BOOLEAN DEFAULT TRUE,
             protecting_signals TEXT[],
+            change_seq BIGINT NOT NULL DEFAULT nextval('railway_control.station_change_seq'),
+            change_xid XID8 NOT NULL DEFAULT pg_current_xact_id(),
             created_at TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP,
             updated_at TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP,
             CONSTRAINT chk_coordinates CHECK (
@@ -465,6 +479,9 @@ bool DatabaseInitializer::createControlTables() {
             is_locked BOOLEAN DEFAULT FALSE,
             manual_control_active BOOLEAN DEFAULT FALSE,
 
+            change_seq BIGINT NOT NULL DEFAULT nextval('railway_control.station_change_seq'),
+            change_xid XID8 NOT NULL DEFAULT pg_current_xact_id(),
+            version INTEGER NOT NULL DEFAULT 0,
             created_at TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP,
             updated_at TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP,
 
@@ -501,6 +518,9 @@ bool DatabaseInitializer::createControlTables() {
             route_locking_enabled BOOLEAN DEFAULT TRUE,
             auto_normalize_after_route BOOLEAN DEFAULT TRUE,
 
+            change_seq BIGINT NOT NULL DEFAULT nextval('railway_control.station_change_seq'),
+            change_xid XID8 NOT NULL DEFAULT pg_current_xact_id(),
+            version INTEGER NOT NULL DEFAULT 0,
             created_at TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP,
             updated_at TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP,
 
@@ -550,6 +570,31 @@ bool DatabaseInitializer::createControlTables() {
             CONSTRAINT chk_no_self_reference CHECK (
                 NOT (source_entity_type = target_entity_type AND source_entity_id = target_entity_id)
             )
+        ))",
+
+        // Compiled signal interlocking rules, installed from the C++ rule engine's published
+        // rule set (the C++ engine stays the authority; these rows are a replica for
+        // server-side validate-and-apply). when_bits / when_mask use the PackedAspect layout.
+        R"(CREATE TABLE railway_control.compiled_signal_control (
+            signal_id VARCHAR(20) PRIMARY KEY,
+            is_independent BOOLEAN NOT NULL DEFAULT FALSE,
+            control_mode VARCHAR(3) NOT NULL DEFAULT 'AND' CHECK (control_mode IN ('AND', 'OR')),
+            controlled_by TEXT[] NOT NULL DEFAULT '{}',
+            rules_version BIGINT NOT NULL
+        ))",
+
+        R"(CREATE TABLE railway_control.compiled_signal_rules (
+            id SERIAL PRIMARY KEY,
+            controller_signal_id VARCHAR(20) NOT NULL,
+            when_bits INTEGER NOT NULL,
+            when_mask INTEGER NOT NULL,
+            condition_machines TEXT[] NOT NULL DEFAULT '{}',
+            condition_position_ids INTEGER[] NOT NULL DEFAULT '{}',
+            allows JSONB NOT NULL,
+            rules_version BIGINT NOT NULL,
+            CONSTRAINT chk_condition_arity CHECK (
+                cardinality(condition_machines) = cardinality(condition_position_ids)
+            )
         ))"
     };
 
@@ -578,6 +623,7 @@ bool DatabaseInitializer::createRouteAssignmentTables() {
                 'PARTIALLY_RELEASED', 'RELEASED', 'FAILED',
                 'EMERGENCY_RELEASED', 'DEGRADED'
             )),
+            version INTEGER NOT NULL DEFAULT 0,
             created_at TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP,
             activated_at TIMESTAMP WITH TIME ZONE,
             released_at TIMESTAMP WITH TIME ZONE,
@@ -600,6 +646,24 @@ bool DatabaseInitializer::createRouteAssignmentTables() {
             CONSTRAINT chk_route_signals CHECK (
                 source_signal_id != dest_signal_id
             )
+        ))",
+
+        // Route resources - one row per (route, circuit) and (route, point machine), carrying
+        // the route's state so lock lookups are indexed equality joins instead of array scans.
+        // Maintained by railway_control.sync_route_resources() on every route_assignments write.
+        R"(CREATE TABLE railway_control.route_circuits (
+            route_id UUID NOT NULL REFERENCES railway_control.route_assignments(id) ON DELETE CASCADE,
+            circuit_id TEXT NOT NULL,
+            is_overlap BOOLEAN NOT NULL DEFAULT FALSE,
+            state TEXT NOT NULL,
+            PRIMARY KEY (route_id, circuit_id)
+        ))",
+
+        R"(CREATE TABLE railway_control.route_point_locks (
+            route_id UUID NOT NULL REFERENCES railway_control.route_assignments(id) ON DELETE CASCADE,
+            machine_id TEXT NOT NULL,
+            state TEXT NOT NULL,
+            PRIMARY KEY (route_id, machine_id)
         ))"
     };
 
@@ -714,6 +778,19 @@ bool DatabaseInitializer::createIndexes() {
         "CREATE INDEX idx_route_assignments_active ON railway_control.route_assignments(state) WHERE state IN ('RESERVED', 'ACTIVE')",
         "CREATE INDEX idx_route_assignments_signals ON railway_control.route_assignments(source_signal_id, dest_signal_id)",
         "CREATE INDEX idx_route_assignments_created ON railway_control.route_assignments(created_at)",
+        "CREATE INDEX idx_route_circuits_circuit_state ON railway_control.route_circuits(circuit_id, state)",
+        "CREATE INDEX idx_route_point_locks_machine_state ON railway_control.route_point_locks(machine_id, state)",
+        "CREATE INDEX idx_compiled_signal_rules_controller ON railway_control.compiled_signal_rules(controller_signal_id)",
+
+        // Incremental snapshot indexes
+        "CREATE INDEX idx_track_circuits_change_seq ON railway_control.track_circuits(change_seq)",
+        "CREATE INDEX idx_track_segments_change_seq ON railway_control.track_segments(change_seq)",
+        "CREATE INDEX idx_signals_change_seq ON railway_control.signals(change_seq)",
+        "CREATE INDEX idx_point_machines_change_seq ON railway_control.point_machines(change_seq)",
+        "CREATE INDEX idx_track_circuits_change_xid ON railway_control.track_circuits(change_xid)",
+        "CREATE INDEX idx_track_segments_change_xid ON railway_control.track_segments(change_xid)",
+        "CREATE INDEX idx_signals_change_xid ON railway_control.signals(change_xid)",
+        "CREATE INDEX idx_point_machines_change_xid ON railway_control.point_machines(change_xid)",
 
         // Audit indexes (KEEP)
         "CREATE INDEX idx_event_log_timestamp ON railway_audit.event_log(event_timestamp)",
@@ -766,6 +843,27 @@ bool DatabaseInitializer::createFunctions() {
         NEW.updated_at = CURRENT_TIMESTAMP;
         RETURN NEW;
     END;
+    $$ LANGUAGE plpgsql)",
+
+        // Per-row version for optimistic concurrency: commands carry the version they validated
+        // against and write with a compare-and-set; every update moves the row on by one
+        R"(CREATE OR REPLACE FUNCTION railway_control.bump_row_version()
+    RETURNS TRIGGER AS $$
+    BEGIN
+        NEW.version = OLD.version + 1;
+        RETURN NEW;
+    END;
+    $$ LANGUAGE plpgsql)",
+
+        // Stamps every modified entity row with the next station change sequence value and the
+        // writing transaction, which get_station_snapshot filters on
+        R"(CREATE OR REPLACE FUNCTION railway_control.stamp_change_seq()
+    RETURNS TRIGGER AS $$
+    BEGIN
+        NEW.change_seq = nextval('railway_control.station_change_seq');
+        NEW.change_xid = pg_current_xact_id();
+        RETURN NEW;
+    END;
     $$ LANGUAGE plpgsql)",
 
         // Specialized trigger for signals to update last_changed_at only when aspect changes
@@ -779,29 +877,270 @@ bool DatabaseInitializer::createFunctions() {
     END;
     $$ LANGUAGE plpgsql)",
 
-        // Helper function to convert aspect codes (RED, GREEN, etc.) to database IDs
-        R"(CREATE OR REPLACE FUNCTION railway_config.get_aspect_id(aspect_code_param VARCHAR)
+        // Code <-> id helpers generated from ConfigLookup: the config tables are seeded in array
+        // order, so the id is the array position and the functions never touch a table. Being
+        // IMMUTABLE SQL one-liners, the planner inlines them and folds constant arguments.
+        QString(R"(CREATE OR REPLACE FUNCTION railway_config.get_aspect_id(aspect_code_param VARCHAR)
+    RETURNS INTEGER AS $$
+        SELECT array_position(%1, aspect_code_param)
+    $$ LANGUAGE sql IMMUTABLE PARALLEL SAFE)").arg(ConfigLookup::aspectSqlArray()),
+
+        QString(R"(CREATE OR REPLACE FUNCTION railway_config.get_aspect_code(aspect_id_param INTEGER)
+    RETURNS VARCHAR AS $$
+        SELECT (%1)[aspect_id_param]
+    $$ LANGUAGE sql IMMUTABLE PARALLEL SAFE)").arg(ConfigLookup::aspectSqlArray()),
+
+        QString(R"(CREATE OR REPLACE FUNCTION railway_config.get_position_id(position_code_param VARCHAR)
     RETURNS INTEGER AS $$
+        SELECT array_position(%1, position_code_param)
+    $$ LANGUAGE sql IMMUTABLE PARALLEL SAFE)").arg(ConfigLookup::positionSqlArray()),
+
+        QString(R"(CREATE OR REPLACE FUNCTION railway_config.get_position_code(position_id_param INTEGER)
+    RETURNS VARCHAR AS $$
+        SELECT (%1)[position_id_param]
+    $$ LANGUAGE sql IMMUTABLE PARALLEL SAFE)").arg(ConfigLookup::positionSqlArray()),
+
+        QString(R"(CREATE OR REPLACE FUNCTION railway_config.get_signal_type_code(type_id_param INTEGER)
+    RETURNS VARCHAR AS $$
+        SELECT (%1)[type_id_param]
+    $$ LANGUAGE sql IMMUTABLE PARALLEL SAFE)").arg(ConfigLookup::signalTypeSqlArray()),
+
+        // 
+        // SERVER-SIDE INTERLOCKING - Optional validate-and-apply for operator commands
+        // 
+
+        // Mirrors SignalBranch::validateMainAspectChange against the compiled rule replica. Callers
+        // hold the signal row FOR UPDATE; everything the verdict depends on (protected circuits,
+        // controlling signals, condition points) is locked FOR SHARE here, so the state cannot
+        // change between this check and the caller's write. Returns {allowed, code, reason}.
+        R"(CREATE OR REPLACE FUNCTION railway_control.validate_signal_aspect_change(
+        signal_id_param VARCHAR,
+        aspect_code_param VARCHAR
+    )
+    RETURNS JSONB AS $$
     DECLARE
-        aspect_id_result INTEGER;
+        red_id CONSTANT INTEGER := railway_config.get_aspect_id('RED');
+        white_id CONSTANT INTEGER := railway_config.get_aspect_id('WHITE');
+        off_id CONSTANT INTEGER := railway_config.get_aspect_id('OFF');
+        requested_id INTEGER := railway_config.get_aspect_id(aspect_code_param);
+        sig RECORD;
+        control RECORD;
+        controller RECORD;
+        occupied_circuit VARCHAR;
+        controller_bits INTEGER;
+        aspect_allowed BOOLEAN;
+        any_allows BOOLEAN := FALSE;
     BEGIN
-        SELECT id INTO aspect_id_result
-        FROM railway_config.signal_aspects
-        WHERE aspect_code = aspect_code_param;
-        RETURN aspect_id_result;
+        SELECT s.is_active, s.current_aspect_id, s.possible_aspects, s.protected_track_circuits
+        INTO sig
+        FROM railway_control.signals s
+        WHERE s.signal_id = signal_id_param;
+
+        IF NOT FOUND THEN
+            RETURN jsonb_build_object('allowed', FALSE, 'code', 'SIGNAL_NOT_FOUND',
+                                      'reason', 'Signal not found: ' || signal_id_param);
+        END IF;
+
+        IF NOT COALESCE(sig.is_active, FALSE) THEN
+            RETURN jsonb_build_object('allowed', FALSE, 'code', 'SIGNAL_INACTIVE',
+                                      'reason', 'Signal is not active: ' || signal_id_param);
+        END IF;
+
+        IF requested_id IS NULL THEN
+            RETURN jsonb_build_object('allowed', FALSE, 'code', 'INVALID_TRANSITION',
+                                      'reason', 'Invalid aspect code: ' || aspect_code_param);
+        END IF;
+
+        -- Basic transition: RED->RED is allowed as safety redundancy, other no-ops are not
+        IF sig.current_aspect_id = requested_id AND requested_id <> red_id THEN
+            RETURN jsonb_build_object('allowed', FALSE, 'code', 'NO_TRANSITION_NEEDED',
+                                      'reason', format('No transition needed - signal %s already showing %s',
+                                                       signal_id_param, aspect_code_param));
+        END IF;
+
+        IF NOT (aspect_code_param = ANY(COALESCE(sig.possible_aspects, '{}'))) THEN
+            RETURN jsonb_build_object('allowed', FALSE, 'code', 'ASPECT_NOT_SUPPORTED',
+                                      'reason', format('Aspect %s not supported by signal %s',
+                                                       aspect_code_param, signal_id_param));
+        END IF;
+
+        -- Calling-on (WHITE) is only entered from and left to RED
+        IF requested_id <> red_id AND sig.current_aspect_id IS DISTINCT FROM red_id
+           AND (sig.current_aspect_id = white_id OR requested_id = white_id) THEN
+            RETURN jsonb_build_object('allowed', FALSE, 'code', 'INVALID_TRANSITION',
+                                      'reason', format('Invalid aspect transition from %s to %s for signal %s',
+                                                       railway_config.get_aspect_code(sig.current_aspect_id),
+                                                       aspect_code_param, signal_id_param));
+        END IF;
+
+        IF requested_id = red_id THEN
+            RETURN jsonb_build_object('allowed', TRUE, 'code', 'ALLOWED', 'reason', 'RED is always permitted');
+        END IF;
+
+        -- Track circuit protection: hold the circuits so no train can enter before commit
+        PERFORM 1 FROM railway_control.track_circuits tc
+        WHERE tc.circuit_id = ANY(COALESCE(sig.protected_track_circuits, '{}'))
+        ORDER BY tc.circuit_id
+        FOR SHARE;
+
+        SELECT tc.circuit_id INTO occupied_circuit
+        FROM railway_control.track_circuits tc
+        WHERE tc.circuit_id = ANY(COALESCE(sig.protected_track_circuits, '{}'))
+          AND tc.is_occupied = TRUE
+        LIMIT 1;
+
+        IF occupied_circuit IS NOT NULL THEN
+            RETURN jsonb_build_object('allowed', FALSE, 'code', 'TRACK_CIRCUIT_OCCUPIED',
+                                      'reason', format('Cannot clear signal %s: protected track circuit %s is occupied',
+                                                       signal_id_param, occupied_circuit),
+                                      'affected', jsonb_build_array(occupied_circuit));
+        END IF;
+
+        -- Controlling signals (InterlockingRuleEngine::validateControllingSignals)
+        SELECT * INTO control
+        FROM railway_control.compiled_signal_control c
+        WHERE c.signal_id = signal_id_param;
+
+        IF NOT FOUND THEN
+            IF NOT EXISTS (SELECT 1 FROM railway_control.compiled_signal_control) THEN
+                RETURN jsonb_build_object('allowed', FALSE, 'code', 'RULES_NOT_LOADED',
+                                          'reason', 'Interlocking rules not installed on the server');
+            END IF;
+            RETURN jsonb_build_object('allowed', FALSE, 'code', 'SIGNAL_NOT_IN_RULES',
+                                      'reason', format('Signal %s not found in interlocking rules', signal_id_param));
+        END IF;
+
+        IF control.is_independent THEN
+            RETURN jsonb_build_object('allowed', TRUE, 'code', 'ALLOWED',
+                                      'reason', 'Independent signal - no interlocking restrictions');
+        END IF;
+
+        PERFORM 1 FROM railway_control.signals s
+        WHERE s.signal_id = ANY(control.controlled_by)
+        ORDER BY s.signal_id
+        FOR SHARE;
+
+        PERFORM 1 FROM railway_control.point_machines pm
+        WHERE pm.machine_id IN (
+            SELECT unnest(r.condition_machines)
+            FROM railway_control.compiled_signal_rules r
+            WHERE r.controller_signal_id = ANY(control.controlled_by)
+        )
+        ORDER BY pm.machine_id
+        FOR SHARE;
+
+        FOR controller IN
+            SELECT cb.controller_id, s.current_aspect_id, s.calling_on_aspect_id, s.loop_aspect_id
+            FROM unnest(control.controlled_by) AS cb(controller_id)
+            LEFT JOIN railway_control.signals s ON s.signal_id = cb.controller_id
+            WHERE EXISTS (SELECT 1 FROM railway_control.compiled_signal_control c
+                          WHERE c.signal_id = cb.controller_id)
+        LOOP
+            -- PackedAspect layout: main | calling-on << 8 | loop << 16, missing components read as OFF
+            controller_bits := COALESCE(controller.current_aspect_id, 0)
+                               | (COALESCE(controller.calling_on_aspect_id, off_id) << 8)
+                               | (COALESCE(controller.loop_aspect_id, off_id) << 16);
+
+            SELECT EXISTS (
+                SELECT 1 FROM railway_control.compiled_signal_rules r
+                WHERE r.controller_signal_id = controller.controller_id
+                  AND (controller_bits & r.when_mask) = r.when_bits
+                  AND (r.allows -> signal_id_param) @> jsonb_build_array(aspect_code_param)
+                  AND NOT EXISTS (
+                      SELECT 1
+                      FROM unnest(r.condition_machines, r.condition_position_ids) AS cond(machine_id, position_id)
+                      LEFT JOIN railway_control.point_machines pm ON pm.machine_id = cond.machine_id
+                      WHERE pm.current_position_id IS DISTINCT FROM cond.position_id
+                  )
+            ) INTO aspect_allowed;
+
+            IF control.control_mode = 'AND' AND NOT aspect_allowed THEN
+                RETURN jsonb_build_object('allowed', FALSE, 'code', 'CONTROLLING_SIGNAL_RESTRICTION',
+                                          'reason', format('Signal %s cannot show %s: controlling signal %s shows %s',
+                                                           signal_id_param, aspect_code_param, controller.controller_id,
+                                                           COALESCE(railway_config.get_aspect_code(controller.current_aspect_id), 'UNKNOWN')),
+                                          'affected', jsonb_build_array(controller.controller_id));
+            END IF;
+
+            any_allows := any_allows OR aspect_allowed;
+        END LOOP;
+
+        IF control.control_mode = 'OR' AND NOT any_allows THEN
+            RETURN jsonb_build_object('allowed', FALSE, 'code', 'CONTROLLING_SIGNAL_RESTRICTION',
+                                      'reason', format('Signal %s cannot show %s: no controlling signals allow it',
+                                                       signal_id_param, aspect_code_param));
+        END IF;
+
+        RETURN jsonb_build_object('allowed', TRUE, 'code', 'ALLOWED',
+                                  'reason', 'All controlling signals permit the requested aspect');
     END;
     $$ LANGUAGE plpgsql)",
 
-        // Helper function to convert position codes (NORMAL, REVERSE) to database IDs
-        R"(CREATE OR REPLACE FUNCTION railway_config.get_position_id(position_code_param VARCHAR)
-    RETURNS INTEGER AS $$
+        // Mirrors PointMachineBranch::validatePositionChange for one machine. Callers hold the
+        // machine row FOR UPDATE; the circuits under the root and requested leg are locked here.
+        R"(CREATE OR REPLACE FUNCTION railway_control.validate_point_position_change(
+        machine_id_param VARCHAR,
+        position_code_param VARCHAR
+    )
+    RETURNS JSONB AS $$
     DECLARE
-        position_id_result INTEGER;
+        machine RECORD;
+        affected_segments TEXT[];
+        occupied RECORD;
     BEGIN
-        SELECT id INTO position_id_result
-        FROM railway_config.point_positions
-        WHERE position_code = position_code_param;
-        RETURN position_id_result;
+        SELECT pm.current_position_id, pm.operating_status,
+               pm.root_track_segment_connection ->> 'trackSegmentId' AS root_segment,
+               CASE WHEN position_code_param = 'NORMAL'
+                    THEN pm.normal_track_segment_connection ->> 'trackSegmentId'
+                    ELSE pm.reverse_track_segment_connection ->> 'trackSegmentId'
+               END AS leg_segment
+        INTO machine
+        FROM railway_control.point_machines pm
+        WHERE pm.machine_id = machine_id_param;
+
+        IF NOT FOUND THEN
+            RETURN jsonb_build_object('allowed', FALSE, 'code', 'POINT_MACHINE_NOT_FOUND',
+                                      'reason', 'Point machine not found: ' || machine_id_param);
+        END IF;
+
+        IF machine.current_position_id = railway_config.get_position_id(position_code_param) THEN
+            RETURN jsonb_build_object('allowed', TRUE, 'code', 'ALLOWED',
+                                      'reason', 'No change required - point already in requested position');
+        END IF;
+
+        IF machine.operating_status IN ('IN_TRANSITION', 'FAILED', 'LOCKED_OUT') THEN
+            RETURN jsonb_build_object('allowed', FALSE,
+                                      'code', CASE machine.operating_status
+                                                  WHEN 'IN_TRANSITION' THEN 'POINT_MACHINE_IN_TRANSITION'
+                                                  WHEN 'FAILED' THEN 'POINT_MACHINE_FAILED'
+                                                  ELSE 'POINT_MACHINE_LOCKED_OUT'
+                                              END,
+                                      'reason', format('Point machine %s is %s', machine_id_param, machine.operating_status));
+        END IF;
+
+        affected_segments := ARRAY[machine.root_segment, machine.leg_segment];
+
+        PERFORM 1 FROM railway_control.track_circuits tc
+        WHERE tc.circuit_id IN (SELECT ts.circuit_id FROM railway_control.track_segments ts
+                                WHERE ts.segment_id = ANY(affected_segments))
+        ORDER BY tc.circuit_id
+        FOR SHARE;
+
+        SELECT ts.segment_id, tc.occupied_by INTO occupied
+        FROM railway_control.track_segments ts
+        JOIN railway_control.track_circuits tc ON tc.circuit_id = ts.circuit_id
+        WHERE ts.segment_id = ANY(affected_segments)
+          AND tc.is_occupied = TRUE
+        LIMIT 1;
+
+        IF FOUND THEN
+            RETURN jsonb_build_object('allowed', FALSE, 'code', 'AFFECTED_TRACK_SEGMENT_OCCUPIED',
+                                      'reason', format('Cannot operate point machine %s: affected trackSegment %s is occupied by %s',
+                                                       machine_id_param, occupied.segment_id, COALESCE(occupied.occupied_by, 'unknown')),
+                                      'affected', jsonb_build_array(occupied.segment_id));
+        END IF;
+
+        RETURN jsonb_build_object('allowed', TRUE, 'code', 'ALLOWED', 'reason', 'All point machine validations passed');
     END;
     $$ LANGUAGE plpgsql)",
 
@@ -809,16 +1148,25 @@ bool DatabaseInitializer::createFunctions() {
         // SIGNAL CONTROL FUNCTIONS - Main and subsidiary signal operations
         // 
 
-        // Main function for updating signal aspects with route assignment locking check
+        // Main function for updating signal aspects with route assignment locking check.
+        // Returns the row as written ({success, signal_id, aspect_id, last_changed_at, change_seq}),
+        // so callers need no verification read. With validate_param the interlocking check runs
+        // under the row lock first; a rejection returns {success: false, blocked: true, code, reason}.
+        // expected_version_param makes the write a compare-and-set: a row that moved on since the
+        // caller validated is left alone and {success: false, stale: true, version} comes back.
         R"(CREATE OR REPLACE FUNCTION railway_control.update_signal_aspect(
         signal_id_param VARCHAR,
         aspect_code_param VARCHAR,
-        operator_id_param VARCHAR DEFAULT 'system'
+        operator_id_param VARCHAR DEFAULT 'system',
+        validate_param BOOLEAN DEFAULT FALSE,
+        expected_version_param INTEGER DEFAULT NULL
     )
-    RETURNS BOOLEAN AS $$
+    RETURNS JSONB AS $$
     DECLARE
         aspect_id_val INTEGER;
-        rows_affected INTEGER;
+        previous_aspect_id INTEGER;
+        result_json JSONB;
+        validation_json JSONB;
         route_locked BOOLEAN;
     BEGIN
         -- Set operator context for audit logging
@@ -830,6 +1178,19 @@ bool DatabaseInitializer::createFunctions() {
             RAISE EXCEPTION 'Invalid aspect code: %', aspect_code_param;
         END IF;
 
+        -- Optional server-side interlocking: check and apply under one row lock
+        IF validate_param THEN
+            SELECT s.current_aspect_id INTO previous_aspect_id
+            FROM railway_control.signals s
+            WHERE s.signal_id = signal_id_param
+            FOR UPDATE;
+
+            validation_json := railway_control.validate_signal_aspect_change(signal_id_param, aspect_code_param);
+            IF NOT (validation_json ->> 'allowed')::BOOLEAN THEN
+                RETURN validation_json || jsonb_build_object('success', FALSE, 'blocked', TRUE, 'signal_id', signal_id_param);
+            END IF;
+        END IF;
+
         -- UPDATED: Check if signal is locked by checking route assignments directly
         SELECT EXISTS(
             SELECT 1 FROM railway_control.route_assignments ra
@@ -847,27 +1208,49 @@ bool DatabaseInitializer::createFunctions() {
         END IF;
 
         -- Update signal aspect
-        UPDATE railway_control.signals
+        UPDATE railway_control.signals s
         SET current_aspect_id = aspect_id_val,
             last_changed_by = operator_id_param
-        WHERE signal_id = signal_id_param;
+        WHERE s.signal_id = signal_id_param
+          AND (expected_version_param IS NULL OR s.version = expected_version_param)
+        RETURNING jsonb_build_object(
+            'success', TRUE,
+            'signal_id', s.signal_id,
+            'aspect_id', s.current_aspect_id,
+            'previous_aspect_id', previous_aspect_id,
+            'version', s.version,
+            'last_changed_at', s.last_changed_at,
+            'change_seq', s.change_seq
+        ) INTO result_json;
+
+        IF result_json IS NULL AND expected_version_param IS NOT NULL THEN
+            SELECT jsonb_build_object('success', FALSE, 'stale', TRUE, 'code', 'STALE_VERSION',
+                                      'signal_id', s.signal_id, 'version', s.version,
+                                      'expected_version', expected_version_param,
+                                      'reason', format('Signal %s changed since validation (version %s, expected %s)',
+                                                       s.signal_id, s.version, expected_version_param))
+            INTO result_json
+            FROM railway_control.signals s
+            WHERE s.signal_id = signal_id_param;
+        END IF;
 
-        GET DIAGNOSTICS rows_affected = ROW_COUNT;
-        RETURN rows_affected > 0;
+        RETURN COALESCE(result_json, jsonb_build_object('success', FALSE, 'signal_id', signal_id_param));
     END;
     $$ LANGUAGE plpgsql)",
 
-        // Function for updating subsidiary signals (calling on and loop aspects)
+        // Function for updating subsidiary signals (calling on and loop aspects); returns the
+        // written row in the same shape as update_signal_aspect, aspect_id being the subsidiary one
         R"(CREATE OR REPLACE FUNCTION railway_control.update_subsidiary_signal_aspect(
         signal_id_param VARCHAR,
         aspect_type_param VARCHAR,
         aspect_code_param VARCHAR,
-        operator_id_param VARCHAR DEFAULT 'system'
+        operator_id_param VARCHAR DEFAULT 'system',
+        expected_version_param INTEGER DEFAULT NULL
     )
-    RETURNS BOOLEAN AS $$
+    RETURNS JSONB AS $$
     DECLARE
         aspect_id_val INTEGER;
-        rows_affected INTEGER;
+        result_json JSONB;
     BEGIN
         -- Set operator context for audit logging
         PERFORM set_config('railway.operator_id', operator_id_param, true);
@@ -885,21 +1268,49 @@ bool DatabaseInitializer::createFunctions() {
 
         -- Update the appropriate subsidiary signal column
         IF aspect_type_param = 'CALLING_ON' THEN
-            UPDATE railway_control.signals
+            UPDATE railway_control.signals s
             SET calling_on_aspect_id = aspect_id_val,
                 last_changed_at = CURRENT_TIMESTAMP,
                 last_changed_by = operator_id_param
-            WHERE signal_id = signal_id_param;
+            WHERE s.signal_id = signal_id_param
+              AND (expected_version_param IS NULL OR s.version = expected_version_param)
+            RETURNING jsonb_build_object(
+                'success', TRUE,
+                'signal_id', s.signal_id,
+                'aspect_id', s.calling_on_aspect_id,
+                'version', s.version,
+                'last_changed_at', s.last_changed_at,
+                'change_seq', s.change_seq
+            ) INTO result_json;
         ELSIF aspect_type_param = 'LOOP' THEN
-            UPDATE railway_control.signals
+            UPDATE railway_control.signals s
             SET loop_aspect_id = aspect_id_val,
                 last_changed_at = CURRENT_TIMESTAMP,
                 last_changed_by = operator_id_param
-            WHERE signal_id = signal_id_param;
+            WHERE s.signal_id = signal_id_param
+              AND (expected_version_param IS NULL OR s.version = expected_version_param)
+            RETURNING jsonb_build_object(
+                'success', TRUE,
+                'signal_id', s.signal_id,
+                'aspect_id', s.loop_aspect_id,
+                'version', s.version,
+                'last_changed_at', s.last_changed_at,
+                'change_seq', s.change_seq
+            ) INTO result_json;
         END IF;
 
-        GET DIAGNOSTICS rows_affected = ROW_COUNT;
-        RETURN rows_affected > 0;
+        IF result_json IS NULL AND expected_version_param IS NOT NULL THEN
+            SELECT jsonb_build_object('success', FALSE, 'stale', TRUE, 'code', 'STALE_VERSION',
+                                      'signal_id', s.signal_id, 'version', s.version,
+                                      'expected_version', expected_version_param,
+                                      'reason', format('Signal %s changed since validation (version %s, expected %s)',
+                                                       s.signal_id, s.version, expected_version_param))
+            INTO result_json
+            FROM railway_control.signals s
+            WHERE s.signal_id = signal_id_param;
+        END IF;
+
+        RETURN COALESCE(result_json, jsonb_build_object('success', FALSE, 'signal_id', signal_id_param));
     END;
     $$ LANGUAGE plpgsql)",
 
@@ -945,16 +1356,21 @@ bool DatabaseInitializer::createFunctions() {
         R"(CREATE OR REPLACE FUNCTION railway_control.update_point_position_paired(
         machine_id_param VARCHAR,
         position_code_param VARCHAR,
-        operator_id_param VARCHAR DEFAULT 'system'
+        operator_id_param VARCHAR DEFAULT 'system',
+        validate_param BOOLEAN DEFAULT FALSE,
+        expected_version_param INTEGER DEFAULT NULL,
+        expected_paired_version_param INTEGER DEFAULT NULL
     )
     RETURNS JSONB AS $$
     DECLARE
         position_id_val INTEGER;
+        stale_machine RECORD;
         paired_machine_id VARCHAR(20);
         current_position_code VARCHAR(20);
         paired_current_position_code VARCHAR(20);
         rows_affected INTEGER;
         result_json JSONB;
+        validation_json JSONB;
         position_mismatch BOOLEAN := FALSE;
         route_locked BOOLEAN;
     BEGIN
@@ -967,11 +1383,77 @@ bool DatabaseInitializer::createFunctions() {
             RAISE EXCEPTION 'Invalid position code: %', position_code_param;
         END IF;
 
+        -- Compare-and-set: hold both halves only if neither moved on since the caller validated
+        IF expected_version_param IS NOT NULL OR expected_paired_version_param IS NOT NULL THEN
+            SELECT pm.machine_id, pm.version,
+                   CASE WHEN pm.machine_id = machine_id_param THEN expected_version_param
+                        ELSE expected_paired_version_param END AS expected_version
+            INTO stale_machine
+            FROM (
+                SELECT p.machine_id, p.version
+                FROM railway_control.point_machines p
+                WHERE p.machine_id = machine_id_param
+                   OR p.machine_id = (SELECT q.paired_entity FROM railway_control.point_machines q
+                                      WHERE q.machine_id = machine_id_param)
+                ORDER BY p.machine_id
+                FOR UPDATE
+            ) pm
+            WHERE pm.version IS DISTINCT FROM CASE WHEN pm.machine_id = machine_id_param
+                                                   THEN COALESCE(expected_version_param, pm.version)
+                                                   ELSE COALESCE(expected_paired_version_param, pm.version) END
+            LIMIT 1;
+
+            IF FOUND THEN
+                RETURN jsonb_build_object(
+                    'success', FALSE,
+                    'stale', TRUE,
+                    'code', 'STALE_VERSION',
+                    'machine_id', stale_machine.machine_id,
+                    'version', stale_machine.version,
+                    'expected_version', stale_machine.expected_version,
+                    'machines_updated', '[]'::jsonb,
+                    'message', format('Point machine %s changed since validation (version %s, expected %s)',
+                                      stale_machine.machine_id, stale_machine.version, stale_machine.expected_version),
+                    'position_mismatch', FALSE
+                );
+            END IF;
+        END IF;
+
+        -- Optional server-side interlocking: lock both halves, then validate each under the locks
+        IF validate_param THEN
+            PERFORM 1 FROM railway_control.point_machines pm
+            WHERE pm.machine_id = machine_id_param
+               OR pm.machine_id = (SELECT p.paired_entity FROM railway_control.point_machines p
+                                   WHERE p.machine_id = machine_id_param)
+            ORDER BY pm.machine_id
+            FOR UPDATE;
+
+            validation_json := railway_control.validate_point_position_change(machine_id_param, position_code_param);
+
+            SELECT pm.paired_entity INTO paired_machine_id
+            FROM railway_control.point_machines pm
+            WHERE pm.machine_id = machine_id_param;
+
+            IF (validation_json ->> 'allowed')::BOOLEAN AND paired_machine_id IS NOT NULL THEN
+                validation_json := railway_control.validate_point_position_change(paired_machine_id, position_code_param);
+            END IF;
+
+            IF NOT (validation_json ->> 'allowed')::BOOLEAN THEN
+                RETURN validation_json || jsonb_build_object(
+                    'success', FALSE,
+                    'blocked', TRUE,
+                    'machines_updated', '[]'::jsonb,
+                    'message', validation_json ->> 'reason',
+                    'position_mismatch', FALSE
+                );
+            END IF;
+        END IF;
+
         -- UPDATED: Check if point machine is locked by checking route assignments directly
         SELECT EXISTS(
-            SELECT 1 FROM railway_control.route_assignments ra
-            WHERE machine_id_param = ANY(ra.locked_point_machines)
-            AND ra.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
+            SELECT 1 FROM railway_control.route_point_locks rpl
+            WHERE rpl.machine_id = machine_id_param
+            AND rpl.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
         ) INTO route_locked;
 
         IF route_locked THEN
@@ -1113,9 +1595,9 @@ bool DatabaseInitializer::createFunctions() {
 
         -- UPDATED: Check if locked by route assignment (no resource_locks table)
         SELECT EXISTS(
-            SELECT 1 FROM railway_control.route_assignments ra
-            WHERE machine_id_param = ANY(ra.locked_point_machines)
-            AND ra.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
+            SELECT 1 FROM railway_control.route_point_locks rpl
+            WHERE rpl.machine_id = machine_id_param
+            AND rpl.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
         ) INTO is_route_locked;
 
         RETURN NOT (COALESCE(is_locked, TRUE) OR COALESCE(is_in_transition, TRUE) OR COALESCE(is_route_locked, TRUE))
@@ -1137,9 +1619,10 @@ bool DatabaseInitializer::createFunctions() {
             tc.is_occupied,
             -- UPDATED: Check if locked by route assignment (no resource_locks table)
             EXISTS(
-                SELECT 1 FROM railway_control.route_assignments ra
-                WHERE tc.circuit_id = ANY(ra.assigned_circuits)
-                AND ra.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
+                SELECT 1 FROM railway_control.route_circuits rc
+                WHERE rc.circuit_id = tc.circuit_id
+                AND NOT rc.is_overlap
+                AND rc.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
             ) as is_locked,
             'TRACK_CIRCUIT'::TEXT as circuit_type  -- UPDATED: Fixed circuit_type reference
         FROM railway_control.track_circuits tc
@@ -1196,7 +1679,8 @@ bool DatabaseInitializer::createFunctions() {
         circuit_id_param VARCHAR,
         is_occupied_param BOOLEAN,
         occupied_by_param VARCHAR DEFAULT NULL,
-        operator_id_param VARCHAR DEFAULT 'system'
+        operator_id_param VARCHAR DEFAULT 'system',
+        expected_version_param INTEGER DEFAULT NULL
     )
     RETURNS BOOLEAN AS $$
     DECLARE
@@ -1215,7 +1699,8 @@ bool DatabaseInitializer::createFunctions() {
             END,
             last_changed_at = CURRENT_TIMESTAMP,
             updated_at = CURRENT_TIMESTAMP
-        WHERE circuit_id = circuit_id_param;
+        WHERE circuit_id = circuit_id_param
+          AND (expected_version_param IS NULL OR version = expected_version_param);
 
         GET DIAGNOSTICS rows_affected = ROW_COUNT;
         RETURN rows_affected > 0;
@@ -1269,9 +1754,9 @@ bool DatabaseInitializer::createFunctions() {
         priority_param INTEGER DEFAULT 100,
         operator_id_param VARCHAR DEFAULT 'system'
     )
-    RETURNS BOOLEAN AS $$
+    RETURNS JSONB AS $$
     DECLARE
-        rows_affected INTEGER;
+        inserted_route JSONB;
         function_start_time TIMESTAMP := CURRENT_TIMESTAMP;
         step_name VARCHAR := 'INITIALIZATION';
         error_context TEXT;
@@ -1362,32 +1847,29 @@ bool DatabaseInitializer::createFunctions() {
                 priority_param,
                 operator_id_param,
                 CURRENT_TIMESTAMP
-            );
+            )
+            RETURNING jsonb_build_object(
+                'success', TRUE,
+                'id', id,
+                'source_signal_id', source_signal_id,
+                'dest_signal_id', dest_signal_id,
+                'state', state,
+                'created_at', created_at
+            ) INTO inserted_route;
 
-            GET DIAGNOSTICS rows_affected = ROW_COUNT;
-            RAISE NOTICE '[insert_route_assignment]  Route insertion completed. Rows affected: %', rows_affected;
+            RAISE NOTICE '[insert_route_assignment]  Route insertion completed';
 
         EXCEPTION WHEN OTHERS THEN
             error_context := 'Route insertion failed: ' || SQLERRM;
             RAISE EXCEPTION '[insert_route_assignment]  INSERTION_FAILED at %: %', step_name, error_context;
         END;
 
-        --   INSERTION VERIFICATION
-        step_name := 'INSERTION_VERIFICATION';
-
-        IF rows_affected = 0 THEN
+        -- RETURNING yields a row only if the insert happened; no re-read needed
+        IF inserted_route IS NULL THEN
             error_context := 'No rows were inserted - unknown error';
             RAISE EXCEPTION '[insert_route_assignment]  NO_ROWS_INSERTED: %', error_context;
         END IF;
 
-        -- Verify the route actually exists
-        IF NOT EXISTS(SELECT 1 FROM railway_control.route_assignments WHERE id = route_id_param) THEN
-            error_context := 'Route was not found after insertion - possible rollback';
-            RAISE EXCEPTION '[insert_route_assignment]  VERIFICATION_FAILED: %', error_context;
-        END IF;
-
-        RAISE NOTICE '[insert_route_assignment]   Route insertion verified successfully';
-
         --   EVENT LOGGING
         step_name := 'EVENT_LOGGING';
 
@@ -1426,7 +1908,7 @@ bool DatabaseInitializer::createFunctions() {
         RAISE NOTICE '[insert_route_assignment]   FUNCTION SUCCESS: Route % created in % ms',
             route_id_param, EXTRACT(EPOCH FROM (CURRENT_TIMESTAMP - function_start_time)) * 1000;
 
-        RETURN rows_affected > 0;
+        RETURN inserted_route;
 
     EXCEPTION WHEN OTHERS THEN
         --   COMPREHENSIVE ERROR HANDLING
@@ -1438,6 +1920,127 @@ bool DatabaseInitializer::createFunctions() {
             route_id_param,
             EXTRACT(EPOCH FROM (CURRENT_TIMESTAMP - function_start_time)) * 1000;
     END;
+    $$ LANGUAGE plpgsql)",
+
+        // 
+        // STATION SNAPSHOT - Bulk load and resync in one round trip
+        // 
+
+        // Narrow projection of every entity type as positional arrays (column order is fixed and
+        // mirrored by DatabaseManager::getStationSnapshot). since_seq_param <= 0 returns the whole
+        // station plus text labels; otherwise only rows written since the 'seq' a previous call
+        // returned. A segment is included when either it or its circuit changed, since its
+        // occupancy comes from the circuit.
+        //
+        // 'seq' is a snapshot-safe resume watermark: the xmin of this call's snapshot, i.e. the
+        // oldest transaction still in flight. change_seq values commit out of order (a lower one
+        // can become visible after a higher one), so MAX(change_seq) would skip it for good;
+        // every transaction not yet visible here has an xid >= xmin, so resuming from xmin
+        // re-reads at most a few already-delivered rows and never misses one.
+        R"(CREATE OR REPLACE FUNCTION railway_control.get_station_snapshot(since_seq_param BIGINT DEFAULT 0)
+    RETURNS JSONB AS $$
+    DECLARE
+        is_full BOOLEAN := COALESCE(since_seq_param, 0) <= 0;
+        since_xid XID8 := GREATEST(COALESCE(since_seq_param, 0), 0)::TEXT::XID8;
+    BEGIN
+        RETURN jsonb_build_object(
+            'seq', pg_snapshot_xmin(pg_current_snapshot())::TEXT::BIGINT,
+            'full', is_full,
+
+            'trackCircuits', COALESCE((
+                SELECT jsonb_agg(jsonb_build_array(
+                    tc.circuit_id, tc.is_occupied, tc.occupied_by, tc.is_assigned, tc.is_overlap, tc.version
+                ) ORDER BY tc.circuit_id)
+                FROM railway_control.track_circuits tc
+                WHERE tc.change_xid >= since_xid
+            ), '[]'::jsonb),
+
+            'trackSegments', COALESCE((
+                SELECT jsonb_agg(jsonb_build_array(
+                    ts.segment_id, ts.segment_name, ts.start_row, ts.start_col, ts.end_row, ts.end_col,
+                    ts.track_segment_type, ts.is_active, ts.circuit_id, ts.is_assigned, ts.is_overlap,
+                    COALESCE(tc.is_occupied, FALSE), tc.occupied_by
+                ) ORDER BY ts.segment_id)
+                FROM railway_control.track_segments ts
+                LEFT JOIN railway_control.track_circuits tc ON ts.circuit_id = tc.circuit_id
+                WHERE ts.change_xid >= since_xid OR tc.change_xid >= since_xid
+            ), '[]'::jsonb),
+
+            'signals', COALESCE((
+                SELECT jsonb_agg(jsonb_build_array(
+                    s.signal_id, s.signal_name, railway_config.get_signal_type_code(s.signal_type_id),
+                    s.location_row, s.location_col, s.direction,
+                    s.is_active, s.is_locked, s.location_description,
+                    railway_config.get_aspect_code(s.current_aspect_id),
+                    railway_config.get_aspect_code(s.calling_on_aspect_id),
+                    railway_config.get_aspect_code(s.loop_aspect_id),
+                    s.loop_signal_configuration, s.aspect_count, s.possible_aspects, s.version
+                ) ORDER BY s.signal_id)
+                FROM railway_control.signals s
+                WHERE s.change_xid >= since_xid
+            ), '[]'::jsonb),
+
+            'pointMachines', COALESCE((
+                SELECT jsonb_agg(jsonb_build_array(
+                    pm.machine_id, pm.machine_name, railway_config.get_position_code(pm.current_position_id),
+                    pm.operating_status, pm.junction_row, pm.junction_col,
+                    pm.root_track_segment_connection, pm.normal_track_segment_connection,
+                    pm.reverse_track_segment_connection,
+                    pm.transition_time_ms, pm.is_locked, pm.lock_reason, pm.paired_entity, pm.version
+                ) ORDER BY pm.machine_id)
+                FROM railway_control.point_machines pm
+                WHERE pm.change_xid >= since_xid
+            ), '[]'::jsonb),
+
+            -- Labels are static layout: full snapshots only
+            'textLabels', CASE WHEN is_full THEN COALESCE((
+                SELECT jsonb_agg(jsonb_build_array(
+                    tl.label_text, tl.position_row, tl.position_col, tl.font_size, tl.color,
+                    tl.font_family, tl.is_visible, tl.label_type
+                ) ORDER BY tl.id)
+                FROM railway_control.text_labels tl
+            ), '[]'::jsonb) ELSE '[]'::jsonb END
+        );
+    END;
+    $$ LANGUAGE plpgsql STABLE)",
+
+        // Keeps route_circuits / route_point_locks in step with route_assignments: membership is
+        // rebuilt when the arrays change, otherwise only the denormalized state is rewritten
+        R"(CREATE OR REPLACE FUNCTION railway_control.sync_route_resources()
+    RETURNS TRIGGER AS $$
+    BEGIN
+        IF TG_OP = 'UPDATE'
+           AND NEW.assigned_circuits IS NOT DISTINCT FROM OLD.assigned_circuits
+           AND NEW.overlap_circuits IS NOT DISTINCT FROM OLD.overlap_circuits
+           AND NEW.locked_point_machines IS NOT DISTINCT FROM OLD.locked_point_machines THEN
+            IF NEW.state IS DISTINCT FROM OLD.state THEN
+                UPDATE railway_control.route_circuits SET state = NEW.state WHERE route_id = NEW.id;
+                UPDATE railway_control.route_point_locks SET state = NEW.state WHERE route_id = NEW.id;
+            END IF;
+            RETURN NEW;
+        END IF;
+
+        IF TG_OP = 'UPDATE' THEN
+            DELETE FROM railway_control.route_circuits WHERE route_id = NEW.id;
+            DELETE FROM railway_control.route_point_locks WHERE route_id = NEW.id;
+        END IF;
+
+        -- A circuit listed as both path and overlap is held as path
+        INSERT INTO railway_control.route_circuits (route_id, circuit_id, is_overlap, state)
+        SELECT NEW.id, c.circuit_id, bool_and(c.is_overlap), NEW.state
+        FROM (
+            SELECT unnest(NEW.assigned_circuits) AS circuit_id, FALSE AS is_overlap
+            UNION ALL
+            SELECT unnest(COALESCE(NEW.overlap_circuits, '{}')), TRUE
+        ) c
+        GROUP BY c.circuit_id;
+
+        INSERT INTO railway_control.route_point_locks (route_id, machine_id, state)
+        SELECT DISTINCT NEW.id, m.machine_id, NEW.state
+        FROM unnest(COALESCE(NEW.locked_point_machines, '{}')) AS m(machine_id);
+
+        RETURN NEW;
+    END;
     $$ LANGUAGE plpgsql)",
 
         // 
@@ -1554,6 +2157,40 @@ bool DatabaseInitializer::createTriggers() {
         BEFORE UPDATE ON railway_control.text_labels
         FOR EACH ROW EXECUTE FUNCTION railway_control.update_timestamp())",
 
+        // Snapshot change sequence
+        R"(CREATE TRIGGER trg_track_circuits_change_seq
+        BEFORE UPDATE ON railway_control.track_circuits
+        FOR EACH ROW EXECUTE FUNCTION railway_control.stamp_change_seq())",
+
+        R"(CREATE TRIGGER trg_track_segments_change_seq
+        BEFORE UPDATE ON railway_control.track_segments
+        FOR EACH ROW EXECUTE FUNCTION railway_control.stamp_change_seq())",
+
+        R"(CREATE TRIGGER trg_signals_change_seq
+        BEFORE UPDATE ON railway_control.signals
+        FOR EACH ROW EXECUTE FUNCTION railway_control.stamp_change_seq())",
+
+        R"(CREATE TRIGGER trg_point_machines_change_seq
+        BEFORE UPDATE ON railway_control.point_machines
+        FOR EACH ROW EXECUTE FUNCTION railway_control.stamp_change_seq())",
+
+        // Row versions
+        R"(CREATE TRIGGER trg_track_circuits_version
+        BEFORE UPDATE ON railway_control.track_circuits
+        FOR EACH ROW EXECUTE FUNCTION railway_control.bump_row_version())",
+
+        R"(CREATE TRIGGER trg_signals_version
+        BEFORE UPDATE ON railway_control.signals
+        FOR EACH ROW EXECUTE FUNCTION railway_control.bump_row_version())",
+
+        R"(CREATE TRIGGER trg_point_machines_version
+        BEFORE UPDATE ON railway_control.point_machines
+        FOR EACH ROW EXECUTE FUNCTION railway_control.bump_row_version())",
+
+        R"(CREATE TRIGGER trg_route_assignments_version
+        BEFORE UPDATE ON railway_control.route_assignments
+        FOR EACH ROW EXECUTE FUNCTION railway_control.bump_row_version())",
+
         // Audit triggers
         R"(CREATE TRIGGER trg_track_circuits_audit
         AFTER INSERT OR UPDATE OR DELETE ON railway_control.track_circuits
@@ -1569,7 +2206,12 @@ bool DatabaseInitializer::createTriggers() {
 
         R"(CREATE TRIGGER trg_point_machines_audit
         AFTER INSERT OR UPDATE OR DELETE ON railway_control.point_machines
-        FOR EACH ROW EXECUTE FUNCTION railway_audit.log_changes())"
+        FOR EACH ROW EXECUTE FUNCTION railway_audit.log_changes())",
+
+        // Route resource junctions (deletes cascade through the foreign keys)
+        R"(CREATE TRIGGER trg_route_assignments_sync_resources
+        AFTER INSERT OR UPDATE ON railway_control.route_assignments
+        FOR EACH ROW EXECUTE FUNCTION railway_control.sync_route_resources())"
     };
 
     for (const QString& query : triggers) {
@@ -1658,11 +2300,13 @@ bool DatabaseInitializer::createViews() {
         FROM railway_control.track_segments ts
         LEFT JOIN railway_control.track_circuits tc ON ts.circuit_id = tc.circuit_id
         -- REMOVED resource_locks JOIN entirely
-        -- Direct join to route_assignments if circuit is in an active route
-        LEFT JOIN railway_control.route_assignments ra ON (
-            tc.circuit_id = ANY(ra.assigned_circuits)
-            AND ra.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
-        ))",
+        -- Route context through the indexed route_circuits junction
+        LEFT JOIN railway_control.route_circuits rc ON (
+            rc.circuit_id = tc.circuit_id
+            AND NOT rc.is_overlap
+            AND rc.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
+        )
+        LEFT JOIN railway_control.route_assignments ra ON ra.id = rc.route_id)",
 
         // Simplified track segment occupancy summary (REMOVED resource_locks metrics)
         R"(CREATE OR REPLACE VIEW railway_control.v_track_segment_occupancy AS
@@ -1694,11 +2338,13 @@ bool DatabaseInitializer::createViews() {
         FROM railway_control.track_segments ts
         LEFT JOIN railway_control.track_circuits tc ON ts.circuit_id = tc.circuit_id
         -- REMOVED resource_locks JOIN entirely
-        -- Direct join to route_assignments if circuit is in an active route
-        LEFT JOIN railway_control.route_assignments ra ON (
-            tc.circuit_id = ANY(ra.assigned_circuits)
-            AND ra.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
+        -- Route context through the indexed route_circuits junction
+        LEFT JOIN railway_control.route_circuits rc ON (
+            rc.circuit_id = tc.circuit_id
+            AND NOT rc.is_overlap
+            AND rc.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
         )
+        LEFT JOIN railway_control.route_assignments ra ON ra.id = rc.route_id
         WHERE ts.is_active = TRUE)",
 
         // Complete signal information - THIS ONE WAS ALREADY OK (no resource_locks references)
@@ -1834,11 +2480,12 @@ bool DatabaseInitializer::createViews() {
         LEFT JOIN railway_control.point_machines paired_pm ON pm.paired_entity = paired_pm.machine_id
         LEFT JOIN railway_config.point_positions paired_pp ON paired_pm.current_position_id = paired_pp.id
 
-        -- Route assignment information (direct join, no resource_locks bridge)
-        LEFT JOIN railway_control.route_assignments ra ON (
-            pm.machine_id = ANY(ra.locked_point_machines)
-            AND ra.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
-        ))",
+        -- Route assignment information through the indexed route_point_locks junction
+        LEFT JOIN railway_control.route_point_locks rpl ON (
+            rpl.machine_id = pm.machine_id
+            AND rpl.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
+        )
+        LEFT JOIN railway_control.route_assignments ra ON ra.id = rpl.route_id)",
 
         // Active routes summary (KEEP - this one was fine)
         R"(CREATE OR REPLACE VIEW railway_control.v_active_routes_summary AS
@@ -1999,6 +2646,8 @@ bool DatabaseInitializer::populateInitialData() {
 bool DatabaseInitializer::populateConfigurationData() {
     qDebug() << "Populating configuration data with route assignment integration...";
 
+    //   ORDER MATTERS: Rows must land on their ConfigLookup index (see ConfigLookup.h)
+
     // Insert signal types with route assignment enhancements
     int starterTypeId = insertSignalType("STARTER", "Starter Signal", 3, true, 200);
     int homeTypeId = insertSignalType("HOME", "Home Signal", 3, true, 300);
@@ -2023,6 +2672,12 @@ bool DatabaseInitializer::populateConfigurationData() {
     insertPointPosition("NORMAL", "Normal Position", 1.0, 3000);
     insertPointPosition("REVERSE", "Reverse Position", 1.2, 3000);
 
+    QString mismatch;
+    if (!ConfigLookup::verify(db, &mismatch)) {
+        setError("Configuration ids do not match lookup tables: " + mismatch);
+        return false;
+    }
+
     return true;
 }
 
@@ -2038,6 +2693,8 @@ bool DatabaseInitializer::validateDatabase() {
         "SELECT COUNT(*) FROM railway_control.signals",
         "SELECT COUNT(*) FROM railway_control.point_machines",
         "SELECT COUNT(*) FROM railway_control.route_assignments",  // Keep this
+        "SELECT COUNT(*) FROM railway_control.route_circuits",
+        "SELECT COUNT(*) FROM railway_control.route_point_locks",
         "SELECT COUNT(*) FROM railway_config.signal_types",
         "SELECT COUNT(*) FROM railway_config.signal_aspects",
         "SELECT COUNT(*) FROM railway_config.point_positions",
@@ -2236,8 +2893,6 @@ QVariantMap DatabaseInitializer::getDatabaseStatus() {
 bool DatabaseInitializer::populateTrackCircuits() {
     qDebug() << "Populating track circuits with locking support...";
 
-    QJsonArray circuitData = getTrackCircuitMappings();
-
     //   UPDATED: Include is_assigned and is_overlap columns for resource locking
     QString insertQuery = R"(
         INSERT INTO railway_control.track_circuits
@@ -2247,25 +2902,9 @@ bool DatabaseInitializer::populateTrackCircuits() {
         ON CONFLICT (circuit_id) DO NOTHING
     )";
 
-    for (const auto& value : circuitData) {
-        QJsonObject circuit = value.toObject();
-
-        // Convert JSON array to PostgreSQL TEXT[] format
-        QJsonArray protectingSignalsArray = circuit["protecting_signals"].toArray();
-        QStringList protectingSignalsList;
-        for (const auto& signal : protectingSignalsArray) {
-            protectingSignalsList.append(signal.toString());
-        }
-
-        QString protectingSignalsStr;
-        if (protectingSignalsList.isEmpty()) {
-            protectingSignalsStr = "{}";
-        } else {
-            protectingSignalsStr = "{" + protectingSignalsList.join(",") + "}";
-        }
-
+    for (const TrackCircuitDef& circuit : Generated::TRACK_CIRCUITS) {
         // Simplified parameters - no location, type, weights, etc.
-        QString circuitId = circuit["circuit_id"].toString();
+        QString circuitId = toQString(circuit.id);
         double lengthMeters = 100.0; // Default length
         int maxSpeedKmh = 80; // Default speed
 
@@ -2276,13 +2915,12 @@ bool DatabaseInitializer::populateTrackCircuits() {
             maxSpeedKmh = 100; // Approach blocks
         }
 
-        //   UPDATED: Include assigned and overlap parameters from JSON data
         QVariantList params = {
-            circuit["circuit_id"].toString(),
-            circuit["circuit_name"].toString(),
-            circuit["assigned"].toBool(),  //   NEW: is_assigned from data
-            circuit["overlap"].toBool(),   //   NEW: is_overlap from data
-            protectingSignalsStr,
+            circuitId,
+            toQString(circuit.name),
+            circuit.assigned,
+            circuit.overlap,
+            toPgArrayLiteral(circuit.protectingSignals),
             lengthMeters,
             maxSpeedKmh
         };
@@ -2292,15 +2930,13 @@ bool DatabaseInitializer::populateTrackCircuits() {
         }
     }
 
-    qDebug() << "  Populated" << circuitData.size() << "track circuits with locking support (all unlocked)";
+    qDebug() << "  Populated" << Generated::TRACK_CIRCUITS.size() << "track circuits with locking support (all unlocked)";
     return true;
 }
 
 bool DatabaseInitializer::populateTrackSegments() {
     qDebug() << "Populating track segments with locking support...";
 
-    QJsonArray trackSegmentData = getTrackSegmentsData();
-
     //   UPDATED: Include is_overlap column for resource locking
     QString insertQuery = R"(
         INSERT INTO railway_control.track_segments
@@ -2309,39 +2945,20 @@ bool DatabaseInitializer::populateTrackSegments() {
         ON CONFLICT (segment_id) DO NOTHING
     )";
 
-    for (const auto& trackSegmentValue : trackSegmentData) {
-        QJsonObject trackSegment = trackSegmentValue.toObject();
-
-        // Handle INVALID circuit_id by setting to NULL
-        QString circuitId = trackSegment["circuit_id"].toString();
-        QVariant circuitIdValue = (circuitId == "INVALID") ? QVariant() : QVariant(circuitId);
+    for (const TrackSegmentDef& trackSegment : Generated::TRACK_SEGMENTS) {
+        // Segments outside any circuit are stored with a NULL circuit_id
+        QVariant circuitIdValue = trackSegment.circuitId.empty() ? QVariant() : QVariant(toQString(trackSegment.circuitId));
 
-        // Convert JSON array to PostgreSQL TEXT[] format
-        QJsonArray protectingSignalsArray = trackSegment["protecting_signals"].toArray();
-        QStringList protectingSignalsList;
-        for (const auto& signal : protectingSignalsArray) {
-            protectingSignalsList.append(signal.toString());
-        }
-
-        // Create PostgreSQL array string {signal1,signal2,signal3}
-        QString protectingSignalsStr;
-        if (protectingSignalsList.isEmpty()) {
-            protectingSignalsStr = "{}";
-        } else {
-            protectingSignalsStr = "{" + protectingSignalsList.join(",") + "}";
-        }
-
-        //   UPDATED: Include overlap parameter
         QVariantList params = {
-            trackSegment["id"].toString(),
-            trackSegment["startRow"].toDouble(),
-            trackSegment["startCol"].toDouble(),
-            trackSegment["endRow"].toDouble(),
-            trackSegment["endCol"].toDouble(),
+            toQString(trackSegment.id),
+            trackSegment.startRow,
+            trackSegment.startCol,
+            trackSegment.endRow,
+            trackSegment.endCol,
             circuitIdValue,
-            trackSegment["assigned"].toBool(),
-            trackSegment["overlap"].toBool(),  //   NEW: is_overlap column
-            protectingSignalsStr
+            trackSegment.assigned,
+            trackSegment.overlap,
+            toPgArrayLiteral(trackSegment.protectingSignals)
         };
 
         if (!executeQuery(insertQuery, params)) {
@@ -2349,81 +2966,28 @@ bool DatabaseInitializer::populateTrackSegments() {
         }
     }
 
-    qDebug() << "  Populated" << trackSegmentData.size() << "track segments with locking support";
+    qDebug() << "  Populated" << Generated::TRACK_SEGMENTS.size() << "track segments with locking support";
     return true;
 }
 
 bool DatabaseInitializer::populateSignals() {
     qDebug() << "Populating signals with route assignment integration and explicit locking status...";
 
-    // Combine all signal types
-    QJsonArray allSignals;
-    QJsonArray outerSignals = getOuterSignalsData();
-    QJsonArray homeSignals = getHomeSignalsData();
-    QJsonArray starterSignals = getStarterSignalsData();
-    QJsonArray advancedSignals = getAdvancedStarterSignalsData();
-
-    // Merge all signal arrays
-    for (const auto& signal : outerSignals) allSignals.append(signal);
-    for (const auto& signal : homeSignals) allSignals.append(signal);
-    for (const auto& signal : starterSignals) allSignals.append(signal);
-    for (const auto& signal : advancedSignals) allSignals.append(signal);
-
-    for (const auto& signalValue : allSignals) {
-        QJsonObject signal = signalValue.toObject();
-        QString signalType = signal["type"].toString();
-
-        // Get signal type ID
-        QSqlQuery typeQuery(db);
-        typeQuery.prepare("SELECT id FROM railway_config.signal_types WHERE type_code = ?");
-        typeQuery.addBindValue(signalType);
-
-        if (!typeQuery.exec() || !typeQuery.next()) {
+    for (const SignalDef& signal : Generated::SIGNALS) {
+        QString signalType = toQString(signal.type);
+
+        // Config ids are array indices (ConfigLookup), no per-row lookups
+        const int typeId = ConfigLookup::signalTypeId(signalType);
+        if (typeId == ConfigLookup::NOT_FOUND) {
             setError(QString("Signal type not found: %1").arg(signalType));
             return false;
         }
-        int typeId = typeQuery.value(0).toInt();
 
-        // Get main signal aspect ID
-        QString currentAspect = signal["currentAspect"].toString();
-        QSqlQuery aspectQuery(db);
-        aspectQuery.prepare("SELECT id FROM railway_config.signal_aspects WHERE aspect_code = ?");
-        aspectQuery.addBindValue(currentAspect);
+        int aspectId = ConfigLookup::aspectId(toQString(signal.currentAspect));
+        if (aspectId == ConfigLookup::NOT_FOUND) aspectId = static_cast<int>(AspectCode::RED);
 
-        int aspectId = 1; // Default to RED
-        if (aspectQuery.exec() && aspectQuery.next()) {
-            aspectId = aspectQuery.value(0).toInt();
-        }
-
-        // Get calling-on aspect ID
-        QString callingOnAspectStr = signal["callingOnAspect"].toString("OFF");
-        int callingOnAspectId = getAspectIdByCode(callingOnAspectStr);
-
-        // Get loop aspect ID
-        QString loopAspectStr = signal["loopAspect"].toString("OFF");
-        int loopAspectId = getAspectIdByCode(loopAspectStr);
-
-        // Convert possible aspects array to PostgreSQL array format
-        QJsonArray possibleAspects = signal["possibleAspects"].toArray();
-        QStringList aspectsList;
-        for (const auto& aspect : possibleAspects) {
-            aspectsList << aspect.toString();
-        }
-        QString aspectsArrayStr = "{" + aspectsList.join(",") + "}";
-
-        // Convert protected track circuits array to PostgreSQL TEXT[]
-        QJsonArray protectedCircuitsArray = signal["protectedTrackCircuits"].toArray();
-        QStringList protectedCircuitsList;
-        for (const auto& circuit : protectedCircuitsArray) {
-            protectedCircuitsList.append(circuit.toString());
-        }
-
-        QString protectedCircuitsStr;
-        if (protectedCircuitsList.isEmpty()) {
-            protectedCircuitsStr = "{}";
-        } else {
-            protectedCircuitsStr = "{" + protectedCircuitsList.join(",") + "}";
-        }
+        int callingOnAspectId = subsidiaryAspectId(toQString(signal.callingOnAspect));
+        int loopAspectId = subsidiaryAspectId(toQString(signal.loopAspect));
 
         // Determine route signal properties
         bool isRouteSignal = (signalType == "HOME" || signalType == "STARTER" || signalType == "ADVANCED_STARTER");
@@ -2446,21 +3010,21 @@ bool DatabaseInitializer::populateSignals() {
         )";
 
         QVariantList params = {
-            signal["id"].toString(),
-            signal["name"].toString(),
+            toQString(signal.id),
+            toQString(signal.name),
             typeId,
-            signal["row"].toDouble(),
-            signal["col"].toDouble(),
-            signal["direction"].toString(),
+            signal.row,
+            signal.col,
+            toQString(signal.direction),
             aspectId,
             callingOnAspectId,
             loopAspectId,
-            signal["loopSignalConfiguration"].toString("UR"),
-            signal["aspectCount"].toInt(2),
-            aspectsArrayStr,
-            protectedCircuitsStr,
-            signal["isActive"].toBool(true),
-            signal["location"].toString(),
+            toQString(signal.loopSignalConfiguration),
+            signal.aspectCount,
+            toPgArrayLiteral(signal.possibleAspects),
+            toPgArrayLiteral(signal.protectedTrackCircuits),
+            signal.isActive,
+            toQString(signal.location),
             isRouteSignal,
             routeSignalType.isEmpty() ? QVariant() : routeSignalType,
             180 // Default overlap distance
@@ -2472,50 +3036,21 @@ bool DatabaseInitializer::populateSignals() {
         }
     }
 
-    qDebug() << "  Populated" << allSignals.size() << "signals with route assignment properties and explicit locking status (all unlocked)";
+    qDebug() << "  Populated" << Generated::SIGNALS.size() << "signals with route assignment properties and explicit locking status (all unlocked)";
     return true;
 }
 
 bool DatabaseInitializer::populatePointMachines() {
     qDebug() << "Populating point machines with route assignment integration and explicit locking status...";
 
-    QJsonArray pointsData = getPointMachinesData();
-
-    for (const auto& pointValue : pointsData) {
-        QJsonObject point = pointValue.toObject();
-
-        // Get position ID
-        QString currentPosition = point["position"].toString();
-        QSqlQuery positionQuery(db);
-        positionQuery.prepare("SELECT id FROM railway_config.point_positions WHERE position_code = ?");
-        positionQuery.addBindValue(currentPosition);
-
-        int positionId = 1; // Default to NORMAL
-        if (positionQuery.exec() && positionQuery.next()) {
-            positionId = positionQuery.value(0).toInt();
-        }
-
-        // Convert track connections to properly formatted JSON strings
-        QJsonObject rootTrackSegment = point["rootTrackSegment"].toObject();
-        QJsonObject normalTrackSegment = point["normalTrackSegment"].toObject();
-        QJsonObject reverseTrackSegment = point["reverseTrackSegment"].toObject();
-
-        QString rootTrackSegmentJson = QString::fromUtf8(QJsonDocument(rootTrackSegment).toJson(QJsonDocument::Compact));
-        QString normalTrackSegmentJson = QString::fromUtf8(QJsonDocument(normalTrackSegment).toJson(QJsonDocument::Compact));
-        QString reverseTrackSegmentJson = QString::fromUtf8(QJsonDocument(reverseTrackSegment).toJson(QJsonDocument::Compact));
-
-        // Handle paired entity (can be null)
-        QString pairedEntity;
-        if (point.contains("pairedEntity") && !point["pairedEntity"].toString().isEmpty()) {
-            pairedEntity = point["pairedEntity"].toString();
-        }
+    for (const PointMachineDef& point : Generated::POINT_MACHINES) {
+        int positionId = ConfigLookup::positionId(toQString(point.position));
+        if (positionId == ConfigLookup::NOT_FOUND) positionId = ConfigLookup::positionId("NORMAL");
 
-        // Handle host track circuit (can be null for paired entities)
-        QString hostTrackCircuit;
-        if (point.contains("hostTrackCircuit") && !point["hostTrackCircuit"].toString().isEmpty()) {
-            hostTrackCircuit = point["hostTrackCircuit"].toString();
-            qDebug() << "    Point machine" << point["id"].toString()
-                     << "assigned to host circuit:" << hostTrackCircuit;
+        // Host track circuit is empty for the secondary half of a paired machine
+        if (!point.hostTrackCircuit.empty()) {
+            qDebug() << "    Point machine" << toQString(point.id)
+                     << "assigned to host circuit:" << toQString(point.hostTrackCircuit);
         }
 
         //   UPDATED: Explicitly include is_locked column for safety
@@ -2529,32 +3064,28 @@ bool DatabaseInitializer::populatePointMachines() {
         )";
 
         QVariantList params = {
-            point["id"].toString(),
-            point["name"].toString(),
-            point["junctionPoint"].toObject()["row"].toDouble(),
-            point["junctionPoint"].toObject()["col"].toDouble(),
-            rootTrackSegmentJson,
-            normalTrackSegmentJson,
-            reverseTrackSegmentJson,
+            toQString(point.id),
+            toQString(point.name),
+            point.junctionRow,
+            point.junctionCol,
+            toQString(point.root.json),
+            toQString(point.normal.json),
+            toQString(point.reverse.json),
             positionId,
-            point["operatingStatus"].toString("CONNECTED"),
+            toQString(point.operatingStatus),
             3000, // Default transition time
-            pairedEntity.isEmpty() ? QVariant() : pairedEntity,
-            hostTrackCircuit.isEmpty() ? QVariant() : hostTrackCircuit
+            point.pairedEntity.empty() ? QVariant() : QVariant(toQString(point.pairedEntity)),
+            point.hostTrackCircuit.empty() ? QVariant() : QVariant(toQString(point.hostTrackCircuit))
             //   NOTE: is_locked = FALSE is now explicitly set in the VALUES clause
         };
 
         if (!executeQuery(insertQuery, params)) {
-            setError(QString("Failed to insert point machine: %1").arg(point["id"].toString()));
+            setError(QString("Failed to insert point machine: %1").arg(toQString(point.id)));
             return false;
         }
     }
 
-    qDebug() << "  Populated" << pointsData.size() << "point machines with explicit locking status (all unlocked)";
-    qDebug() << "  PM001 → W22T (primary, unlocked)";
-    qDebug() << "  PM004 → W21T (primary, unlocked)";
-    qDebug() << "  PM002, PM003 → No host circuit (paired entities, unlocked)";
-
+    qDebug() << "  Populated" << Generated::POINT_MACHINES.size() << "point machines with explicit locking status (all unlocked)";
     return true;
 }
 
@@ -2562,22 +3093,18 @@ bool DatabaseInitializer::populatePointMachines() {
 bool DatabaseInitializer::populateTextLabels() {
     qDebug() << "Populating text labels...";
 
-    QJsonArray labelsData = getTextLabelsData();
-
     QString insertQuery = R"(
         INSERT INTO railway_control.text_labels
         (label_text, position_row, position_col, font_size)
         VALUES (?, ?, ?, ?)
     )";
 
-    for (const auto& labelValue : labelsData) {
-        QJsonObject label = labelValue.toObject();
-
+    for (const TextLabelDef& label : Generated::TEXT_LABELS) {
         QVariantList params = {
-            label["text"].toString(),
-            label["row"].toDouble(),
-            label["col"].toDouble(),
-            label["fontSize"].toInt(12)
+            toQString(label.text),
+            label.row,
+            label.col,
+            label.fontSize
         };
 
         if (!executeQuery(insertQuery, params)) {
@@ -2585,15 +3112,13 @@ bool DatabaseInitializer::populateTextLabels() {
         }
     }
 
-    qDebug() << "  Populated" << labelsData.size() << "text labels";
+    qDebug() << "  Populated" << Generated::TEXT_LABELS.size() << "text labels";
     return true;
 }
 
 bool DatabaseInitializer::populateInterlockingRules() {
     qDebug() << "Populating interlocking rules...";
 
-    QJsonArray rulesData = getInterlockingRulesData();
-
     QString insertQuery = R"(
         INSERT INTO railway_control.interlocking_rules (
             rule_name, source_entity_type, source_entity_id,
@@ -2603,18 +3128,16 @@ bool DatabaseInitializer::populateInterlockingRules() {
         ON CONFLICT DO NOTHING
     )";
 
-    for (const auto& value : rulesData) {
-        QJsonObject rule = value.toObject();
-
+    for (const InterlockingRuleDef& rule : Generated::INTERLOCKING_RULES) {
         QVariantList params = {
-            rule["rule_name"].toString(),
-            rule["source_entity_type"].toString(),
-            rule["source_entity_id"].toString(),
-            rule["target_entity_type"].toString(),
-            rule["target_entity_id"].toString(),
-            rule["target_constraint"].toString(),
-            rule["rule_type"].toString(),
-            rule["priority"].toInt()
+            toQString(rule.name),
+            toQString(rule.sourceEntityType),
+            toQString(rule.sourceEntityId),
+            toQString(rule.targetEntityType),
+            toQString(rule.targetEntityId),
+            toQString(rule.targetConstraint),
+            toQString(rule.ruleType),
+            rule.priority
         };
 
         if (!executeQuery(insertQuery, params)) {
@@ -2622,278 +3145,23 @@ bool DatabaseInitializer::populateInterlockingRules() {
         }
     }
 
-    qDebug() << "  Populated" << rulesData.size() << "interlocking rules";
+    qDebug() << "  Populated" << Generated::INTERLOCKING_RULES.size() << "interlocking rules";
     return true;
 }
-// 
-// DATA GETTER METHODS
-// 
-
-QJsonArray DatabaseInitializer::getInterlockingRulesData() {
-    return QJsonArray {
-        // PROTECTION RULES
-        QJsonObject{{"rule_name", "Signal AS002 protects Circuit A42T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "AS002"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "A42T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal OT001 protects Circuit 6T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "OT001"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "6T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal AS002 protects Circuit 6T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "AS002"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "6T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal OT001 protects Circuit 5T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "OT001"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "5T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal ST003 protects Circuit 5T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "ST003"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "5T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal HM001 protects Circuit W22T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "HM001"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "W22T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal ST003 protects Circuit W22T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "ST003"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "W22T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal ST004 protects Circuit W22T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "ST004"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "W22T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal HM001 protects Circuit 3T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "HM001"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "3T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal HM002 protects Circuit 3T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "HM002"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "3T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal HM002 protects Circuit W21T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "HM002"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "W21T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal ST001 protects Circuit W21T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "ST001"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "W21T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal ST002 protects Circuit W21T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "ST002"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "W21T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal OT002 protects Circuit 2T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "OT002"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "2T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal ST001 protects Circuit 2T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "ST001"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "2T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal OT002 protects Circuit 1T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "OT002"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "1T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal AS001 protects Circuit 1T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "AS001"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "1T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-        QJsonObject{{"rule_name", "Signal AS001 protects Circuit A1T"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "AS001"}, {"target_entity_type", "TRACK_CIRCUIT"}, {"target_entity_id", "A1T"}, {"target_constraint", "MUST_BE_CLEAR"}, {"rule_type", "PROTECTING"}, {"priority", 900}},
-
-        // OPPOSING RULES
-        QJsonObject{{"rule_name", "Opposing Signals HM001-HM002"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "HM001"}, {"target_entity_type", "SIGNAL"}, {"target_entity_id", "HM002"}, {"target_constraint", "MUST_BE_RED"}, {"rule_type", "OPPOSING"}, {"priority", 1000}},
-        QJsonObject{{"rule_name", "Opposing Signals HM002-HM001"}, {"source_entity_type", "SIGNAL"}, {"source_entity_id", "HM002"}, {"target_entity_type", "SIGNAL"}, {"target_entity_id", "HM001"}, {"target_constraint", "MUST_BE_RED"}, {"rule_type", "OPPOSING"}, {"priority", 1000}}
-    };
-}
-
-QJsonArray DatabaseInitializer::getTrackSegmentsData() {
-    return QJsonArray {
-        QJsonObject{{"id", "T1S1"}, {"startRow", 110}, {"startCol", 0}, {"endRow", 110}, {"endCol", 12}, {"circuit_id", "INVALID"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{}}},
-        QJsonObject{{"id", "T1S2"}, {"startRow", 110}, {"startCol", 13}, {"endRow", 110}, {"endCol", 34}, {"circuit_id", "A42T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"AS002"}}},
-        QJsonObject{{"id", "T1S3"}, {"startRow", 110}, {"startCol", 35}, {"endRow", 110}, {"endCol", 67}, {"circuit_id", "6T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"OT001", "AS002"}}},
-        QJsonObject{{"id", "T1S4"}, {"startRow", 110}, {"startCol", 68}, {"endRow", 110}, {"endCol", 90}, {"circuit_id", "5T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"OT001", "ST003"}}},
-        QJsonObject{{"id", "T1S5"}, {"startRow", 110}, {"startCol", 91}, {"endRow", 110}, {"endCol", 117}, {"circuit_id", "W22T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"HM001", "ST003", "ST004"}}},
-        QJsonObject{{"id", "T1S6"}, {"startRow", 110}, {"startCol", 128}, {"endRow", 110}, {"endCol", 158}, {"circuit_id", "W22T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"HM001", "ST003", "ST004"}}},
-        QJsonObject{{"id", "T1S7"}, {"startRow", 110}, {"startCol", 159}, {"endRow", 110}, {"endCol", 221}, {"circuit_id", "3T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{}}},
-        QJsonObject{{"id", "T1S8"}, {"startRow", 110}, {"startCol", 222}, {"endRow", 110}, {"endCol", 254}, {"circuit_id", "W21T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"HM002", "ST001", "ST002"}}},
-        QJsonObject{{"id", "T1S9"}, {"startRow", 110}, {"startCol", 264}, {"endRow", 110}, {"endCol", 286}, {"circuit_id", "W21T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"HM002", "ST001", "ST002"}}},
-        QJsonObject{{"id", "T1S10"}, {"startRow", 110}, {"startCol", 287}, {"endRow", 110}, {"endCol", 305}, {"circuit_id", "2T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"OT002", "ST001"}}},
-        QJsonObject{{"id", "T1S11"}, {"startRow", 110}, {"startCol", 306}, {"endRow", 110}, {"endCol", 338}, {"circuit_id", "1T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"OT002", "AS001"}}},
-        QJsonObject{{"id", "T1S12"}, {"startRow", 110}, {"startCol", 339}, {"endRow", 110}, {"endCol", 358}, {"circuit_id", "A1T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"AS001"}}},
-        QJsonObject{{"id", "T1S13"}, {"startRow", 110}, {"startCol", 359}, {"endRow", 110}, {"endCol", 369}, {"circuit_id", "INVALID"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{}}},
-        QJsonObject{{"id", "T4S1"}, {"startRow", 88}, {"startCol", 125}, {"endRow", 88}, {"endCol", 137}, {"circuit_id", "W22T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"HM001", "ST003", "ST004"}}},
-        QJsonObject{{"id", "T4S2"}, {"startRow", 88}, {"startCol", 147}, {"endRow", 88}, {"endCol", 153}, {"circuit_id", "W22T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"HM001", "ST003", "ST004"}}},
-        QJsonObject{{"id", "T4S3"}, {"startRow", 88}, {"startCol", 154}, {"endRow", 88}, {"endCol", 226}, {"circuit_id", "4T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{}}},
-        QJsonObject{{"id", "T4S4"}, {"startRow", 88}, {"startCol", 227}, {"endRow", 88}, {"endCol", 232}, {"circuit_id", "W21T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"HM002", "ST001", "ST002"}}},
-        QJsonObject{{"id", "T4S5"}, {"startRow", 88}, {"startCol", 242}, {"endRow", 88}, {"endCol", 258}, {"circuit_id", "W21T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"HM002", "ST001", "ST002"}}},
-        QJsonObject{{"id", "T5S1"}, {"startRow", 106}, {"startCol", 125}, {"endRow", 92}, {"endCol", 139}, {"circuit_id", "W22T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"HM001", "ST003", "ST004"}}},
-        QJsonObject{{"id", "T6S1"}, {"startRow", 92}, {"startCol", 240}, {"endRow", 105}, {"endCol", 254}, {"circuit_id", "W21T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"HM002", "ST001", "ST002"}}}
-    };
-}
-
-QJsonArray DatabaseInitializer::getTrackCircuitMappings() {
-    return QJsonArray {
-        QJsonObject{{"circuit_id", "A42T"}, {"circuit_name", "Approach Block A42T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"AS002"}}},
-        QJsonObject{{"circuit_id", "6T"}, {"circuit_name", "Main Line Section 6T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"OT001", "AS002"}}},
-        QJsonObject{{"circuit_id", "5T"}, {"circuit_name", "Main Line Section 5T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"OT001", "ST003"}}},
-        QJsonObject{{"circuit_id", "W22T"}, {"circuit_name", "Junction W22T Circuit"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"HM001", "ST003", "ST004"}}},
-        QJsonObject{{"circuit_id", "3T"}, {"circuit_name", "Platform Section 3T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"HM001", "HM002"}}},
-        QJsonObject{{"circuit_id", "W21T"}, {"circuit_name", "Junction W21T Circuit"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"HM002", "ST001", "ST002"}}},
-        QJsonObject{{"circuit_id", "2T"}, {"circuit_name", "Main Line Section 2T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"OT002", "ST001"}}},
-        QJsonObject{{"circuit_id", "1T"}, {"circuit_name", "Main Line Section 1T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"OT002", "AS001"}}},
-        QJsonObject{{"circuit_id", "A1T"}, {"circuit_name", "Exit Block A1T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{"AS001"}}},
-        QJsonObject{{"circuit_id", "4T"}, {"circuit_name", "Loop Section 4T"}, {"assigned", false}, {"overlap", false}, {"protecting_signals", QJsonArray{}}}
-    };
-}
-
-QJsonArray DatabaseInitializer::getOuterSignalsData() {
-    return QJsonArray {
-        QJsonObject{
-            {"id", "OT001"}, {"name", "Outer A1"}, {"type", "OUTER"},
-            {"row", 102}, {"col", 30}, {"direction", "UP"},
-            {"currentAspect", "RED"}, {"aspectCount", 4},
-            {"possibleAspects", QJsonArray{"RED", "SINGLE_YELLOW", "DOUBLE_YELLOW", "GREEN"}},
-            {"protectedTrackCircuits", QJsonArray{"6T", "5T"}},
-            {"isActive", true}, {"location", "Approach_Block_1"}
-        },
-        QJsonObject{
-            {"id", "OT002"}, {"name", "Outer A2"}, {"type", "OUTER"},
-            {"row", 113}, {"col", 330}, {"direction", "DOWN"},
-            {"currentAspect", "RED"}, {"aspectCount", 4},
-            {"possibleAspects", QJsonArray{"RED", "SINGLE_YELLOW", "DOUBLE_YELLOW", "GREEN"}},
-            {"protectedTrackCircuits", QJsonArray{"2T", "1T"}},
-            {"isActive", true}, {"location", "Approach_Block_2"}
-        }
-    };
-}
-
-QJsonArray DatabaseInitializer::getHomeSignalsData() {
-    return QJsonArray {
-        QJsonObject{
-            {"id", "HM001"}, {"name", "Home A1"}, {"type", "HOME"},
-            {"row", 102}, {"col", 84}, {"direction", "UP"},
-            {"currentAspect", "RED"}, {"aspectCount", 3},
-            {"possibleAspects", QJsonArray{"RED", "YELLOW", "GREEN"}},
-            {"callingOnAspect", "WHITE"}, {"loopAspect", "YELLOW"}, {"loopSignalConfiguration", "UR"},
-            {"protectedTrackCircuits", QJsonArray{"W22T", "3T"}},
-            {"isActive", true}, {"location", "Platform_A_Entry"}
-        },
-        QJsonObject{
-            {"id", "HM002"}, {"name", "Home A2"}, {"type", "HOME"},
-            {"row", 113}, {"col", 275}, {"direction", "DOWN"},
-            {"currentAspect", "RED"}, {"aspectCount", 3},
-            {"possibleAspects", QJsonArray{"RED", "YELLOW", "GREEN"}},
-            {"callingOnAspect", "OFF"}, {"loopAspect", "OFF"}, {"loopSignalConfiguration", "UR"},
-            {"protectedTrackCircuits", QJsonArray{"W21T", "3T"}},
-            {"isActive", true}, {"location", "Platform_A_Exit"}
-        }
-    };
-}
-
-QJsonArray DatabaseInitializer::getStarterSignalsData() {
-    return QJsonArray {
-        QJsonObject{
-            {"id", "ST001"}, {"name", "Starter A1"}, {"type", "STARTER"},
-            {"row", 103}, {"col", 217}, {"direction", "UP"},
-            {"currentAspect", "RED"}, {"aspectCount", 3},
-            {"possibleAspects", QJsonArray{"RED", "YELLOW", "GREEN"}},
-            {"protectedTrackCircuits", QJsonArray{"W21T", "2T"}},
-            {"isActive", true}, {"location", "Platform_A_Main_Departure"}
-        },
-        QJsonObject{
-            {"id", "ST002"}, {"name", "Starter A2"}, {"type", "STARTER"},
-            {"row", 83}, {"col", 220}, {"direction", "UP"},
-            {"currentAspect", "RED"}, {"aspectCount", 2},
-            {"possibleAspects", QJsonArray{"RED", "YELLOW"}},
-            {"protectedTrackCircuits", QJsonArray{"W21T"}},
-            {"isActive", true}, {"location", "Platform_A_Departure"}
-        },
-        QJsonObject{
-            {"id", "ST003"}, {"name", "Starter B1"}, {"type", "STARTER"},
-            {"row", 115}, {"col", 152}, {"direction", "DOWN"},
-            {"currentAspect", "RED"}, {"aspectCount", 3},
-            {"possibleAspects", QJsonArray{"RED", "YELLOW", "GREEN"}},
-            {"protectedTrackCircuits", QJsonArray{"5T", "W22T"}},
-            {"isActive", true}, {"location", "Platform_A_Main_Departure"}
-        },
-        QJsonObject{
-            {"id", "ST004"}, {"name", "Starter B2"}, {"type", "STARTER"},
-            {"row", 91}, {"col", 150}, {"direction", "DOWN"},
-            {"currentAspect", "RED"}, {"aspectCount", 2},
-            {"possibleAspects", QJsonArray{"RED", "YELLOW"}},
-            {"protectedTrackCircuits", QJsonArray{"W22T"}},
-            {"isActive", true}, {"location", "Junction_Loop_Entry"}
-        }
-    };
-}
-
-QJsonArray DatabaseInitializer::getAdvancedStarterSignalsData() {
-    return QJsonArray {
-        QJsonObject{
-            {"id", "AS001"}, {"name", "Advanced Starter A1"}, {"type", "ADVANCED_STARTER"},
-            {"row", 102}, {"col", 302}, {"direction", "UP"},
-            {"currentAspect", "RED"}, {"aspectCount", 2},
-            {"possibleAspects", QJsonArray{"RED", "GREEN"}},
-            {"protectedTrackCircuits", QJsonArray{"1T", "A1T"}},
-            {"isActive", true}, {"location", "Advanced_Departure_A"}
-        },
-        QJsonObject{
-            {"id", "AS002"}, {"name", "Advanced Starter A2"}, {"type", "ADVANCED_STARTER"},
-            {"row", 113}, {"col", 56}, {"direction", "DOWN"},
-            {"currentAspect", "RED"}, {"aspectCount", 2},
-            {"possibleAspects", QJsonArray{"RED", "GREEN"}},
-            {"protectedTrackCircuits", QJsonArray{"A42T", "6T"}},
-            {"isActive", true}, {"location", "Advanced_Departure_B"}
-        }
-    };
-}
-
-QJsonArray DatabaseInitializer::getPointMachinesData() {
-    return QJsonArray {
-        QJsonObject{
-            {"id", "PM001"}, {"name", "Junction A"}, {"position", "NORMAL"}, {"operatingStatus", "CONNECTED"},
-            {"pairedEntity", "PM002"},
-            {"hostTrackCircuit", "W22T"},  //  NEW: Host track circuit
-            {"junctionPoint", QJsonObject{{"row", 110}, {"col", 121.2}}},
-            {"rootTrackSegment", QJsonObject{{"trackSegmentId", "T1S5"}, {"connectionEnd", "END"}, {"offset", QJsonObject{{"row", 0}, {"col", 0}}}}},
-            {"normalTrackSegment", QJsonObject{{"trackSegmentId", "T1S6"}, {"connectionEnd", "START"}, {"offset", QJsonObject{{"row", 0}, {"col", 0}}}}},
-            {"reverseTrackSegment", QJsonObject{{"trackSegmentId", "T5S1"}, {"connectionEnd", "START"}, {"offset", QJsonObject{{"row", 0}, {"col", 0}}}}}
-        },
-        QJsonObject{
-            {"id", "PM002"}, {"name", "Junction B"}, {"position", "NORMAL"}, {"operatingStatus", "CONNECTED"},
-            {"pairedEntity", "PM001"},
-            //  NO hostTrackCircuit - paired entity, leave empty to avoid unexpected behavior
-            {"junctionPoint", QJsonObject{{"row", 88}, {"col", 143.3}}},
-            {"rootTrackSegment", QJsonObject{{"trackSegmentId", "T4S2"}, {"connectionEnd", "START"}, {"offset", QJsonObject{{"row", 0}, {"col", 0}}}}},
-            {"normalTrackSegment", QJsonObject{{"trackSegmentId", "T4S1"}, {"connectionEnd", "END"}, {"offset", QJsonObject{{"row", 0}, {"col", 0}}}}},
-            {"reverseTrackSegment", QJsonObject{{"trackSegmentId", "T5S1"}, {"connectionEnd", "END"}, {"offset", QJsonObject{{"row", 0}, {"col", 0}}}}}
-        },
-        QJsonObject{
-            {"id", "PM003"}, {"name", "Junction C"}, {"position", "NORMAL"}, {"operatingStatus", "CONNECTED"},
-            {"pairedEntity", "PM004"},
-            //  NO hostTrackCircuit - paired entity, leave empty to avoid unexpected behavior
-            {"junctionPoint", QJsonObject{{"row", 88}, {"col", 235.6}}},
-            {"rootTrackSegment", QJsonObject{{"trackSegmentId", "T4S4"}, {"connectionEnd", "END"}, {"offset", QJsonObject{{"row", 0}, {"col", 0}}}}},
-            {"normalTrackSegment", QJsonObject{{"trackSegmentId", "T4S5"}, {"connectionEnd", "START"}, {"offset", QJsonObject{{"row", 0}, {"col", 0}}}}},
-            {"reverseTrackSegment", QJsonObject{{"trackSegmentId", "T6S1"}, {"connectionEnd", "START"}, {"offset", QJsonObject{{"row", 0}, {"col", 0}}}}}
-        },
-        QJsonObject{
-            {"id", "PM004"}, {"name", "Junction D"}, {"position", "NORMAL"}, {"operatingStatus", "CONNECTED"},
-            {"pairedEntity", "PM003"},
-            {"hostTrackCircuit", "W21T"},  //  NEW: Host track circuit
-            {"junctionPoint", QJsonObject{{"row", 110}, {"col", 259.5}}},
-            {"rootTrackSegment", QJsonObject{{"trackSegmentId", "T1S9"}, {"connectionEnd", "START"}, {"offset", QJsonObject{{"row", 0}, {"col", 0}}}}},
-            {"normalTrackSegment", QJsonObject{{"trackSegmentId", "T1S8"}, {"connectionEnd", "END"}, {"offset", QJsonObject{{"row", 0}, {"col", 0}}}}},
-            {"reverseTrackSegment", QJsonObject{{"trackSegmentId", "T6S1"}, {"connectionEnd", "END"}, {"offset", QJsonObject{{"row", 0}, {"col", 0}}}}}
-        }
-    };
-}
-
-QJsonArray DatabaseInitializer::getTextLabelsData() {
-    return QJsonArray {
-        QJsonObject{{"text", "50"}, {"row", 1}, {"col", 49}, {"fontSize", 12}},
-        QJsonObject{{"text", "100"}, {"row", 1}, {"col", 99}, {"fontSize", 12}},
-        QJsonObject{{"text", "150"}, {"row", 1}, {"col", 149}, {"fontSize", 12}},
-        QJsonObject{{"text", "200"}, {"row", 1}, {"col", 199}, {"fontSize", 12}},
-        QJsonObject{{"text", "30"}, {"row", 29}, {"col", 1}, {"fontSize", 12}},
-        QJsonObject{{"text", "90"}, {"row", 89}, {"col", 1}, {"fontSize", 12}},
-        QJsonObject{{"text", "T1S1"}, {"row", 107}, {"col", 4}, {"fontSize", 12}},
-        QJsonObject{{"text", "T1S2"}, {"row", 107}, {"col", 20}, {"fontSize", 12}},
-        QJsonObject{{"text", "T1S3"}, {"row", 107}, {"col", 48}, {"fontSize", 12}},
-        QJsonObject{{"text", "T1S4"}, {"row", 107}, {"col", 77}, {"fontSize", 12}},
-        QJsonObject{{"text", "T1S5"}, {"row", 107}, {"col", 105}, {"fontSize", 12}},
-        QJsonObject{{"text", "T1S6"}, {"row", 107}, {"col", 138}, {"fontSize", 12}},
-        QJsonObject{{"text", "T1S7"}, {"row", 107}, {"col", 188}, {"fontSize", 12}},
-        QJsonObject{{"text", "T1S8"}, {"row", 107}, {"col", 236}, {"fontSize", 12}},
-        QJsonObject{{"text", "T1S9"}, {"row", 107}, {"col", 271}, {"fontSize", 12}},
-        QJsonObject{{"text", "T1S10"}, {"row", 107}, {"col", 293}, {"fontSize", 12}},
-        QJsonObject{{"text", "T1S11"}, {"row", 107}, {"col", 318}, {"fontSize", 12}},
-        QJsonObject{{"text", "T1S12"}, {"row", 107}, {"col", 345}, {"fontSize", 12}},
-        QJsonObject{{"text", "T1S13"}, {"row", 107}, {"col", 360}, {"fontSize", 12}},
-        QJsonObject{{"text", "T4S1"}, {"row", 85}, {"col", 130}, {"fontSize", 12}},
-        QJsonObject{{"text", "T4S3"}, {"row", 85}, {"col", 188}, {"fontSize", 12}},
-        QJsonObject{{"text", "T4S5"}, {"row", 85}, {"col", 246}, {"fontSize", 12}}
-    };
-}
 
 // 
 // HELPER METHODS
 // 
 
-int DatabaseInitializer::getAspectIdByCode(const QString& aspectCode) {
-    // Hardcoded based on insertion order
-    if (aspectCode == "RED") return 1;
-    if (aspectCode == "YELLOW") return 2;
-    if (aspectCode == "GREEN") return 3;
-    if (aspectCode == "SINGLE_YELLOW") return 4;
-    if (aspectCode == "DOUBLE_YELLOW") return 5;
-    if (aspectCode == "WHITE") return 6;
-    if (aspectCode == "BLUE") return 7;
-    if (aspectCode == "OFF") return 8;
-
-    // Fallback: Query database for other aspects
-    QSqlQuery query(db);
-    query.prepare("SELECT id FROM railway_config.signal_aspects WHERE aspect_code = ?");
-    query.addBindValue(aspectCode);
-
-    if (query.exec() && query.next()) {
-        return query.value(0).toInt();
+int DatabaseInitializer::subsidiaryAspectId(const QString& aspectCode) {
+    const int aspectId = ConfigLookup::aspectId(aspectCode);
+    if (aspectId != ConfigLookup::NOT_FOUND) {
+        return aspectId;
     }
 
-    // Default: Return OFF aspect ID if not found
+    // Default: OFF for unknown subsidiary aspects
     qWarning() << " Aspect code not found:" << aspectCode << "- defaulting to OFF";
-    return 8; // OFF
+    return static_cast<int>(AspectCode::OFF);
 }
 
 // Async methods for backward compatibility
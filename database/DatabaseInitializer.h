@@ -173,28 +173,7 @@ private:
                             double pathfindingWeight, int transitionTimeMs);
 
     // Utility helpers
-    int getAspectIdByCode(const QString& aspectCode);
-
-    //
-    // DATA SOURCE METHODS
-    //
-
-    // Track infrastructure data
-    QJsonArray getTrackSegmentsData();
-    QJsonArray getTrackCircuitMappings();
-
-    // Signal data by type
-    QJsonArray getOuterSignalsData();
-    QJsonArray getHomeSignalsData();
-    QJsonArray getStarterSignalsData();
-    QJsonArray getAdvancedStarterSignalsData();
-
-    // Other infrastructure data
-    QJsonArray getPointMachinesData();
-    QJsonArray getTextLabelsData();
-
-    // Safety and interlocking data
-    QJsonArray getInterlockingRulesData();
+    int subsidiaryAspectId(const QString& aspectCode);
 
     //
     // LEGACY METHODS (for backward compatibility)
@@ -9,24 +9,67 @@
 #include <QString>
 #include <QSqlRecord>
 #include "../interlocking/InterlockingService.h"
+#include "../interlocking/InterlockingRuleEngine.h"
+#include "../interlocking/OccupancyLatencyMonitor.h"
+#include "TrackCircuitFilter.h"
+#include "StationEventBus.h"
+#include "../interlocking/PackedAspect.h"
+#include "ConfigLookup.h"
+#include "CommandJournal.h"
+#include "TelemetryWriter.h"
 
 DatabaseManager::DatabaseManager(QObject* parent)
     : QObject(parent)
-    , pollingTimer(std::make_unique<QTimer>(this))
+    , m_eventBus(std::make_unique<StationEventBus>(this))
+    , m_trackCircuitFilter(std::make_unique<TrackCircuitFilter>(this))
+    , m_telemetryWriter(std::make_unique<TelemetryWriter>())
+    , pollingTimer(std::make_unique<ClockTimer>(this))
     , connected(false)
+    , m_diagnosticVerification(qEnvironmentVariableIntValue("RAILFLUX_DB_DIAGNOSTICS") != 0)
+    , m_serverSideValidation(qEnvironmentVariableIntValue("RAILFLUX_SERVER_VALIDATION") != 0)
+    , m_commandJournalEnabled(qEnvironmentVariableIntValue("RAILFLUX_COMMAND_JOURNAL") != 0)
 {
-    connect(pollingTimer.get(), &QTimer::timeout, this, &DatabaseManager::pollDatabase);
+    connect(m_trackCircuitFilter.get(), &TrackCircuitFilter::clearConfirmed,
+            this, &DatabaseManager::onTrackCircuitClearConfirmed);
+    connect(m_trackCircuitFilter.get(), &TrackCircuitFilter::flickerStateChanged,
+            this, &DatabaseManager::trackCircuitFlickerChanged);
+    connect(m_telemetryWriter.get(), &TelemetryWriter::routeEventWritten,
+            this, &DatabaseManager::routeEventLogged);
+
+    // QML BRIDGE: One coarse NOTIFY per entity kind per batch, however many changes it holds
+    m_eventBus->subscribe("qml-bridge", [this](StationEventBus::Batch batch) {
+        bool signalsTouched = false, pointsTouched = false, segmentsTouched = false, circuitsTouched = false;
+        for (const StationEventBus::ChangeRecord& record : batch) {
+            switch (record.kind) {
+            case StationEventBus::EntityKind::Signal: signalsTouched = true; break;
+            case StationEventBus::EntityKind::PointMachine: pointsTouched = true; break;
+            case StationEventBus::EntityKind::TrackSegment: segmentsTouched = true; break;
+            case StationEventBus::EntityKind::TrackCircuit: circuitsTouched = segmentsTouched = true; break;
+            }
+        }
+
+        if (signalsTouched) emit signalsChanged();
+        if (pointsTouched) emit pointMachinesChanged();
+        if (circuitsTouched) emit trackCircuitsChanged();
+        if (segmentsTouched) emit trackSegmentsChanged();
+    });
+
+    connect(pollingTimer.get(), &ClockTimer::timeout, this, &DatabaseManager::pollDatabase);
     pollingTimer->setInterval(POLLING_INTERVAL_MS);
 
     // ADD: Health monitoring for notifications
-    m_notificationHealthTimer = new QTimer(this);
-    connect(m_notificationHealthTimer, &QTimer::timeout, this, &DatabaseManager::checkNotificationHealth);
+    m_notificationHealthTimer = new ClockTimer(this);
+    connect(m_notificationHealthTimer, &ClockTimer::timeout, this, &DatabaseManager::checkNotificationHealth);
     m_notificationHealthTimer->start(100000); // Check every minute
 }
 
 
 DatabaseManager::~DatabaseManager() {
     stopPolling();
+    if (m_commandJournal) {
+        m_commandJournal->close();  // Drains acknowledged commands while the server is still up
+    }
+    m_telemetryWriter->stop();
     if (db.isOpen()) {
         db.close();
     }
@@ -39,8 +82,7 @@ bool DatabaseManager::connectToDatabase()
     // Try system PostgreSQL first
     if (connectToSystemPostgreSQL()) {
         qDebug() << "Connected to system PostgreSQL";
-        enableRealTimeUpdates();  // Enable LISTEN/NOTIFY
-        return true;
+        return completeConnectionSetup();
     }
 
     qDebug() << "System PostgreSQL unavailable, starting portable mode...";
@@ -48,8 +90,7 @@ bool DatabaseManager::connectToDatabase()
     // Fall back to portable PostgreSQL
     if (startPortableMode()) {
         qDebug() << "Connected to portable PostgreSQL";
-        enableRealTimeUpdates();  // Enable LISTEN/NOTIFY
-        return true;
+        return completeConnectionSetup();
     }
 
     // Set disconnected state and emit signal
@@ -60,6 +101,31 @@ bool DatabaseManager::connectToDatabase()
     return false;
 }
 
+bool DatabaseManager::completeConnectionSetup()
+{
+    // SAFETY: Config ids are array indices from here on - a database whose config tables
+    // disagree with the compiled lookup would silently misread every aspect and position
+    QString error;
+    if (!ConfigLookup::verify(db, &error)) {
+        qCritical() << "SAFETY: Database configuration does not match this build - refusing connection:" << error;
+        db.close();
+        connected = false;
+        m_isConnected = false;
+        emit connectionStateChanged(connected);
+        emit errorOccurred("Database configuration mismatch (reset the database to reinitialize): " + error);
+        return false;
+    }
+
+    if (m_serverSideValidation) setServerSideValidation(true);  // Install the rule replica
+    if (m_commandJournalEnabled) setCommandJournal(true);
+    m_telemetryWriter->start(db.connectionName());
+    enableRealTimeUpdates();  // Enable LISTEN/NOTIFY
+
+    // Announced only now: receivers initialize services against a verified, fully set-up connection
+    emit connectionStateChanged(connected);
+    return true;
+}
+
 // In DatabaseManager.cpp - Fix connectToSystemPostgreSQL()
 bool DatabaseManager::connectToSystemPostgreSQL()
 {
@@ -91,7 +157,6 @@ bool DatabaseManager::connectToSystemPostgreSQL()
         if (db.open()) {
             connected = true;
             m_isConnected = true;
-            emit connectionStateChanged(connected);
             qDebug() << "Connected to system PostgreSQL";
             return true;
         }
@@ -148,7 +213,6 @@ bool DatabaseManager::startPortableMode()
             connected = true;
             m_isConnected = true;
             m_connectionStatus = "Connected to Portable PostgreSQL";
-            emit connectionStateChanged(connected);
             qDebug() << "Portable PostgreSQL connected with schema created";
             return true;
         }
@@ -301,7 +365,7 @@ void DatabaseManager::enableRealTimeUpdates() {
         QObject::connect(db.driver(), &QSqlDriver::notification,
                          this, [this](const QString& name, QSqlDriver::NotificationSource source, const QVariant& payload) {
                              // TRACK SEGMENT: Update health indicators
-                             m_lastNotificationReceived = QDateTime::currentDateTime();
+                             m_lastNotificationReceived = m_clock->currentDateTime();
                              m_notificationsWorking = true;
 
                              qDebug() << " NOTIFICATION RECEIVED:" << name << "Payload:" << payload.toString();
@@ -315,13 +379,13 @@ void DatabaseManager::enableRealTimeUpdates() {
                          });
 
         m_notificationsEnabled = true;
-        m_lastNotificationReceived = QDateTime::currentDateTime(); // Initialize
+        m_lastNotificationReceived = m_clock->currentDateTime(); // Initialize
 
         // Send test notification
         QSqlQuery testQuery(db);
         if (testQuery.exec("SELECT pg_notify('railway_changes', "
                            "'{\"test\": \"startup\", \"timestamp\": \"" +
-                           QString::number(QDateTime::currentSecsSinceEpoch()) + "\"}'::text)")) {
+                           QString::number(m_clock->currentDateTime().toSecsSinceEpoch()) + "\"}'::text)")) {
             qDebug() << "Test notification sent";
         }
     } else {
@@ -332,7 +396,7 @@ void DatabaseManager::enableRealTimeUpdates() {
 void DatabaseManager::checkNotificationHealth() {
     if (!m_notificationsEnabled) return;
 
-    QDateTime now = QDateTime::currentDateTime();
+    QDateTime now = m_clock->currentDateTime();
 
     if (m_lastNotificationReceived.isValid() &&
         m_lastNotificationReceived.secsTo(now) > 300) {
@@ -386,7 +450,7 @@ void DatabaseManager::handleDatabaseNotification(const QString& name, const QVar
 
     // UPDATE: Mark notifications as working (for health monitoring)
     m_notificationsWorking = true;
-    m_lastNotificationReceived = QDateTime::currentDateTime();
+    m_lastNotificationReceived = m_clock->currentDateTime();
 
     // SAFETY: No cache refreshing - just emit signals for UI updates
     if (obj["test"].toString() == "startup") {
@@ -394,26 +458,16 @@ void DatabaseManager::handleDatabaseNotification(const QString& name, const QVar
         return; // ← Don't trigger data refresh
     }
 
+    // BATCHED: The payload carries no values, so these are whole-row change records
     if (table == "signals") {
-        emit signalsChanged();
-        emit signalUpdated(entityId);
-        qDebug() << "Emitted signalsChanged and signalUpdated(" << entityId << ")";
+        m_eventBus->publish(StationEventBus::EntityKind::Signal, entityId, StationEventBus::Field::Row);
     } else if (table == "point_machines") {
-        emit pointMachinesChanged();
-        emit pointMachineUpdated(entityId);
-        qDebug() << "Emitted pointMachinesChanged and pointMachineUpdated(" << entityId << ")";
+        m_eventBus->publish(StationEventBus::EntityKind::PointMachine, entityId, StationEventBus::Field::Row);
     } else if (table == "track_segments") {
-        emit trackSegmentsChanged();  //  Consistent naming
-        emit trackSegmentUpdated(entityId);  //  Consistent naming
-        qDebug() << "Emitted trackSegmentsChanged and trackSegmentUpdated(" << entityId << ")";
-    } else if (table == "track_circuits") {  // NEW: Handle circuit notifications
-        emit trackCircuitsChanged();
-        emit trackSegmentsChanged(); // Segments depend on circuits
-        qDebug() << "Emitted trackCircuitsChanged and trackSegmentsChanged (circuit affects segments)";
+        m_eventBus->publish(StationEventBus::EntityKind::TrackSegment, entityId, StationEventBus::Field::Row);
+    } else if (table == "track_circuits") {
+        m_eventBus->publish(StationEventBus::EntityKind::TrackCircuit, entityId, StationEventBus::Field::Row);
     }
-
-    emit dataUpdated();
-    qDebug() << "Emitted dataUpdated()";
 }
 
 int DatabaseManager::getCurrentPollingInterval() const {
@@ -494,37 +548,75 @@ bool DatabaseManager::isConnected() const {
 void DatabaseManager::pollDatabase() {
     if (!connected) return;
 
-    qDebug() << "SAFETY POLLING: Direct database state check";
-    detectAndEmitChanges();
-    emit dataUpdated(); // Trigger QML property updates
+    qDebug() << "SAFETY POLLING: Incremental station snapshot";
+    if (detectAndEmitChanges()) {
+        emit dataUpdated(); // Trigger QML property updates
+    }
 }
 
-void DatabaseManager::detectAndEmitChanges() {
-    // Poll signals
-    QSqlQuery signalQuery("SELECT signal_id, current_aspect_id FROM railway_control.signals", db);
-    while (signalQuery.next()) {
-        QString signalId = signalQuery.value(0).toString();
-        int aspectId = signalQuery.value(1).toInt();
+bool DatabaseManager::detectAndEmitChanges() {
+    //   One incremental snapshot replaces the per-table polling queries
+    const QVariantMap snapshot = getStationSnapshot(m_snapshotSeq);
+    if (snapshot.isEmpty()) return false;
+
+    const qint64 seq = snapshot["seq"].toLongLong();
+    if (seq < m_snapshotSeq) {
+        qWarning() << "SAFETY POLLING: Change sequence went backwards (" << m_snapshotSeq << "->" << seq
+                   << ") - database re-initialised, resyncing on next poll";
+        m_snapshotSeq = 0;
+        return false;
+    }
+    m_snapshotSeq = seq;
+
+    const QVariantList signalRows = snapshot["signals"].toList();
+    for (const QVariant& value : signalRows) {
+        const QVariantMap signal = value.toMap();
+        const QString signalId = signal["id"].toString();
+        const int aspectId = static_cast<int>(PackedAspect::codeFromString(signal["currentAspect"].toString()));
+
+        // Aspect ids are AspectCode values, so they go on the bus as-is
+        auto last = lastSignalAspects.constFind(signalId);
+        if (last == lastSignalAspects.constEnd() || last.value() != aspectId) {
+            const int oldAspectId = last == lastSignalAspects.constEnd() ? StationEventBus::UNKNOWN_VALUE : last.value();
+            lastSignalAspects.insert(signalId, aspectId);
+            m_eventBus->publish(StationEventBus::EntityKind::Signal, signalId,
+                                StationEventBus::Field::MainAspect, oldAspectId, aspectId);
+        }
+    }
+
+    //  Track circuits carry occupancy (segments inherit it)
+    const QVariantList circuitRows = snapshot["trackCircuits"].toList();
+    for (const QVariant& value : circuitRows) {
+        const QVariantMap circuit = value.toMap();
+        const QString circuitId = circuit["id"].toString();
+        const bool isOccupied = circuit["occupied"].toBool();
 
-        if (!lastSignalStates.contains(signalId.toInt()) || lastSignalStates[signalId.toInt()] != QString::number(aspectId)) {
-            lastSignalStates[signalId.toInt()] = QString::number(aspectId);
-            emit signalStateChanged(signalId.toInt(), QString::number(aspectId));
+        auto last = lastTrackCircuitStates.constFind(circuitId);
+        if (last == lastTrackCircuitStates.constEnd() || last.value() != isOccupied) {
+            const int wasOccupied = last == lastTrackCircuitStates.constEnd() ? StationEventBus::UNKNOWN_VALUE : last.value();
+            lastTrackCircuitStates.insert(circuitId, isOccupied);
+            m_eventBus->publish(StationEventBus::EntityKind::TrackCircuit, circuitId,
+                                StationEventBus::Field::Occupancy, wasOccupied, isOccupied);
         }
     }
 
-    //  Poll trackSegment circuits for occupancy (not segments)
-    QSqlQuery circuitQuery("SELECT circuit_id, is_occupied FROM railway_control.track_circuits", db);
-    while (circuitQuery.next()) {
-        QString circuitId = circuitQuery.value(0).toString();
-        bool isOccupied = circuitQuery.value(1).toBool();
+    const QVariantList pointRows = snapshot["pointMachines"].toList();
+    for (const QVariant& value : pointRows) {
+        const QVariantMap machine = value.toMap();
+        const QString machineId = machine["id"].toString();
+        const int position = StationEventBus::positionCode(machine["position"].toString());
 
-        // Use circuit_id as key for tracking state changes
-        int circuitKey = qHash(circuitId);
-        if (!lastTrackSegmentStates.contains(circuitKey) || lastTrackSegmentStates[circuitKey] != isOccupied) {
-            lastTrackSegmentStates[circuitKey] = isOccupied;
-            emit trackCircuitStateChanged(circuitKey, isOccupied);
+        auto last = lastPointPositions.constFind(machineId);
+        if (last == lastPointPositions.constEnd() || last.value() != position) {
+            const int oldPosition = last == lastPointPositions.constEnd() ? StationEventBus::UNKNOWN_VALUE : last.value();
+            lastPointPositions.insert(machineId, position);
+            m_eventBus->publish(StationEventBus::EntityKind::PointMachine, machineId,
+                                StationEventBus::Field::Position, oldPosition, position);
         }
     }
+
+    return !signalRows.isEmpty() || !circuitRows.isEmpty() || !pointRows.isEmpty()
+           || !snapshot["trackSegments"].toList().isEmpty();
 }
 
 bool DatabaseManager::isPortableServerRunning()
@@ -602,11 +694,13 @@ QVariantList DatabaseManager::getTrackSegmentsList() {
         FROM railway_control.track_segments ts
         LEFT JOIN railway_control.track_circuits tc ON ts.circuit_id = tc.circuit_id
         -- REMOVED: resource_locks JOIN entirely
-        -- OPTIONAL: Add route context if needed
-        LEFT JOIN railway_control.route_assignments ra ON (
-            tc.circuit_id = ANY(ra.assigned_circuits)
-            AND ra.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
+        -- Route context through the indexed route_circuits junction
+        LEFT JOIN railway_control.route_circuits rc ON (
+            rc.circuit_id = tc.circuit_id
+            AND NOT rc.is_overlap
+            AND rc.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
         )
+        LEFT JOIN railway_control.route_assignments ra ON ra.id = rc.route_id
         WHERE ts.is_active = TRUE
         ORDER BY ts.segment_id
     )";
@@ -807,6 +901,41 @@ QVariantList DatabaseManager::getTextLabelsList() {
     return labels;
 }
 
+QVariantMap DatabaseManager::getStationSnapshot(qint64 sinceSeq) {
+    if (!connected) return QVariantMap();
+
+    QSqlQuery query(db);
+    query.prepare("SELECT railway_control.get_station_snapshot(?)");
+    query.addBindValue(sinceSeq);
+
+    if (!query.exec() || !query.next()) {
+        qWarning() << " SAFETY CRITICAL: Station snapshot query failed:" << query.lastError().text();
+        return QVariantMap();
+    }
+
+    const QJsonObject root = QJsonDocument::fromJson(query.value(0).toString().toUtf8()).object();
+
+    auto expand = [&root](const QString& key, QVariantMap (*convert)(const QJsonArray&)) {
+        const QJsonArray rows = root[key].toArray();
+        QVariantList expanded;
+        expanded.reserve(rows.size());
+        for (const QJsonValue& row : rows) {
+            expanded.append(convert(row.toArray()));
+        }
+        return expanded;
+    };
+
+    QVariantMap snapshot;
+    snapshot["seq"] = root["seq"].toInteger();
+    snapshot["full"] = root["full"].toBool();
+    snapshot["trackCircuits"] = expand("trackCircuits", &DatabaseManager::convertSnapshotTrackCircuit);
+    snapshot["trackSegments"] = expand("trackSegments", &DatabaseManager::convertSnapshotTrackSegment);
+    snapshot["signals"] = expand("signals", &DatabaseManager::convertSnapshotSignal);
+    snapshot["pointMachines"] = expand("pointMachines", &DatabaseManager::convertSnapshotPointMachine);
+    snapshot["textLabels"] = expand("textLabels", &DatabaseManager::convertSnapshotTextLabel);
+    return snapshot;
+}
+
 QVariantList DatabaseManager::getOuterSignalsList() {
     QVariantList result;
     QVariantList allSignals = getAllSignalsList();  // This is fine
@@ -971,11 +1100,13 @@ QVariantMap DatabaseManager::getTrackSegmentById(const QString& trackSegmentId)
         FROM railway_control.track_segments ts
         LEFT JOIN railway_control.track_circuits tc ON ts.circuit_id = tc.circuit_id
         -- REMOVED: resource_locks JOIN entirely
-        -- OPTIONAL: Add route context if needed
-        LEFT JOIN railway_control.route_assignments ra ON (
-            tc.circuit_id = ANY(ra.assigned_circuits)
-            AND ra.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
+        -- Route context through the indexed route_circuits junction
+        LEFT JOIN railway_control.route_circuits rc ON (
+            rc.circuit_id = tc.circuit_id
+            AND NOT rc.is_overlap
+            AND rc.state IN ('RESERVED', 'ACTIVE', 'PARTIALLY_RELEASED')
         )
+        LEFT JOIN railway_control.route_assignments ra ON ra.id = rc.route_id
         WHERE ts.segment_id = ?
     )");
 
@@ -1122,14 +1253,28 @@ bool DatabaseManager::updateMainSignalAspect(const QString& signalId, const QStr
 
     qDebug() << "SAFETY: Updating MAIN signal aspect:" << signalId << "to aspect:" << newAspect;
 
-    // Get current main aspect for interlocking validation
-    QString currentAspect = getCurrentSignalAspect(signalId);
+    // Get current main aspect and its row version for interlocking validation
+    int currentAspectId = 0;
+    int expectedVersion = 0;
+    readVersionedState("signals", "signal_id", "current_aspect_id", signalId, currentAspectId, expectedVersion);
+    QString currentAspect = ConfigLookup::aspectCode(currentAspectId);
+    if (isCommandJournalEnabled()) {
+        currentAspect = m_commandJournal->pendingSignalAspect(signalId, "MAIN").value_or(currentAspect);
+    }
     if (currentAspect.isEmpty()) {
         qWarning() << "Could not get current main aspect for signal:" << signalId;
         emit operationBlocked(signalId, "Signal not found or invalid main aspect state");
         return false;
     }
 
+    // Versions of the protected circuits, controlling signals and condition points as well
+    ValidationRequest readSetRequest;
+    readSetRequest.kind = ValidationRequest::Kind::MainAspect;
+    readSetRequest.entityId = signalId;
+    ValidationReadSet readSet;
+    ReadSetVersions readSetVersions;
+    if (!captureReadSet(readSetRequest, readSet, readSetVersions)) return false;
+
     // Main signal interlocking validation
     if (m_interlockingService) {
         auto validation = m_interlockingService->validateMainSignalOperation(
@@ -1146,6 +1291,29 @@ bool DatabaseManager::updateMainSignalAspect(const QString& signalId, const QStr
         qWarning() << "Interlocking service not available - proceeding without validation";
     }
 
+    // Server-side rules are an additional gate, applied as a compare-and-set on the validated version
+    if (m_serverSideValidation) {
+        const bool applied = applyMainSignalAspectOnServer(signalId, newAspect, expectedVersion,
+                                                           readSet, readSetVersions);
+        qDebug() << "Main signal server-side operation completed in" << timer.elapsed() << "ms";
+        return applied;
+    }
+
+    if (isCommandJournalEnabled()) {
+        CommandJournal::Command command;
+        command.kind = CommandJournal::CommandKind::MainAspect;
+        command.entityId = signalId;
+        command.value = newAspect;
+        command.expectedVersion = m_commandJournal->pendingSignalVersion(signalId).value_or(expectedVersion);
+        if (!journalCommand(command)) return false;
+
+        m_eventBus->publish(StationEventBus::EntityKind::Signal, signalId, StationEventBus::Field::MainAspect,
+                            static_cast<qint32>(PackedAspect::codeFromString(currentAspect)),
+                            static_cast<qint32>(PackedAspect::codeFromString(newAspect)));
+        qDebug() << "Main signal command journaled in" << timer.elapsed() << "ms";
+        return true;
+    }
+
     // Database transaction for main signal update
     QSqlQuery query(db);
 
@@ -1154,27 +1322,37 @@ bool DatabaseManager::updateMainSignalAspect(const QString& signalId, const QStr
         return false;
     }
 
-    // Call existing main signal update function
-    query.prepare("SELECT railway_control.update_signal_aspect(?, ?, 'HMI_USER')");
+    if (!holdReadSet(signalId, readSet, readSetVersions)) {
+        db.rollback();
+        return false;
+    }
+
+    // Compare-and-set against the version the validation above was made on
+    query.prepare("SELECT railway_control.update_signal_aspect(?, ?, 'HMI_USER', FALSE, ?)");
     query.addBindValue(signalId);
     query.addBindValue(newAspect);
+    query.addBindValue(expectedVersion);
 
     bool success = false;
     if (query.exec() && query.next()) {
-        success = query.value(0).toBool();
+        // The function returns the row as written, so no re-read is needed to confirm it
+        const QJsonObject result = QJsonDocument::fromJson(query.value(0).toString().toUtf8()).object();
+        success = result["success"].toBool();
+        if (result["stale"].toBool()) {
+            db.rollback();
+            qWarning() << "SAFETY: Main signal" << signalId << "changed during validation:" << result["reason"].toString();
+            emit operationBlocked(signalId, "Signal state changed since validation - please retry");
+            return false;
+        }
         if (success && db.commit()) {
-            // Verify main aspect change
-            QSqlQuery verifyQuery(db);
-            verifyQuery.prepare("SELECT current_aspect_id FROM railway_control.signals WHERE signal_id = ?");
-            verifyQuery.addBindValue(signalId);
-            if (verifyQuery.exec() && verifyQuery.next()) {
-                int currentAspectId = verifyQuery.value(0).toInt();
-                qDebug() << "SAFETY: Main signal" << signalId << "now has aspect_id:" << currentAspectId;
-            }
+            qDebug() << "SAFETY: Main signal" << signalId << "now has aspect_id:" << result["aspect_id"].toInt();
+            diagnosticReread("main signal " + signalId,
+                             "SELECT current_aspect_id, last_changed_at, change_seq FROM railway_control.signals WHERE signal_id = ?",
+                             {signalId});
 
-            // Emit success signals
-            emit signalUpdated(signalId);
-            emit signalsChanged();
+            m_eventBus->publish(StationEventBus::EntityKind::Signal, signalId, StationEventBus::Field::MainAspect,
+                                static_cast<qint32>(PackedAspect::codeFromString(currentAspect)),
+                                static_cast<qint32>(PackedAspect::codeFromString(newAspect)));
 
             qDebug() << "Main signal operation completed in" << timer.elapsed() << "ms";
             return true;
@@ -1208,14 +1386,34 @@ bool DatabaseManager::updateSubsidiarySignalAspect(const QString& signalId,
         return false;
     }
 
-    // Get current subsidiary aspect for validation
-    QString currentSubsidiaryAspect = getCurrentSubsidiaryAspect(signalId, aspectType);
+    // Get current subsidiary aspect and the signal's row version for validation
+    int currentSubsidiaryId = 0;
+    int expectedVersion = 0;
+    const bool found = readVersionedState("signals", "signal_id",
+                                          aspectType == "CALLING_ON" ? "calling_on_aspect_id" : "loop_aspect_id",
+                                          signalId, currentSubsidiaryId, expectedVersion);
+    QString currentSubsidiaryAspect;
+    if (found) {
+        currentSubsidiaryAspect = ConfigLookup::aspectCode(currentSubsidiaryId);
+        if (currentSubsidiaryAspect.isEmpty()) currentSubsidiaryAspect = QStringLiteral("OFF");
+        if (isCommandJournalEnabled()) {
+            currentSubsidiaryAspect = m_commandJournal->pendingSignalAspect(signalId, aspectType)
+                                          .value_or(currentSubsidiaryAspect);
+        }
+    }
     if (currentSubsidiaryAspect.isEmpty()) {
         qWarning() << "Could not get current subsidiary aspect for signal:" << signalId << "type:" << aspectType;
         emit operationBlocked(signalId, "Signal not found or invalid subsidiary aspect state");
         return false;
     }
 
+    ValidationRequest readSetRequest;
+    readSetRequest.kind = ValidationRequest::Kind::SubsidiaryAspect;
+    readSetRequest.entityId = signalId;
+    ValidationReadSet readSet;
+    ReadSetVersions readSetVersions;
+    if (!captureReadSet(readSetRequest, readSet, readSetVersions)) return false;
+
     // Interlocking validation for subsidiary signals
     if (m_interlockingService) {
         auto validation = m_interlockingService->validateSubsidiarySignalOperation(
@@ -1232,6 +1430,24 @@ bool DatabaseManager::updateSubsidiarySignalAspect(const QString& signalId,
         qWarning() << "Interlocking service not available - proceeding without validation";
     }
 
+    if (isCommandJournalEnabled()) {
+        CommandJournal::Command command;
+        command.kind = CommandJournal::CommandKind::SubsidiaryAspect;
+        command.entityId = signalId;
+        command.aspectType = aspectType;
+        command.value = newAspect;
+        command.expectedVersion = m_commandJournal->pendingSignalVersion(signalId).value_or(expectedVersion);
+        if (!journalCommand(command)) return false;
+
+        m_eventBus->publish(StationEventBus::EntityKind::Signal, signalId,
+                            aspectType == "CALLING_ON" ? StationEventBus::Field::CallingOnAspect
+                                                       : StationEventBus::Field::LoopAspect,
+                            static_cast<qint32>(PackedAspect::codeFromString(currentSubsidiaryAspect)),
+                            static_cast<qint32>(PackedAspect::codeFromString(newAspect)));
+        qDebug() << "Subsidiary signal command journaled in" << timer.elapsed() << "ms";
+        return true;
+    }
+
     // Database transaction for subsidiary signal update
     QSqlQuery query(db);
 
@@ -1240,30 +1456,40 @@ bool DatabaseManager::updateSubsidiarySignalAspect(const QString& signalId,
         return false;
     }
 
+    if (!holdReadSet(signalId, readSet, readSetVersions)) {
+        db.rollback();
+        return false;
+    }
+
     // Call subsidiary signal update function (TO BE CREATED)
-    query.prepare("SELECT railway_control.update_subsidiary_signal_aspect(?, ?, ?, 'HMI_USER')");
+    query.prepare("SELECT railway_control.update_subsidiary_signal_aspect(?, ?, ?, 'HMI_USER', ?)");
     query.addBindValue(signalId);
     query.addBindValue(aspectType);
     query.addBindValue(newAspect);
+    query.addBindValue(expectedVersion);
 
     bool success = false;
     if (query.exec() && query.next()) {
-        success = query.value(0).toBool();
+        const QJsonObject result = QJsonDocument::fromJson(query.value(0).toString().toUtf8()).object();
+        success = result["success"].toBool();
+        if (result["stale"].toBool()) {
+            db.rollback();
+            qWarning() << "SAFETY: Subsidiary signal" << signalId << "changed during validation:" << result["reason"].toString();
+            emit operationBlocked(signalId, "Signal state changed since validation - please retry");
+            return false;
+        }
         if (success && db.commit()) {
-            // Verify subsidiary aspect change
-            QString columnName = (aspectType == "CALLING_ON") ? "calling_on_aspect" : "loop_aspect";
-            QSqlQuery verifyQuery(db);
-            verifyQuery.prepare(QString("SELECT %1 FROM railway_control.signals WHERE signal_id = ?").arg(columnName));
-            verifyQuery.addBindValue(signalId);
-            if (verifyQuery.exec() && verifyQuery.next()) {
-                QString currentValue = verifyQuery.value(0).toString();
-                qDebug() << "SAFETY: Subsidiary signal" << signalId << aspectType
-                         << "now has value:" << currentValue;
-            }
-
-            // Emit success signals
-            emit signalUpdated(signalId);
-            emit signalsChanged();
+            qDebug() << "SAFETY: Subsidiary signal" << signalId << aspectType
+                     << "now has aspect_id:" << result["aspect_id"].toInt();
+            diagnosticReread("subsidiary signal " + signalId,
+                             "SELECT calling_on_aspect_id, loop_aspect_id, last_changed_at, change_seq FROM railway_control.signals WHERE signal_id = ?",
+                             {signalId});
+
+            m_eventBus->publish(StationEventBus::EntityKind::Signal, signalId,
+                                aspectType == "CALLING_ON" ? StationEventBus::Field::CallingOnAspect
+                                                           : StationEventBus::Field::LoopAspect,
+                                static_cast<qint32>(PackedAspect::codeFromString(currentSubsidiaryAspect)),
+                                static_cast<qint32>(PackedAspect::codeFromString(newAspect)));
 
             qDebug() << "Subsidiary signal operation completed in" << timer.elapsed() << "ms";
             return true;
@@ -1332,8 +1558,14 @@ bool DatabaseManager::updatePointMachinePosition(const QString& machineId, const
 
     qDebug() << "SAFETY: Updating point machine:" << machineId << "to position:" << newPosition;
 
-    // Step 1: Get current positions for paired validation
-    QString currentPosition = getCurrentPointPosition(machineId);
+    // Step 1: Get current positions and row versions for paired validation
+    int currentPositionId = 0;
+    int expectedVersion = 0;
+    readVersionedState("point_machines", "machine_id", "current_position_id", machineId, currentPositionId, expectedVersion);
+    QString currentPosition = ConfigLookup::positionCode(currentPositionId);
+    if (isCommandJournalEnabled()) {
+        currentPosition = m_commandJournal->pendingPointPosition(machineId).value_or(currentPosition);
+    }
     if (currentPosition.isEmpty()) {
         qWarning() << "Could not get current position for point machine:" << machineId;
         emit operationBlocked(machineId, "Point machine not found or invalid state");
@@ -1342,9 +1574,27 @@ bool DatabaseManager::updatePointMachinePosition(const QString& machineId, const
 
     // Step 2: Get paired machine info for comprehensive validation
     QString pairedMachineId = getPairedMachine(machineId);
+    QVariant expectedPairedVersion;
+
+    // Versions of the segments' circuits either machine would sweep
+    ValidationRequest readSetRequest;
+    readSetRequest.kind = pairedMachineId.isEmpty() ? ValidationRequest::Kind::PointPosition
+                                                    : ValidationRequest::Kind::PairedPointPosition;
+    readSetRequest.entityId = machineId;
+    readSetRequest.pairedEntityId = pairedMachineId;
+    ValidationReadSet readSet;
+    ReadSetVersions readSetVersions;
+    if (!captureReadSet(readSetRequest, readSet, readSetVersions)) return false;
 
     if (!pairedMachineId.isEmpty()) {
-        QString pairedCurrentPosition = getCurrentPointPosition(pairedMachineId);
+        int pairedPositionId = 0;
+        int pairedVersion = 0;
+        readVersionedState("point_machines", "machine_id", "current_position_id", pairedMachineId, pairedPositionId, pairedVersion);
+        QString pairedCurrentPosition = ConfigLookup::positionCode(pairedPositionId);
+        expectedPairedVersion = pairedVersion;
+        if (isCommandJournalEnabled()) {
+            pairedCurrentPosition = m_commandJournal->pendingPointPosition(pairedMachineId).value_or(pairedCurrentPosition);
+        }
 
         // === USE PAIRED VALIDATION ===
         if (m_interlockingService) {
@@ -1373,22 +1623,69 @@ bool DatabaseManager::updatePointMachinePosition(const QString& machineId, const
 
     qDebug() << "Interlocking validation passed for all affected machines";
 
+    // Server-side rules are an additional gate, applied as a compare-and-set on the validated versions
+    if (m_serverSideValidation) {
+        return applyPointMachinePositionOnServer(machineId, newPosition, expectedVersion, expectedPairedVersion,
+                                                 readSet, readSetVersions);
+    }
+
+    if (isCommandJournalEnabled()) {
+        CommandJournal::Command command;
+        command.kind = CommandJournal::CommandKind::PointPosition;
+        command.entityId = machineId;
+        command.value = newPosition;
+        command.pairedEntityId = pairedMachineId;
+        command.expectedVersion = m_commandJournal->pendingPointVersion(machineId).value_or(expectedVersion);
+        if (!pairedMachineId.isEmpty()) {
+            command.expectedPairedVersion = m_commandJournal->pendingPointVersion(pairedMachineId)
+                                                .value_or(expectedPairedVersion.toInt());
+        }
+        if (!journalCommand(command)) return false;
+
+        QStringList machinesList{machineId};
+        if (!pairedMachineId.isEmpty()) machinesList.append(pairedMachineId);
+        for (const QString& updatedId : machinesList) {
+            m_eventBus->publish(StationEventBus::EntityKind::PointMachine, updatedId, StationEventBus::Field::Position,
+                                updatedId == machineId ? StationEventBus::positionCode(currentPosition)
+                                                       : StationEventBus::UNKNOWN_VALUE,
+                                StationEventBus::positionCode(newPosition));
+        }
+        if (machinesList.size() > 1) {
+            emit pairedMachinesUpdated(machinesList);
+        }
+        return true;
+    }
+
     // Step 3: Execute atomic database operation (rest remains unchanged)
     if (!db.transaction()) {
         qWarning() << "SAFETY CRITICAL: Failed to start transaction for point machine update";
         return false;
     }
 
+    if (!holdReadSet(machineId, readSet, readSetVersions)) {
+        db.rollback();
+        return false;
+    }
+
     QSqlQuery query(db);
-    query.prepare("SELECT railway_control.update_point_position_paired(?, ?, 'HMI_USER')");
+    query.prepare("SELECT railway_control.update_point_position_paired(?, ?, 'HMI_USER', FALSE, ?, ?)");
     query.addBindValue(machineId);
     query.addBindValue(newPosition);
+    query.addBindValue(expectedVersion);
+    query.addBindValue(expectedPairedVersion);
 
     bool success = false;
     if (query.exec() && query.next()) {
         QJsonDocument doc = QJsonDocument::fromJson(query.value(0).toString().toUtf8());
         QJsonObject result = doc.object();
 
+        if (result["stale"].toBool()) {
+            db.rollback();
+            qWarning() << "SAFETY: Point machine update rejected:" << result["message"].toString();
+            emit operationBlocked(machineId, "Point machine state changed since validation - please retry");
+            return false;
+        }
+
         success = result["success"].toBool();
         bool positionMismatch = result["position_mismatch"].toBool();
         QJsonArray updatedMachines = result["machines_updated"].toArray();
@@ -1401,8 +1698,12 @@ bool DatabaseManager::updatePointMachinePosition(const QString& machineId, const
                 // Emit appropriate signals
                 QStringList machinesList;
                 for (const auto& machine : updatedMachines) {
-                    machinesList.append(machine.toString());
-                    emit pointMachineUpdated(machine.toString());
+                    const QString updatedId = machine.toString();
+                    machinesList.append(updatedId);
+                    m_eventBus->publish(StationEventBus::EntityKind::PointMachine, updatedId, StationEventBus::Field::Position,
+                                        updatedId == machineId ? StationEventBus::positionCode(currentPosition)
+                                                               : StationEventBus::UNKNOWN_VALUE,
+                                        StationEventBus::positionCode(newPosition));
                 }
 
                 if (machinesList.size() > 1) {
@@ -1415,7 +1716,6 @@ bool DatabaseManager::updatePointMachinePosition(const QString& machineId, const
                     emit positionMismatchCorrected(machineId, pairedMachineId);
                 }
 
-                emit pointMachinesChanged();
                 return true;
             } else {
                 qWarning() << "SAFETY CRITICAL: Failed to commit transaction:" << db.lastError().text();
@@ -1441,12 +1741,7 @@ QString DatabaseManager::getCurrentSignalAspect(const QString& signalId) {
     }
 
     QSqlQuery query(db);
-    query.prepare(R"(
-        SELECT sa.aspect_code
-        FROM railway_control.signals s
-        LEFT JOIN railway_config.signal_aspects sa ON s.current_aspect_id = sa.id
-        WHERE s.signal_id = ?
-    )");
+    query.prepare("SELECT current_aspect_id FROM railway_control.signals WHERE signal_id = ?");
     query.addBindValue(signalId);
 
     if (!query.exec()) {
@@ -1455,7 +1750,9 @@ QString DatabaseManager::getCurrentSignalAspect(const QString& signalId) {
     }
 
     if (query.next()) {
-        return query.value(0).toString();
+        const QString aspectCode = ConfigLookup::aspectCode(query.value(0).toInt());
+        return isCommandJournalEnabled() ? m_commandJournal->pendingSignalAspect(signalId, "MAIN").value_or(aspectCode)
+                                         : aspectCode;
     }
 
     qWarning() << "Signal not found:" << signalId;
@@ -1468,28 +1765,23 @@ QString DatabaseManager::getCurrentSubsidiaryAspect(const QString& signalId, con
 
     QString columnName;
     if (aspectType == "CALLING_ON") {
-        columnName = "sa_calling.aspect_code";
+        columnName = "calling_on_aspect_id";
     } else if (aspectType == "LOOP") {
-        columnName = "sa_loop.aspect_code";
+        columnName = "loop_aspect_id";
     } else {
         qWarning() << " Invalid subsidiary aspect type:" << aspectType;
         return QString();
     }
 
     QSqlQuery query(db);
-    QString sql = QString(R"(
-        SELECT COALESCE(%1, 'OFF') as aspect_code
-        FROM railway_control.signals s
-        LEFT JOIN railway_config.signal_aspects sa_calling ON s.calling_on_aspect_id = sa_calling.id
-        LEFT JOIN railway_config.signal_aspects sa_loop ON s.loop_aspect_id = sa_loop.id
-        WHERE s.signal_id = ?
-    )").arg(columnName);
-
-    query.prepare(sql);
+    query.prepare(QString("SELECT %1 FROM railway_control.signals WHERE signal_id = ?").arg(columnName));
     query.addBindValue(signalId);
 
     if (query.exec() && query.next()) {
-        return query.value(0).toString();
+        QString aspectCode = ConfigLookup::aspectCode(query.value(0).toInt());
+        if (aspectCode.isEmpty()) aspectCode = QStringLiteral("OFF");
+        return isCommandJournalEnabled() ? m_commandJournal->pendingSignalAspect(signalId, aspectType).value_or(aspectCode)
+                                         : aspectCode;
     }
 
     qWarning() << " Failed to get current subsidiary aspect:" << query.lastError().text();
@@ -1498,20 +1790,129 @@ QString DatabaseManager::getCurrentSubsidiaryAspect(const QString& signalId, con
 
 QString DatabaseManager::getCurrentPointPosition(const QString& machineId) {
     QSqlQuery query(db);
-    query.prepare(R"(
-        SELECT pp.position_code
-        FROM railway_control.point_machines pm
-        LEFT JOIN railway_config.point_positions pp ON pm.current_position_id = pp.id
-        WHERE pm.machine_id = ?
-    )");
+    query.prepare("SELECT current_position_id FROM railway_control.point_machines WHERE machine_id = ?");
     query.addBindValue(machineId);
 
     if (query.exec() && query.next()) {
-        return query.value(0).toString();
+        const QString positionCode = ConfigLookup::positionCode(query.value(0).toInt());
+        return isCommandJournalEnabled() ? m_commandJournal->pendingPointPosition(machineId).value_or(positionCode)
+                                         : positionCode;
     }
     return QString();
 }
 
+//   OPTIMISTIC CONCURRENCY: State and row version in one read, so the version handed to the
+//   compare-and-set write is exactly the one the interlocking decision was made on
+bool DatabaseManager::readVersionedState(const QString& table, const QString& keyColumn, const QString& valueColumn,
+                                         const QString& key, int& valueId, int& version) {
+    QSqlQuery query(db);
+    query.prepare(QString("SELECT %1, version FROM railway_control.%2 WHERE %3 = ?").arg(valueColumn, table, keyColumn));
+    query.addBindValue(key);
+
+    if (!query.exec() || !query.next()) {
+        qWarning() << " Failed to read versioned state for" << table << key << ":" << query.lastError().text();
+        return false;
+    }
+
+    valueId = query.value(0).toInt();
+    version = query.value(1).toInt();
+    return true;
+}
+
+//   Route transitions go through update_route_state(), which has no version parameter. Inside the
+//   caller's transaction this row-locks the assignment only if it is still at expectedVersion, so
+//   the transition cannot land on top of one that committed after getRouteAssignment() ran.
+bool DatabaseManager::claimRouteVersion(const QString& routeId, int expectedVersion) {
+    QSqlQuery query(db);
+    query.prepare("SELECT version FROM railway_control.route_assignments WHERE id = ? FOR UPDATE");
+    query.addBindValue(routeId);
+
+    if (!query.exec() || !query.next()) {
+        qWarning() << " Failed to lock route" << routeId << ":" << query.lastError().text();
+        return false;
+    }
+
+    const int currentVersion = query.value(0).toInt();
+    if (currentVersion != expectedVersion) {
+        qWarning() << " SAFETY: Route" << routeId << "is at version" << currentVersion
+                   << "- expected" << expectedVersion << "(concurrent change)";
+        return false;
+    }
+    return true;
+}
+
+//   Versions from the state version the validation evaluates, not from the database: that
+//   version may lag the rows, and a matching recheck under lock then means the verdict was
+//   reached on exactly the state being written over. A lagging version fails the recheck.
+bool DatabaseManager::captureReadSet(const ValidationRequest& request, ValidationReadSet& readSet,
+                                     ReadSetVersions& versions) {
+    if (!m_interlockingService) return true;
+
+    readSet = m_interlockingService->validationReadSet(request);
+    versions = m_interlockingService->currentVersionsOf(readSet);
+    return true;
+}
+
+bool DatabaseManager::readReadSetVersions(const ValidationReadSet& readSet, bool lockForShare,
+                                          ReadSetVersions& versions) {
+    //   Locks are taken in key order so concurrent commands cannot deadlock on each other
+    const QString lockClause = lockForShare ? " ORDER BY 1 FOR SHARE" : "";
+
+    auto readVersions = [this, &lockClause](const QString& select, const QVariantList& params,
+                                            QHash<QString, int>& into) {
+        QSqlQuery query(db);
+        query.prepare(select + lockClause);
+        for (const QVariant& param : params) {
+            query.addBindValue(param);
+        }
+        if (!query.exec()) {
+            qWarning() << " Failed to read validation read set versions:" << query.lastError().text();
+            return false;
+        }
+        while (query.next()) {
+            into.insert(query.value(0).toString(), query.value(1).toInt());
+        }
+        return true;
+    };
+
+    if (!readSet.signalIds.isEmpty()
+        && !readVersions("SELECT signal_id, version FROM railway_control.signals WHERE signal_id = ANY(?::TEXT[])",
+                         {"{" + readSet.signalIds.join(",") + "}"}, versions.signalVersions)) {
+        return false;
+    }
+    if (!readSet.pointMachineIds.isEmpty()
+        && !readVersions("SELECT machine_id, version FROM railway_control.point_machines WHERE machine_id = ANY(?::TEXT[])",
+                         {"{" + readSet.pointMachineIds.join(",") + "}"}, versions.pointMachineVersions)) {
+        return false;
+    }
+    if ((!readSet.trackCircuitIds.isEmpty() || !readSet.trackSegmentIds.isEmpty())
+        && !readVersions("SELECT circuit_id, version FROM railway_control.track_circuits "
+                         "WHERE circuit_id = ANY(?::TEXT[]) OR circuit_id IN "
+                         "(SELECT circuit_id FROM railway_control.track_segments WHERE segment_id = ANY(?::TEXT[]))",
+                         {"{" + readSet.trackCircuitIds.join(",") + "}", "{" + readSet.trackSegmentIds.join(",") + "}"},
+                         versions.trackCircuitVersions)) {
+        return false;
+    }
+    return true;
+}
+
+//   Inside the write transaction, before the compare-and-set; the caller rolls back on false
+bool DatabaseManager::holdReadSet(const QString& entityId, const ValidationReadSet& readSet,
+                                  const ReadSetVersions& expected) {
+    ReadSetVersions current;
+    if (!readReadSetVersions(readSet, true, current)) {
+        emit operationBlocked(entityId, "Interlocking state not available for validation");
+        return false;
+    }
+
+    if (current != expected) {
+        qWarning() << "SAFETY: State read by the validation of" << entityId << "changed before the write";
+        emit operationBlocked(entityId, "Interlocking state changed since validation - please retry");
+        return false;
+    }
+    return true;
+}
+
 QStringList DatabaseManager::getInterlockedSignals(const QString& signalId) {
     auto signalData = getSignalById(signalId);
     if (!signalData.isEmpty()) {
@@ -1523,6 +1924,25 @@ QStringList DatabaseManager::getInterlockedSignals(const QString& signalId) {
 void DatabaseManager::setInterlockingService(InterlockingService* service) {
     m_interlockingService = service;
     qDebug() << "Interlocking service connected to DatabaseManager";
+
+    if (!service) return;
+
+    //   The server-side replica follows every published rule set
+    connect(service, &InterlockingService::interlockingRulesReloaded, this, [this]() {
+        if (m_serverSideValidation) installServerSideRules();
+    });
+}
+
+void DatabaseManager::setClock(Clock* clock) {
+    if (!clock) return;
+
+    m_clock = clock;
+    pollingTimer->setClock(clock);
+    m_notificationHealthTimer->setClock(clock);
+    m_trackCircuitFilter->setClock(clock);
+    if (m_lastNotificationReceived.isValid()) {
+        m_lastNotificationReceived = clock->currentDateTime();
+    }
 }
 
 // ADD: Database access method for interlocking branches
@@ -1534,15 +1954,48 @@ QSqlDatabase DatabaseManager::getDatabase() const {
 bool DatabaseManager::updateTrackSegmentOccupancy(const QString& trackSegmentId, bool isOccupied) {
     if (!connected) return false;
 
+    // LATENCY: Occupancy-to-danger is timed from the report's arrival, on either reaction path
+    const qint64 inputNs = OccupancyLatencyMonitor::nowNs();
+
+    // FILTERED: Occupied passes straight through; clear waits out the circuit's pick-up delay
+    const QString circuitId = m_trackCircuitFilter->circuitForTrackSegment(trackSegmentId);
+    if (!circuitId.isEmpty()) {
+        switch (m_trackCircuitFilter->submit(circuitId, trackSegmentId, isOccupied)) {
+        case TrackCircuitFilter::Decision::CommitNow: break;
+        case TrackCircuitFilter::Decision::Deferred:
+        case TrackCircuitFilter::Decision::Suppressed: return true;
+        }
+    }
+
+    const bool success = commitTrackSegmentOccupancy(trackSegmentId, isOccupied, inputNs);
+    if (!circuitId.isEmpty()) {
+        reportFilteredCommit(circuitId, isOccupied, success);
+    }
+    return success;
+}
+
+void DatabaseManager::reportFilteredCommit(const QString& trackCircuitId, bool isOccupied, bool success) {
+    // The filter only treats a state as committed once the database has it
+    if (success) {
+        m_trackCircuitFilter->confirmCommit(trackCircuitId, isOccupied);
+    } else {
+        m_trackCircuitFilter->rollbackCommit(trackCircuitId);
+    }
+}
+
+bool DatabaseManager::commitTrackSegmentOccupancy(const QString& trackSegmentId, bool isOccupied, qint64 inputNs) {
     qDebug() << "HARDWARE: Track segment occupancy change:" << trackSegmentId << "→" << isOccupied;
     qDebug() << "             (This updates the CIRCUIT that contains this segment)";
 
-    // Get previous state for interlocking comparison
-    bool wasOccupied = false;
-    auto currentTrackSegmentData = getTrackSegmentById(trackSegmentId);
-    if (!currentTrackSegmentData.isEmpty()) {
-        wasOccupied = currentTrackSegmentData["occupied"].toBool();
-    }
+    // Previous state from the filter's committed circuit state - no database read on the detection
+    // path. Unknown (first report, or a segment without a circuit) counts as a transition.
+    const QString circuitId = m_trackCircuitFilter->circuitForTrackSegment(trackSegmentId);
+    const bool wasOccupied = m_trackCircuitFilter->committedOccupancy(circuitId).value_or(!isOccupied);
+
+    // PIPELINED: Hand the transition to the interlocking pipeline before our own commit,
+    // so the safety reaction never waits on this write
+    bool reactionQueued = m_interlockingService &&
+                          m_interlockingService->submitOccupancyChange(trackSegmentId, wasOccupied, isOccupied, inputNs);
 
     // UPDATED: Use the wrapper function that maps segment to circuit
     QSqlQuery query(db);
@@ -1553,17 +2006,23 @@ bool DatabaseManager::updateTrackSegmentOccupancy(const QString& trackSegmentId,
     if (query.exec() && query.next()) {
         bool success = query.value(0).toBool();
         if (success) {
-            // REACTIVE: Trigger automatic interlocking enforcement
-            if (m_interlockingService && m_interlockingService->isOperational()) {
+            // REACTIVE: Trigger automatic interlocking enforcement (synchronous fallback)
+            if (!reactionQueued && m_interlockingService && m_interlockingService->isOperational()) {
                 QMetaObject::invokeMethod(m_interlockingService,
                                           "reactToTrackSegmentOccupancyChange", Qt::QueuedConnection,
                                           Q_ARG(QString, trackSegmentId),
                                           Q_ARG(bool, wasOccupied),
-                                          Q_ARG(bool, isOccupied));
+                                          Q_ARG(bool, isOccupied),
+                                          Q_ARG(qint64, inputNs));
             }
 
-            emit trackSegmentUpdated(trackSegmentId);  //  Consistent naming
-            emit trackSegmentsChanged();               //  Consistent naming
+            m_eventBus->publish(StationEventBus::EntityKind::TrackSegment, trackSegmentId,
+                                StationEventBus::Field::Occupancy, wasOccupied, isOccupied);
+
+            if (!circuitId.isEmpty()) {
+                m_eventBus->publish(StationEventBus::EntityKind::TrackCircuit, circuitId,
+                                    StationEventBus::Field::Occupancy, StationEventBus::UNKNOWN_VALUE, isOccupied);
+            }
         }
         return success;
     }
@@ -1575,8 +2034,37 @@ bool DatabaseManager::updateTrackSegmentOccupancy(const QString& trackSegmentId,
 bool DatabaseManager::updateTrackCircuitOccupancy(const QString& trackCircuitId, bool isOccupied) {
     if (!connected) return false;
 
+    const qint64 inputNs = OccupancyLatencyMonitor::nowNs();
+
+    switch (m_trackCircuitFilter->submit(trackCircuitId, trackCircuitId, isOccupied)) {
+    case TrackCircuitFilter::Decision::CommitNow: break;
+    case TrackCircuitFilter::Decision::Deferred:
+    case TrackCircuitFilter::Decision::Suppressed: return true;
+    }
+
+    const bool success = commitTrackCircuitOccupancy(trackCircuitId, isOccupied, inputNs);
+    reportFilteredCommit(trackCircuitId, isOccupied, success);
+    return success;
+}
+
+bool DatabaseManager::commitTrackCircuitOccupancy(const QString& trackCircuitId, bool isOccupied, qint64 inputNs) {
     qDebug() << "CIRCUIT: Track Segment circuit occupancy change:" << trackCircuitId << "→" << isOccupied;
 
+    // A circuit report changes every section of the circuit: each gets the interlocking reaction
+    // a segment report would. The previous state is the filter's committed one; until there is
+    // one the change is treated as a transition, so an occupied report always protects.
+    const bool wasOccupied = m_trackCircuitFilter->committedOccupancy(trackCircuitId).value_or(!isOccupied);
+    const QStringList trackSegmentIds = m_trackCircuitFilter->trackSegmentsForCircuit(trackCircuitId);
+
+    // PIPELINED: Queued before our own commit, as for segment reports
+    QStringList reactAfterCommit;
+    for (const QString& trackSegmentId : trackSegmentIds) {
+        if (!m_interlockingService
+            || !m_interlockingService->submitOccupancyChange(trackSegmentId, wasOccupied, isOccupied, inputNs)) {
+            reactAfterCommit.append(trackSegmentId);
+        }
+    }
+
     QSqlQuery query(db);
     query.prepare("SELECT railway_control.update_track_circuit_occupancy(?, ?, NULL, 'HARDWARE_AUTO')");
     query.addBindValue(trackCircuitId);
@@ -1585,8 +2073,24 @@ bool DatabaseManager::updateTrackCircuitOccupancy(const QString& trackCircuitId,
     if (query.exec() && query.next()) {
         bool success = query.value(0).toBool();
         if (success) {
-            emit trackCircuitsChanged();  // NEW: Circuit-specific signal
-            emit trackSegmentsChanged();  // Also update segments since they depend on circuits
+            // REACTIVE: Synchronous fallback for sections the pipeline did not take
+            if (m_interlockingService && m_interlockingService->isOperational()) {
+                for (const QString& trackSegmentId : reactAfterCommit) {
+                    QMetaObject::invokeMethod(m_interlockingService,
+                                              "reactToTrackSegmentOccupancyChange", Qt::QueuedConnection,
+                                              Q_ARG(QString, trackSegmentId),
+                                              Q_ARG(bool, wasOccupied),
+                                              Q_ARG(bool, isOccupied),
+                                              Q_ARG(qint64, inputNs));
+                }
+            }
+
+            m_eventBus->publish(StationEventBus::EntityKind::TrackCircuit, trackCircuitId,
+                                StationEventBus::Field::Occupancy, StationEventBus::UNKNOWN_VALUE, isOccupied);
+            for (const QString& trackSegmentId : trackSegmentIds) {
+                m_eventBus->publish(StationEventBus::EntityKind::TrackSegment, trackSegmentId,
+                                    StationEventBus::Field::Occupancy, wasOccupied, isOccupied);
+            }
         }
         return success;
     }
@@ -1595,6 +2099,36 @@ bool DatabaseManager::updateTrackCircuitOccupancy(const QString& trackCircuitId,
     return false;
 }
 
+void DatabaseManager::onTrackCircuitClearConfirmed(const QString& trackCircuitId, const QString& sourceId) {
+    if (!connected) return;
+
+    // The deferred clear is committed against whatever the raw report named
+    const bool success = sourceId == trackCircuitId ? commitTrackCircuitOccupancy(trackCircuitId, false)
+                                                    : commitTrackSegmentOccupancy(sourceId, false);
+    reportFilteredCommit(trackCircuitId, false, success);
+}
+
+bool DatabaseManager::configureTrackCircuitFilter(const QString& circuitId, const QVariantMap& config) {
+    if (circuitId.isEmpty()) {
+        m_trackCircuitFilter->setDefaultConfig(
+            TrackCircuitFilter::configFromVariantMap(config, m_trackCircuitFilter->circuitConfig(QString())));
+        return true;
+    }
+
+    m_trackCircuitFilter->setCircuitConfig(
+        circuitId, TrackCircuitFilter::configFromVariantMap(config, m_trackCircuitFilter->circuitConfig(circuitId)));
+    return true;
+}
+
+QVariantMap DatabaseManager::getTrackCircuitFlickerStatistics(const QString& circuitId) const {
+    return circuitId.isEmpty() ? m_trackCircuitFilter->statistics()
+                               : m_trackCircuitFilter->circuitStatistics(circuitId);
+}
+
+QStringList DatabaseManager::trackSegmentsForCircuit(const QString& trackCircuitId) const {
+    return m_trackCircuitFilter->trackSegmentsForCircuit(trackCircuitId);
+}
+
 bool DatabaseManager::getTrackCircuitOccupancy(const QString& trackCircuitId) {
     QSqlQuery query(db);
     query.prepare("SELECT is_occupied FROM railway_control.track_circuits WHERE circuit_id = ?");
@@ -1834,6 +2368,34 @@ QStringList DatabaseManager::getProtectedTrackCircuitsFromInterlockingRules(cons
     return trackCircuits;
 }
 
+QHash<QString, QStringList> DatabaseManager::getAllProtectedTrackCircuitsFromInterlockingRules() {
+    QHash<QString, QStringList> circuitsBySignal;
+    if (!connected) return circuitsBySignal;
+
+    QSqlQuery query(db);
+    query.prepare(R"(
+        SELECT source_entity_id, target_entity_id
+        FROM railway_control.interlocking_rules
+        WHERE source_entity_type = 'SIGNAL'
+          AND target_entity_type = 'TRACK_CIRCUIT'
+          AND target_constraint = 'MUST_BE_CLEAR'
+          AND rule_type = 'PROTECTING'
+          AND is_active = TRUE
+        ORDER BY source_entity_id, target_entity_id
+    )");
+
+    if (!query.exec()) {
+        qCritical() << " DatabaseManager: Failed to query protected track circuits from interlocking rules:" << query.lastError().text();
+        return circuitsBySignal;
+    }
+
+    while (query.next()) {
+        circuitsBySignal[query.value(0).toString()].append(query.value(1).toString());
+    }
+
+    return circuitsBySignal;
+}
+
 QVariantMap DatabaseManager::getTrackCircuitById(const QString& circuitId) {
     if (!connected) return QVariantMap();
 
@@ -2221,12 +2783,109 @@ QVariantMap DatabaseManager::convertTrackCircuitRowToVariant(const QSqlQuery& qu
     return circuit;
 }
 
+//   SNAPSHOT ROWS: Column order matches railway_control.get_station_snapshot()
+
+QVariantMap DatabaseManager::convertSnapshotTrackCircuit(const QJsonArray& row) {
+    QVariantMap circuit;
+    circuit["id"] = row.at(0).toString();
+    circuit["occupied"] = row.at(1).toBool();
+    circuit["occupiedBy"] = row.at(2).toString();
+    circuit["isAssigned"] = row.at(3).toBool();
+    circuit["isOverlap"] = row.at(4).toBool();
+    circuit["version"] = row.at(5).toInt();
+    return circuit;
+}
+
+QVariantMap DatabaseManager::convertSnapshotTrackSegment(const QJsonArray& row) {
+    QVariantMap trackSegment;
+    trackSegment["id"] = row.at(0).toString();
+    trackSegment["name"] = row.at(1).toString();
+    trackSegment["startRow"] = row.at(2).toDouble();
+    trackSegment["startCol"] = row.at(3).toDouble();
+    trackSegment["endRow"] = row.at(4).toDouble();
+    trackSegment["endCol"] = row.at(5).toDouble();
+    trackSegment["trackSegmentType"] = row.at(6).toString();
+    trackSegment["isActive"] = row.at(7).toBool();
+    trackSegment["circuitId"] = row.at(8).toString();
+    trackSegment["assigned"] = row.at(9).toBool();
+    trackSegment["isOverlap"] = row.at(10).toBool();
+    trackSegment["occupied"] = row.at(11).toBool();
+    trackSegment["occupiedBy"] = row.at(12).toString();
+    return trackSegment;
+}
+
+QVariantMap DatabaseManager::convertSnapshotSignal(const QJsonArray& row) {
+    QVariantMap signal;
+    signal["id"] = row.at(0).toString();
+    signal["name"] = row.at(1).toString();
+    signal["type"] = row.at(2).toString();
+    signal["row"] = row.at(3).toDouble();
+    signal["col"] = row.at(4).toDouble();
+    signal["direction"] = row.at(5).toString();
+    signal["isActive"] = row.at(6).toBool();
+    signal["isLocked"] = row.at(7).toBool();
+    signal["location"] = row.at(8).toString();
+    signal["currentAspect"] = row.at(9).toString();
+    signal["callingOnAspect"] = row.at(10).toString();
+    signal["loopAspect"] = row.at(11).toString();
+    signal["loopSignalConfiguration"] = row.at(12).toString();
+    signal["aspectCount"] = row.at(13).toInt();
+
+    QStringList possibleAspects;
+    for (const QJsonValue& aspect : row.at(14).toArray()) {
+        possibleAspects.append(aspect.toString());
+    }
+    signal["possibleAspects"] = possibleAspects;
+    signal["version"] = row.at(15).toInt();
+    return signal;
+}
+
+QVariantMap DatabaseManager::convertSnapshotPointMachine(const QJsonArray& row) {
+    QVariantMap pm;
+    pm["id"] = row.at(0).toString();
+    pm["name"] = row.at(1).toString();
+    pm["position"] = row.at(2).toString();
+    pm["currentPosition"] = row.at(2).toString();
+    pm["operatingStatus"] = row.at(3).toString();
+
+    QVariantMap junctionPoint;
+    junctionPoint["row"] = row.at(4).toDouble();
+    junctionPoint["col"] = row.at(5).toDouble();
+    pm["junctionPoint"] = junctionPoint;
+
+    pm["rootTrackSegment"] = row.at(6).toObject().toVariantMap();
+    pm["normalTrackSegment"] = row.at(7).toObject().toVariantMap();
+    pm["reverseTrackSegment"] = row.at(8).toObject().toVariantMap();
+    pm["transitionTime"] = row.at(9).toInt();
+    pm["isLocked"] = row.at(10).toBool();
+    pm["lockReason"] = row.at(11).toString();
+
+    const QString pairedEntity = row.at(12).toString();
+    pm["pairedEntity"] = pairedEntity.isEmpty() ? QVariant() : pairedEntity;
+    pm["isPaired"] = !pairedEntity.isEmpty();
+    pm["version"] = row.at(13).toInt();
+    return pm;
+}
+
+QVariantMap DatabaseManager::convertSnapshotTextLabel(const QJsonArray& row) {
+    QVariantMap label;
+    label["text"] = row.at(0).toString();
+    label["row"] = row.at(1).toDouble();
+    label["col"] = row.at(2).toDouble();
+    label["fontSize"] = row.at(3).toInt();
+    label["color"] = row.at(4).toString();
+    label["fontFamily"] = row.at(5).toString();
+    label["isVisible"] = row.at(6).toBool();
+    label["type"] = row.at(7).toString();
+    return label;
+}
+
 // Legacy methods for compatibility
 QVariantMap DatabaseManager::getAllSignalStates() {
     QVariantMap states;
     QSqlQuery query("SELECT signal_id, current_aspect_id FROM railway_control.signals", db);
     while (query.next()) {
-        states[query.value(0).toString()] = query.value(1).toString();
+        states[query.value(0).toString()] = ConfigLookup::aspectCode(query.value(1).toInt());
     }
     return states;
 }
@@ -2236,7 +2895,8 @@ QString DatabaseManager::getSignalState(int signalId) {
     query.prepare("SELECT current_aspect_id FROM railway_control.signals WHERE signal_id = ?");
     query.addBindValue(QString::number(signalId));
     if (query.exec() && query.next()) {
-        return query.value(0).toString();
+        const QString aspectCode = ConfigLookup::aspectCode(query.value(0).toInt());
+        if (!aspectCode.isEmpty()) return aspectCode;
     }
     return "RED"; // Safe default
 }
@@ -2311,11 +2971,278 @@ QString DatabaseManager::getPointPosition(int machineId) {
     query.prepare("SELECT current_position_id FROM railway_control.point_machines WHERE machine_id = ?");
     query.addBindValue(QString::number(machineId));
     if (query.exec() && query.next()) {
-        return query.value(0).toString();
+        const QString positionCode = ConfigLookup::positionCode(query.value(0).toInt());
+        if (!positionCode.isEmpty()) return positionCode;
     }
     return "NORMAL"; // Safe default
 }
 
+//   DIAGNOSTIC RE-READS: Command paths trust their function's return value; a deep re-read of
+//   the written row only happens when diagnostic verification is switched on
+void DatabaseManager::setDiagnosticVerification(bool enabled) {
+    m_diagnosticVerification = enabled;
+    qDebug() << "Diagnostic post-commit verification" << (enabled ? "enabled" : "disabled");
+}
+
+void DatabaseManager::diagnosticReread(const QString& context, const QString& sql, const QVariantList& params) {
+    if (!m_diagnosticVerification) return;
+
+    QSqlQuery verifyQuery(db);
+    verifyQuery.prepare(sql);
+    for (const QVariant& param : params) {
+        verifyQuery.addBindValue(param);
+    }
+
+    if (!verifyQuery.exec()) {
+        qWarning() << " [DIAGNOSTIC]" << context << "re-read failed:" << verifyQuery.lastError().text();
+        return;
+    }
+    if (!verifyQuery.next()) {
+        qWarning() << " [DIAGNOSTIC]" << context << "re-read returned no row";
+        return;
+    }
+
+    const QSqlRecord record = verifyQuery.record();
+    QStringList fields;
+    for (int i = 0; i < record.count(); ++i) {
+        fields.append(record.fieldName(i) + "=" + verifyQuery.value(i).toString());
+    }
+    qDebug() << " [DIAGNOSTIC]" << context << fields.join(", ");
+}
+
+//   SERVER-SIDE VALIDATE-AND-APPLY: One autocommit statement per command. The function locks
+//   the target rows, evaluates the installed rule replica and writes, so there is no window
+//   between the check and the write; a rejection comes back as {blocked, code, reason}.
+bool DatabaseManager::setServerSideValidation(bool enabled) {
+    if (enabled && !installServerSideRules()) {
+        qWarning() << "Server-side validation not enabled: rules could not be installed";
+        m_serverSideValidation = false;
+        return false;
+    }
+
+    m_serverSideValidation = enabled;
+    qDebug() << "Server-side validate-and-apply" << (enabled ? "enabled" : "disabled");
+    return true;
+}
+
+bool DatabaseManager::setCommandJournal(bool enabled) {
+    m_commandJournalEnabled = enabled;
+
+    if (!enabled) {
+        if (m_commandJournal) m_commandJournal->close();
+        qDebug() << "Command journal disabled";
+        return true;
+    }
+
+    if (!connected) return false;  // Opened by connectToDatabase()
+
+    if (!m_commandJournal) {
+        m_commandJournal = std::make_unique<CommandJournal>();
+
+        //   The operator was already acknowledged: surface the rejection and resync from the database
+        connect(m_commandJournal.get(), &CommandJournal::commandRejected, this,
+                [this](quint64 sequence, CommandJournal::CommandKind kind, const QString& entityId, const QString& error) {
+            qCritical() << "SAFETY: Journaled command" << sequence << "rejected:" << error;
+            m_snapshotSeq = 0;
+            republishRejectedEntity(kind, entityId);
+            emit operationBlocked(entityId, "Command rejected by database after acknowledgement: " + error);
+        });
+    }
+
+    const QString journalPath = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+                                + "/journal/commands.journal";
+    if (!m_commandJournal->open(journalPath, db.connectionName())) {
+        qWarning() << "Command journal not enabled: could not open" << journalPath;
+        m_commandJournalEnabled = false;
+        return false;
+    }
+
+    qDebug() << "Command journal enabled";
+    return true;
+}
+
+//   The bus carried the acknowledged value; put the row as the database holds it back on it
+void DatabaseManager::republishRejectedEntity(CommandJournal::CommandKind kind, const QString& entityId) {
+    QSqlQuery query(db);
+
+    if (kind == CommandJournal::CommandKind::PointPosition) {
+        query.prepare("SELECT machine_id, current_position_id FROM railway_control.point_machines "
+                      "WHERE machine_id = ? OR machine_id = (SELECT paired_entity FROM railway_control.point_machines "
+                      "WHERE machine_id = ?)");
+        query.addBindValue(entityId);
+        query.addBindValue(entityId);
+        if (!query.exec()) {
+            qWarning() << "Failed to reread rejected point machine" << entityId << ":" << query.lastError().text();
+            return;
+        }
+        while (query.next()) {
+            m_eventBus->publish(StationEventBus::EntityKind::PointMachine, query.value(0).toString(),
+                                StationEventBus::Field::Position, StationEventBus::UNKNOWN_VALUE,
+                                StationEventBus::positionCode(ConfigLookup::positionCode(query.value(1).toInt())));
+        }
+        return;
+    }
+
+    query.prepare("SELECT current_aspect_id, calling_on_aspect_id, loop_aspect_id "
+                  "FROM railway_control.signals WHERE signal_id = ?");
+    query.addBindValue(entityId);
+    if (!query.exec() || !query.next()) {
+        qWarning() << "Failed to reread rejected signal" << entityId << ":" << query.lastError().text();
+        return;
+    }
+
+    //   Aspect ids are AspectCode values; an unset subsidiary aspect reads as OFF
+    const std::pair<StationEventBus::Field, int> fields[] = {
+        {StationEventBus::Field::MainAspect, 0},
+        {StationEventBus::Field::CallingOnAspect, 1},
+        {StationEventBus::Field::LoopAspect, 2}};
+    for (const auto& [field, column] : fields) {
+        const QString aspect = ConfigLookup::aspectCode(query.value(column).toInt());
+        m_eventBus->publish(StationEventBus::EntityKind::Signal, entityId, field, StationEventBus::UNKNOWN_VALUE,
+                            static_cast<qint32>(PackedAspect::codeFromString(aspect.isEmpty() ? QStringLiteral("OFF") : aspect)));
+    }
+}
+
+bool DatabaseManager::journalCommand(CommandJournal::Command command) {
+    command.operatorId = "HMI_USER";
+    if (m_commandJournal->appendDurable(command) == 0) {
+        //   NO FALLBACK: A direct write could overtake journaled commands still being shipped
+        emit operationBlocked(command.entityId, "Command journal unavailable - command not accepted");
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::installServerSideRules() {
+    if (!connected || !m_interlockingService) return false;
+
+    InterlockingRuleEngine* ruleEngine = m_interlockingService->getRuleEngine();
+    return ruleEngine && ruleEngine->installServerSideRules(db);
+}
+
+bool DatabaseManager::applyMainSignalAspectOnServer(const QString& signalId, const QString& newAspect,
+                                                   int expectedVersion, const ValidationReadSet& readSet,
+                                                   const ReadSetVersions& readSetVersions) {
+    if (!db.transaction()) {
+        qWarning() << "Failed to start transaction for main signal:" << db.lastError().text();
+        return false;
+    }
+    if (!holdReadSet(signalId, readSet, readSetVersions)) {
+        db.rollback();
+        return false;
+    }
+
+    QSqlQuery query(db);
+    query.prepare("SELECT railway_control.update_signal_aspect(?, ?, 'HMI_USER', TRUE, ?)");
+    query.addBindValue(signalId);
+    query.addBindValue(newAspect);
+    query.addBindValue(expectedVersion);
+
+    if (!query.exec() || !query.next()) {
+        qWarning() << "Main signal server-side update failed:" << query.lastError().text();
+        db.rollback();
+        emit operationBlocked(signalId, query.lastError().text());
+        return false;
+    }
+
+    const QJsonObject result = QJsonDocument::fromJson(query.value(0).toString().toUtf8()).object();
+    if (result["stale"].toBool()) {
+        db.rollback();
+        qWarning() << "SAFETY: Main signal" << signalId << "changed during validation:" << result["reason"].toString();
+        emit operationBlocked(signalId, "Signal state changed since validation - please retry");
+        return false;
+    }
+    if (!result["success"].toBool()) {
+        db.rollback();
+        const QString reason = result["reason"].toString("Signal not found or invalid main aspect state");
+        qDebug() << "Main signal operation blocked on server:" << result["code"].toString() << reason;
+        emit operationBlocked(signalId, reason);
+        return false;
+    }
+    if (!db.commit()) {
+        qWarning() << "Main signal server-side commit failed:" << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    diagnosticReread("main signal " + signalId,
+                     "SELECT current_aspect_id, last_changed_at, change_seq FROM railway_control.signals WHERE signal_id = ?",
+                     {signalId});
+
+    //   Aspect ids are AspectCode values (ConfigLookup), so they go onto the bus as-is
+    m_eventBus->publish(StationEventBus::EntityKind::Signal, signalId, StationEventBus::Field::MainAspect,
+                        result["previous_aspect_id"].toInt(StationEventBus::UNKNOWN_VALUE),
+                        result["aspect_id"].toInt());
+    return true;
+}
+
+bool DatabaseManager::applyPointMachinePositionOnServer(const QString& machineId, const QString& newPosition,
+                                                        int expectedVersion, const QVariant& expectedPairedVersion,
+                                                        const ValidationReadSet& readSet,
+                                                        const ReadSetVersions& readSetVersions) {
+    if (!db.transaction()) {
+        qWarning() << "SAFETY CRITICAL: Failed to start transaction for point machine update";
+        return false;
+    }
+    if (!holdReadSet(machineId, readSet, readSetVersions)) {
+        db.rollback();
+        return false;
+    }
+
+    QSqlQuery query(db);
+    query.prepare("SELECT railway_control.update_point_position_paired(?, ?, 'HMI_USER', TRUE, ?, ?)");
+    query.addBindValue(machineId);
+    query.addBindValue(newPosition);
+    query.addBindValue(expectedVersion);
+    query.addBindValue(expectedPairedVersion);
+
+    if (!query.exec() || !query.next()) {
+        qWarning() << "SAFETY CRITICAL: Point machine server-side update failed:" << query.lastError().text();
+        db.rollback();
+        emit operationBlocked(machineId, query.lastError().text());
+        return false;
+    }
+
+    const QJsonObject result = QJsonDocument::fromJson(query.value(0).toString().toUtf8()).object();
+    if (result["stale"].toBool()) {
+        db.rollback();
+        qWarning() << "SAFETY: Point machine update rejected:" << result["message"].toString();
+        emit operationBlocked(machineId, "Point machine state changed since validation - please retry");
+        return false;
+    }
+    if (!result["success"].toBool()) {
+        db.rollback();
+        const QString reason = result["reason"].toString(result["message"].toString());
+        qDebug() << "Point machine operation blocked on server:" << result["code"].toString() << reason;
+        emit operationBlocked(machineId, reason);
+        return false;
+    }
+    if (!db.commit()) {
+        qWarning() << "SAFETY CRITICAL: Failed to commit transaction:" << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    QStringList machinesList;
+    for (const auto& machine : result["machines_updated"].toArray()) {
+        const QString updatedId = machine.toString();
+        machinesList.append(updatedId);
+        m_eventBus->publish(StationEventBus::EntityKind::PointMachine, updatedId, StationEventBus::Field::Position,
+                            StationEventBus::UNKNOWN_VALUE, StationEventBus::positionCode(newPosition));
+    }
+
+    if (machinesList.size() > 1) {
+        emit pairedMachinesUpdated(machinesList);
+    }
+
+    if (result["position_mismatch"].toBool() && machinesList.size() > 1) {
+        qCritical() << "SAFETY WARNING: Position mismatch corrected for paired machines:" << machinesList;
+        emit positionMismatchCorrected(machinesList.at(0), machinesList.at(1));
+    }
+
+    return true;
+}
+
 void DatabaseManager::logError(const QString& operation, const QSqlError& error) {
     qWarning() << "Database error in" << operation << ":" << error.text();
 }
@@ -2414,7 +3341,8 @@ bool DatabaseManager::insertRouteAssignment(
             throw std::runtime_error("Query executed but no result returned");
         }
 
-        bool success = query.value(0).toBool();
+        const QJsonObject result = QJsonDocument::fromJson(query.value(0).toString().toUtf8()).object();
+        bool success = result["success"].toBool();
         qDebug() << " [DB_INSERT] Function returned:" << success;
 
         if (!success) {
@@ -2433,31 +3361,16 @@ bool DatabaseManager::insertRouteAssignment(
 
         qDebug() << "  [DB_INSERT] Transaction committed successfully";
 
-        //   VERIFICATION LOGGING
-        qDebug() << " [DB_INSERT] Verifying route creation...";
-
-        QSqlQuery verifyQuery(db);
-        verifyQuery.prepare("SELECT id, source_signal_id, dest_signal_id, state, created_at FROM railway_control.route_assignments WHERE id = ?");
-        verifyQuery.addBindValue(routeId);
-
-        if (!verifyQuery.exec()) {
-            qCritical() << " [DB_INSERT] Verification query failed:" << verifyQuery.lastError().text();
-            return false;
-        }
-
-        if (!verifyQuery.next()) {
-            qCritical() << " [DB_INSERT] CRITICAL: Route not found after commit!";
-            qCritical() << " [DB_INSERT] This suggests a transaction rollback occurred";
-            return false;
-        }
-
-        // Log the verified route details
-        qDebug() << "  [DB_INSERT] Route verification successful:";
-        qDebug() << "   ID:" << verifyQuery.value("id").toString();
-        qDebug() << "   Source:" << verifyQuery.value("source_signal_id").toString();
-        qDebug() << "   Dest:" << verifyQuery.value("dest_signal_id").toString();
-        qDebug() << "   State:" << verifyQuery.value("state").toString();
-        qDebug() << "   Created:" << verifyQuery.value("created_at").toDateTime();
+        //   RESULT LOGGING: Row as inserted, returned by the function
+        qDebug() << "  [DB_INSERT] Route created:";
+        qDebug() << "   ID:" << result["id"].toString();
+        qDebug() << "   Source:" << result["source_signal_id"].toString();
+        qDebug() << "   Dest:" << result["dest_signal_id"].toString();
+        qDebug() << "   State:" << result["state"].toString();
+        qDebug() << "   Created:" << result["created_at"].toString();
+        diagnosticReread("route " + routeId,
+                         "SELECT id, source_signal_id, dest_signal_id, state, created_at FROM railway_control.route_assignments WHERE id = ?",
+                         {routeId});
 
         //   SUCCESS LOGGING
         qDebug() << "  [DB_INSERT] ==================== ROUTE INSERTION SUCCESS ====================";
@@ -2484,6 +3397,208 @@ bool DatabaseManager::insertRouteAssignment(
     }
 }
 
+QVariantList DatabaseManager::applyRouteBatch(const QVariantList& routes, const QString& operatorId) {
+    QVariantList results;
+    auto failAll = [&routes](const QString& error) {
+        QVariantList failed;
+        for (const QVariant& route : routes) {
+            failed.append(QVariantMap{{"routeId", route.toMap()["routeId"]}, {"success", false}, {"error", error}});
+        }
+        return failed;
+    };
+
+    if (!connected) {
+        logError("applyRouteBatch", QSqlError("Not connected to database", "", QSqlError::ConnectionError));
+        return failAll("DATABASE_NOT_CONNECTED");
+    }
+    if (routes.isEmpty()) {
+        return results;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!db.transaction()) {
+        qWarning() << "Failed to start route batch transaction:" << db.lastError().text();
+        return failAll("TRANSACTION_FAILED");
+    }
+
+    const QString op = operatorId.isEmpty() ? QString("system") : operatorId;
+    QSqlQuery savepoint(db);
+    // Server-side rules gate the batch only where they are installed, as for single commands;
+    // otherwise the client-side speculative check the routes carry versions from is the authority
+    QSqlQuery pointQuery(db);
+    pointQuery.prepare("SELECT railway_control.update_point_position_paired(?, ?, ?, ?, ?, ?)");
+    QSqlQuery signalQuery(db);
+    signalQuery.prepare("SELECT railway_control.update_signal_aspect(?, ?, ?, ?, ?)");
+    auto version = [](const QVariant& expected) {
+        return expected.isValid() && expected.toInt() >= 0 ? QVariant(expected.toInt()) : QVariant(QMetaType::fromType<int>());
+    };
+    QSqlQuery routeQuery(db);
+    routeQuery.prepare("SELECT railway_control.insert_route_assignment(?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+
+    //   One JSONB-returning call; the error is the server's reason or the driver's message
+    auto call = [](QSqlQuery& query, const QVariantList& params, QJsonObject& result, QString& error) {
+        for (int i = 0; i < params.size(); ++i) {
+            query.bindValue(i, params[i]);
+        }
+        if (!query.exec() || !query.next()) {
+            error = query.lastError().text();
+            return false;
+        }
+        result = QJsonDocument::fromJson(query.value(0).toString().toUtf8()).object();
+        query.finish();
+        if (!result["success"].toBool()) {
+            error = result["reason"].toString(result["message"].toString("Rejected by database"));
+            return false;
+        }
+        return true;
+    };
+
+    //   Bus events are published only after the commit
+    struct AppliedRoute {
+        struct SignalChange {
+            QString signalId;
+            qint32 previousCode;
+            QString aspect;
+        };
+        QString routeId;
+        QList<SignalChange> signalChanges;
+        QList<QPair<QStringList, QString>> pointChanges; //   machines moved, position
+    };
+    QList<AppliedRoute> applied;
+
+    for (const QVariant& value : routes) {
+        const QVariantMap route = value.toMap();
+        AppliedRoute done;
+        done.routeId = route["routeId"].toString();
+        QString error;
+
+        //   READ-YOUR-WRITES: Unshipped journal commands would overwrite this route later
+        if (isCommandJournalEnabled()) {
+            for (const QVariant& move : route["pointMoves"].toList()) {
+                if (m_commandJournal->pendingPointPosition(move.toMap()["machineId"].toString())) {
+                    error = "Journaled command pending for " + move.toMap()["machineId"].toString();
+                }
+            }
+            for (const QVariant& aspect : route["signalAspects"].toList()) {
+                if (m_commandJournal->pendingSignalAspect(aspect.toMap()["signalId"].toString(), "MAIN")) {
+                    error = "Journaled command pending for " + aspect.toMap()["signalId"].toString();
+                }
+            }
+            if (!error.isEmpty()) {
+                results.append(QVariantMap{{"routeId", done.routeId}, {"success", false}, {"error", error}});
+                continue;
+            }
+        }
+
+        savepoint.exec("SAVEPOINT route_batch");
+        bool ok = true;
+        QJsonObject result;
+
+        //   READ SET: Rows the route was validated on must not have changed since; held FOR SHARE
+        //   until the commit, like a single command's
+        const ReadSetVersions expected = ReadSetVersions::fromVariantMap(route["readVersions"].toMap());
+        if (!expected.isEmpty()) {
+            ReadSetVersions current;
+            if (!readReadSetVersions(expected.readSet(), true, current)) {
+                ok = false;
+                error = "Interlocking state not available for validation";
+            } else if (current != expected) {
+                ok = false;
+                error = "Interlocking state changed since validation - please retry";
+            }
+        }
+
+        for (const QVariant& moveValue : route["pointMoves"].toList()) {
+            if (!ok) break;
+            const QVariantMap move = moveValue.toMap();
+            if (!(ok = call(pointQuery, {move["machineId"], move["position"], op, m_serverSideValidation,
+                                         version(move["expectedVersion"]), version(move["expectedPairedVersion"])},
+                            result, error))) break;
+            QStringList machines;
+            for (const auto& machine : result["machines_updated"].toArray()) {
+                machines.append(machine.toString());
+            }
+            done.pointChanges.append({machines, move["position"].toString()});
+        }
+
+        for (const QVariant& aspectValue : route["signalAspects"].toList()) {
+            if (!ok) break;
+            const QVariantMap aspect = aspectValue.toMap();
+            if (!(ok = call(signalQuery, {aspect["signalId"], aspect["aspect"], op, m_serverSideValidation,
+                                          version(aspect["expectedVersion"])},
+                            result, error))) break;
+            //   aspect_id is the AspectCode, so the previous id is the bus's old value as is
+            done.signalChanges.append({aspect["signalId"].toString(),
+                                       result.contains("previous_aspect_id")
+                                           ? static_cast<qint32>(result["previous_aspect_id"].toInt())
+                                           : StationEventBus::UNKNOWN_VALUE,
+                                       aspect["aspect"].toString()});
+        }
+
+        if (ok) {
+            //   Both halves of a paired move are locked by the route
+            QStringList lockedMachines;
+            for (const QVariant& move : route["pointMoves"].toList()) {
+                lockedMachines.append(move.toMap()["machineId"].toString());
+            }
+            for (const auto& [machines, position] : done.pointChanges) {
+                lockedMachines += machines;
+            }
+            lockedMachines.removeDuplicates();
+            ok = call(routeQuery,
+                      {done.routeId, route["sourceSignalId"], route["destSignalId"], route["direction"],
+                       "{" + route["assignedCircuits"].toStringList().join(",") + "}",
+                       "{" + route["overlapCircuits"].toStringList().join(",") + "}",
+                       "ACTIVE",
+                       "{" + lockedMachines.join(",") + "}",
+                       route.value("priority", 100).toInt(), op},
+                      result, error);
+        }
+
+        if (ok) {
+            savepoint.exec("RELEASE SAVEPOINT route_batch");
+            applied.append(done);
+            results.append(QVariantMap{{"routeId", done.routeId}, {"success", true}});
+        } else {
+            savepoint.exec("ROLLBACK TO SAVEPOINT route_batch");
+            savepoint.exec("RELEASE SAVEPOINT route_batch");
+            qWarning() << "Route" << done.routeId << "rolled back within batch:" << error;
+            results.append(QVariantMap{{"routeId", done.routeId}, {"success", false}, {"error", error}});
+        }
+    }
+
+    if (!db.commit()) {
+        qCritical() << "Route batch commit failed:" << db.lastError().text();
+        db.rollback();
+        return failAll("COMMIT_FAILED");
+    }
+
+    for (const AppliedRoute& route : applied) {
+        for (const auto& [machines, position] : route.pointChanges) {
+            for (const QString& machineId : machines) {
+                m_eventBus->publish(StationEventBus::EntityKind::PointMachine, machineId, StationEventBus::Field::Position,
+                                    StationEventBus::UNKNOWN_VALUE, StationEventBus::positionCode(position));
+            }
+            if (machines.size() > 1) {
+                emit pairedMachinesUpdated(machines);
+            }
+        }
+        for (const AppliedRoute::SignalChange& change : route.signalChanges) {
+            m_eventBus->publish(StationEventBus::EntityKind::Signal, change.signalId, StationEventBus::Field::MainAspect,
+                                change.previousCode, static_cast<qint32>(PackedAspect::codeFromString(change.aspect)));
+        }
+        emit routeAssignmentInserted(route.routeId);
+    }
+    if (!applied.isEmpty()) {
+        emit routeAssignmentsChanged();
+    }
+
+    qDebug() << "Route batch:" << applied.size() << "of" << routes.size() << "routes committed in" << timer.elapsed() << "ms";
+    return results;
+}
+
 // 
 // ROUTE ASSIGNMENT METHODS IMPLEMENTATION
 // 
@@ -2525,6 +3640,12 @@ bool DatabaseManager::updateRouteState(const QString& routeId, const QString& ne
         return false;
     }
 
+    if (!claimRouteVersion(routeId, currentRoute["version"].toInt())) {
+        db.rollback();
+        emit operationBlocked(routeId, "Route changed since it was read - please retry");
+        return false;
+    }
+
     //   POLICY: Call SQL function instead of direct UPDATE
     query.prepare("SELECT railway_control.update_route_state(?, ?, ?, ?)");
     query.addBindValue(routeId);
@@ -2536,14 +3657,8 @@ bool DatabaseManager::updateRouteState(const QString& routeId, const QString& ne
     if (query.exec() && query.next()) {
         success = query.value(0).toBool();
         if (success && db.commit()) {
-            // Verify state change
-            QSqlQuery verifyQuery(db);
-            verifyQuery.prepare("SELECT state FROM railway_control.route_assignments WHERE id = ?");
-            verifyQuery.addBindValue(routeId);
-            if (verifyQuery.exec() && verifyQuery.next()) {
-                QString verifiedState = verifyQuery.value(0).toString();
-                qDebug() << "  SAFETY: Route" << routeId << "now has state:" << verifiedState;
-            }
+            qDebug() << "  SAFETY: Route" << routeId << "now has state:" << newState;
+            diagnosticReread("route " + routeId, "SELECT state, updated_at FROM railway_control.route_assignments WHERE id = ?", {routeId});
 
             // Emit success signals
             emit routeStateChanged(routeId, newState);
@@ -2606,6 +3721,12 @@ bool DatabaseManager::updateRouteActivation(const QString& routeId) {
         return false;
     }
 
+    if (!claimRouteVersion(routeId, currentRoute["version"].toInt())) {
+        db.rollback();
+        emit operationBlocked(routeId, "Route changed since it was read - please retry");
+        return false;
+    }
+
     //   POLICY: Call SQL function instead of direct UPDATE
     query.prepare("SELECT railway_control.update_route_state(?, ?, ?)");
     query.addBindValue(routeId);
@@ -2617,15 +3738,8 @@ bool DatabaseManager::updateRouteActivation(const QString& routeId) {
     if (query.exec() && query.next()) {
         success = query.value(0).toBool();
         if (success && db.commit()) {
-            // Verify activation
-            QSqlQuery verifyQuery(db);
-            verifyQuery.prepare("SELECT state, activated_at FROM railway_control.route_assignments WHERE id = ?");
-            verifyQuery.addBindValue(routeId);
-            if (verifyQuery.exec() && verifyQuery.next()) {
-                QString verifiedState = verifyQuery.value(0).toString();
-                QString activatedAt = verifyQuery.value(1).toString();
-                qDebug() << "  SAFETY: Route" << routeId << "activated. State:" << verifiedState << "Time:" << activatedAt;
-            }
+            qDebug() << "  SAFETY: Route" << routeId << "activated";
+            diagnosticReread("route " + routeId, "SELECT state, activated_at FROM railway_control.route_assignments WHERE id = ?", {routeId});
 
             // Emit success signals
             emit routeActivated(routeId);
@@ -2689,6 +3803,12 @@ bool DatabaseManager::updateRouteRelease(const QString& routeId) {
         return false;
     }
 
+    if (!claimRouteVersion(routeId, currentRoute["version"].toInt())) {
+        db.rollback();
+        emit operationBlocked(routeId, "Route changed since it was read - please retry");
+        return false;
+    }
+
     //   POLICY: Call SQL function instead of direct UPDATE
     query.prepare("SELECT railway_control.update_route_state(?, ?, ?)");
     query.addBindValue(routeId);
@@ -2700,15 +3820,8 @@ bool DatabaseManager::updateRouteRelease(const QString& routeId) {
     if (query.exec() && query.next()) {
         success = query.value(0).toBool();
         if (success && db.commit()) {
-            // Verify release
-            QSqlQuery verifyQuery(db);
-            verifyQuery.prepare("SELECT state, released_at FROM railway_control.route_assignments WHERE id = ?");
-            verifyQuery.addBindValue(routeId);
-            if (verifyQuery.exec() && verifyQuery.next()) {
-                QString verifiedState = verifyQuery.value(0).toString();
-                QString releasedAt = verifyQuery.value(1).toString();
-                qDebug() << "  SAFETY: Route" << routeId << "released. State:" << verifiedState << "Time:" << releasedAt;
-            }
+            qDebug() << "  SAFETY: Route" << routeId << "released";
+            diagnosticReread("route " + routeId, "SELECT state, released_at FROM railway_control.route_assignments WHERE id = ?", {routeId});
 
             // Emit success signals
             emit routeReleased(routeId);
@@ -2789,17 +3902,9 @@ bool DatabaseManager::updateRouteFailure(const QString& routeId, const QString&
     if (query.exec() && query.next()) {
         success = query.value(0).toBool();
         if (success && db.commit()) {
-            // Verify failure state and reason
-            QSqlQuery verifyQuery(db);
-            verifyQuery.prepare("SELECT state, failure_reason, updated_at FROM railway_control.route_assignments WHERE id = ?");
-            verifyQuery.addBindValue(routeId);
-            if (verifyQuery.exec() && verifyQuery.next()) {
-                QString verifiedState = verifyQuery.value(0).toString();
-                QString verifiedReason = verifyQuery.value(1).toString();
-                QString updatedAt = verifyQuery.value(2).toString();
-                qDebug() << "  SAFETY: Route" << routeId << "marked as failed.";
-                qDebug() << "   State:" << verifiedState << "Reason:" << verifiedReason << "Time:" << updatedAt;
-            }
+            qDebug() << "  SAFETY: Route" << routeId << "marked as failed. Reason:" << failureReason;
+            diagnosticReread("route " + routeId,
+                             "SELECT state, failure_reason, updated_at FROM railway_control.route_assignments WHERE id = ?", {routeId});
 
             // Emit success signals
             emit routeFailed(routeId, failureReason);
@@ -2843,52 +3948,14 @@ bool DatabaseManager::updateRoutePerformanceMetrics(const QString& routeId, cons
         return false;
     }
 
-    // Convert metrics to JSON
-    QJsonDocument jsonDoc = QJsonDocument::fromVariant(metrics);
-    QString jsonString = jsonDoc.toJson(QJsonDocument::Compact);
-
-    qDebug() << " Performance metrics:" << jsonString;
-
-    // Database transaction for performance metrics update
-    QSqlQuery query(db);
-
-    if (!db.transaction()) {
-        qWarning() << " Failed to start transaction for performance metrics:" << db.lastError().text();
+    //   TELEMETRY: Buffered and written in batches off the route-setting path
+    if (!m_telemetryWriter->enqueuePerformanceMetrics(routeId, metrics, "HMI_USER")) {
+        qWarning() << " Performance metrics not buffered for route" << routeId;
         return false;
     }
 
-    //   POLICY: Call SQL function instead of direct UPDATE
-    query.prepare("SELECT railway_control.update_route_performance_metrics(?, ?::jsonb, ?)");
-    query.addBindValue(routeId);
-    query.addBindValue(jsonString);
-    query.addBindValue("HMI_USER"); // operator_id
-
-    bool success = false;
-    if (query.exec() && query.next()) {
-        success = query.value(0).toBool();
-        if (success && db.commit()) {
-            // Optional: Verify metrics were updated
-            QSqlQuery verifyQuery(db);
-            verifyQuery.prepare("SELECT performance_metrics FROM railway_control.route_assignments WHERE id = ?");
-            verifyQuery.addBindValue(routeId);
-            if (verifyQuery.exec() && verifyQuery.next()) {
-                QString storedMetrics = verifyQuery.value(0).toString();
-                qDebug() << "  Performance metrics updated for route" << routeId;
-                qDebug() << " Stored metrics:" << storedMetrics.left(100) << "..."; // Truncate for logging
-            }
-
-            qDebug() << "  Performance metrics update completed in" << timer.elapsed() << "ms";
-            return true;
-        } else {
-            qWarning() << " Performance metrics update failed:" << query.lastError().text();
-            db.rollback();
-            return false;
-        }
-    } else {
-        qWarning() << " Performance metrics query execution failed:" << query.lastError().text();
-        db.rollback();
-        return false;
-    }
+    qDebug() << "  Performance metrics queued in" << timer.elapsed() << "ms";
+    return true;
 }
 
 QVariantMap DatabaseManager::getRouteAssignment(const QString& routeId) {
@@ -2901,7 +3968,7 @@ QVariantMap DatabaseManager::getRouteAssignment(const QString& routeId) {
                assigned_circuits, overlap_circuits, state,
                created_at, activated_at, released_at,
                locked_point_machines, priority, operator_id,
-               failure_reason, performance_metrics
+               failure_reason, performance_metrics, version
         FROM railway_control.route_assignments
         WHERE id = ?
     )");
@@ -2923,6 +3990,7 @@ QVariantMap DatabaseManager::getRouteAssignment(const QString& routeId) {
         route["operatorId"] = query.value("operator_id").toString();
         route["failureReason"] = query.value("failure_reason").toString();
         route["performanceMetrics"] = query.value("performance_metrics").toString();
+        route["version"] = query.value("version").toInt();
     } else if (!query.exec()) {
         logError("getRouteAssignment", query.lastError());
     }
@@ -3078,18 +4146,8 @@ bool DatabaseManager::deleteRouteAssignment(const QString& routeId, bool forceDe
     if (query.exec() && query.next()) {
         success = query.value(0).toBool();
         if (success && db.commit()) {
-            // Verify deletion
-            QSqlQuery verifyQuery(db);
-            verifyQuery.prepare("SELECT COUNT(*) FROM railway_control.route_assignments WHERE id = ?");
-            verifyQuery.addBindValue(routeId);
-            if (verifyQuery.exec() && verifyQuery.next()) {
-                int remainingCount = verifyQuery.value(0).toInt();
-                if (remainingCount == 0) {
-                    qDebug() << "  SAFETY: Route" << routeId << "successfully deleted";
-                } else {
-                    qWarning() << " Unexpected: Route still exists after deletion";
-                }
-            }
+            qDebug() << "  SAFETY: Route" << routeId << "successfully deleted";
+            diagnosticReread("deleted route " + routeId, "SELECT COUNT(*) AS remaining FROM railway_control.route_assignments WHERE id = ?", {routeId});
 
             // Emit success signals
             emit routeDeleted(routeId); // You may need to add this signal to header
@@ -3145,79 +4203,24 @@ bool DatabaseManager::insertRouteEvent(
         return false;
     }
 
-    // Convert event data to JSON
-    QJsonDocument jsonDoc = QJsonDocument::fromVariant(eventData);
-    QString jsonString = jsonDoc.toJson(QJsonDocument::Compact);
-
-    // Log event details for debugging
-    qDebug() << "Event details:";
-    qDebug() << "   Type:" << eventType;
-    qDebug() << "   Operator:" << (operatorId.isEmpty() ? "system" : operatorId);
-    qDebug() << "   Source:" << (sourceComponent.isEmpty() ? "DatabaseManager" : sourceComponent);
-    qDebug() << "   Critical:" << safetyCritical;
-    qDebug() << "   Response Time:" << responseTimeMs << "ms";
-    qDebug() << "   Data:" << jsonString.left(200) << (jsonString.length() > 200 ? "..." : "");
+    //   TELEMETRY: routeEventLogged is emitted once the writer has committed the event
+    TelemetryWriter::RouteEvent event;
+    event.routeId = routeId;
+    event.eventType = eventType;
+    event.eventData = eventData;
+    event.operatorId = operatorId;
+    event.sourceComponent = sourceComponent;
+    event.correlationId = correlationId;
+    event.responseTimeMs = responseTimeMs;
+    event.safetyCritical = safetyCritical;
 
-    // Database transaction for route event insertion
-    QSqlQuery query(db);
-
-    if (!db.transaction()) {
-        qWarning() << " Failed to start transaction for route event:" << db.lastError().text();
+    if (!m_telemetryWriter->enqueueRouteEvent(std::move(event))) {
+        qWarning() << " Route event" << eventType << "not buffered for route" << routeId;
         return false;
     }
 
-    //   POLICY: Call SQL function instead of direct INSERT
-    query.prepare("SELECT railway_control.insert_route_event(?, ?, ?::jsonb, ?, ?, ?, ?, ?)");
-    query.addBindValue(routeId);
-    query.addBindValue(eventType);
-    query.addBindValue(jsonString.isEmpty() ? "{}" : jsonString);
-    query.addBindValue(operatorId.isEmpty() ? QVariant(QVariant::String) : operatorId);
-    query.addBindValue(sourceComponent.isEmpty() ? QVariant(QVariant::String) : sourceComponent);
-    query.addBindValue(correlationId.isEmpty() ? QVariant(QVariant::String) : correlationId);
-    query.addBindValue(responseTimeMs > 0.0 ? responseTimeMs : QVariant(QVariant::Double));
-    query.addBindValue(safetyCritical);
-
-    bool success = false;
-    if (query.exec() && query.next()) {
-        success = query.value(0).toBool();
-        if (success && db.commit()) {
-            // Verify event was logged (optional for performance)
-            if (safetyCritical) {
-                QSqlQuery verifyQuery(db);
-                verifyQuery.prepare(R"(
-                    SELECT event_timestamp, sequence_number
-                    FROM railway_control.route_events
-                    WHERE route_id = ? AND event_type = ?
-                    ORDER BY event_timestamp DESC LIMIT 1
-                )");
-                verifyQuery.addBindValue(routeId);
-                verifyQuery.addBindValue(eventType);
-                if (verifyQuery.exec() && verifyQuery.next()) {
-                    QString timestamp = verifyQuery.value(0).toString();
-                    qint64 sequenceNum = verifyQuery.value(1).toLongLong();
-                    qDebug() << "  SAFETY: Critical event logged at" << timestamp << "sequence:" << sequenceNum;
-                }
-            }
-
-            // Emit success signal
-            emit routeEventLogged(routeId, eventType);
-
-            if (safetyCritical) {
-                qDebug() << "  Safety-critical route event logged in" << timer.elapsed() << "ms";
-            } else {
-                qDebug() << "  Route event logged in" << timer.elapsed() << "ms";
-            }
-            return true;
-        } else {
-            qWarning() << " Route event insertion failed:" << query.lastError().text();
-            db.rollback();
-            return false;
-        }
-    } else {
-        qWarning() << " Route event query execution failed:" << query.lastError().text();
-        db.rollback();
-        return false;
-    }
+    qDebug() << "  Route event queued in" << timer.elapsed() << "ms";
+    return true;
 }
 
 QVariantList DatabaseManager::getRouteEvents(const QString& routeId, int limitHours) {
@@ -3338,27 +4341,13 @@ bool DatabaseManager::insertResourceLock(
     if (query.exec() && query.next()) {
         success = query.value(0).toBool();
         if (success && db.commit()) {
-            // Verify lock was acquired
-            QSqlQuery verifyQuery(db);
-            verifyQuery.prepare(R"(
+            qDebug() << "  SAFETY: Resource lock acquired:" << resourceType << resourceId;
+            diagnosticReread("resource lock " + resourceId, R"(
                 SELECT id, acquired_at, lock_type
                 FROM railway_control.resource_locks
                 WHERE resource_type = ? AND resource_id = ? AND route_id = ? AND is_active = TRUE
                 ORDER BY acquired_at DESC LIMIT 1
-            )");
-            verifyQuery.addBindValue(resourceType);
-            verifyQuery.addBindValue(resourceId);
-            verifyQuery.addBindValue(routeId);
-
-            if (verifyQuery.exec() && verifyQuery.next()) {
-                QString lockId = verifyQuery.value(0).toString();
-                QString acquiredAt = verifyQuery.value(1).toString();
-                QString verifiedLockType = verifyQuery.value(2).toString();
-                qDebug() << "  SAFETY: Resource lock acquired";
-                qDebug() << "   Lock ID:" << lockId;
-                qDebug() << "   Acquired at:" << acquiredAt;
-                qDebug() << "   Lock type:" << verifiedLockType;
-            }
+            )", {resourceType, resourceId, routeId});
 
             // Emit success signal
             emit resourceLockAcquired(routeId, resourceType, resourceId);
@@ -3450,29 +4439,16 @@ bool DatabaseManager::releaseResourceLocks(const QString& routeId) {
         int locksReleased = query.value(0).toInt();
 
         if (db.commit()) {
-            // Verify locks were released
-            QSqlQuery verifyQuery(db);
-            verifyQuery.prepare(R"(
-                SELECT COUNT(*) as active_locks,
+            // The function's count is the outcome; the lock table is only re-read in diagnostic mode
+            qDebug() << "  SAFETY: Locks released:" << locksReleased << "of" << expectedLockCount << "expected";
+            diagnosticReread("resource locks for route " + routeId, R"(
+                SELECT COUNT(*) FILTER (WHERE is_active = TRUE) as active_locks,
                        COUNT(*) FILTER (WHERE is_active = FALSE) as released_locks
                 FROM railway_control.resource_locks
                 WHERE route_id = ?
-            )");
-            verifyQuery.addBindValue(routeId);
-
-            if (verifyQuery.exec() && verifyQuery.next()) {
-                int activeLocks = verifyQuery.value(0).toInt();
-                int releasedLocks = verifyQuery.value(1).toInt();
-                qDebug() << "  SAFETY: Lock release verification:";
-                qDebug() << "   Locks released:" << locksReleased;
-                qDebug() << "   Active locks remaining:" << activeLocks;
-                qDebug() << "   Total released locks:" << releasedLocks;
-
-                success = (locksReleased > 0 || expectedLockCount == 0);
-            } else {
-                // If verification fails, still consider successful if function returned > 0
-                success = (locksReleased >= 0);
-            }
+            )", {routeId});
+
+            success = (locksReleased > 0 || expectedLockCount == 0);
 
             if (success) {
                 // Emit success signal
@@ -3485,7 +4461,7 @@ bool DatabaseManager::releaseResourceLocks(const QString& routeId) {
                 }
                 return true;
             } else {
-                qWarning() << " Lock release verification failed";
+                qWarning() << " Lock release failed: no locks released although" << expectedLockCount << "were active";
                 return false;
             }
         } else {
@@ -18,8 +18,16 @@
 #include <QFileInfo>
 #include <QDateTime>
 #include <QElapsedTimer>
+#include "CommandJournal.h"
+#include "../core/Clock.h"
 
 class InterlockingService;
+struct ValidationRequest;
+struct ValidationReadSet;
+struct ReadSetVersions;
+class TrackCircuitFilter;
+class StationEventBus;
+class TelemetryWriter;
 
 class DatabaseManager : public QObject {
     Q_OBJECT
@@ -40,6 +48,11 @@ public:
     ~DatabaseManager();
 
     void setInterlockingService(InterlockingService* service);
+    StationEventBus* eventBus() const { return m_eventBus.get(); }
+
+    // Time source for polling, health checks and the occupancy filter (set before startPolling)
+    void setClock(Clock* clock);
+    Clock* clock() const { return m_clock; }
     QSqlDatabase getDatabase() const;
     QString getCurrentSignalAspect(const QString& signalId);
 
@@ -59,12 +72,39 @@ public:
     // Real-time notifications
     Q_INVOKABLE void enableRealTimeUpdates();
 
+    // Diagnostic mode: re-read rows after each command commit (also RAILFLUX_DB_DIAGNOSTICS=1)
+    Q_INVOKABLE void setDiagnosticVerification(bool enabled);
+    Q_INVOKABLE bool isDiagnosticVerificationEnabled() const { return m_diagnosticVerification; }
+
+    // Server-side validate-and-apply: after the C++ interlocking validation passes, main signal and
+    // point commands are checked again against the installed rule replica and written in one
+    // statement under row locks, as a compare-and-set on the validated versions (also RAILFLUX_SERVER_VALIDATION=1)
+    Q_INVOKABLE bool setServerSideValidation(bool enabled);
+    Q_INVOKABLE bool isServerSideValidationEnabled() const { return m_serverSideValidation; }
+
+    // Command journal: operator signal/point commands are acknowledged once durable in a local
+    // group-committed journal and shipped to PostgreSQL in the background (also RAILFLUX_COMMAND_JOURNAL=1).
+    // Server-side validation, when enabled, applies the commands it covers synchronously instead.
+    Q_INVOKABLE bool setCommandJournal(bool enabled);
+    Q_INVOKABLE bool isCommandJournalEnabled() const { return m_commandJournal && m_commandJournal->isOpen(); }
+    // Acknowledged commands not yet in the database; empty when the journal is off
+    CommandJournal::PendingState pendingJournalState() const {
+        return isCommandJournalEnabled() ? m_commandJournal->pendingState() : CommandJournal::PendingState();
+    }
+
     // STREAMLINED: Track Segment Circuit operations (primary occupancy management)
     Q_INVOKABLE QVariantList getTrackCircuitsList();
     Q_INVOKABLE bool updateTrackCircuitOccupancy(const QString& trackCircuitId, bool isOccupied);
     Q_INVOKABLE bool getTrackCircuitOccupancy(const QString& trackCircuitId);
     Q_INVOKABLE QVariantMap getAllTrackCircuitStates();
 
+    // FLICKER FILTER: Empty circuitId configures the default for all circuits
+    Q_INVOKABLE bool configureTrackCircuitFilter(const QString& circuitId, const QVariantMap& config);
+    Q_INVOKABLE QVariantMap getTrackCircuitFlickerStatistics(const QString& circuitId = QString()) const;
+
+    // LAYOUT: Circuit sections from the generated station tables (no database read)
+    QStringList trackSegmentsForCircuit(const QString& trackCircuitId) const;
+
     // STREAMLINED: Track Segment Segment operations (UI and physical layout)
     Q_INVOKABLE QVariantList getTrackSegmentsList();
     Q_INVOKABLE QVariantList getTrackSegmentsByCircuitId(const QString& trackCircuitId);
@@ -90,6 +130,12 @@ public:
 
     // Text Labels
     Q_INVOKABLE QVariantList getTextLabelsList();
+
+    // Station snapshot: every entity type in one round trip. sinceSeq <= 0 loads the whole
+    // station; otherwise only rows changed since the seq watermark an earlier call returned
+    // (rows may be re-delivered, never skipped). Returns { seq, full, trackCircuits,
+    // trackSegments, signals, pointMachines, textLabels } using the list methods' field names.
+    Q_INVOKABLE QVariantMap getStationSnapshot(qint64 sinceSeq = 0);
     Q_INVOKABLE QStringList getInterlockedSignals(const QString& signalId);
 
     // === NEW: TRIPLE-SOURCE PROTECTION SIGNAL QUERIES ===
@@ -98,6 +144,8 @@ public:
     QStringList getProtectingSignalsFromTrackSegments(const QString& trackSegmentId);
     QString getCircuitIdByTrackSegmentId(const QString& trackSegmentId);
     QStringList getProtectedTrackCircuitsFromInterlockingRules(const QString& signalId);
+    //   Every signal's rule-protected circuits in one query (signal id -> circuit ids)
+    QHash<QString, QStringList> getAllProtectedTrackCircuitsFromInterlockingRules();
 
     QVariantMap getTrackCircuitById(const QString& circuitId);
 
@@ -119,6 +167,14 @@ public:
         int priority,
         const QString& operatorId
     );
+
+    //   ROUTE BATCH: Moves each route's points, sets its signals and records it ACTIVE, all in
+    //   one transaction. Every command is re-checked by the server under its row lock. Each
+    //   route runs under its own savepoint, so a route that fails rolls back alone.
+    //   Route map: { routeId, sourceSignalId, destSignalId, direction, assignedCircuits,
+    //   overlapCircuits, pointMoves: [{machineId, position}], signalAspects: [{signalId, aspect}],
+    //   priority }. Returns one { routeId, success, error } per route, in order.
+    QVariantList applyRouteBatch(const QVariantList& routes, const QString& operatorId);
     
     Q_INVOKABLE bool updateRouteState(
         const QString& routeId,
@@ -185,26 +241,13 @@ signals:
     void operationBlocked(const QString& entityId, const QString& reason);
     void pollingIntervalChanged(int newInterval);
 
-    //  Consistent track segment signals
+    // BATCHED: Emitted at most once per event-bus flush; per-entity changes travel on eventBus()
     void trackSegmentsChanged();
-    void trackSegmentUpdated(const QString& trackSegmentId);
-
-    // NEW: Track Segment circuit signals
     void trackCircuitsChanged();
-    void trackCircuitUpdated(const QString& trackCircuitId);
-
-    // Signal change signals
     void signalsChanged();
-    void signalUpdated(const QString& signalId);
-    void signalStateChanged(int signalId, const QString& newState);  // KEPT: Legacy
-
-    // Point machine signals
     void pointMachinesChanged();
-    void pointMachineUpdated(const QString& machineId);
-    void pointMachineStateChanged(int machineId, const QString& newPosition);  // KEPT: Legacy
 
-    // Track Segment circuit state (for legacy compatibility)
-    void trackCircuitStateChanged(int circuitId, bool isOccupied);
+    void trackCircuitFlickerChanged(const QString& trackCircuitId, bool isFlickering);
 
     // Text labels
     void textLabelsChanged();
@@ -235,13 +278,32 @@ private:
     static constexpr int POLLING_INTERVAL_FAST = 400000;     //  Real production values
     static constexpr int POLLING_INTERVAL_SLOW = 500000;   //  Real production values
 
+    // Post-connect setup shared by system and portable modes; fails on a config lookup mismatch
+    bool completeConnectionSetup();
+
     // Services
     InterlockingService* m_interlockingService = nullptr;
 
+    // Typed change records for in-process subscribers
+    std::unique_ptr<StationEventBus> m_eventBus;
+
+    // Raw occupancy inputs are debounced here before they reach the database
+    std::unique_ptr<TrackCircuitFilter> m_trackCircuitFilter;
+
+    // Route events and performance metrics are batched on a background connection
+    std::unique_ptr<TelemetryWriter> m_telemetryWriter;
+
+    // Durable local journal for operator commands (opened once connected, when enabled)
+    std::unique_ptr<CommandJournal> m_commandJournal;
+
     // Database connection
     QSqlDatabase db;
-    std::unique_ptr<QTimer> pollingTimer;
+    Clock* m_clock = Clock::system();
+    std::unique_ptr<ClockTimer> pollingTimer;
     bool connected;
+    bool m_diagnosticVerification = false;
+    bool m_serverSideValidation = false;
+    bool m_commandJournalEnabled = false;
     bool m_isConnected = false;
     QString m_connectionStatus = "Not Connected";
 
@@ -249,7 +311,7 @@ private:
     bool m_notificationsEnabled = false;
     bool m_notificationsWorking = false;
     QDateTime m_lastNotificationReceived;
-    QTimer* m_notificationHealthTimer = nullptr;
+    ClockTimer* m_notificationHealthTimer = nullptr;
 
     // Portable PostgreSQL
     QProcess* m_postgresProcess = nullptr;
@@ -260,14 +322,35 @@ private:
     int m_systemPort = 5432;
 
     // State tracking for polling
-    QHash<int, QString> lastSignalStates;
-    QHash<int, bool> lastTrackSegmentStates;  // Now trackSegments circuit states
-    QHash<int, QString> lastPointStates;
+    QHash<QString, int> lastSignalAspects;
+    QHash<QString, bool> lastTrackCircuitStates;
+    QHash<QString, int> lastPointPositions;
+    qint64 m_snapshotSeq = 0;
 
     // Private methods
-    void detectAndEmitChanges();
+    bool detectAndEmitChanges();
     void checkNotificationHealth();
     void logError(const QString& operation, const QSqlError& error);
+    void diagnosticReread(const QString& context, const QString& sql, const QVariantList& params);
+    bool readVersionedState(const QString& table, const QString& keyColumn, const QString& valueColumn,
+                            const QString& key, int& valueId, int& version);
+    bool claimRouteVersion(const QString& routeId, int expectedVersion);
+
+    // Validation read set: versions of the rows a validation read besides its target, taken
+    // before validating and rechecked FOR SHARE inside the write transaction, so a change to
+    // a protected circuit, controlling signal or condition point fails the command
+    bool captureReadSet(const ValidationRequest& request, ValidationReadSet& readSet, ReadSetVersions& versions);
+    bool readReadSetVersions(const ValidationReadSet& readSet, bool lockForShare, ReadSetVersions& versions);
+    bool holdReadSet(const QString& entityId, const ValidationReadSet& readSet, const ReadSetVersions& expected);
+
+    bool installServerSideRules();
+    bool applyMainSignalAspectOnServer(const QString& signalId, const QString& newAspect, int expectedVersion,
+                                       const ValidationReadSet& readSet, const ReadSetVersions& readSetVersions);
+    bool applyPointMachinePositionOnServer(const QString& machineId, const QString& newPosition,
+                                           int expectedVersion, const QVariant& expectedPairedVersion,
+                                           const ValidationReadSet& readSet, const ReadSetVersions& readSetVersions);
+    bool journalCommand(CommandJournal::Command command);
+    void republishRejectedEntity(CommandJournal::CommandKind kind, const QString& entityId);
 
     // Database setup
     bool setupDatabase();
@@ -285,8 +368,21 @@ private:
     QVariantMap convertPointMachineRowToVariant(const QSqlQuery& query);
     QVariantMap convertTrackCircuitRowToVariant(const QSqlQuery& query);
 
+    // Snapshot row expansion (positional arrays from get_station_snapshot)
+    static QVariantMap convertSnapshotTrackCircuit(const QJsonArray& row);
+    static QVariantMap convertSnapshotTrackSegment(const QJsonArray& row);
+    static QVariantMap convertSnapshotSignal(const QJsonArray& row);
+    static QVariantMap convertSnapshotPointMachine(const QJsonArray& row);
+    static QVariantMap convertSnapshotTextLabel(const QJsonArray& row);
+
     // Current state helpers (for interlocking) - MOVED TO PUBLIC
 
+    // Filtered occupancy commits (called once TrackCircuitFilter lets a change through)
+    bool commitTrackSegmentOccupancy(const QString& trackSegmentId, bool isOccupied, qint64 inputNs = 0);
+    void reportFilteredCommit(const QString& trackCircuitId, bool isOccupied, bool success);
+    bool commitTrackCircuitOccupancy(const QString& trackCircuitId, bool isOccupied, qint64 inputNs = 0);
+    void onTrackCircuitClearConfirmed(const QString& trackCircuitId, const QString& sourceId);
+
     bool updateMainSignalAspect(const QString& signalId, const QString& newAspect);
     bool updateSubsidiarySignalAspect(const QString& signalId,
                                       const QString& aspectType,
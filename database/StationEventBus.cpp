@@ -0,0 +1,212 @@
+#include "StationEventBus.h"
+#include <QDebug>
+#include <QVariantList>
+#include <algorithm>
+
+StationEventBus::StationEventBus(QObject* parent)
+    : QObject(parent)
+    , m_ring(INITIAL_CAPACITY)
+    , m_mask(INITIAL_CAPACITY - 1)
+{
+}
+
+quint32 StationEventBus::intern(const QString& entityId) {
+    auto it = m_entityHandles.constFind(entityId);
+    if (it != m_entityHandles.constEnd()) {
+        return it.value();
+    }
+
+    const quint32 handle = static_cast<quint32>(m_entityIds.size());
+    m_entityIds.push_back(entityId);
+    m_entityHandles.insert(entityId, handle);
+    return handle;
+}
+
+//
+//   PUBLISH
+//
+
+void StationEventBus::publish(EntityKind kind, const QString& entityId, Field field, qint32 oldValue, qint32 newValue) {
+    const quint32 entity = intern(entityId);
+
+    if (!m_deferred.empty() || m_nextSequence - oldestUnread() >= m_ring.size()) {
+        if (m_flushing) {
+            //   A handler is publishing mid-flush: the ring cannot be drained or reallocated now
+            m_deferred.push_back(ChangeRecord{m_nextSequence, entity, kind, field, oldValue, newValue});
+            ++m_nextSequence;
+            scheduleFlush();
+            return;
+        }
+        ++m_synchronousFlushes;
+        flush();
+    }
+
+    //   Sequence taken after any synchronous flush: its handlers may have published records
+    const ChangeRecord record{m_nextSequence, entity, kind, field, oldValue, newValue};
+    m_ring[record.sequence & m_mask] = record;
+    ++m_nextSequence;
+    scheduleFlush();
+}
+
+void StationEventBus::scheduleFlush() {
+    if (m_flushScheduled) return;
+    m_flushScheduled = true;
+    QMetaObject::invokeMethod(this, &StationEventBus::flush, Qt::QueuedConnection);
+}
+
+quint64 StationEventBus::oldestUnread() const {
+    quint64 oldest = m_flushing ? m_flushFloor : m_nextSequence;
+    for (const Subscriber& subscriber : m_subscribers) {
+        if (!subscriber.removed) {
+            oldest = std::min(oldest, subscriber.cursor);
+        }
+    }
+    return oldest;
+}
+
+void StationEventBus::grow() {
+    const quint64 oldest = oldestUnread();
+    std::vector<ChangeRecord> ring(m_ring.size() * 2);
+    const size_t mask = ring.size() - 1;
+
+    for (quint64 sequence = oldest; sequence < m_nextSequence; ++sequence) {
+        ring[sequence & mask] = m_ring[sequence & m_mask];
+    }
+
+    m_ring.swap(ring);
+    m_mask = mask;
+    qWarning() << " [EventBus] Ring grown to" << m_ring.size() << "records";
+}
+
+//
+//   DELIVERY
+//
+
+void StationEventBus::flush() {
+    m_flushScheduled = false;
+    if (m_flushing) return;
+    m_flushFloor = oldestUnread();
+    m_flushing = true;
+
+    const quint64 head = m_nextSequence;
+    const quint64 batchSize = head - m_flushFloor;
+    if (batchSize > 0) {
+        ++m_flushCount;
+        m_maxBatch = std::max(m_maxBatch, batchSize);
+    }
+
+    //   Index loop: a handler may subscribe (appended) or unsubscribe (tombstoned, compacted below)
+    for (size_t i = 0; i < m_subscribers.size(); ++i) {
+        if (m_subscribers[i].removed) continue;
+        const quint64 from = m_subscribers[i].cursor;
+        if (from >= head) continue;
+
+        const size_t count = static_cast<size_t>(head - from);
+        const size_t start = static_cast<size_t>(from & m_mask);
+
+        Batch batch;
+        if (start + count <= m_ring.size()) {
+            batch = Batch(m_ring.data() + start, count);
+        } else {
+            //   Wrapped: hand out one contiguous span anyway
+            m_wrapScratch.assign(m_ring.begin() + static_cast<std::ptrdiff_t>(start), m_ring.end());
+            m_wrapScratch.insert(m_wrapScratch.end(), m_ring.begin(),
+                                 m_ring.begin() + static_cast<std::ptrdiff_t>(count - (m_ring.size() - start)));
+            batch = Batch(m_wrapScratch.data(), count);
+        }
+
+        m_subscribers[i].cursor = head;
+        m_subscribers[i].delivered += count;
+        ++m_subscribers[i].batches;
+
+        const BatchHandler handler = m_subscribers[i].handler;
+        handler(batch);
+    }
+
+    m_flushing = false;
+
+    m_subscribers.erase(std::remove_if(m_subscribers.begin(), m_subscribers.end(),
+                                       [](const Subscriber& subscriber) { return subscriber.removed; }),
+                        m_subscribers.end());
+
+    //   No spans are live any more: place held-back records, growing if the ring is still full
+    for (const ChangeRecord& record : m_deferred) {
+        if (record.sequence - oldestUnread() >= m_ring.size()) {
+            grow();
+        }
+        m_ring[record.sequence & m_mask] = record;
+    }
+    m_deferred.clear();
+
+    //   Records published by handlers go out in the next batch
+    if (m_nextSequence != head) {
+        scheduleFlush();
+    }
+}
+
+//
+//   SUBSCRIPTION
+//
+
+int StationEventBus::subscribe(const QString& name, BatchHandler handler) {
+    const int id = m_nextSubscriberId++;
+    m_subscribers.push_back(Subscriber{id, name, std::move(handler), m_nextSequence});
+    return id;
+}
+
+void StationEventBus::unsubscribe(int subscriberId) {
+    if (m_flushing) {
+        //   Erasing would shift the flush loop's index past the next subscriber
+        for (Subscriber& subscriber : m_subscribers) {
+            if (subscriber.id == subscriberId) {
+                subscriber.removed = true;
+            }
+        }
+        return;
+    }
+
+    m_subscribers.erase(std::remove_if(m_subscribers.begin(), m_subscribers.end(),
+                                       [subscriberId](const Subscriber& subscriber) { return subscriber.id == subscriberId; }),
+                        m_subscribers.end());
+}
+
+//
+//   VALUE CODES
+//
+
+qint32 StationEventBus::positionCode(const QString& position) {
+    if (position == QLatin1String("NORMAL")) return POSITION_NORMAL;
+    if (position == QLatin1String("REVERSE")) return POSITION_REVERSE;
+    return UNKNOWN_VALUE;
+}
+
+QString StationEventBus::positionName(qint32 code) {
+    switch (code) {
+    case POSITION_NORMAL: return QStringLiteral("NORMAL");
+    case POSITION_REVERSE: return QStringLiteral("REVERSE");
+    default: return QString();
+    }
+}
+
+QVariantMap StationEventBus::statistics() const {
+    QVariantList subscribers;
+    for (const Subscriber& subscriber : m_subscribers) {
+        if (subscriber.removed) continue;
+        QVariantMap entry;
+        entry["name"] = subscriber.name;
+        entry["delivered"] = subscriber.delivered;
+        entry["batches"] = subscriber.batches;
+        entry["lag"] = m_nextSequence - subscriber.cursor;
+        subscribers.append(entry);
+    }
+
+    QVariantMap stats;
+    stats["published"] = m_nextSequence;
+    stats["flushes"] = m_flushCount;
+    stats["maxBatch"] = m_maxBatch;
+    stats["synchronousFlushes"] = m_synchronousFlushes;
+    stats["capacity"] = static_cast<qulonglong>(m_ring.size());
+    stats["entities"] = static_cast<int>(m_entityIds.size());
+    stats["subscribers"] = subscribers;
+    return stats;
+}
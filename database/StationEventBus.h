@@ -0,0 +1,117 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QVariantMap>
+#include <functional>
+#include <span>
+#include <vector>
+
+//   STATION EVENT BUS
+//
+//   Typed change records in a ring buffer, delivered to subscribers in batches. Every
+//   change is one fixed-size record (entity handle, field, old/new value, sequence);
+//   publishing costs an append, and one queued flush per batch replaces one queued
+//   signal emission per change per receiver.
+//
+//   DELIVERY: Each subscriber keeps its own cursor and receives every record published
+//   after it subscribed exactly once, in sequence order, as one contiguous span per
+//   flush. Records are never overwritten unread: a full ring is flushed synchronously;
+//   records published by handlers during a flush that would not fit are held back and
+//   placed (growing the ring if needed) once no batch span is live.
+//
+//   Single-threaded: publish, subscribe and flush all run on the owner's (GUI) thread.
+class StationEventBus : public QObject {
+    Q_OBJECT
+
+public:
+    enum class EntityKind : quint8 {
+        Signal,
+        PointMachine,
+        TrackSegment,
+        TrackCircuit
+    };
+
+    enum class Field : quint8 {
+        Row,                //   Whole row changed, values unknown (e.g. NOTIFY without payload)
+        MainAspect,         //   AspectCode
+        CallingOnAspect,    //   AspectCode
+        LoopAspect,         //   AspectCode
+        Position,           //   POSITION_*
+        Occupancy           //   0 / 1
+    };
+
+    static constexpr qint32 UNKNOWN_VALUE = -1;
+    static constexpr qint32 POSITION_NORMAL = 0;
+    static constexpr qint32 POSITION_REVERSE = 1;
+
+    struct ChangeRecord {
+        quint64 sequence;
+        quint32 entity;         //   Handle from intern(); entityId() maps back
+        EntityKind kind;
+        Field field;
+        qint32 oldValue;
+        qint32 newValue;
+    };
+
+    using Batch = std::span<const ChangeRecord>;
+    using BatchHandler = std::function<void(Batch)>;
+
+    explicit StationEventBus(QObject* parent = nullptr);
+
+    //   ENTITY HANDLES: Stable for the life of the bus
+    quint32 intern(const QString& entityId);
+    const QString& entityId(quint32 handle) const { return m_entityIds[handle]; }
+
+    //   PUBLISH
+    void publish(EntityKind kind, const QString& entityId, Field field,
+                 qint32 oldValue = UNKNOWN_VALUE, qint32 newValue = UNKNOWN_VALUE);
+
+    //   SUBSCRIBE: Handlers see records published after this call; returns an id for unsubscribe()
+    int subscribe(const QString& name, BatchHandler handler);
+    void unsubscribe(int subscriberId);
+
+    static qint32 positionCode(const QString& position);
+    static QString positionName(qint32 code);
+
+    Q_INVOKABLE QVariantMap statistics() const;
+
+public slots:
+    void flush();
+
+private:
+    static constexpr size_t INITIAL_CAPACITY = 1024;   //   Power of two
+
+    struct Subscriber {
+        int id;
+        QString name;
+        BatchHandler handler;
+        quint64 cursor;             //   Next sequence to deliver
+        quint64 delivered = 0;
+        quint64 batches = 0;
+        bool removed = false;       //   Unsubscribed mid-flush; dropped when the flush ends
+    };
+
+    quint64 oldestUnread() const;
+    void grow();
+    void scheduleFlush();
+
+    std::vector<ChangeRecord> m_ring;
+    size_t m_mask;
+    quint64 m_nextSequence = 0;
+
+    std::vector<Subscriber> m_subscribers;
+    int m_nextSubscriberId = 1;
+    bool m_flushScheduled = false;
+    bool m_flushing = false;
+    quint64 m_flushFloor = 0;                   //   Oldest record a live batch span may point at
+    std::vector<ChangeRecord> m_wrapScratch;
+    std::vector<ChangeRecord> m_deferred;
+
+    std::vector<QString> m_entityIds;
+    QHash<QString, quint32> m_entityHandles;
+
+    quint64 m_flushCount = 0;
+    quint64 m_maxBatch = 0;
+    quint64 m_synchronousFlushes = 0;
+};
@@ -0,0 +1,412 @@
+#include "TelemetryWriter.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QDebug>
+#include <QSet>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+
+namespace {
+const QString WRITER_CONNECTION_NAME = QStringLiteral("telemetry_writer_connection");
+
+QJsonValue optionalString(const QString& value) {
+    return value.isEmpty() ? QJsonValue(QJsonValue::Null) : QJsonValue(value);
+}
+}
+
+TelemetryWriter::TelemetryWriter(QObject* parent)
+    : QObject(parent) {
+}
+
+TelemetryWriter::~TelemetryWriter() {
+    stop();
+}
+
+//
+//   LIFECYCLE
+//
+
+bool TelemetryWriter::start(const QString& databaseConnectionName) {
+    if (isRunning()) {
+        return true;
+    }
+
+    if (databaseConnectionName.isEmpty()) {
+        qWarning() << " Telemetry writer not started: no database connection to clone";
+        return false;
+    }
+
+    m_sourceConnectionName = databaseConnectionName;
+    m_running.store(true, std::memory_order_release);
+    m_writerThread = std::thread(&TelemetryWriter::runWriter, this);
+
+    qDebug() << "  Telemetry writer started (batch" << FLUSH_BATCH_SIZE << "/" << FLUSH_INTERVAL_MS << "ms)";
+    return true;
+}
+
+void TelemetryWriter::stop() {
+    if (!m_running.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    m_bufferReady.notify_all();
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+
+    qDebug() << "  Telemetry writer stopped after" << writtenEvents() << "events," << droppedEvents() << "dropped,"
+             << deadLetteredEvents() << "dead-lettered";
+}
+
+//
+//   ENQUEUE
+//
+
+bool TelemetryWriter::enqueueRouteEvent(RouteEvent event) {
+    if (!isRunning()) {
+        return false;
+    }
+
+    std::size_t buffered = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_bufferMutex);
+        if (!admitLocked(event, m_events.size())) {
+            return false;
+        }
+        m_events.push_back(std::move(event));
+        buffered = m_events.size();
+    }
+
+    //   SIZE THRESHOLD: The first record arms the timer, a full batch flushes immediately
+    if (buffered == 1 || buffered >= static_cast<std::size_t>(FLUSH_BATCH_SIZE)) {
+        m_bufferReady.notify_one();
+    }
+    return true;
+}
+
+bool TelemetryWriter::enqueuePerformanceMetrics(const QString& routeId, const QVariantMap& metrics,
+                                                const QString& operatorId) {
+    if (!isRunning()) {
+        return false;
+    }
+
+    bool first = false;
+    {
+        std::lock_guard<std::mutex> lock(m_bufferMutex);
+        first = m_events.empty() && m_metrics.isEmpty();
+        PendingMetrics& pending = m_metrics[routeId];
+        pending.metrics.insert(metrics);
+        pending.operatorId = operatorId;
+    }
+
+    if (first) {
+        m_bufferReady.notify_one();
+    }
+    return true;
+}
+
+bool TelemetryWriter::admitLocked(const RouteEvent& event, std::size_t buffered) {
+    const int limit = event.safetyCritical ? MAX_BUFFERED_EVENTS : MAX_BUFFERED_EVENTS - SAFETY_RESERVED_EVENTS;
+    if (buffered < static_cast<std::size_t>(limit)) {
+        return true;
+    }
+
+    const quint64 dropped = m_droppedEvents.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (event.safetyCritical) {
+        qCritical() << " Telemetry buffer full - dropped safety-critical" << event.eventType << "for route" << event.routeId;
+    } else if (dropped == 1 || dropped % 1000 == 0) {
+        qWarning() << " Telemetry buffer full - dropped" << dropped << "route events so far";
+    }
+    return false;
+}
+
+int TelemetryWriter::bufferedEvents() const {
+    std::lock_guard<std::mutex> lock(m_bufferMutex);
+    return static_cast<int>(m_events.size()) + static_cast<int>(m_metrics.size());
+}
+
+//
+//   WRITER THREAD
+//
+
+void TelemetryWriter::runWriter() {
+    {
+        //   THREAD AFFINITY: QSqlDatabase handles may only be used by the thread that opened them
+        QSqlDatabase db = QSqlDatabase::cloneDatabase(m_sourceConnectionName, WRITER_CONNECTION_NAME);
+        if (!db.open()) {
+            qWarning() << " Telemetry writer connection failed:" << db.lastError().text();
+        }
+
+        auto running = [this]() { return m_running.load(std::memory_order_acquire); };
+        auto hasWork = [this]() { return !m_events.empty() || !m_metrics.isEmpty(); };
+
+        std::unique_lock<std::mutex> lock(m_bufferMutex);
+        while (true) {
+            m_bufferReady.wait(lock, [&]() { return !running() || hasWork(); });
+
+            //   TIME THRESHOLD: Let a partial batch fill for up to FLUSH_INTERVAL_MS
+            if (running() && m_events.size() < static_cast<std::size_t>(FLUSH_BATCH_SIZE)) {
+                m_bufferReady.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS), [&]() {
+                    return !running() || m_events.size() >= static_cast<std::size_t>(FLUSH_BATCH_SIZE);
+                });
+            }
+
+            if (!hasWork()) {
+                if (!running()) break;
+                continue;
+            }
+
+            std::vector<RouteEvent> events;
+            QHash<QString, PendingMetrics> metrics;
+            events.swap(m_events);
+            metrics.swap(m_metrics);
+            const bool finalFlush = !running();
+            lock.unlock();
+
+            QString error;
+            std::vector<RouteEvent> failedEvents;
+            QHash<QString, PendingMetrics> failedMetrics;
+            const bool written = (db.isOpen() || db.open())
+                                 && writeBatch(db, events, metrics, failedEvents, failedMetrics, error);
+            if (written) {
+                m_writtenEvents.fetch_add(events.size(), std::memory_order_relaxed);
+                for (const RouteEvent& event : events) {
+                    emit routeEventWritten(event.routeId, event.eventType);
+                }
+                if (!failedEvents.empty() || !failedMetrics.isEmpty()) {
+                    qWarning() << " Telemetry:" << failedEvents.size() + failedMetrics.size()
+                               << "rows not written:" << error;
+                    emit writeFailed(error);
+                }
+            } else {
+                if (error.isEmpty()) error = db.lastError().text();
+                qWarning() << " Telemetry batch of" << events.size() << "events not written:" << error;
+                emit writeFailed(error);
+            }
+
+            lock.lock();
+            if (written) {
+                //   Rows that failed alone go round again until they run out of attempts
+                if (finalFlush) {
+                    deadLetter(failedEvents, failedMetrics);
+                    continue;
+                }
+                requeue(failedEvents, failedMetrics);
+                continue;
+            }
+            if (finalFlush) {
+                break;
+            }
+
+            requeue(events, metrics);
+            m_bufferReady.wait_for(lock, std::chrono::milliseconds(RETRY_BACKOFF_MS), [&]() { return !running(); });
+        }
+        lock.unlock();
+
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(WRITER_CONNECTION_NAME);
+}
+
+void TelemetryWriter::requeue(std::vector<RouteEvent>& events, QHash<QString, PendingMetrics>& metrics) {
+    //   Rows out of attempts leave here; the rest keep their count
+    std::vector<RouteEvent> exhaustedEvents;
+    QHash<QString, PendingMetrics> exhaustedMetrics;
+
+    //   Older events go back in front; the buffer limits still apply
+    std::vector<RouteEvent> merged;
+    merged.reserve(events.size() + m_events.size());
+    for (RouteEvent& event : events) {
+        if (event.attempts >= MAX_WRITE_ATTEMPTS) {
+            exhaustedEvents.push_back(std::move(event));
+        } else if (admitLocked(event, merged.size() + m_events.size())) {
+            merged.push_back(std::move(event));
+        }
+    }
+    for (RouteEvent& event : m_events) {
+        merged.push_back(std::move(event));
+    }
+    m_events.swap(merged);
+
+    //   Metrics queued since the failed write are newer: their keys win
+    for (auto it = metrics.begin(); it != metrics.end(); ++it) {
+        if (it->attempts >= MAX_WRITE_ATTEMPTS) {
+            exhaustedMetrics.insert(it.key(), *it);
+            continue;
+        }
+        PendingMetrics& current = m_metrics[it.key()];
+        QVariantMap combined = it->metrics;
+        combined.insert(current.metrics);
+        current.metrics = combined;
+        current.attempts = std::max(current.attempts, it->attempts);
+        if (current.operatorId.isEmpty()) current.operatorId = it->operatorId;
+    }
+
+    deadLetter(exhaustedEvents, exhaustedMetrics);
+}
+
+void TelemetryWriter::deadLetter(std::vector<RouteEvent>& events, QHash<QString, PendingMetrics>& metrics) {
+    //   DEAD LETTER: The log keeps what the database would not take
+    for (const RouteEvent& event : events) {
+        qCritical() << " Telemetry: route event dropped after" << event.attempts << "failed writes -"
+                    << event.routeId << event.eventType << QJsonObject::fromVariantMap(event.eventData);
+    }
+    for (auto it = metrics.cbegin(); it != metrics.cend(); ++it) {
+        qCritical() << " Telemetry: metrics dropped after" << it->attempts << "failed writes -"
+                    << it.key() << QJsonObject::fromVariantMap(it->metrics);
+    }
+    m_deadLetteredEvents.fetch_add(events.size() + metrics.size(), std::memory_order_relaxed);
+    events.clear();
+    metrics.clear();
+}
+
+bool TelemetryWriter::writeBatch(QSqlDatabase& db, std::vector<RouteEvent>& events,
+                                 QHash<QString, PendingMetrics>& metrics, std::vector<RouteEvent>& failedEvents,
+                                 QHash<QString, PendingMetrics>& failedMetrics, QString& error) {
+    if (!db.transaction()) {
+        error = db.lastError().text();
+        return false;
+    }
+
+    //   SAVEPOINT per statement: a failing statement is undone alone, not the whole transaction
+    QSqlQuery savepoint(db);
+    bool sessionFailed = false;
+    auto attempt = [&](const std::function<bool(QString&)>& statement) {
+        if (!savepoint.exec("SAVEPOINT telemetry_rows")) {
+            sessionFailed = true;
+            return false;
+        }
+        QString statementError;
+        if (statement(statementError)) {
+            savepoint.exec("RELEASE SAVEPOINT telemetry_rows");
+            return true;
+        }
+        if (!savepoint.exec("ROLLBACK TO SAVEPOINT telemetry_rows")) {
+            sessionFailed = true;
+        }
+        error = statementError;
+        return false;
+    };
+
+    //   SET-BASED first; on failure, row by row to find the ones at fault
+    std::vector<bool> eventFailed(events.size(), false);
+    if (!events.empty()
+        && !attempt([&](QString& statementError) { return insertRouteEvents(db, events, statementError); })) {
+        for (std::size_t i = 0; i < events.size() && !sessionFailed; ++i) {
+            eventFailed[i] = !attempt([&](QString& statementError) {
+                return insertRouteEvents(db, std::vector<RouteEvent>{events[i]}, statementError);
+            });
+        }
+    }
+
+    QSet<QString> metricsFailed;
+    if (!metrics.isEmpty() && !sessionFailed
+        && !attempt([&](QString& statementError) { return updateMetrics(db, metrics, statementError); })) {
+        for (auto it = metrics.cbegin(); it != metrics.cend() && !sessionFailed; ++it) {
+            if (!attempt([&](QString& statementError) {
+                    return updateMetrics(db, QHash<QString, PendingMetrics>{{it.key(), *it}}, statementError);
+                })) {
+                metricsFailed.insert(it.key());
+            }
+        }
+    }
+
+    if (sessionFailed || !db.commit()) {
+        if (error.isEmpty()) error = db.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    //   Committed: split off the rows that failed on their own
+    std::vector<RouteEvent> written;
+    written.reserve(events.size());
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        if (eventFailed[i]) {
+            ++events[i].attempts;
+            failedEvents.push_back(std::move(events[i]));
+        } else {
+            written.push_back(std::move(events[i]));
+        }
+    }
+    events.swap(written);
+
+    for (const QString& routeId : metricsFailed) {
+        PendingMetrics failed = metrics.take(routeId);
+        ++failed.attempts;
+        failedMetrics.insert(routeId, failed);
+    }
+    return true;
+}
+
+//   Columns are cast to insert_route_event's parameter types so the call resolves to the
+//   function however jsonb_to_recordset typed them
+bool TelemetryWriter::insertRouteEvents(QSqlDatabase& db, const std::vector<RouteEvent>& events, QString& error) {
+    QJsonArray rows;
+    for (const RouteEvent& event : events) {
+        QJsonObject row;
+        row["route_id"] = event.routeId;
+        row["event_type"] = event.eventType;
+        row["event_data"] = QJsonObject::fromVariantMap(event.eventData);
+        row["operator_id"] = optionalString(event.operatorId);
+        row["source_component"] = optionalString(event.sourceComponent);
+        row["correlation_id"] = optionalString(event.correlationId);
+        row["response_time_ms"] = event.responseTimeMs > 0.0 ? QJsonValue(event.responseTimeMs)
+                                                             : QJsonValue(QJsonValue::Null);
+        row["safety_critical"] = event.safetyCritical;
+        rows.append(row);
+    }
+
+    QSqlQuery query(db);
+    query.prepare(R"(
+        SELECT COUNT(*) FILTER (WHERE NOT railway_control.insert_route_event(
+            e.route_id::UUID, e.event_type::VARCHAR, e.event_data::JSONB, e.operator_id::VARCHAR,
+            e.source_component::VARCHAR, e.correlation_id::VARCHAR, e.response_time_ms::NUMERIC,
+            e.safety_critical::BOOLEAN))
+        FROM jsonb_to_recordset(?::jsonb) AS e(
+            route_id TEXT, event_type TEXT, event_data JSONB, operator_id TEXT,
+            source_component TEXT, correlation_id TEXT, response_time_ms DOUBLE PRECISION,
+            safety_critical BOOLEAN)
+    )");
+    query.addBindValue(QString::fromUtf8(QJsonDocument(rows).toJson(QJsonDocument::Compact)));
+
+    if (!query.exec() || !query.next()) {
+        error = query.lastError().text();
+        return false;
+    }
+    if (query.value(0).toInt() > 0) {
+        qWarning() << " Telemetry:" << query.value(0).toInt() << "route events refused by insert_route_event";
+    }
+    return true;
+}
+
+bool TelemetryWriter::updateMetrics(QSqlDatabase& db, const QHash<QString, PendingMetrics>& metrics, QString& error) {
+    QJsonArray rows;
+    for (auto it = metrics.cbegin(); it != metrics.cend(); ++it) {
+        QJsonObject row;
+        row["route_id"] = it.key();
+        row["metrics"] = QJsonObject::fromVariantMap(it->metrics);
+        row["operator_id"] = it->operatorId;
+        rows.append(row);
+    }
+
+    QSqlQuery query(db);
+    query.prepare(R"(
+        SELECT COUNT(*) FILTER (WHERE NOT railway_control.update_route_performance_metrics(
+            m.route_id::UUID, m.metrics::JSONB, m.operator_id::VARCHAR))
+        FROM jsonb_to_recordset(?::jsonb) AS m(route_id TEXT, metrics JSONB, operator_id TEXT)
+    )");
+    query.addBindValue(QString::fromUtf8(QJsonDocument(rows).toJson(QJsonDocument::Compact)));
+
+    if (!query.exec() || !query.next()) {
+        error = query.lastError().text();
+        return false;
+    }
+    if (query.value(0).toInt() > 0) {
+        qWarning() << " Telemetry:" << query.value(0).toInt() << "metrics updates matched no route";
+    }
+    return true;
+}
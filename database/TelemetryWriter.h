@@ -0,0 +1,108 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QSqlDatabase>
+#include <QString>
+#include <QVariantMap>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//   ROUTE TELEMETRY WRITER
+//
+//   Route events and performance metrics are non-vital, so they never cost the route-setting
+//   path a database round trip. Callers enqueue into an in-memory buffer and return; a writer
+//   thread on its own cloned connection flushes the buffer when it reaches FLUSH_BATCH_SIZE
+//   records or FLUSH_INTERVAL_MS after the oldest one arrived, as one set-based statement per
+//   kind (jsonb_to_recordset feeding the existing SQL functions) in one transaction.
+//
+//   ROW ISOLATION: Each statement runs under a savepoint. If a set-based statement fails, its
+//   rows are retried one by one so a single bad row cannot hold back the rest; a row that
+//   fails MAX_WRITE_ATTEMPTS times is dropped to the log and counted as dead-lettered.
+//
+//   BACKPRESSURE: The buffer holds at most MAX_BUFFERED_EVENTS events, the last
+//   SAFETY_RESERVED_EVENTS of them kept for safety-critical events; routine events beyond their
+//   share, and safety events beyond the whole buffer, are dropped and counted. Metrics are
+//   coalesced per route (later keys win), so they are bounded by the number of routes.
+class TelemetryWriter : public QObject {
+    Q_OBJECT
+
+public:
+    struct RouteEvent {
+        QString routeId;
+        QString eventType;
+        QVariantMap eventData;
+        QString operatorId;
+        QString sourceComponent;
+        QString correlationId;
+        double responseTimeMs = 0.0;
+        bool safetyCritical = false;
+        int attempts = 0;               //   Writer thread: writes this row has failed
+    };
+
+    explicit TelemetryWriter(QObject* parent = nullptr);
+    ~TelemetryWriter();
+
+    //   LIFECYCLE: stop() writes whatever is still buffered before the thread exits
+    bool start(const QString& databaseConnectionName);
+    void stop();
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    //   ENQUEUE: Never blocks on the database. Returns false only if the record was dropped.
+    bool enqueueRouteEvent(RouteEvent event);
+    bool enqueuePerformanceMetrics(const QString& routeId, const QVariantMap& metrics, const QString& operatorId);
+
+    //   MONITORING
+    quint64 writtenEvents() const { return m_writtenEvents.load(std::memory_order_relaxed); }
+    quint64 droppedEvents() const { return m_droppedEvents.load(std::memory_order_relaxed); }
+    quint64 deadLetteredEvents() const { return m_deadLetteredEvents.load(std::memory_order_relaxed); }
+    int bufferedEvents() const;
+
+signals:
+    //   Emitted from the writer thread once the event is committed
+    void routeEventWritten(const QString& routeId, const QString& eventType);
+    void writeFailed(const QString& error);
+
+private:
+    struct PendingMetrics {
+        QVariantMap metrics;
+        QString operatorId;
+        int attempts = 0;
+    };
+
+    void runWriter();
+    bool admitLocked(const RouteEvent& event, std::size_t buffered);
+    void requeue(std::vector<RouteEvent>& events, QHash<QString, PendingMetrics>& metrics);
+    void deadLetter(std::vector<RouteEvent>& events, QHash<QString, PendingMetrics>& metrics);
+
+    //   False when the transaction itself failed (nothing written). Otherwise the rows that
+    //   failed on their own are moved to failedEvents / failedMetrics with attempts counted.
+    bool writeBatch(QSqlDatabase& db, std::vector<RouteEvent>& events, QHash<QString, PendingMetrics>& metrics,
+                    std::vector<RouteEvent>& failedEvents, QHash<QString, PendingMetrics>& failedMetrics,
+                    QString& error);
+    static bool insertRouteEvents(QSqlDatabase& db, const std::vector<RouteEvent>& events, QString& error);
+    static bool updateMetrics(QSqlDatabase& db, const QHash<QString, PendingMetrics>& metrics, QString& error);
+
+    static constexpr int FLUSH_BATCH_SIZE = 256;
+    static constexpr int FLUSH_INTERVAL_MS = 250;
+    static constexpr int MAX_BUFFERED_EVENTS = 8192;
+    static constexpr int SAFETY_RESERVED_EVENTS = 1024;
+    static constexpr int MAX_WRITE_ATTEMPTS = 3;
+    static constexpr int RETRY_BACKOFF_MS = 1000;
+
+    mutable std::mutex m_bufferMutex;
+    std::condition_variable m_bufferReady;
+    std::vector<RouteEvent> m_events;
+    QHash<QString, PendingMetrics> m_metrics;
+
+    std::atomic<bool> m_running{false};
+    std::atomic<quint64> m_writtenEvents{0};
+    std::atomic<quint64> m_droppedEvents{0};
+    std::atomic<quint64> m_deadLetteredEvents{0};
+
+    QString m_sourceConnectionName;
+    std::thread m_writerThread;
+};
@@ -0,0 +1,315 @@
+#include "TrackCircuitFilter.h"
+#include "StationData.h"
+#include <QDebug>
+#include <algorithm>
+
+TrackCircuitFilter::TrackCircuitFilter(QObject* parent)
+    : QObject(parent)
+    , m_tickTimer(std::make_unique<ClockTimer>(this))
+{
+    //   Segment -> circuit mapping is fixed by the station layout
+    using namespace RailFlux::Station;
+    for (const TrackSegmentDef& segment : Generated::TRACK_SEGMENTS) {
+        if (!segment.circuitId.empty()) {
+            m_segmentCircuit.insert(toQString(segment.id), toQString(segment.circuitId));
+            m_circuitSegments[toQString(segment.circuitId)].append(toQString(segment.id));
+        }
+    }
+
+    m_tickTimer->setInterval(TICK_MS);
+    connect(m_tickTimer.get(), &ClockTimer::timeout, this, &TrackCircuitFilter::advanceWheel);
+}
+
+void TrackCircuitFilter::setClock(Clock* clock) {
+    if (!clock || clock == m_clock) return;
+
+    //   Wheel slots are relative to m_wheelTicks, so rebasing it keeps every pending delay
+    m_clock = clock;
+    m_wheelTicks = m_clock->elapsedMs() / TICK_MS;
+    m_tickTimer->setClock(clock);
+}
+
+QString TrackCircuitFilter::circuitForTrackSegment(const QString& trackSegmentId) const {
+    return m_segmentCircuit.value(trackSegmentId);
+}
+
+QStringList TrackCircuitFilter::trackSegmentsForCircuit(const QString& circuitId) const {
+    return m_circuitSegments.value(circuitId);
+}
+
+std::optional<bool> TrackCircuitFilter::committedOccupancy(const QString& circuitId) const {
+    const auto index = m_channelIndex.constFind(circuitId);
+    if (index == m_channelIndex.cend()) return std::nullopt;
+
+    switch (m_channels[index.value()].committed) {
+    case CommittedState::Occupied: return true;
+    case CommittedState::Clear: return false;
+    case CommittedState::Unknown: break;
+    }
+    return std::nullopt;
+}
+
+//
+//   RAW INPUT
+//
+
+TrackCircuitFilter::Decision TrackCircuitFilter::submit(const QString& circuitId, const QString& sourceId, bool isOccupied) {
+    Channel& channel = channelFor(circuitId);
+    const qint64 nowMs = m_clock->elapsedMs();
+    ++channel.stats.rawReports;
+
+    if (isOccupied) {
+        channel.occupiedSources.insert(sourceId);
+
+        //   SAFETY: Occupied is never delayed; it only cancels a clear that had not matured
+        if (channel.clearPending) {
+            cancelClear(channel);
+            recordGlitch(channel, nowMs);
+        }
+
+        if (channel.committed == CommittedState::Occupied) {
+            ++channel.stats.suppressed;
+            return Decision::Suppressed;
+        }
+
+        return Decision::CommitNow;
+    }
+
+    //   A circuit-level report speaks for every section; a section only for itself
+    if (sourceId == circuitId) {
+        channel.occupiedSources.clear();
+    } else {
+        channel.occupiedSources.remove(sourceId);
+    }
+
+    if (!channel.occupiedSources.isEmpty()) {
+        ++channel.stats.suppressed;
+        return Decision::Suppressed; // Another section of the circuit is still occupied
+    }
+
+    if (channel.committed == CommittedState::Clear || channel.clearPending) {
+        ++channel.stats.suppressed;
+        return Decision::Suppressed; // Already clear, or already waiting to be
+    }
+
+    //   Flicker flag lapses once a full window passes without a glitch
+    const Config& config = effectiveConfig(channel);
+    if (channel.flickering && nowMs - channel.stats.lastGlitchMs > config.glitchWindowMs) {
+        channel.flickering = false;
+        emit flickerStateChanged(channel.circuitId, false);
+    }
+
+    const int delayMs = channel.flickering ? config.flickerPickUpDelayMs : config.pickUpDelayMs;
+    if (delayMs <= 0) {
+        return Decision::CommitNow;
+    }
+
+    channel.pendingSourceId = sourceId;
+    scheduleClear(m_channelIndex.value(circuitId), delayMs);
+    return Decision::Deferred;
+}
+
+void TrackCircuitFilter::confirmCommit(const QString& circuitId, bool isOccupied) {
+    Channel& channel = channelFor(circuitId);
+    channel.committed = isOccupied ? CommittedState::Occupied : CommittedState::Clear;
+    ++channel.stats.commits;
+}
+
+void TrackCircuitFilter::rollbackCommit(const QString& circuitId) {
+    //   Committed state is left as it was, so the next report for the circuit is written again
+    Channel& channel = channelFor(circuitId);
+    ++channel.stats.failedCommits;
+    qWarning() << " [TrackCircuitFilter] Occupancy commit failed for circuit" << circuitId
+               << "- state left uncommitted";
+}
+
+TrackCircuitFilter::Channel& TrackCircuitFilter::channelFor(const QString& circuitId) {
+    auto it = m_channelIndex.constFind(circuitId);
+    if (it != m_channelIndex.constEnd()) {
+        return m_channels[it.value()];
+    }
+
+    m_channelIndex.insert(circuitId, static_cast<int>(m_channels.size()));
+    Channel& channel = m_channels.emplace_back();
+    channel.circuitId = circuitId;
+    return channel;
+}
+
+const TrackCircuitFilter::Config& TrackCircuitFilter::effectiveConfig(const Channel& channel) const {
+    return channel.hasOwnConfig ? channel.config : m_defaultConfig;
+}
+
+void TrackCircuitFilter::recordGlitch(Channel& channel, qint64 nowMs) {
+    const Config& config = effectiveConfig(channel);
+
+    if (nowMs - channel.windowStartMs > config.glitchWindowMs) {
+        channel.windowStartMs = nowMs;
+        channel.glitchesInWindow = 0;
+    }
+
+    ++channel.glitchesInWindow;
+    ++channel.stats.glitches;
+    channel.stats.lastGlitchMs = nowMs;
+
+    if (!channel.flickering && config.glitchThreshold > 0 && channel.glitchesInWindow >= config.glitchThreshold) {
+        channel.flickering = true;
+        ++channel.stats.flickerEpisodes;
+        qWarning() << " [TrackCircuitFilter] Circuit" << channel.circuitId << "flickering:"
+                   << channel.glitchesInWindow << "glitches in" << config.glitchWindowMs << "ms";
+        emit flickerStateChanged(channel.circuitId, true);
+    }
+}
+
+//
+//   TIMER WHEEL
+//
+
+void TrackCircuitFilter::scheduleClear(int channelIndex, int delayMs) {
+    if (m_pendingEntries == 0) {
+        //   Wheel was idle: resynchronise with the clock before placing the entry
+        m_wheelTicks = m_clock->elapsedMs() / TICK_MS;
+        m_tickTimer->start();
+    }
+
+    const int ticks = std::max(1, (delayMs + TICK_MS - 1) / TICK_MS);
+    const int slot = static_cast<int>((m_wheelTicks + ticks) % WHEEL_SLOTS);
+
+    Channel& channel = m_channels[channelIndex];
+    channel.clearPending = true;
+    m_wheel[slot].push_back({channelIndex, channel.generation, (ticks - 1) / WHEEL_SLOTS});
+    ++m_pendingEntries;
+}
+
+void TrackCircuitFilter::cancelClear(Channel& channel) {
+    //   Lazy cancel: the wheel entry stays put and is discarded when its slot comes round
+    channel.clearPending = false;
+    channel.pendingSourceId.clear();
+    ++channel.generation;
+}
+
+void TrackCircuitFilter::advanceWheel() {
+    const qint64 targetTicks = m_clock->elapsedMs() / TICK_MS;
+    QList<int> matured;
+
+    //   Catch up on every tick elapsed since the last timeout (the event loop may have stalled)
+    while (m_wheelTicks < targetTicks && m_pendingEntries > 0) {
+        ++m_wheelTicks;
+        std::vector<WheelEntry>& slot = m_wheel[m_wheelTicks % WHEEL_SLOTS];
+
+        auto keep = slot.begin();
+        for (WheelEntry& entry : slot) {
+            if (entry.rounds > 0) {
+                --entry.rounds;
+                *keep++ = entry;
+                continue;
+            }
+
+            --m_pendingEntries;
+            const Channel& channel = m_channels[entry.channel];
+            if (channel.clearPending && channel.generation == entry.generation) {
+                matured.append(entry.channel);
+            }
+        }
+        slot.erase(keep, slot.end());
+    }
+
+    if (m_pendingEntries == 0) {
+        m_tickTimer->stop();
+    }
+
+    //   Emit after the wheel is consistent: handlers may submit() again
+    for (int channelIndex : matured) {
+        Channel& channel = m_channels[channelIndex];
+        const QString sourceId = channel.pendingSourceId;
+
+        channel.clearPending = false;
+        channel.pendingSourceId.clear();
+
+        //   The receiver commits the clear and reports back through confirmCommit()/rollbackCommit()
+        emit clearConfirmed(channel.circuitId, sourceId);
+    }
+}
+
+//
+//   CONFIGURATION
+//
+
+void TrackCircuitFilter::setDefaultConfig(const Config& config) {
+    m_defaultConfig = config;
+}
+
+void TrackCircuitFilter::setCircuitConfig(const QString& circuitId, const Config& config) {
+    Channel& channel = channelFor(circuitId);
+    channel.config = config;
+    channel.hasOwnConfig = true;
+}
+
+TrackCircuitFilter::Config TrackCircuitFilter::circuitConfig(const QString& circuitId) const {
+    const int index = m_channelIndex.value(circuitId, -1);
+    return index < 0 ? m_defaultConfig : effectiveConfig(m_channels[index]);
+}
+
+TrackCircuitFilter::Config TrackCircuitFilter::configFromVariantMap(const QVariantMap& map, const Config& base) {
+    Config config = base;
+    config.pickUpDelayMs = std::max(0, map.value("pickUpDelayMs", base.pickUpDelayMs).toInt());
+    config.flickerPickUpDelayMs = std::max(config.pickUpDelayMs,
+                                           map.value("flickerPickUpDelayMs", base.flickerPickUpDelayMs).toInt());
+    config.glitchThreshold = std::max(0, map.value("glitchThreshold", base.glitchThreshold).toInt());
+    config.glitchWindowMs = std::max(0, map.value("glitchWindowMs", base.glitchWindowMs).toInt());
+    return config;
+}
+
+//
+//   STATISTICS
+//
+
+QVariantMap TrackCircuitFilter::circuitStatistics(const QString& circuitId) const {
+    const int index = m_channelIndex.value(circuitId, -1);
+    if (index < 0) {
+        return QVariantMap();
+    }
+
+    const Channel& channel = m_channels[index];
+    QVariantMap map;
+    map["circuitId"] = channel.circuitId;
+    map["rawReports"] = channel.stats.rawReports;
+    map["commits"] = channel.stats.commits;
+    map["failedCommits"] = channel.stats.failedCommits;
+    map["suppressed"] = channel.stats.suppressed;
+    map["glitches"] = channel.stats.glitches;
+    map["flickerEpisodes"] = channel.stats.flickerEpisodes;
+    map["isFlickering"] = channel.flickering;
+    map["clearPending"] = channel.clearPending;
+    map["msSinceLastGlitch"] = channel.stats.lastGlitchMs < 0 ? -1 : m_clock->elapsedMs() - channel.stats.lastGlitchMs;
+    return map;
+}
+
+QVariantMap TrackCircuitFilter::statistics() const {
+    QVariantMap circuits;
+    quint64 rawReports = 0;
+    quint64 commits = 0;
+    int flickering = 0;
+
+    for (const Channel& channel : m_channels) {
+        circuits[channel.circuitId] = circuitStatistics(channel.circuitId);
+        rawReports += channel.stats.rawReports;
+        commits += channel.stats.commits;
+        flickering += channel.flickering ? 1 : 0;
+    }
+
+    QVariantMap map;
+    map["rawReports"] = rawReports;
+    map["commits"] = commits;
+    map["suppressionRatio"] = rawReports == 0 ? 0.0 : 1.0 - static_cast<double>(commits) / rawReports;
+    map["flickeringCircuits"] = flickering;
+    map["pendingClears"] = m_pendingEntries;
+    map["circuits"] = circuits;
+    return map;
+}
+
+void TrackCircuitFilter::resetStatistics() {
+    for (Channel& channel : m_channels) {
+        channel.stats = Stats();
+        channel.glitchesInWindow = 0;
+    }
+}
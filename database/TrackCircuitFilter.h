@@ -0,0 +1,143 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "../core/Clock.h"
+
+//   TRACK CIRCUIT FLICKER FILTER
+//
+//   Conditions raw occupancy inputs before they are committed to the database. Each
+//   circuit is a channel with its own debounce settings:
+//     - Drop-away (clear -> occupied) is NEVER delayed: the occupied state is committed
+//       on the first raw report, so the filter cannot hide a train.
+//     - Pick-up (occupied -> clear) must read clear continuously for pickUpDelayMs before
+//       it is committed. An occupied report inside that window cancels the clear and is
+//       counted as a glitch.
+//     - A channel that glitches glitchThreshold times within glitchWindowMs is flagged as
+//       flickering and uses the longer flickerPickUpDelayMs until a window passes cleanly.
+//   Repeated reports of the state already committed (or already pending) are absorbed.
+//
+//   A circuit reads occupied while any of its sections (segment reports) does: one segment
+//   clearing while another is still occupied is absorbed, not treated as a pick-up. The
+//   committed state only changes once the caller reports the database write via
+//   confirmCommit(); after rollbackCommit() the next report is committed again.
+//
+//   Pending clears sit on a hashed timer wheel driven by one ClockTimer, so thousands of
+//   channels cost one timer and O(1) schedule/cancel. Owned and driven by the GUI thread.
+class TrackCircuitFilter : public QObject {
+    Q_OBJECT
+
+public:
+    struct Config {
+        int pickUpDelayMs = 300;
+        int flickerPickUpDelayMs = 2000;
+        int glitchThreshold = 3;
+        int glitchWindowMs = 10000;
+    };
+
+    //   Outcome of a raw report
+    enum class Decision {
+        CommitNow,      //   Caller commits the new state immediately
+        Deferred,       //   Clear scheduled; clearConfirmed() fires when it matures
+        Suppressed      //   No change to commit
+    };
+
+    explicit TrackCircuitFilter(QObject* parent = nullptr);
+
+    //   RAW INPUT: sourceId is the segment/circuit id the caller will commit against
+    Decision submit(const QString& circuitId, const QString& sourceId, bool isOccupied);
+
+    //   COMMIT OUTCOME: Report every CommitNow/clearConfirmed write once it has succeeded or failed
+    void confirmCommit(const QString& circuitId, bool isOccupied);
+    void rollbackCommit(const QString& circuitId);
+
+    //   TIME SOURCE: Debounce delays and glitch windows are measured on this clock. Set it before
+    //   raw input arrives; pending clears keep their remaining delay across a switch.
+    void setClock(Clock* clock);
+
+    //   Circuit owning a track segment (from the generated station tables); empty if none
+    QString circuitForTrackSegment(const QString& trackSegmentId) const;
+    //   Sections of a circuit, in layout order; empty for an unknown circuit
+    QStringList trackSegmentsForCircuit(const QString& circuitId) const;
+
+    //   Last state the database confirmed for the circuit; nullopt until one is committed
+    std::optional<bool> committedOccupancy(const QString& circuitId) const;
+
+    //   CONFIGURATION
+    void setDefaultConfig(const Config& config);
+    void setCircuitConfig(const QString& circuitId, const Config& config);
+    Config circuitConfig(const QString& circuitId) const;
+    static Config configFromVariantMap(const QVariantMap& map, const Config& base);
+
+    //   STATISTICS
+    QVariantMap circuitStatistics(const QString& circuitId) const;
+    QVariantMap statistics() const;
+    void resetStatistics();
+
+signals:
+    void clearConfirmed(const QString& circuitId, const QString& sourceId);
+    void flickerStateChanged(const QString& circuitId, bool isFlickering);
+
+private:
+    static constexpr int TICK_MS = 10;
+    static constexpr int WHEEL_SLOTS = 256;     //   2.56 s per revolution; longer delays wrap
+
+    enum class CommittedState : quint8 { Unknown, Clear, Occupied };
+
+    struct Stats {
+        quint64 rawReports = 0;
+        quint64 commits = 0;
+        quint64 failedCommits = 0;
+        quint64 suppressed = 0;
+        quint64 glitches = 0;
+        quint64 flickerEpisodes = 0;
+        qint64 lastGlitchMs = -1;
+    };
+
+    struct Channel {
+        QString circuitId;
+        QString pendingSourceId;
+        QSet<QString> occupiedSources;      //   Sections last reported occupied
+        CommittedState committed = CommittedState::Unknown;
+        bool clearPending = false;
+        bool flickering = false;
+        quint32 generation = 0;             //   Bumped on cancel; stale wheel entries are skipped
+        int glitchesInWindow = 0;
+        qint64 windowStartMs = 0;
+        bool hasOwnConfig = false;
+        Config config;
+        Stats stats;
+    };
+
+    struct WheelEntry {
+        int channel;
+        quint32 generation;
+        int rounds;
+    };
+
+    Channel& channelFor(const QString& circuitId);
+    const Config& effectiveConfig(const Channel& channel) const;
+    void recordGlitch(Channel& channel, qint64 nowMs);
+    void scheduleClear(int channelIndex, int delayMs);
+    void cancelClear(Channel& channel);
+    void advanceWheel();
+
+    Config m_defaultConfig;
+    std::vector<Channel> m_channels;
+    QHash<QString, int> m_channelIndex;
+    QHash<QString, QString> m_segmentCircuit;
+    QHash<QString, QStringList> m_circuitSegments;
+
+    std::array<std::vector<WheelEntry>, WHEEL_SLOTS> m_wheel;
+    int m_pendingEntries = 0;
+    qint64 m_wheelTicks = 0;
+    Clock* m_clock = Clock::system();
+    std::unique_ptr<ClockTimer> m_tickTimer;
+};
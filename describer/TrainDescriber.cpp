@@ -0,0 +1,385 @@
+#include "TrainDescriber.h"
+#include "StationData.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+TrainDescriber::TrainDescriber(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    buildBerthGraph();
+}
+
+//
+//   BERTH GRAPH
+//
+
+void TrainDescriber::buildBerthGraph() {
+    using namespace RailFlux::Station;
+
+    for (const TrackCircuitDef& circuit : Generated::TRACK_CIRCUITS) {
+        m_berthIndex.insert(toQString(circuit.id), static_cast<int>(m_berthIds.size()));
+        m_berthIds.push_back(toQString(circuit.id));
+    }
+    m_adjacency.resize(m_berthIds.size());
+    m_occupied.assign(m_berthIds.size(), false);
+    m_berthTrain.assign(m_berthIds.size(), NO_TRAIN);
+
+    auto link = [this](int a, int b) {
+        if (a < 0 || b < 0 || a == b) return;
+        if (std::find(m_adjacency[a].begin(), m_adjacency[a].end(), b) == m_adjacency[a].end()) {
+            m_adjacency[a].push_back(b);
+            m_adjacency[b].push_back(a);
+        }
+    };
+
+    auto circuitOf = [this](const TrackSegmentDef& segment) {
+        return segment.circuitId.empty() ? -1 : berthIndex(toQString(segment.circuitId));
+    };
+
+    //   Plain track: segments of different circuits whose ends abut
+    auto abuts = [](double rowA, double colA, double rowB, double colB) {
+        return std::hypot(rowA - rowB, colA - colB) <= ADJACENCY_TOLERANCE;
+    };
+
+    const auto& segments = Generated::TRACK_SEGMENTS;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        for (size_t j = i + 1; j < segments.size(); ++j) {
+            const TrackSegmentDef& a = segments[i];
+            const TrackSegmentDef& b = segments[j];
+            if (abuts(a.endRow, a.endCol, b.startRow, b.startCol) || abuts(a.startRow, a.startCol, b.endRow, b.endCol)
+                || abuts(a.startRow, a.startCol, b.startRow, b.startCol) || abuts(a.endRow, a.endCol, b.endRow, b.endCol)) {
+                link(circuitOf(a), circuitOf(b));
+            }
+        }
+    }
+
+    //   Points: root leads to both normal and reverse legs
+    QHash<QString, int> segmentCircuit;
+    for (const TrackSegmentDef& segment : segments) {
+        segmentCircuit.insert(toQString(segment.id), circuitOf(segment));
+    }
+    for (const PointMachineDef& machine : Generated::POINT_MACHINES) {
+        const int root = segmentCircuit.value(toQString(machine.root.trackSegmentId), -1);
+        link(root, segmentCircuit.value(toQString(machine.normal.trackSegmentId), -1));
+        link(root, segmentCircuit.value(toQString(machine.reverse.trackSegmentId), -1));
+    }
+
+    qDebug() << " [TrainDescriber] Berth graph:" << m_berthIds.size() << "berths";
+}
+
+//
+//   OCCUPANCY EVENTS
+//
+
+void TrainDescriber::onTrackCircuitOccupancyChanged(const QString& circuitId, bool isOccupied) {
+    const int berth = berthIndex(circuitId);
+    if (berth < 0) return;
+
+    m_occupied[berth] = isOccupied;
+    const int row = m_berthTrain[berth];
+
+    if (isOccupied) {
+        if (row != NO_TRAIN) {
+            m_trains[row].detected = true;
+            rowChanged(row);
+            return;
+        }
+
+        const int stepping = findSteppingTrain(berth);
+        if (stepping != NO_TRAIN) {
+            stepTrain(stepping, berth);
+        } else if (isBoundary(berth)) {
+            const int added = addTrain(UNKNOWN_HEADCODE, berth);
+            emit trainEntered(m_trains[added].headcode, circuitId);
+        } else {
+            emit unidentifiedOccupation(circuitId);
+        }
+        return;
+    }
+
+    if (row == NO_TRAIN) return;
+
+    //   Front berth cleared without stepping on: left the area at a boundary, otherwise lost detection
+    if (isBoundary(berth)) {
+        const QString headcode = m_trains[row].headcode;
+        removeTrain(row);
+        emit trainExited(headcode, circuitId);
+    } else {
+        m_trains[row].detected = false;
+        rowChanged(row);
+    }
+}
+
+int TrainDescriber::findSteppingTrain(int berth) const {
+    int candidate = NO_TRAIN;
+    int candidateCount = 0;
+
+    for (int neighbour : m_adjacency[berth]) {
+        const int row = m_berthTrain[neighbour];
+        if (row == NO_TRAIN) continue;
+
+        const Train& train = m_trains[row];
+        const int next = train.nextBerth();
+        if (next == berth) {
+            return row; // Routed into this berth
+        }
+        if (next < 0 && train.previousBerth != berth) {
+            candidate = row;
+            ++candidateCount;
+        }
+    }
+
+    return candidateCount == 1 ? candidate : NO_TRAIN;
+}
+
+void TrainDescriber::stepTrain(int row, int toBerth) {
+    Train& train = m_trains[row];
+    const int fromBerth = train.berth;
+
+    m_berthTrain[fromBerth] = NO_TRAIN;
+    m_berthTrain[toBerth] = row;
+
+    if (train.nextBerth() == toBerth) {
+        ++train.routeIndex;
+    }
+    train.previousBerth = fromBerth;
+    train.berth = toBerth;
+    train.detected = m_occupied[toBerth];
+    ++train.stepCount;
+    train.lastStepMs = m_clock->elapsedMs();
+
+    attachPendingRoute(row);
+    rowChanged(row);
+    emit trainStepped(train.headcode, m_berthIds[fromBerth], m_berthIds[toBerth]);
+}
+
+//
+//   ROUTES
+//
+
+void TrainDescriber::onRouteAssigned(const QString& routeId, const QString& sourceSignal, const QString& destSignal, const QStringList& path) {
+    Q_UNUSED(sourceSignal)
+    Q_UNUSED(destSignal)
+
+    std::vector<int> berths;
+    berths.reserve(path.size());
+    for (const QString& circuitId : path) {
+        const int berth = berthIndex(circuitId);
+        if (berth >= 0) berths.push_back(berth);
+    }
+    if (berths.empty()) return;
+
+    const int entry = berths.front();
+    if (m_berthTrain[entry] != NO_TRAIN) {
+        attachRoute(m_berthTrain[entry], routeId, berths);
+        return;
+    }
+
+    //   Train standing at the route's entry signal, i.e. next to the first circuit but not on the path
+    int candidate = NO_TRAIN;
+    int candidateCount = 0;
+    for (int neighbour : m_adjacency[entry]) {
+        const int row = m_berthTrain[neighbour];
+        if (row != NO_TRAIN && std::find(berths.begin(), berths.end(), neighbour) == berths.end()) {
+            candidate = row;
+            ++candidateCount;
+        }
+    }
+
+    if (candidateCount == 1) {
+        attachRoute(candidate, routeId, berths);
+    } else {
+        m_pendingRoutes.insert(entry, PendingRoute{routeId, berths});
+    }
+}
+
+void TrainDescriber::attachRoute(int row, const QString& routeId, const std::vector<int>& path) {
+    Train& train = m_trains[row];
+    const auto position = std::find(path.begin(), path.end(), train.berth);
+
+    train.routeId = routeId;
+    train.routePath = path;
+    train.routeIndex = position == path.end() ? -1 : static_cast<int>(position - path.begin());
+    m_pendingRoutes.remove(path.front());
+
+    rowChanged(row);
+}
+
+void TrainDescriber::attachPendingRoute(int row) {
+    const Train& train = m_trains[row];
+    if (train.nextBerth() >= 0) return;
+
+    auto it = m_pendingRoutes.constFind(train.berth);
+    if (it != m_pendingRoutes.constEnd()) {
+        const PendingRoute pending = it.value();
+        attachRoute(row, pending.routeId, pending.path);
+    }
+}
+
+//
+//   TRAIN LIST
+//
+
+int TrainDescriber::addTrain(const QString& headcode, int berth) {
+    const int row = static_cast<int>(m_trains.size());
+
+    beginInsertRows(QModelIndex(), row, row);
+    Train& train = m_trains.emplace_back();
+    train.id = m_nextTrainId++;
+    train.headcode = headcode;
+    train.berth = berth;
+    train.detected = m_occupied[berth];
+    train.lastStepMs = m_clock->elapsedMs();
+    m_berthTrain[berth] = row;
+    endInsertRows();
+
+    attachPendingRoute(row);
+    emit trainCountChanged();
+    return row;
+}
+
+void TrainDescriber::removeTrain(int row) {
+    const int last = static_cast<int>(m_trains.size()) - 1;
+    m_berthTrain[m_trains[row].berth] = NO_TRAIN;
+
+    //   Swap-remove keeps removal O(1): the last train takes over the vacated row
+    if (row != last) {
+        m_trains[row] = std::move(m_trains[last]);
+        m_berthTrain[m_trains[row].berth] = row;
+        rowChanged(row);
+    }
+
+    beginRemoveRows(QModelIndex(), last, last);
+    m_trains.pop_back();
+    endRemoveRows();
+
+    emit trainCountChanged();
+}
+
+void TrainDescriber::rowChanged(int row) {
+    const QModelIndex modelIndex = index(row);
+    emit dataChanged(modelIndex, modelIndex);
+}
+
+bool TrainDescriber::interposeTrain(const QString& headcode, const QString& circuitId) {
+    const int berth = berthIndex(circuitId);
+    if (berth < 0 || headcode.trimmed().isEmpty()) {
+        qWarning() << " [TrainDescriber] Cannot interpose" << headcode << "into unknown berth" << circuitId;
+        return false;
+    }
+
+    if (m_berthTrain[berth] != NO_TRAIN) {
+        return renameTrain(circuitId, headcode);
+    }
+
+    addTrain(headcode.trimmed(), berth);
+    return true;
+}
+
+bool TrainDescriber::renameTrain(const QString& circuitId, const QString& headcode) {
+    const int berth = berthIndex(circuitId);
+    if (berth < 0 || m_berthTrain[berth] == NO_TRAIN || headcode.trimmed().isEmpty()) return false;
+
+    const int row = m_berthTrain[berth];
+    m_trains[row].headcode = headcode.trimmed();
+    rowChanged(row);
+    return true;
+}
+
+bool TrainDescriber::cancelTrain(const QString& circuitId) {
+    const int berth = berthIndex(circuitId);
+    if (berth < 0 || m_berthTrain[berth] == NO_TRAIN) return false;
+
+    removeTrain(m_berthTrain[berth]);
+    return true;
+}
+
+void TrainDescriber::setInitialOccupancy(const QVariantMap& circuitStates) {
+    for (auto it = circuitStates.cbegin(); it != circuitStates.cend(); ++it) {
+        const int berth = berthIndex(it.key());
+        if (berth >= 0) {
+            m_occupied[berth] = it.value().toBool();
+        }
+    }
+}
+
+//
+//   QUERIES
+//
+
+QString TrainDescriber::headcodeInBerth(const QString& circuitId) const {
+    const int berth = berthIndex(circuitId);
+    if (berth < 0 || m_berthTrain[berth] == NO_TRAIN) return QString();
+    return m_trains[m_berthTrain[berth]].headcode;
+}
+
+QStringList TrainDescriber::adjacentBerths(const QString& circuitId) const {
+    QStringList berths;
+    const int berth = berthIndex(circuitId);
+    if (berth < 0) return berths;
+
+    for (int neighbour : m_adjacency[berth]) {
+        berths.append(m_berthIds[neighbour]);
+    }
+    return berths;
+}
+
+QVariantList TrainDescriber::getTrains() const {
+    QVariantList trains;
+    const QHash<int, QByteArray> roles = roleNames();
+
+    for (int row = 0; row < trainCount(); ++row) {
+        QVariantMap train;
+        for (auto it = roles.cbegin(); it != roles.cend(); ++it) {
+            train[QString::fromLatin1(it.value())] = data(index(row), it.key());
+        }
+        trains.append(train);
+    }
+    return trains;
+}
+
+//
+//   MODEL
+//
+
+int TrainDescriber::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : trainCount();
+}
+
+QVariant TrainDescriber::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() < 0 || index.row() >= trainCount()) {
+        return QVariant();
+    }
+
+    const Train& train = m_trains[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+    case HeadcodeRole: return train.headcode;
+    case TrainIdRole: return train.id;
+    case BerthRole: return m_berthIds[train.berth];
+    case PreviousBerthRole: return train.previousBerth < 0 ? QString() : m_berthIds[train.previousBerth];
+    case RouteIdRole: return train.routeId;
+    case NextBerthRole: return train.nextBerth() < 0 ? QString() : m_berthIds[train.nextBerth()];
+    case StatusRole:
+        if (!train.detected) return QStringLiteral("UNDETECTED");
+        return train.nextBerth() < 0 ? QStringLiteral("DESCRIBED") : QStringLiteral("ROUTED");
+    case StepCountRole: return train.stepCount;
+    case LastStepMsRole: return train.lastStepMs;
+    default: return QVariant();
+    }
+}
+
+QHash<int, QByteArray> TrainDescriber::roleNames() const {
+    return {
+        {TrainIdRole, "trainId"},
+        {HeadcodeRole, "headcode"},
+        {BerthRole, "berth"},
+        {PreviousBerthRole, "previousBerth"},
+        {RouteIdRole, "routeId"},
+        {NextBerthRole, "nextBerth"},
+        {StatusRole, "status"},
+        {StepCountRole, "stepCount"},
+        {LastStepMsRole, "lastStepMs"}
+    };
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include <QAbstractListModel>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <vector>
+#include "../core/Clock.h"
+
+//   TRAIN DESCRIBER
+//
+//   Keeps train identities (headcodes) in berths and steps them along as occupancy
+//   changes. Berths are track circuits; circuit adjacency is derived once from the
+//   generated station layout (segment endpoints that meet, plus point connections).
+//
+//   When a circuit becomes occupied, the description steps in from an adjacent berth:
+//     1. the neighbour whose route expects this circuit next, else
+//     2. the only unrouted neighbour that is not stepping back into the berth it left.
+//   An occupation at a boundary berth with no candidate describes a new "????" train;
+//   a boundary berth clearing under its train means the train has left the area.
+//
+//   Every event touches one berth and its (at most three) neighbours, and updates one
+//   model row. The model is the live train list for QML; nothing is re-queried.
+class TrainDescriber : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int trainCount READ trainCount NOTIFY trainCountChanged)
+
+public:
+    enum Roles {
+        TrainIdRole = Qt::UserRole + 1,
+        HeadcodeRole,
+        BerthRole,
+        PreviousBerthRole,
+        RouteIdRole,
+        NextBerthRole,
+        StatusRole,
+        StepCountRole,
+        LastStepMsRole
+    };
+
+    static constexpr const char* UNKNOWN_HEADCODE = "????";
+
+    explicit TrainDescriber(QObject* parent = nullptr);
+
+    //   Step times (lastStepMs) are read from this clock
+    void setClock(Clock* clock) { if (clock) m_clock = clock; }
+
+    //   QAbstractListModel
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int trainCount() const { return static_cast<int>(m_trains.size()); }
+
+    //   OPERATOR / TRAIN DATA ENTRY
+    Q_INVOKABLE bool interposeTrain(const QString& headcode, const QString& circuitId);
+    Q_INVOKABLE bool renameTrain(const QString& circuitId, const QString& headcode);
+    Q_INVOKABLE bool cancelTrain(const QString& circuitId);
+
+    //   QUERIES
+    Q_INVOKABLE QString headcodeInBerth(const QString& circuitId) const;
+    Q_INVOKABLE QStringList adjacentBerths(const QString& circuitId) const;
+    Q_INVOKABLE QVariantList getTrains() const;
+
+    //   Occupancy snapshot taken once at startup; later changes arrive as events
+    void setInitialOccupancy(const QVariantMap& circuitStates);
+
+public slots:
+    void onTrackCircuitOccupancyChanged(const QString& circuitId, bool isOccupied);
+    void onRouteAssigned(const QString& routeId, const QString& sourceSignal, const QString& destSignal, const QStringList& path);
+
+signals:
+    void trainCountChanged();
+    void trainStepped(const QString& headcode, const QString& fromBerth, const QString& toBerth);
+    void trainEntered(const QString& headcode, const QString& berth);
+    void trainExited(const QString& headcode, const QString& berth);
+    void unidentifiedOccupation(const QString& circuitId);
+
+private:
+    static constexpr int NO_TRAIN = -1;
+    static constexpr double ADJACENCY_TOLERANCE = 1.5;  //   Grid units between abutting segment ends
+
+    struct Train {
+        quint32 id = 0;
+        QString headcode;
+        int berth = -1;
+        int previousBerth = -1;
+        QString routeId;
+        std::vector<int> routePath;         //   Circuit indices
+        int routeIndex = -1;                //   Position of berth in routePath (-1: not yet entered)
+        bool detected = true;
+        int stepCount = 0;
+        qint64 lastStepMs = 0;
+
+        int nextBerth() const {
+            const int next = routeIndex + 1;
+            return next < static_cast<int>(routePath.size()) ? routePath[next] : -1;
+        }
+    };
+
+    struct PendingRoute {
+        QString routeId;
+        std::vector<int> path;
+    };
+
+    void buildBerthGraph();
+    int berthIndex(const QString& circuitId) const { return m_berthIndex.value(circuitId, -1); }
+    bool isBoundary(int berth) const { return m_adjacency[berth].size() <= 1; }
+
+    int findSteppingTrain(int berth) const;
+    void stepTrain(int row, int toBerth);
+    int addTrain(const QString& headcode, int berth);
+    void removeTrain(int row);
+    void attachRoute(int row, const QString& routeId, const std::vector<int>& path);
+    void attachPendingRoute(int row);
+    void rowChanged(int row);
+
+    //   BERTH GRAPH (fixed at construction)
+    std::vector<QString> m_berthIds;
+    QHash<QString, int> m_berthIndex;
+    std::vector<std::vector<int>> m_adjacency;
+
+    //   LIVE STATE
+    std::vector<bool> m_occupied;
+    std::vector<int> m_berthTrain;              //   Berth -> row in m_trains, or NO_TRAIN
+    std::vector<Train> m_trains;
+    QHash<int, PendingRoute> m_pendingRoutes;   //   Entry berth -> route waiting for its train
+    quint32 m_nextTrainId = 1;
+    Clock* m_clock = Clock::system();
+};
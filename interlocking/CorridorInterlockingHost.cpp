@@ -0,0 +1,291 @@
+#include "CorridorInterlockingHost.h"
+#include "StationShard.h"
+#include "StationData.h"
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <algorithm>
+
+CorridorInterlockingHost::CorridorInterlockingHost(QObject* parent)
+    : QObject(parent)
+{
+}
+
+CorridorInterlockingHost::~CorridorInterlockingHost() {
+    stopShards();
+}
+
+template <typename Work>
+bool CorridorInterlockingHost::post(const QString& stationId, Work&& work) {
+    StationShard* shard = m_shards.value(stationId, nullptr);
+    if (!shard) {
+        return false;
+    }
+
+    QMetaObject::invokeMethod(shard, [shard, work = std::forward<Work>(work)]() { work(shard); }, Qt::QueuedConnection);
+    return true;
+}
+
+//
+//   CORRIDOR SETUP
+//
+
+bool CorridorInterlockingHost::loadCorridor(const QString& configPath) {
+    QList<StationConfig> stations;
+    QList<QPair<BlockEnd, BlockEnd>> interfaces;
+    QStringList errors;
+
+    if (configPath.isEmpty()) {
+        stations.append(StationConfig{RailFlux::Station::toQString(RailFlux::Station::Generated::STATION_ID), QString(), {},
+                                      StationShard::builtInCircuitSegments()});
+    } else {
+        QFile file(configPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            qCritical() << " [Corridor] Cannot open corridor file:" << configPath;
+            return false;
+        }
+        if (!parseCorridor(file.readAll(), stations, interfaces, errors)) {
+            qCritical() << " [Corridor] Corridor file rejected:" << errors;
+            return false;
+        }
+    }
+
+    stopShards();
+    startShards(stations, interfaces);
+    emit corridorChanged();
+    return true;
+}
+
+bool CorridorInterlockingHost::parseCorridor(const QByteArray& json, QList<StationConfig>& stations,
+                                             QList<QPair<BlockEnd, BlockEnd>>& interfaces, QStringList& errors) const {
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        errors.append("Invalid JSON: " + parseError.errorString());
+        return false;
+    }
+
+    QSet<QString> stationIds;
+    for (const QJsonValue& value : document.object()["stations"].toArray()) {
+        const QJsonObject stationObject = value.toObject();
+        StationConfig station;
+        station.stationId = stationObject["station_id"].toString();
+        station.rulesPath = stationObject["rules"].toString();
+
+        if (station.stationId.isEmpty() || stationIds.contains(station.stationId)) {
+            errors.append(QString("Missing or duplicate station_id '%1'").arg(station.stationId));
+            continue;
+        }
+        stationIds.insert(station.stationId);
+
+        for (const QJsonValue& routeValue : stationObject["routes"].toArray()) {
+            const QJsonObject route = routeValue.toObject();
+            QStringList path;
+            for (const QJsonValue& circuit : route["path"].toArray()) {
+                path.append(circuit.toString());
+            }
+            station.routes.insert(StationShard::routeKey(route["source"].toString(), route["dest"].toString()), path);
+        }
+
+        const QJsonObject circuits = stationObject["circuits"].toObject();
+        for (auto it = circuits.constBegin(); it != circuits.constEnd(); ++it) {
+            for (const QJsonValue& segment : it.value().toArray()) {
+                station.circuitSegments[it.key()].append(segment.toString());
+            }
+        }
+        if (circuits.isEmpty()) {
+            if (station.stationId == RailFlux::Station::toQString(RailFlux::Station::Generated::STATION_ID)) {
+                station.circuitSegments = StationShard::builtInCircuitSegments();
+            } else {
+                qWarning() << " [Corridor] Station" << station.stationId
+                           << "has no circuit layout - each circuit is read as one segment of the same ID";
+            }
+        }
+        stations.append(station);
+    }
+
+    auto parseEnd = [&](const QJsonObject& object) {
+        BlockEnd end{object["station"].toString(), object["circuit"].toString(), object["exit_signal"].toString()};
+        if (!stationIds.contains(end.stationId) || end.circuitId.isEmpty()) {
+            errors.append(QString("Block interface end %1/%2 does not name a known station and circuit")
+                              .arg(end.stationId, end.circuitId));
+        }
+        return end;
+    };
+
+    for (const QJsonValue& value : document.object()["block_interfaces"].toArray()) {
+        const QJsonObject interfaceObject = value.toObject();
+        const BlockEnd a = parseEnd(interfaceObject["a"].toObject());
+        const BlockEnd b = parseEnd(interfaceObject["b"].toObject());
+        if (a.stationId == b.stationId) {
+            errors.append(QString("Block interface joins station %1 to itself").arg(a.stationId));
+        }
+        interfaces.append({a, b});
+    }
+
+    if (stations.isEmpty()) {
+        errors.append("Corridor has no stations");
+    }
+    return errors.isEmpty();
+}
+
+void CorridorInterlockingHost::startShards(const QList<StationConfig>& stations,
+                                           const QList<QPair<BlockEnd, BlockEnd>>& interfaces) {
+    const int workerCount = std::max(1, std::min(static_cast<int>(stations.size()), QThread::idealThreadCount()));
+    for (int i = 0; i < workerCount; ++i) {
+        auto worker = std::make_unique<QThread>();
+        worker->setObjectName(QString("InterlockingShard-%1").arg(i));
+        worker->start();
+        m_workers.push_back(std::move(worker));
+    }
+
+    for (int i = 0; i < stations.size(); ++i) {
+        const StationConfig& config = stations[i];
+        const int workerIndex = i % workerCount;
+        QThread* worker = m_workers[workerIndex].get();
+
+        //   Unparented so it can move; the worker deletes it when it stops
+        auto* shard = new StationShard(config.stationId, config.rulesPath, config.circuitSegments);
+        shard->moveToThread(worker);
+        connect(worker, &QThread::finished, shard, &QObject::deleteLater);
+
+        connect(shard, &StationShard::started, this, [this](const QString& stationId, bool success, const QStringList& errors) {
+            m_stationHealthy.insert(stationId, success);
+            emit stationStarted(stationId, success, errors);
+        });
+        connect(shard, &StationShard::permittedAspectsChanged, this, &CorridorInterlockingHost::onPermittedAspectsChanged);
+        connect(shard, &StationShard::boundaryOccupancyChanged, this, &CorridorInterlockingHost::onBoundaryOccupancyChanged);
+        connect(shard, &StationShard::routeChecked, this, &CorridorInterlockingHost::routeChecked);
+
+        m_shards.insert(config.stationId, shard);
+        m_shardWorker.insert(config.stationId, workerIndex);
+        m_stationOrder.append(config.stationId);
+
+        const QHash<QString, QStringList> routes = config.routes;
+        post(config.stationId, [routes](StationShard* target) {
+            target->setRouteTable(routes);
+        });
+    }
+
+    //   Both ends of every block section learn about each other before the shards start
+    for (const auto& blockInterface : interfaces) {
+        const BlockEnd a = blockInterface.first;
+        const BlockEnd b = blockInterface.second;
+        post(a.stationId, [a, b](StationShard* target) {
+            target->addBoundaryLink({a.circuitId, a.exitSignalId, b.stationId, b.circuitId});
+        });
+        post(b.stationId, [a, b](StationShard* target) {
+            target->addBoundaryLink({b.circuitId, b.exitSignalId, a.stationId, a.circuitId});
+        });
+    }
+
+    for (const QString& stationId : m_stationOrder) {
+        post(stationId, [](StationShard* target) { target->start(); });
+    }
+
+    qDebug() << " [Corridor] Hosting" << m_stationOrder.size() << "stations on" << workerCount << "worker threads,"
+             << interfaces.size() << "block interfaces";
+}
+
+void CorridorInterlockingHost::stopShards() {
+    for (auto& worker : m_workers) {
+        worker->quit();
+    }
+    for (auto& worker : m_workers) {
+        worker->wait();
+    }
+
+    m_workers.clear();
+    m_shards.clear();
+    m_shardWorker.clear();
+    m_stationOrder.clear();
+    m_permitted.clear();
+    m_stationHealthy.clear();
+}
+
+//
+//   INPUT
+//
+
+bool CorridorInterlockingHost::submitOccupancy(const QString& stationId, const QString& circuitId, bool isOccupied) {
+    return post(stationId, [circuitId, isOccupied](StationShard* shard) {
+        shard->applyOccupancy(circuitId, isOccupied);
+    });
+}
+
+bool CorridorInterlockingHost::submitSignalAspect(const QString& stationId, const QString& signalId,
+                                                  const QString& mainAspect, const QString& callingOnAspect,
+                                                  const QString& loopAspect) {
+    const PackedAspect state = PackedAspect::fromState(mainAspect, callingOnAspect, loopAspect);
+    return post(stationId, [signalId, state](StationShard* shard) {
+        shard->applySignalAspect(signalId, state);
+    });
+}
+
+bool CorridorInterlockingHost::submitPointPosition(const QString& stationId, const QString& machineId, const QString& position) {
+    return post(stationId, [machineId, position](StationShard* shard) {
+        shard->applyPointPosition(machineId, position);
+    });
+}
+
+bool CorridorInterlockingHost::checkRoute(const QString& stationId, const QString& sourceSignalId, const QString& destSignalId) {
+    return post(stationId, [sourceSignalId, destSignalId](StationShard* shard) {
+        shard->checkRoute(sourceSignalId, destSignalId);
+    });
+}
+
+//
+//   SHARD OUTPUT (host thread)
+//
+
+void CorridorInterlockingHost::onPermittedAspectsChanged(const QString& stationId, const QVariantMap& permittedAspects) {
+    QHash<QString, QStringList>& station = m_permitted[stationId];
+    for (auto it = permittedAspects.cbegin(); it != permittedAspects.cend(); ++it) {
+        station.insert(it.key(), it.value().toStringList());
+    }
+    emit permittedAspectsChanged(stationId, permittedAspects.keys());
+}
+
+void CorridorInterlockingHost::onBoundaryOccupancyChanged(const QString& stationId, const QString& remoteStationId,
+                                                          const QString& remoteCircuitId, bool isOccupied) {
+    const bool forwarded = post(remoteStationId, [remoteCircuitId, isOccupied](StationShard* shard) {
+        shard->applyRemoteBlockOccupancy(remoteCircuitId, isOccupied);
+    });
+
+    if (!forwarded) {
+        qWarning() << " [Corridor] Block message from" << stationId << "to unknown station" << remoteStationId;
+        return;
+    }
+    emit blockOccupancyForwarded(stationId, remoteStationId, remoteCircuitId, isOccupied);
+}
+
+//
+//   RESULTS
+//
+
+QStringList CorridorInterlockingHost::getPermittedAspects(const QString& stationId, const QString& signalId) const {
+    return m_permitted.value(stationId).value(signalId);
+}
+
+QVariantMap CorridorInterlockingHost::getCorridorStatus() const {
+    QVariantList stations;
+    for (const QString& stationId : m_stationOrder) {
+        const StationShard* shard = m_shards.value(stationId);
+
+        QVariantMap station;
+        station["stationId"] = stationId;
+        station["worker"] = m_shardWorker.value(stationId);
+        station["healthy"] = m_stationHealthy.value(stationId, false);
+        station["eventsProcessed"] = shard ? shard->eventsProcessed() : 0;
+        station["lastEvaluationUs"] = shard ? shard->lastEvaluationNs() / 1000.0 : 0.0;
+        stations.append(station);
+    }
+
+    QVariantMap status;
+    status["workerThreads"] = static_cast<int>(m_workers.size());
+    status["stations"] = stations;
+    return status;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVariantMap>
+#include <memory>
+#include <vector>
+
+class StationShard;
+
+//   CORRIDOR INTERLOCKING HOST
+//
+//   Hosts one StationShard per station of a corridor in a single process. Shards are
+//   spread round-robin over min(stations, idealThreadCount) worker threads and pinned
+//   there, so independent stations are evaluated in parallel.
+//
+//   All traffic into a shard is posted to its thread; everything coming out arrives as
+//   queued signals on the host's thread. Block interfaces between adjacent stations are
+//   explicit: a shard reports a change on its boundary circuit, and the host forwards it
+//   to the shard at the other end of the block section.
+//
+//   CORRIDOR FILE (JSON):
+//     { "stations": [ { "station_id": "T1", "rules": "",
+//                       "circuits": { "W22T": ["T1W22", "T1W23"] },
+//                       "routes": [ { "source": "HM001", "dest": "ST003", "path": ["W22T", "3T"] } ] } ],
+//       "block_interfaces": [ { "a": { "station": "T1", "circuit": "A1T", "exit_signal": "AS001" },
+//                               "b": { "station": "T2", "circuit": "A42T", "exit_signal": "AS002" } } ] }
+//   An empty "rules" uses the rule set generated at build time. "circuits" is the station's
+//   own circuit -> track segment layout; left out, the station generated at build time uses
+//   its generated layout and any other station reads each circuit as one segment of that ID.
+class CorridorInterlockingHost : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(QStringList stationIds READ stationIds NOTIFY corridorChanged)
+
+public:
+    explicit CorridorInterlockingHost(QObject* parent = nullptr);
+    ~CorridorInterlockingHost();
+
+    //   Empty path: a single-station corridor of the built-in station
+    bool loadCorridor(const QString& configPath = QString());
+    QStringList stationIds() const { return m_stationOrder; }
+
+    //   INPUT: Posted to the owning shard; false if the station is unknown
+    Q_INVOKABLE bool submitOccupancy(const QString& stationId, const QString& circuitId, bool isOccupied);
+    Q_INVOKABLE bool submitSignalAspect(const QString& stationId, const QString& signalId,
+                                        const QString& mainAspect, const QString& callingOnAspect,
+                                        const QString& loopAspect);
+    Q_INVOKABLE bool submitPointPosition(const QString& stationId, const QString& machineId, const QString& position);
+    Q_INVOKABLE bool checkRoute(const QString& stationId, const QString& sourceSignalId, const QString& destSignalId);
+
+    //   RESULTS: Last published by each shard, cached on the host thread
+    Q_INVOKABLE QStringList getPermittedAspects(const QString& stationId, const QString& signalId) const;
+    Q_INVOKABLE QVariantMap getCorridorStatus() const;
+
+signals:
+    void corridorChanged();
+    void stationStarted(const QString& stationId, bool success, const QStringList& errors);
+    void permittedAspectsChanged(const QString& stationId, const QStringList& signalIds);
+    void blockOccupancyForwarded(const QString& fromStationId, const QString& toStationId,
+                                 const QString& circuitId, bool isOccupied);
+    void routeChecked(const QString& stationId, const QString& sourceSignalId, const QString& destSignalId,
+                      bool available, const QString& reason);
+
+private:
+    struct StationConfig {
+        QString stationId;
+        QString rulesPath;
+        QHash<QString, QStringList> routes;
+        QHash<QString, QStringList> circuitSegments;
+    };
+
+    struct BlockEnd {
+        QString stationId;
+        QString circuitId;
+        QString exitSignalId;
+    };
+
+    bool parseCorridor(const QByteArray& json, QList<StationConfig>& stations,
+                       QList<QPair<BlockEnd, BlockEnd>>& interfaces, QStringList& errors) const;
+    void startShards(const QList<StationConfig>& stations, const QList<QPair<BlockEnd, BlockEnd>>& interfaces);
+    void stopShards();
+
+    template <typename Work>
+    bool post(const QString& stationId, Work&& work);
+
+    void onPermittedAspectsChanged(const QString& stationId, const QVariantMap& permittedAspects);
+    void onBoundaryOccupancyChanged(const QString& stationId, const QString& remoteStationId,
+                                    const QString& remoteCircuitId, bool isOccupied);
+
+    std::vector<std::unique_ptr<QThread>> m_workers;
+    QHash<QString, StationShard*> m_shards;             //   Owned by their worker (deleteLater on finish)
+    QHash<QString, int> m_shardWorker;
+    QStringList m_stationOrder;
+    QHash<QString, QHash<QString, QStringList>> m_permitted;
+    QHash<QString, bool> m_stationHealthy;
+};
@@ -0,0 +1,329 @@
+#include "InterlockingPipeline.h"
+#include "OccupancyLatencyMonitor.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QDebug>
+
+namespace {
+const QString PERSISTENCE_CONNECTION_NAME = QStringLiteral("pipeline_persistence_connection");
+const QString ENFORCEMENT_OPERATOR_ID = QStringLiteral("INTERLOCKING_AUTO");
+}
+
+InterlockingPipeline::InterlockingPipeline(QObject* parent)
+    : QObject(parent) {
+}
+
+InterlockingPipeline::~InterlockingPipeline() {
+    stop();
+}
+
+//
+//   LIFECYCLE
+//
+
+bool InterlockingPipeline::start(const QString& databaseConnectionName, const ProtectionTable& protectionTable) {
+    if (isRunning()) {
+        return true;
+    }
+
+    if (databaseConnectionName.isEmpty()) {
+        qWarning() << " Interlocking pipeline not started: no database connection to clone";
+        return false;
+    }
+
+    //   IMMUTABLE WHILE RUNNING: Only the interlocking stage reads the table after this point
+    m_protectionTable = protectionTable;
+    m_sourceConnectionName = databaseConnectionName;
+
+    m_ingestionFinished.store(false, std::memory_order_relaxed);
+    m_interlockingFinished.store(false, std::memory_order_relaxed);
+    m_persistenceFinished.store(false, std::memory_order_relaxed);
+    m_running.store(true, std::memory_order_release);
+    m_publicationThread = std::thread(&InterlockingPipeline::runPublicationStage, this);
+    m_persistenceThread = std::thread(&InterlockingPipeline::runPersistenceStage, this);
+    m_interlockingThread = std::thread(&InterlockingPipeline::runInterlockingStage, this);
+    m_ingestionThread = std::thread(&InterlockingPipeline::runIngestionStage, this);
+
+    qDebug() << "  Interlocking pipeline started with" << m_protectionTable.size()
+             << "protected track segments";
+    return true;
+}
+
+void InterlockingPipeline::stop() {
+    if (!m_running.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    //   SAFETY: Queued occupancy records are still driven to danger - each stage drains its
+    //   queue after the one upstream has finished, so the joins below wait for enforcement
+    ring(m_ingestDoorbell);
+
+    for (std::thread* stage : {&m_ingestionThread, &m_interlockingThread,
+                               &m_persistenceThread, &m_publicationThread}) {
+        if (stage->joinable()) {
+            stage->join();
+        }
+    }
+
+    qDebug() << "  Interlocking pipeline stopped after" << processedEvents() << "events";
+}
+
+//
+//   INGESTION ENTRY POINT
+//
+
+bool InterlockingPipeline::submitOccupancyChange(const QString& trackSegmentId, bool wasOccupied, bool isOccupied,
+                                                 qint64 inputNs) {
+    Q_ASSERT(QThread::currentThread() == thread());
+
+    if (!isRunning()) {
+        return false;
+    }
+
+    OccupancyEvent event{trackSegmentId, wasOccupied, isOccupied,
+                         inputNs > 0 ? inputNs : OccupancyLatencyMonitor::nowNs()};
+    if (!m_ingestQueue.tryPush(std::move(event))) {
+        qCritical() << " Interlocking pipeline input queue full - falling back to synchronous enforcement for"
+                    << trackSegmentId;
+        return false;
+    }
+
+    ring(m_ingestDoorbell);
+    return true;
+}
+
+int InterlockingPipeline::pendingEvents() const {
+    return static_cast<int>(m_ingestQueue.sizeApprox() + m_evaluationQueue.sizeApprox()
+                            + m_persistenceQueue.sizeApprox() + m_publicationQueue.sizeApprox());
+}
+
+//
+//   STAGE 1: INGESTION - filter raw transitions down to safety-critical ones
+//
+
+void InterlockingPipeline::runIngestionStage() {
+    OccupancyEvent event;
+    for (;;) {
+        const uint32_t observed = m_ingestDoorbell.load(std::memory_order_acquire);
+        //   Sampled before draining: the producer shares stop()'s thread, so nothing follows it
+        const bool stopping = !m_running.load(std::memory_order_acquire);
+
+        while (m_ingestQueue.tryPop(event)) {
+            //   SAFETY: Only the clear -> occupied transition requires enforcement
+            if (event.wasOccupied || !event.isOccupied) {
+                m_processedEvents.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            pushBlocking(m_evaluationQueue, event, m_evaluationDoorbell);
+        }
+
+        if (stopping) break;
+        waitForWork(m_ingestDoorbell, observed);
+    }
+
+    finishStage(m_ingestionFinished, m_evaluationDoorbell);
+}
+
+//
+//   STAGE 2: INTERLOCKING - decide protecting signals from the in-memory table
+//
+
+void InterlockingPipeline::runInterlockingStage() {
+    OccupancyEvent event;
+    for (;;) {
+        const uint32_t observed = m_evaluationDoorbell.load(std::memory_order_acquire);
+        const bool upstreamFinished = m_ingestionFinished.load(std::memory_order_acquire);
+
+        while (m_evaluationQueue.tryPop(event)) {
+            const QStringList protectingSignals = m_protectionTable.value(event.trackSegmentId);
+
+            //   SINGLE PRODUCER: Unprotected segments travel as an empty command through the
+            //   persistence stage, which is the only producer on the publication queue
+            EnforcementCommand command;
+            command.trackSegmentId = event.trackSegmentId;
+            command.signalIds = protectingSignals;
+            command.reason = QString("AUTOMATIC: Track segment %1 occupied").arg(event.trackSegmentId);
+            command.inputNs = event.inputNs;
+            command.decisionNs = OccupancyLatencyMonitor::nowNs();
+
+            pushBlocking(m_persistenceQueue, command, m_persistenceDoorbell);
+        }
+
+        if (upstreamFinished) break;
+        waitForWork(m_evaluationDoorbell, observed);
+    }
+
+    finishStage(m_interlockingFinished, m_persistenceDoorbell);
+}
+
+//
+//   STAGE 3: PERSISTENCE/AUDIT - apply danger aspects on a dedicated connection
+//
+
+void InterlockingPipeline::runPersistenceStage() {
+    {
+        //   THREAD AFFINITY: QSqlDatabase handles may only be used by the thread that opened them
+        QSqlDatabase db = QSqlDatabase::cloneDatabase(m_sourceConnectionName, PERSISTENCE_CONNECTION_NAME);
+        if (!db.open()) {
+            qCritical() << " CRITICAL: Interlocking pipeline persistence connection failed:" << db.lastError().text();
+        }
+
+        EnforcementCommand command;
+        for (;;) {
+            const uint32_t observed = m_persistenceDoorbell.load(std::memory_order_acquire);
+            const bool upstreamFinished = m_interlockingFinished.load(std::memory_order_acquire);
+
+            while (m_persistenceQueue.tryPop(command)) {
+                PublicationEvent publication;
+                publication.trackSegmentId = command.trackSegmentId;
+                publication.inputNs = command.inputNs;
+                publication.decisionNs = command.decisionNs;
+
+                QStringList errors;
+                for (const QString& signalId : command.signalIds) {
+                    QString error;
+                    if (persistSignalToRed(PERSISTENCE_CONNECTION_NAME, signalId, error)) {
+                        publication.enforcedSignals.append(signalId);
+                    } else {
+                        publication.failedSignals.append(signalId);
+                        errors.append(QString("%1: %2").arg(signalId, error));
+                    }
+                }
+
+                publication.commitNs = OccupancyLatencyMonitor::nowNs();
+
+                if (command.signalIds.isEmpty()) {
+                    publication.kind = PublicationEvent::Kind::Unprotected;
+                } else if (publication.failedSignals.isEmpty()) {
+                    publication.kind = PublicationEvent::Kind::Completed;
+                } else {
+                    publication.kind = PublicationEvent::Kind::Failed;
+                    publication.error = QString("Failed to enforce RED aspect (%1): %2")
+                                            .arg(command.reason, errors.join("; "));
+                }
+
+                pushBlocking(m_publicationQueue, publication, m_publicationDoorbell);
+            }
+
+            if (upstreamFinished) break;
+            waitForWork(m_persistenceDoorbell, observed);
+        }
+
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(PERSISTENCE_CONNECTION_NAME);
+    finishStage(m_persistenceFinished, m_publicationDoorbell);
+}
+
+bool InterlockingPipeline::persistSignalToRed(const QString& connectionName, const QString& signalId, QString& error) {
+    QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+    if (!db.isOpen() && !db.open()) {
+        error = "Persistence connection unavailable: " + db.lastError().text();
+        return false;
+    }
+
+    //   SAFETY: Written even when the signal already shows danger; the row version moves on,
+    //   so a command validated against the aspect before this occupancy cannot commit after it
+    QSqlQuery query(db);
+    query.prepare("SELECT railway_control.update_signal_aspect(?, 'RED', ?)");
+    query.addBindValue(signalId);
+    query.addBindValue(ENFORCEMENT_OPERATOR_ID);
+
+    if (!query.exec() || !query.next()) {
+        error = query.lastError().text();
+        return false;
+    }
+
+    if (!QJsonDocument::fromJson(query.value(0).toString().toUtf8()).object().value("success").toBool()) {
+        error = "Signal not found";
+        return false;
+    }
+
+    return true;
+}
+
+//
+//   STAGE 4: UI PUBLICATION - fan results out to Qt receivers
+//
+
+void InterlockingPipeline::runPublicationStage() {
+    PublicationEvent publication;
+    for (;;) {
+        const uint32_t observed = m_publicationDoorbell.load(std::memory_order_acquire);
+        const bool upstreamFinished = m_persistenceFinished.load(std::memory_order_acquire);
+
+        while (m_publicationQueue.tryPop(publication)) {
+            switch (publication.kind) {
+            case PublicationEvent::Kind::Completed:
+                for (const QString& signalId : publication.enforcedSignals) {
+                    emit signalEnforced(signalId);
+                }
+                emit enforcementCompleted(publication.trackSegmentId, publication.enforcedSignals);
+                break;
+            case PublicationEvent::Kind::Failed:
+                for (const QString& signalId : publication.enforcedSignals) {
+                    emit signalEnforced(signalId);
+                }
+                emit enforcementFailed(publication.trackSegmentId, publication.failedSignals.join(","),
+                                       publication.error);
+                break;
+            case PublicationEvent::Kind::Unprotected:
+                emit unprotectedSegmentOccupied(publication.trackSegmentId);
+                break;
+            }
+
+            //   SLO: Failed enforcements are timed too - a slow failure must not hide from the SLO
+            if (m_latencyMonitor && publication.kind != PublicationEvent::Kind::Unprotected) {
+                OccupancyLatencyMonitor::Sample sample;
+                sample.trackSegmentId = publication.trackSegmentId;
+                sample.signalCount = publication.enforcedSignals.size() + publication.failedSignals.size();
+                sample.failed = publication.kind == PublicationEvent::Kind::Failed;
+                sample.inputNs = publication.inputNs;
+                sample.decisionNs = publication.decisionNs;
+                sample.commitNs = publication.commitNs;
+                sample.publishedNs = OccupancyLatencyMonitor::nowNs();
+                m_latencyMonitor->record(sample);
+            }
+
+            m_processedEvents.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (upstreamFinished) break;
+        waitForWork(m_publicationDoorbell, observed);
+    }
+}
+
+//
+//   QUEUE HELPERS
+//
+
+template <typename Queue, typename Record>
+void InterlockingPipeline::pushBlocking(Queue& queue, Record& record, std::atomic<uint32_t>& doorbell) {
+    //   Cannot stall: the consumer keeps draining until this stage has finished
+    while (!queue.tryPush(std::move(record))) {
+        std::this_thread::yield();
+    }
+
+    ring(doorbell);
+}
+
+void InterlockingPipeline::ring(std::atomic<uint32_t>& doorbell) {
+    doorbell.fetch_add(1, std::memory_order_release);
+    doorbell.notify_one();
+}
+
+void InterlockingPipeline::waitForWork(std::atomic<uint32_t>& doorbell, uint32_t observed) {
+    //   PARK: Returns immediately if a producer rang since 'observed' was sampled
+    doorbell.wait(observed, std::memory_order_acquire);
+}
+
+void InterlockingPipeline::finishStage(std::atomic<bool>& finished, std::atomic<uint32_t>& downstreamDoorbell) {
+    //   Release orders every record this stage pushed before the flag its consumer reads
+    finished.store(true, std::memory_order_release);
+    ring(downstreamDoorbell);
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "SpscRingBuffer.h"
+
+class OccupancyLatencyMonitor;
+
+//   STAGED INTERLOCKING PIPELINE
+//
+//   Hardware input -> [ingestion] -> [interlocking] -> [persistence/audit] -> [UI publication]
+//
+//   Each stage runs on its own thread and hands work to the next stage through a
+//   bounded lock-free SPSC ring buffer. The interlocking stage decides which signals
+//   must go to danger from an in-memory protection table, so a slow database commit
+//   downstream never delays the safety decision for the next occupancy event.
+class InterlockingPipeline : public QObject {
+    Q_OBJECT
+
+public:
+    //   PROTECTION TABLE: track segment ID -> protecting signal IDs (immutable while running)
+    using ProtectionTable = QHash<QString, QStringList>;
+
+    explicit InterlockingPipeline(QObject* parent = nullptr);
+    ~InterlockingPipeline();
+
+    //   LIFECYCLE: Connection name is cloned so the persistence stage owns its own session
+    bool start(const QString& databaseConnectionName, const ProtectionTable& protectionTable);
+    //   DRAIN: Stops accepting input, then returns once every queued record has been enforced
+    void stop();
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    //   LATENCY: Set before start(); every occupied transition is stamped at each stage
+    void setLatencyMonitor(OccupancyLatencyMonitor* monitor) { m_latencyMonitor = monitor; }
+
+    //   INGESTION ENTRY POINT: Single producer - call only from the thread owning this object.
+    //   Returns false if the pipeline is not running or the input queue is full, in which
+    //   case the caller must fall back to the synchronous enforcement path. inputNs is the
+    //   arrival stamp (OccupancyLatencyMonitor::nowNs()); 0 stamps on submission.
+    bool submitOccupancyChange(const QString& trackSegmentId, bool wasOccupied, bool isOccupied,
+                               qint64 inputNs = 0);
+
+    //   PROTECTION TABLE LOOKUP: Signals the interlocking stage will enforce for a segment
+    QStringList protectingSignals(const QString& trackSegmentId) const { return m_protectionTable.value(trackSegmentId); }
+
+    //   MONITORING
+    int pendingEvents() const;
+    quint64 processedEvents() const { return m_processedEvents.load(std::memory_order_relaxed); }
+
+signals:
+    //   Emitted from the publication thread; receivers on the GUI thread get queued delivery
+    void signalEnforced(const QString& signalId);
+    void enforcementCompleted(const QString& trackSegmentId, const QStringList& affectedSignals);
+    void enforcementFailed(const QString& trackSegmentId, const QString& failedSignals, const QString& error);
+    void unprotectedSegmentOccupied(const QString& trackSegmentId);
+
+private:
+    //   STAGE RECORDS
+    struct OccupancyEvent {
+        QString trackSegmentId;
+        bool wasOccupied = false;
+        bool isOccupied = false;
+        qint64 inputNs = 0;
+    };
+
+    struct EnforcementCommand {
+        QString trackSegmentId;
+        QStringList signalIds;                  //   Empty: segment has no protecting signals
+        QString reason;
+        qint64 inputNs = 0;
+        qint64 decisionNs = 0;
+    };
+
+    struct PublicationEvent {
+        enum class Kind { Completed, Failed, Unprotected };
+        Kind kind = Kind::Completed;
+        QString trackSegmentId;
+        QStringList enforcedSignals;
+        QStringList failedSignals;
+        QString error;
+        qint64 inputNs = 0;
+        qint64 decisionNs = 0;
+        qint64 commitNs = 0;
+    };
+
+    static constexpr std::size_t INGEST_QUEUE_CAPACITY = 1024;
+    static constexpr std::size_t EVALUATION_QUEUE_CAPACITY = 1024;
+    static constexpr std::size_t PERSISTENCE_QUEUE_CAPACITY = 1024;
+    static constexpr std::size_t PUBLICATION_QUEUE_CAPACITY = 1024;
+
+    //   STAGE LOOPS
+    void runIngestionStage();
+    void runInterlockingStage();
+    void runPersistenceStage();
+    void runPublicationStage();
+
+    //   PERSISTENCE HELPERS
+    bool persistSignalToRed(const QString& connectionName, const QString& signalId, QString& error);
+
+    //   BACKPRESSURE: Safety records are never dropped between stages - the producer retries
+    template <typename Queue, typename Record>
+    void pushBlocking(Queue& queue, Record& record, std::atomic<uint32_t>& doorbell);
+    static void ring(std::atomic<uint32_t>& doorbell);
+    static void waitForWork(std::atomic<uint32_t>& doorbell, uint32_t observed);
+    //   SHUTDOWN: A stage exits only once its upstream has exited and its own queue is empty
+    static void finishStage(std::atomic<bool>& finished, std::atomic<uint32_t>& downstreamDoorbell);
+
+    SpscRingBuffer<OccupancyEvent, INGEST_QUEUE_CAPACITY> m_ingestQueue;
+    SpscRingBuffer<OccupancyEvent, EVALUATION_QUEUE_CAPACITY> m_evaluationQueue;
+    SpscRingBuffer<EnforcementCommand, PERSISTENCE_QUEUE_CAPACITY> m_persistenceQueue;
+    SpscRingBuffer<PublicationEvent, PUBLICATION_QUEUE_CAPACITY> m_publicationQueue;
+
+    //   DOORBELLS: Bumped after every push so idle consumers park on atomic wait
+    std::atomic<uint32_t> m_ingestDoorbell{0};
+    std::atomic<uint32_t> m_evaluationDoorbell{0};
+    std::atomic<uint32_t> m_persistenceDoorbell{0};
+    std::atomic<uint32_t> m_publicationDoorbell{0};
+
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_ingestionFinished{false};
+    std::atomic<bool> m_interlockingFinished{false};
+    std::atomic<bool> m_persistenceFinished{false};
+    std::atomic<quint64> m_processedEvents{0};
+
+    ProtectionTable m_protectionTable;
+    OccupancyLatencyMonitor* m_latencyMonitor = nullptr;
+    QString m_sourceConnectionName;
+
+    std::thread m_ingestionThread;
+    std::thread m_interlockingThread;
+    std::thread m_persistenceThread;
+    std::thread m_publicationThread;
+};
@@ -1,23 +1,42 @@
 #include "InterlockingRuleEngine.h"
+#include "InterlockingSnapshot.h"
 #include "../database/DatabaseManager.h"
+#include "StationData.h"
+#include "RuleVocabulary.h"
+#include "../database/ConfigLookup.h"
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QSqlQuery>
+#include <QSqlError>
 #include <QDebug>
+#include <utility>
 
 InterlockingRuleEngine::InterlockingRuleEngine(DatabaseManager* dbManager, QObject* parent)
     : QObject(parent), m_dbManager(dbManager) {
     if (!dbManager) {
         qCritical() << " [Constructor] InterlockingRuleEngine initialized with null DatabaseManager!";
     }
+
+    //   Single compiler thread: reloads are serialized, never concurrent
+    m_compilePool.setMaxThreadCount(1);
+}
+
+InterlockingRuleEngine::~InterlockingRuleEngine() {
+    m_compilePool.waitForDone();
 }
 
 // === VALIDATION METHODS ===
 
-bool InterlockingRuleEngine::checkConditions(const QList<SignalRule::Condition>& conditions) {
+bool InterlockingRuleEngine::checkConditions(const QList<SignalRule::Condition>& conditions,
+                                             const PositionReader& readPosition,
+                                             const OccupancyReader& readOccupancy) {
     for (const SignalRule::Condition& condition : conditions) {
         if (condition.entityType == "point_machine") {
-            QString currentPosition = getCurrentPointPosition(condition.entityId);
+            QString currentPosition = readPosition(condition.entityId);
             if (currentPosition != condition.requiredState) {
                 qWarning() << " [checkConditions] Point machine" << condition.entityId
                            << "is" << currentPosition << "but requires" << condition.requiredState;
@@ -25,30 +44,87 @@ bool InterlockingRuleEngine::checkConditions(const QList<SignalRule::Condition>&
             }
         }
         else if (condition.entityType == "track_segment") {
-            // Future implementation for track segment occupancy conditions
+            const bool requiresOccupied = condition.requiredState == "OCCUPIED";
+            if (readOccupancy(condition.entityId) != requiresOccupied) {
+                qWarning() << " [checkConditions] Track segment" << condition.entityId
+                           << "occupancy does not meet required state" << condition.requiredState;
+                return false;
+            }
         }
     }
     return true;
 }
 
-bool InterlockingRuleEngine::doesSignalMatchCompositeAspect(const QString& signalId, const QString& compositeAspect) {
-    if (!isCompositeAspect(compositeAspect)) {
-        QString currentMainAspect = getCurrentSignalAspect(signalId);
-        return currentMainAspect == compositeAspect;
+bool InterlockingRuleEngine::loadBuiltInRules() {
+    auto ruleSet = buildRuleSetFromGeneratedTables();
+    if (ruleSet->signalRules.isEmpty()) {
+        qCritical() << " [loadBuiltInRules] Generated station tables contain no signal interlocking rules";
+        return false;
+    }
+
+    publishRuleSet(std::move(ruleSet));
+    return true;
+}
+
+std::shared_ptr<InterlockingRuleEngine::RuleSet> InterlockingRuleEngine::buildRuleSetFromGeneratedTables() {
+    using namespace RailFlux::Station;
+
+    //   Already cross-checked by stationgen when the tables were generated
+    auto ruleSet = std::make_shared<RuleSet>();
+    ruleSet->stationId = toQString(Generated::STATION_ID);
+    ruleSet->sourcePath = QStringLiteral("<built-in>");
+    ruleSet->signalRules.reserve(static_cast<qsizetype>(Generated::SIGNAL_INTERLOCKING.size()));
+
+    for (const SignalInterlockingDef& signalDef : Generated::SIGNAL_INTERLOCKING) {
+        SignalInfo signalInfo;
+        signalInfo.signalType = toQString(signalDef.type);
+        signalInfo.isIndependent = signalDef.independent;
+        signalInfo.controlMode = toQString(signalDef.controlMode);
+        signalInfo.controlledBy = toQStringList(signalDef.controlledBy);
+
+        for (const SignalRuleDef& ruleDef : signalDef.rules) {
+            QList<SignalRule::Condition> conditions;
+            for (const RuleConditionDef& conditionDef : ruleDef.conditions) {
+                conditions.append(SignalRule::Condition{toQString(conditionDef.entityType),
+                                                        toQString(conditionDef.entityId),
+                                                        toQString(conditionDef.requiredState)});
+            }
+
+            QList<SignalRule::AllowedSignal> allowedSignals;
+            for (const AllowedSignalDef& allowedDef : ruleDef.allows) {
+                allowedSignals.append(SignalRule::AllowedSignal{toQString(allowedDef.signalId),
+                                                                toQStringList(allowedDef.aspects)});
+            }
+
+            signalInfo.rules.append(SignalRule(toQString(ruleDef.whenAspect), conditions, allowedSignals));
+        }
+
+        ruleSet->signalRules.insert(toQString(signalDef.signalId), signalInfo);
     }
 
-    auto requiredComponents = parseCompositeAspect(compositeAspect);
-    auto signalData = m_dbManager->getSignalById(signalId);
+    return ruleSet;
+}
 
-    QString currentMainAspect = signalData.value("currentAspect", "RED").toString();
-    QString currentCallingOn = signalData.value("callingOnAspect", "OFF").toString();
-    QString currentLoop = signalData.value("loopAspect", "OFF").toString();
+InterlockingRuleEngine::RuleSetPtr InterlockingRuleEngine::compileRulesFile(const QString& filePath, QStringList& errors) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errors.append(QString("Cannot open interlocking rules file: %1").arg(filePath));
+        return nullptr;
+    }
 
-    bool mainMatches = (currentMainAspect == requiredComponents["main"].toString());
-    bool callingOnMatches = (currentCallingOn == requiredComponents["calling_on"].toString());
-    bool loopMatches = (currentLoop == requiredComponents["loop"].toString());
+    auto ruleSet = compileRuleSet(file.readAll(), filePath, errors);
+    if (ruleSet) {
+        ruleSet->version = 1;
+        ruleSet->compiledAt = QDateTime::currentDateTime();
+    }
+    return ruleSet;
+}
 
-    return mainMatches && callingOnMatches && loopMatches;
+InterlockingRuleEngine::RuleSetPtr InterlockingRuleEngine::builtInRuleSet() {
+    auto ruleSet = buildRuleSetFromGeneratedTables();
+    ruleSet->version = 1;
+    ruleSet->compiledAt = QDateTime::currentDateTime();
+    return ruleSet;
 }
 
 bool InterlockingRuleEngine::loadRulesFromResource(const QString& resourcePath) {
@@ -58,23 +134,316 @@ bool InterlockingRuleEngine::loadRulesFromResource(const QString& resourcePath)
         return false;
     }
 
+    QStringList errors;
+    auto ruleSet = compileRuleSet(file.readAll(), resourcePath, errors);
+    if (!ruleSet) {
+        qCritical() << " [loadRules] Interlocking rules rejected:" << errors;
+        return false;
+    }
+
+    publishRuleSet(std::move(ruleSet));
+    return true;
+}
+
+// === HOT RELOAD ===
+
+void InterlockingRuleEngine::reloadRulesAsync(const QString& filePath) {
+    {
+        std::lock_guard<std::mutex> lock(m_reloadMutex);
+        if (m_reloadInProgress) {
+            //   PENDING: The file changed again mid-compile - reload once more when this one ends
+            m_pendingReloadPath = filePath;
+            qDebug() << " [reloadRules] Reload in progress - queued follow-up reload of" << filePath;
+            return;
+        }
+        m_reloadInProgress = true;
+    }
+
+    startReloadCompile(filePath);
+}
+
+void InterlockingRuleEngine::startReloadCompile(const QString& filePath) {
+    qDebug() << " [reloadRules] Compiling interlocking rules in background:" << filePath;
+
+    m_compilePool.start([this, filePath]() {
+        QStringList errors;
+        std::shared_ptr<RuleSet> ruleSet;
+
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            errors.append(QString("Cannot open rules file: %1").arg(file.errorString()));
+        } else {
+            ruleSet = compileRuleSet(file.readAll(), filePath, errors);
+        }
+
+        if (ruleSet) {
+            publishRuleSet(ruleSet);
+        } else {
+            //   SAFETY: The previously published rule set stays active
+            qCritical() << " [reloadRules] Rejected rules from" << filePath << "- keeping version"
+                        << rulesVersion() << ":" << errors;
+        }
+
+        //   Hand over to a queued reload under the same lock requesters use, so none is lost
+        QString nextPath;
+        {
+            std::lock_guard<std::mutex> lock(m_reloadMutex);
+            nextPath = std::exchange(m_pendingReloadPath, QString());
+            m_reloadInProgress = !nextPath.isEmpty();
+        }
+
+        if (ruleSet) {
+            emit rulesReloaded(ruleSet->version, filePath);
+        } else {
+            emit rulesReloadFailed(filePath, errors);
+        }
+
+        if (!nextPath.isEmpty()) {
+            startReloadCompile(nextPath);
+        }
+    });
+}
+
+bool InterlockingRuleEngine::watchRulesFile(const QString& filePath) {
+    if (!QFileInfo::exists(filePath)) {
+        qWarning() << " [watchRules] Rules file does not exist:" << filePath;
+        return false;
+    }
+
+    if (!m_rulesWatcher) {
+        m_rulesWatcher = new QFileSystemWatcher(this);
+        m_reloadDebounceTimer = new QTimer(this);
+        m_reloadDebounceTimer->setSingleShot(true);
+        m_reloadDebounceTimer->setInterval(RELOAD_DEBOUNCE_MS);
+
+        connect(m_reloadDebounceTimer, &QTimer::timeout, this, [this]() {
+            reloadRulesAsync(m_watchedRulesPath);
+        });
+
+        connect(m_rulesWatcher, &QFileSystemWatcher::fileChanged, this, [this](const QString& path) {
+            //   Editors often save by replace, which drops the path from the watcher
+            if (!m_rulesWatcher->files().contains(path) && QFileInfo::exists(path)) {
+                m_rulesWatcher->addPath(path);
+            }
+            m_reloadDebounceTimer->start();
+        });
+    }
+
+    if (!m_watchedRulesPath.isEmpty()) {
+        m_rulesWatcher->removePath(m_watchedRulesPath);
+    }
+
+    m_watchedRulesPath = filePath;
+    m_rulesWatcher->addPath(filePath);
+    reloadRulesAsync(filePath);
+
+    qDebug() << " [watchRules] Watching interlocking rules file:" << filePath;
+    return true;
+}
+
+quint64 InterlockingRuleEngine::rulesVersion() const {
+    auto ruleSet = currentRules();
+    return ruleSet ? ruleSet->version : 0;
+}
+
+void InterlockingRuleEngine::publishRuleSet(std::shared_ptr<RuleSet> ruleSet) {
+    ruleSet->version = m_versionCounter.fetch_add(1, std::memory_order_relaxed) + 1;
+    ruleSet->compiledAt = QDateTime::currentDateTime();
+
+    const quint64 version = ruleSet->version;
+    const int signalCount = ruleSet->signalRules.size();
+    const QString sourcePath = ruleSet->sourcePath;
+
+    m_ruleSet.store(RuleSetPtr(std::move(ruleSet)), std::memory_order_release);
+
+    qDebug() << " [publishRules] Interlocking rules version" << version << "active:"
+             << signalCount << "signals from" << sourcePath;
+}
+
+// === SERVER-SIDE REPLICA ===
+
+bool InterlockingRuleEngine::installServerSideRules(QSqlDatabase db) const {
+    RuleSetPtr ruleSet = currentRules();
+    if (!ruleSet) {
+        qWarning() << " [installServerRules] No rule set published - nothing to install";
+        return false;
+    }
+
+    if (!db.transaction()) {
+        qWarning() << " [installServerRules] Failed to start transaction:" << db.lastError().text();
+        return false;
+    }
+
+    QSqlQuery query(db);
+    if (!query.exec("DELETE FROM railway_control.compiled_signal_rules")
+        || !query.exec("DELETE FROM railway_control.compiled_signal_control")) {
+        qWarning() << " [installServerRules] Failed to clear previous rules:" << query.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    QSqlQuery controlInsert(db);
+    controlInsert.prepare(R"(
+        INSERT INTO railway_control.compiled_signal_control
+        (signal_id, is_independent, control_mode, controlled_by, rules_version)
+        VALUES (?, ?, ?, ?::TEXT[], ?)
+    )");
+
+    QSqlQuery ruleInsert(db);
+    ruleInsert.prepare(R"(
+        INSERT INTO railway_control.compiled_signal_rules
+        (controller_signal_id, when_bits, when_mask, condition_machines, condition_position_ids, allows, rules_version)
+        VALUES (?, ?, ?, ?::TEXT[], ?::INTEGER[], ?::jsonb, ?)
+    )");
+
+    const qint64 version = static_cast<qint64>(ruleSet->version);
+    int ruleRows = 0;
+
+    for (auto it = ruleSet->signalRules.cbegin(); it != ruleSet->signalRules.cend(); ++it) {
+        const SignalInfo& signalInfo = it.value();
+        const QString controlMode = signalInfo.controlMode.trimmed().toUpper();
+
+        controlInsert.addBindValue(it.key());
+        controlInsert.addBindValue(signalInfo.isIndependent);
+        controlInsert.addBindValue(controlMode.isEmpty() ? QStringLiteral("AND") : controlMode);
+        controlInsert.addBindValue(QString("{%1}").arg(signalInfo.controlledBy.join(',')));
+        controlInsert.addBindValue(version);
+        if (!controlInsert.exec()) {
+            qWarning() << " [installServerRules] Failed to install" << it.key() << ":" << controlInsert.lastError().text();
+            db.rollback();
+            return false;
+        }
+
+        for (const SignalRule& rule : signalInfo.rules) {
+            //   Only point conditions are evaluated (track segment conditions are not enforced in C++ either)
+            QStringList machines;
+            QStringList positionIds;
+            for (const SignalRule::Condition& condition : rule.getConditions()) {
+                if (condition.entityType == "point_machine") {
+                    machines.append(condition.entityId);
+                    positionIds.append(QString::number(ConfigLookup::positionId(condition.requiredState)));
+                }
+            }
+
+            QJsonObject allows;
+            for (const SignalRule::AllowedSignal& allowedSignal : rule.getAllowedSignals()) {
+                allows.insert(allowedSignal.signalId, QJsonArray::fromStringList(allowedSignal.allowedAspects));
+            }
+
+            ruleInsert.addBindValue(it.key());
+            ruleInsert.addBindValue(static_cast<qint32>(rule.getPackedWhenAspect().bits()));
+            ruleInsert.addBindValue(static_cast<qint32>(rule.getPackedWhenAspect().mask()));
+            ruleInsert.addBindValue(QString("{%1}").arg(machines.join(',')));
+            ruleInsert.addBindValue(QString("{%1}").arg(positionIds.join(',')));
+            ruleInsert.addBindValue(QString::fromUtf8(QJsonDocument(allows).toJson(QJsonDocument::Compact)));
+            ruleInsert.addBindValue(version);
+            if (!ruleInsert.exec()) {
+                qWarning() << " [installServerRules] Failed to install rule for" << it.key() << ":" << ruleInsert.lastError().text();
+                db.rollback();
+                return false;
+            }
+            ++ruleRows;
+        }
+    }
+
+    if (!db.commit()) {
+        qWarning() << " [installServerRules] Commit failed:" << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    qDebug() << " [installServerRules] Installed rules version" << version << ":"
+             << ruleSet->signalRules.size() << "signals," << ruleRows << "rules";
+    return true;
+}
+
+std::shared_ptr<InterlockingRuleEngine::RuleSet> InterlockingRuleEngine::compileRuleSet(
+    const QByteArray& jsonData, const QString& sourcePath, QStringList& errors) {
+
     QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    QJsonDocument doc = QJsonDocument::fromJson(jsonData, &parseError);
 
     if (parseError.error != QJsonParseError::NoError) {
-        qCritical() << " [loadRules] Invalid JSON in interlocking rules:" << parseError.errorString();
-        return false;
+        errors.append(QString("Invalid JSON: %1").arg(parseError.errorString()));
+        return nullptr;
     }
 
     QJsonObject rootObject = doc.object();
     QJsonObject rulesObject = rootObject["signal_interlocking_rules"].toObject();
+    if (rulesObject.isEmpty()) {
+        errors.append("Missing or empty 'signal_interlocking_rules' object");
+        return nullptr;
+    }
+
+    auto ruleSet = std::make_shared<RuleSet>();
+    ruleSet->stationId = rootObject["station_id"].toString();
+    ruleSet->sourcePath = sourcePath;
 
-    return parseJsonRules(rulesObject);
+    if (!parseJsonRules(rulesObject, *ruleSet, errors)) {
+        return nullptr;
+    }
+
+    validateRuleSet(*ruleSet, errors);
+    if (!errors.isEmpty()) {
+        return nullptr;
+    }
+
+    return ruleSet;
 }
 
-ValidationResult InterlockingRuleEngine::validateControllingSignals(const QString& signalId, const QString& requestedAspect) {
-    auto signalInfoIt = m_signalRules.find(signalId);
-    if (signalInfoIt == m_signalRules.end()) {
+void InterlockingRuleEngine::validateRuleSet(const RuleSet& ruleSet, QStringList& errors) {
+    using namespace RailFlux::Station;
+
+    for (auto it = ruleSet.signalRules.cbegin(); it != ruleSet.signalRules.cend(); ++it) {
+        const QString& signalId = it.key();
+        const SignalInfo& signalInfo = it.value();
+
+        if (!isValidControlMode(signalInfo.controlMode)) {
+            errors.append(QString("%1: invalid control_mode '%2'").arg(signalId, signalInfo.controlMode));
+        }
+
+        for (const QString& controllerId : signalInfo.controlledBy) {
+            if (!ruleSet.signalRules.contains(controllerId)) {
+                errors.append(QString("%1: controlled_by references unknown signal %2").arg(signalId, controllerId));
+            }
+        }
+
+        for (const SignalRule& rule : signalInfo.rules) {
+            if (rule.getWhenAspect().isEmpty()) {
+                errors.append(QString("%1: rule without when_aspect").arg(signalId));
+            } else if (!isValidRuleAspect(rule.getWhenAspect())) {
+                errors.append(QString("%1: unknown when_aspect '%2'").arg(signalId, rule.getWhenAspect()));
+            }
+
+            for (const SignalRule::Condition& condition : rule.getConditions()) {
+                if (!condition.isValid() || condition.entityType == "unknown") {
+                    errors.append(QString("%1: unrecognised condition in rule for %2").arg(signalId, rule.getWhenAspect()));
+                } else if (condition.entityType == "point_machine" && !isValidPointPosition(condition.requiredState)) {
+                    errors.append(QString("%1: point machine %2 has invalid position '%3'")
+                                      .arg(signalId, condition.entityId, condition.requiredState));
+                }
+            }
+
+            for (const SignalRule::AllowedSignal& allowedSignal : rule.getAllowedSignals()) {
+                if (!ruleSet.signalRules.contains(allowedSignal.signalId)) {
+                    errors.append(QString("%1: allows unknown signal %2").arg(signalId, allowedSignal.signalId));
+                }
+                if (allowedSignal.allowedAspects.isEmpty()) {
+                    errors.append(QString("%1: empty aspect list for %2").arg(signalId, allowedSignal.signalId));
+                }
+            }
+        }
+    }
+}
+
+ValidationResult InterlockingRuleEngine::validateControllingSignals(const RuleSet& ruleSet,
+                                                                   const QString& signalId,
+                                                                   const QString& requestedAspect,
+                                                                   const AspectReader& readAspect,
+                                                                   const PositionReader& readPosition,
+                                                                   const OccupancyReader& readOccupancy) {
+    auto signalInfoIt = ruleSet.signalRules.find(signalId);
+    if (signalInfoIt == ruleSet.signalRules.end()) {
         qWarning() << " [validateControlling] Signal" << signalId << "not found in rules";
         return ValidationResult::blocked("Signal not found in rules", "SIGNAL_NOT_FOUND");
     }
@@ -87,10 +456,11 @@ ValidationResult InterlockingRuleEngine::validateControllingSignals(const QStrin
     QStringList blockingReasons;
 
     for (const QString& controllingSignalId : signalInfo.controlledBy) {
-        QString controllingCompositeAspect = getCurrentCompositeAspect(controllingSignalId);
+        //   One read per controlling signal; every rule below is matched against this packed state
+        const PackedAspect controllingState = readAspect(controllingSignalId);
 
-        auto controllingInfoIt = m_signalRules.find(controllingSignalId);
-        if (controllingInfoIt == m_signalRules.end()) {
+        auto controllingInfoIt = ruleSet.signalRules.find(controllingSignalId);
+        if (controllingInfoIt == ruleSet.signalRules.end()) {
             continue;
         }
 
@@ -98,13 +468,11 @@ ValidationResult InterlockingRuleEngine::validateControllingSignals(const QStrin
         bool aspectAllowed = false;
 
         for (const SignalRule& rule : controllingInfo.rules) {
-            QString ruleWhenAspect = rule.getWhenAspect();
-
-            if (doesSignalMatchCompositeAspect(controllingSignalId, ruleWhenAspect)) {
-                if (!checkConditions(rule.getConditions())) {
+            if (rule.getPackedWhenAspect().matches(controllingState)) {
+                if (!checkConditions(rule.getConditions(), readPosition, readOccupancy)) {
                     blockingReasons.append(
                         QString("Conditions not met for rule when %1 shows %2")
-                            .arg(controllingSignalId, ruleWhenAspect));
+                            .arg(controllingSignalId, rule.getWhenAspect()));
                     continue;
                 }
 
@@ -120,7 +488,7 @@ ValidationResult InterlockingRuleEngine::validateControllingSignals(const QStrin
                 qWarning() << " [validateControlling] AND mode blocked by" << controllingSignalId;
                 return ValidationResult::blocked(
                            QString("Signal %1 cannot show %2: controlling signal %3 shows %4")
-                               .arg(signalId, requestedAspect, controllingSignalId, controllingCompositeAspect),
+                               .arg(signalId, requestedAspect, controllingSignalId, controllingState.toString()),
                            "CONTROLLING_SIGNAL_RESTRICTION"
                            ).addAffectedEntity(controllingSignalId);
             }
@@ -149,8 +517,51 @@ ValidationResult InterlockingRuleEngine::validateControllingSignals(const QStrin
 ValidationResult InterlockingRuleEngine::validateInterlockedSignalAspectChange(
     const QString& signalId, const QString& currentAspect, const QString& requestedAspect) {
 
-    auto signalInfoIt = m_signalRules.find(signalId);
-    if (signalInfoIt == m_signalRules.end()) {
+    Q_UNUSED(currentAspect);
+
+    //   SNAPSHOT: Hold this version for the whole evaluation, even if a reload publishes meanwhile
+    return evaluateAspectChange(currentRules(), signalId, requestedAspect,
+                                [this](const QString& id) { return readPackedSignalAspect(id); },
+                                [this](const QString& id) { return getCurrentPointPosition(id); },
+                                [this](const QString& id) { return isTrackSegmentOccupied(id); });
+}
+
+ValidationResult InterlockingRuleEngine::validateInterlockedSignalAspectChange(
+    const InterlockingSnapshot& snapshot, const QString& signalId,
+    const QString& currentAspect, const QString& requestedAspect) {
+
+    Q_UNUSED(currentAspect);
+
+    //   Unknown entities read as the database path's defaults: RED signal, NORMAL points,
+    //   occupied segments
+    return evaluateAspectChange(
+        snapshot.rules, signalId, requestedAspect,
+        [&snapshot](const QString& id) {
+            const InterlockingSnapshot::SignalState* signal = snapshot.signalState(id);
+            return signal ? signal->packedAspect() : PackedAspect::fromState("RED", "OFF", "OFF");
+        },
+        [&snapshot](const QString& id) {
+            const InterlockingSnapshot::PointState* point = snapshot.pointState(id);
+            return point && !point->position.isEmpty() ? point->position : QString("NORMAL");
+        },
+        [&snapshot](const QString& id) {
+            const InterlockingSnapshot::Occupancy* segment = snapshot.trackSegment(id);
+            return !segment || segment->occupied;
+        });
+}
+
+ValidationResult InterlockingRuleEngine::evaluateAspectChange(const RuleSetPtr& ruleSet,
+                                                              const QString& signalId,
+                                                              const QString& requestedAspect,
+                                                              const AspectReader& readAspect,
+                                                              const PositionReader& readPosition,
+                                                              const OccupancyReader& readOccupancy) {
+    if (!ruleSet) {
+        return ValidationResult::blocked("Interlocking rules not loaded", "RULES_NOT_LOADED");
+    }
+
+    auto signalInfoIt = ruleSet->signalRules.find(signalId);
+    if (signalInfoIt == ruleSet->signalRules.end()) {
         qWarning() << " [validateAspectChange] Signal" << signalId << "not found in interlocking rules";
         return ValidationResult::blocked(
             QString("Signal %1 not found in interlocking rules").arg(signalId),
@@ -164,27 +575,18 @@ ValidationResult InterlockingRuleEngine::validateInterlockedSignalAspectChange(
         return ValidationResult::allowed("Independent signal - no interlocking restrictions");
     }
 
-    return validateControllingSignals(signalId, requestedAspect);
+    return validateControllingSignals(*ruleSet, signalId, requestedAspect, readAspect, readPosition, readOccupancy);
 }
 
 // === UTILITY METHODS ===
 
-QString InterlockingRuleEngine::getCurrentCompositeAspect(const QString& signalId) {
+PackedAspect InterlockingRuleEngine::readPackedSignalAspect(const QString& signalId) {
     if (!m_dbManager) {
-        qWarning() << " [getCurrentComposite] Database manager not available";
-        return "RED";
+        qWarning() << " [readPackedAspect] Database manager not available";
+        return PackedAspect::fromState("RED", "OFF", "OFF");
     }
 
-    auto signalData = m_dbManager->getSignalById(signalId);
-    QString mainAspect = signalData.value("currentAspect", "RED").toString();
-    QString callingOnAspect = signalData.value("callingOnAspect", "OFF").toString();
-    QString loopAspect = signalData.value("loopAspect", "OFF").toString();
-
-    QString compositeAspect = mainAspect;
-    if (callingOnAspect == "WHITE") compositeAspect += "_CALLING";
-    if (loopAspect == "YELLOW") compositeAspect += "_LOOP";
-
-    return compositeAspect;
+    return PackedAspect::fromSignalData(m_dbManager->getSignalById(signalId));
 }
 
 QString InterlockingRuleEngine::getCurrentPointPosition(const QString& pointId) {
@@ -197,20 +599,24 @@ QString InterlockingRuleEngine::getCurrentPointPosition(const QString& pointId)
     return pointData.value("position", "NORMAL").toString();
 }
 
-QString InterlockingRuleEngine::getCurrentSignalAspect(const QString& signalId) {
+bool InterlockingRuleEngine::isTrackSegmentOccupied(const QString& trackSegmentId) {
     if (!m_dbManager) {
-        qWarning() << " [getCurrentSignal] Database manager not available";
-        return "RED";
+        qWarning() << " [isTrackSegmentOccupied] Database manager not available";
+        return true;
     }
 
-    auto signalData = m_dbManager->getSignalById(signalId);
-    return signalData.value("currentAspect", "RED").toString();
+    //   Unknown segment: occupied, the restrictive reading
+    auto segmentData = m_dbManager->getTrackSegmentById(trackSegmentId);
+    return segmentData.value("occupied", true).toBool();
 }
 
 QStringList InterlockingRuleEngine::getControlledSignals(const QString& signalId) const {
     QStringList controlled;
-    auto signalInfoIt = m_signalRules.find(signalId);
-    if (signalInfoIt != m_signalRules.end()) {
+    RuleSetPtr ruleSet = currentRules();
+    if (!ruleSet) return controlled;
+
+    auto signalInfoIt = ruleSet->signalRules.find(signalId);
+    if (signalInfoIt != ruleSet->signalRules.end()) {
         const SignalInfo& signalInfo = signalInfoIt.value();
         for (const SignalRule& rule : signalInfo.rules) {
             for (const SignalRule::AllowedSignal& allowedSignal : rule.getAllowedSignals()) {
@@ -224,47 +630,27 @@ QStringList InterlockingRuleEngine::getControlledSignals(const QString& signalId
 }
 
 QStringList InterlockingRuleEngine::getControllingSignals(const QString& signalId) const {
-    auto signalInfoIt = m_signalRules.find(signalId);
-    if (signalInfoIt != m_signalRules.end()) {
+    RuleSetPtr ruleSet = currentRules();
+    if (!ruleSet) return QStringList();
+
+    auto signalInfoIt = ruleSet->signalRules.find(signalId);
+    if (signalInfoIt != ruleSet->signalRules.end()) {
         return signalInfoIt.value().controlledBy;
     }
     return QStringList();
 }
 
-bool InterlockingRuleEngine::isCompositeAspect(const QString& aspect) {
-    return aspect.contains("_CALLING") || aspect.contains("_LOOP");
-}
-
 bool InterlockingRuleEngine::isSignalIndependent(const QString& signalId) const {
-    auto signalInfoIt = m_signalRules.find(signalId);
-    if (signalInfoIt != m_signalRules.end()) {
+    RuleSetPtr ruleSet = currentRules();
+    if (!ruleSet) return false;
+
+    auto signalInfoIt = ruleSet->signalRules.find(signalId);
+    if (signalInfoIt != ruleSet->signalRules.end()) {
         return signalInfoIt.value().isIndependent;
     }
     return false;
 }
 
-QVariantMap InterlockingRuleEngine::parseCompositeAspect(const QString& compositeAspect) {
-    QVariantMap components;
-    QString aspect = compositeAspect;
-
-    if (aspect.contains("_CALLING")) {
-        components["calling_on"] = "WHITE";
-        aspect = aspect.replace("_CALLING", "");
-    } else {
-        components["calling_on"] = "OFF";
-    }
-
-    if (aspect.contains("_LOOP")) {
-        components["loop"] = "YELLOW";
-        aspect = aspect.replace("_LOOP", "");
-    } else {
-        components["loop"] = "OFF";
-    }
-
-    components["main"] = aspect.isEmpty() ? "RED" : aspect;
-    return components;
-}
-
 // === PARSING METHODS ===
 
 SignalRule::AllowedSignal InterlockingRuleEngine::parseAllowedSignal(const QString& signalId, const QJsonArray& aspectsArray) {
@@ -302,11 +688,15 @@ SignalRule::Condition InterlockingRuleEngine::parseCondition(const QJsonObject&
     return condition;
 }
 
-bool InterlockingRuleEngine::parseJsonRules(const QJsonObject& rulesObject) {
-    m_signalRules.clear();
+bool InterlockingRuleEngine::parseJsonRules(const QJsonObject& rulesObject, RuleSet& ruleSet, QStringList& errors) {
+    ruleSet.signalRules.clear();
 
     for (auto it = rulesObject.begin(); it != rulesObject.end(); ++it) {
         QString signalId = it.key();
+        if (!it.value().isObject()) {
+            errors.append(QString("%1: signal entry is not an object").arg(signalId));
+            continue;
+        }
         QJsonObject signalObject = it.value().toObject();
 
         SignalInfo signalInfo;
@@ -326,10 +716,10 @@ bool InterlockingRuleEngine::parseJsonRules(const QJsonObject& rulesObject) {
             signalInfo.rules.append(rule);
         }
 
-        m_signalRules[signalId] = signalInfo;
+        ruleSet.signalRules[signalId] = signalInfo;
     }
 
-    return true;
+    return errors.isEmpty();
 }
 
 SignalRule InterlockingRuleEngine::parseRule(const QJsonObject& ruleObject) {
@@ -363,21 +753,30 @@ QStringList InterlockingRuleEngine::getAspectsPermittedByController(
              << "(" << controllerAspect << ") allows for" << controlledSignalId;
 
     // Find the controller signal's rules
-    auto signalInfoIt = m_signalRules.find(controllerSignalId);
-    if (signalInfoIt == m_signalRules.end()) {
+    RuleSetPtr ruleSet = currentRules();
+    if (!ruleSet) {
+        qWarning() << " [RULE_ENGINE] Interlocking rules not loaded";
+        return QStringList{"RED"}; // Safe fallback
+    }
+
+    auto signalInfoIt = ruleSet->signalRules.find(controllerSignalId);
+    if (signalInfoIt == ruleSet->signalRules.end()) {
         qWarning() << " [RULE_ENGINE] Controller signal" << controllerSignalId << "not found in rules";
         return QStringList{"RED"}; // Safe fallback
     }
 
     const SignalInfo& signalInfo = signalInfoIt.value();
+    const PackedAspect requestedControllerAspect = PackedAspect::fromRuleAspect(controllerAspect);
 
     // Look for rules that match the controller's current aspect
     for (const SignalRule& rule : signalInfo.rules) {
-        if (rule.getWhenAspect() == controllerAspect) {
+        if (rule.getPackedWhenAspect() == requestedControllerAspect) {
             qDebug() << "   Found matching rule for aspect:" << controllerAspect;
 
             // Check if all conditions are met (e.g., point machine positions)
-            if (!checkConditions(rule.getConditions())) {
+            if (!checkConditions(rule.getConditions(),
+                                 [this](const QString& id) { return getCurrentPointPosition(id); },
+                                 [this](const QString& id) { return isTrackSegmentOccupied(id); })) {
                 qDebug() << "    Conditions not met for rule, skipping";
                 continue; // Try next rule
             }
@@ -3,23 +3,80 @@
 #include <QHash>
 #include <QJsonObject>
 #include <QStringList>
+#include <QDateTime>
+#include <QThreadPool>
+#include <QSqlDatabase>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include "SignalRule.h"
 #include "InterlockingService.h"
 
 class DatabaseManager;
+struct InterlockingSnapshot;
+class QFileSystemWatcher;
+class QTimer;
 
 class InterlockingRuleEngine : public QObject {
     Q_OBJECT
 
 public:
+    struct SignalInfo {
+        QString signalType;
+        bool isIndependent = false;
+        QString controlMode; //   Added field
+        QStringList controlledBy;
+        QList<SignalRule> rules;
+    };
+
+    //   COMPILED RULE SET: Immutable once published. Validations take a snapshot at
+    //   entry, so a concurrent reload never changes the rules under an in-flight check.
+    struct RuleSet {
+        QString stationId;
+        QString sourcePath;
+        quint64 version = 0;
+        QDateTime compiledAt;
+        QHash<QString, SignalInfo> signalRules;
+    };
+    using RuleSetPtr = std::shared_ptr<const RuleSet>;
+
     explicit InterlockingRuleEngine(DatabaseManager* dbManager, QObject* parent = nullptr);
+    ~InterlockingRuleEngine();
 
+    //   BUILT-IN RULES: Publish the tables generated at build time (startup path, no parsing)
+    bool loadBuiltInRules();
+
+    //   SYNCHRONOUS LOAD: Compile and publish on the calling thread
     bool loadRulesFromResource(const QString& resourcePath = ":/resources/data/signal_interlocking_rules.json");
 
+    //   HOT RELOAD: Compile and validate off-thread, then publish with an atomic swap
+    void reloadRulesAsync(const QString& filePath);
+    bool watchRulesFile(const QString& filePath);
+
+    RuleSetPtr currentRules() const { return m_ruleSet.load(std::memory_order_acquire); }
+
+    //   SERVER-SIDE REPLICA: Copy the published rule set into railway_control.compiled_signal_*
+    //   for validate-and-apply commands. This engine stays the authority; the copy is replaced
+    //   wholesale, in one transaction, whenever it is reinstalled.
+    bool installServerSideRules(QSqlDatabase db) const;
+
+    //   STANDALONE COMPILATION: Rule sets for hosts that keep their own (one per station shard)
+    static RuleSetPtr compileRulesFile(const QString& filePath, QStringList& errors);
+    static RuleSetPtr builtInRuleSet();
+    quint64 rulesVersion() const;
+
     ValidationResult validateInterlockedSignalAspectChange(const QString& signalId,
                                                            const QString& currentAspect,
                                                            const QString& requestedAspect);
 
+    //   REENTRANT FORM: Rules, controlling aspects and point positions all come from the
+    //   snapshot, so concurrent callers share nothing mutable
+    static ValidationResult validateInterlockedSignalAspectChange(const InterlockingSnapshot& snapshot,
+                                                                  const QString& signalId,
+                                                                  const QString& currentAspect,
+                                                                  const QString& requestedAspect);
+
     // Information queries
     QStringList getControlledSignals(const QString& signalId) const;
     QStringList getControllingSignals(const QString& signalId) const;
@@ -30,35 +87,71 @@ public:
         const QString& controlledSignalId
         );
 
+signals:
+    void rulesReloaded(quint64 version, const QString& sourcePath);
+    void rulesReloadFailed(const QString& sourcePath, const QStringList& errors);
+
 private:
     DatabaseManager* m_dbManager;
 
-    struct SignalInfo {
-        QString signalType;
-        bool isIndependent = false;
-        QString controlMode; //   Added field
-        QStringList controlledBy;
-        QList<SignalRule> rules;
-    };
+    //   RCU PUBLICATION: Readers load, the compiler thread stores; old sets die with their last reader
+    std::atomic<RuleSetPtr> m_ruleSet;
+    std::atomic<quint64> m_versionCounter{0};
+
+    //   RELOAD COALESCING: A request during a compile is kept (latest path wins) and run after it
+    std::mutex m_reloadMutex;
+    bool m_reloadInProgress = false;
+    QString m_pendingReloadPath;
+    void startReloadCompile(const QString& filePath);
+
+    QFileSystemWatcher* m_rulesWatcher = nullptr;
+    QTimer* m_reloadDebounceTimer = nullptr;
+    QString m_watchedRulesPath;
+    static constexpr int RELOAD_DEBOUNCE_MS = 250;
 
-    QHash<QString, SignalInfo> m_signalRules;
+    //   STATE READERS: Database for the member API, snapshot for the reentrant one
+    using AspectReader = std::function<PackedAspect(const QString& signalId)>;
+    using PositionReader = std::function<QString(const QString& machineId)>;
+    using OccupancyReader = std::function<bool(const QString& trackSegmentId)>;
 
     // Helper methods
-    ValidationResult validateControllingSignals(const QString& signalId,
-                                                const QString& requestedAspect);
-    bool checkConditions(const QList<SignalRule::Condition>& conditions);
-    QString getCurrentSignalAspect(const QString& signalId);
+    static ValidationResult evaluateAspectChange(const RuleSetPtr& ruleSet,
+                                                 const QString& signalId,
+                                                 const QString& requestedAspect,
+                                                 const AspectReader& readAspect,
+                                                 const PositionReader& readPosition,
+                                                 const OccupancyReader& readOccupancy);
+    static ValidationResult validateControllingSignals(const RuleSet& ruleSet,
+                                                       const QString& signalId,
+                                                       const QString& requestedAspect,
+                                                       const AspectReader& readAspect,
+                                                       const PositionReader& readPosition,
+                                                       const OccupancyReader& readOccupancy);
+    //   Same semantics as StationAspectEvaluator: point conditions need the position, segment
+    //   conditions need OCCUPIED or (any other state) clear
+    static bool checkConditions(const QList<SignalRule::Condition>& conditions,
+                                const PositionReader& readPosition,
+                                const OccupancyReader& readOccupancy);
     QString getCurrentPointPosition(const QString& pointId);
+    bool isTrackSegmentOccupied(const QString& trackSegmentId);
+
+    //   COMPILATION: Pure functions of their input so they can run on any thread
+    static std::shared_ptr<RuleSet> compileRuleSet(const QByteArray& jsonData,
+                                                   const QString& sourcePath,
+                                                   QStringList& errors);
+    static std::shared_ptr<RuleSet> buildRuleSetFromGeneratedTables();
+    static void validateRuleSet(const RuleSet& ruleSet, QStringList& errors);
+    void publishRuleSet(std::shared_ptr<RuleSet> ruleSet);
 
     // JSON parsing
-    bool parseJsonRules(const QJsonObject& rulesObject);
-    SignalRule parseRule(const QJsonObject& ruleObject);
-    SignalRule::Condition parseCondition(const QJsonObject& conditionObject);
-    SignalRule::AllowedSignal parseAllowedSignal(const QString& signalId, const QJsonArray& aspectsArray);
-
-    //   NEW: Composite aspect evaluation
-    QString getCurrentCompositeAspect(const QString& signalId);
-    bool isCompositeAspect(const QString& aspect);
-    QVariantMap parseCompositeAspect(const QString& compositeAspect);
-    bool doesSignalMatchCompositeAspect(const QString& signalId, const QString& compositeAspect);
+    static bool parseJsonRules(const QJsonObject& rulesObject, RuleSet& ruleSet, QStringList& errors);
+    static SignalRule parseRule(const QJsonObject& ruleObject);
+    static SignalRule::Condition parseCondition(const QJsonObject& conditionObject);
+    static SignalRule::AllowedSignal parseAllowedSignal(const QString& signalId, const QJsonArray& aspectsArray);
+
+    //   Composite aspect evaluation: one read per controlling signal, packed for integer matching
+    PackedAspect readPackedSignalAspect(const QString& signalId);
+
+    //   Declared last: destroyed (and drained) before anything a compile task touches
+    QThreadPool m_compilePool;
 };
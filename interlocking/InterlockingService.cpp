@@ -1,10 +1,24 @@
 #include "InterlockingService.h"
 #include "InterlockingRuleEngine.h"
+#include "InterlockingSnapshot.h"
 #include "SignalBranch.h"
 #include "TrackCircuitBranch.h"
 #include "PointMachineBranch.h"
+#include "InterlockingPipeline.h"
+#include "OccupancyLatencyMonitor.h"
+#include "StationAspectEvaluator.h"
+#include "PackedAspect.h"
 #include "../database/DatabaseManager.h"
+#include "../database/StationEventBus.h"
+#include "../core/Clock.h"
+#include "../core/VersionedStore.h"
 #include <QDebug>
+#include <QPointer>
+#include <QSet>
+#include <QThread>
+#include <algorithm>
+#include <latch>
+#include <vector>
 
 // 
 //   ValidationResult Implementation
@@ -35,13 +49,63 @@ QVariantMap ValidationResult::toVariantMap() const {
     return map;
 }
 
+bool ValidationRequest::fromVariantMap(const QVariantMap& map, ValidationRequest& request) {
+    const QString kind = map.value("kind").toString().toUpper();
+    if (kind == "MAIN") request.kind = Kind::MainAspect;
+    else if (kind == "SUBSIDIARY") request.kind = Kind::SubsidiaryAspect;
+    else if (kind == "POINT") request.kind = Kind::PointPosition;
+    else if (kind == "PAIRED_POINT") request.kind = Kind::PairedPointPosition;
+    else return false;
+
+    request.entityId = map.value("entityId").toString();
+    request.pairedEntityId = map.value("pairedEntityId").toString();
+    request.aspectType = map.value("aspectType").toString();
+    request.currentState = map.value("currentState").toString();
+    request.pairedCurrentState = map.value("pairedCurrentState").toString();
+    request.requestedState = map.value("requestedState").toString();
+    request.operatorId = map.value("operatorId", "HMI_USER").toString();
+    return !request.entityId.isEmpty();
+}
+
+ValidationReadSet ReadSetVersions::readSet() const {
+    ValidationReadSet readSet;
+    readSet.signalIds = signalVersions.keys();
+    readSet.pointMachineIds = pointMachineVersions.keys();
+    readSet.trackCircuitIds = trackCircuitVersions.keys();
+    return readSet;
+}
+
+QVariantMap ReadSetVersions::toVariantMap() const {
+    auto toMap = [](const QHash<QString, int>& versions) {
+        QVariantMap map;
+        for (auto it = versions.cbegin(); it != versions.cend(); ++it) {
+            map.insert(it.key(), it.value());
+        }
+        return map;
+    };
+    return QVariantMap{{"signals", toMap(signalVersions)},
+                       {"pointMachines", toMap(pointMachineVersions)},
+                       {"trackCircuits", toMap(trackCircuitVersions)}};
+}
+
+ReadSetVersions ReadSetVersions::fromVariantMap(const QVariantMap& map) {
+    auto fromMap = [](const QVariant& value) {
+        QHash<QString, int> versions;
+        const QVariantMap entries = value.toMap();
+        for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+            versions.insert(it.key(), it.value().toInt());
+        }
+        return versions;
+    };
+    ReadSetVersions versions;
+    versions.signalVersions = fromMap(map["signals"]);
+    versions.pointMachineVersions = fromMap(map["pointMachines"]);
+    versions.trackCircuitVersions = fromMap(map["trackCircuits"]);
+    return versions;
+}
+
 InterlockingRuleEngine* InterlockingService::getRuleEngine() const {
-    // Since InterlockingService uses SignalBranch which has the rule engine
-    // We need to expose it. Looking at the code structure, add this:
-    if (m_signalBranch) {
-        return m_signalBranch->getRuleEngine(); // You might need to add this to SignalBranch too
-    }
-    return nullptr;
+    return m_ruleEngine.get();
 }
 
 // 
@@ -56,10 +120,17 @@ InterlockingService::InterlockingService(DatabaseManager* dbManager, QObject* pa
         return;
     }
 
-    //   CREATE VALIDATION BRANCHES
-    m_signalBranch = std::make_unique<SignalBranch>(dbManager, this);
+    //   RULE ENGINE: Publishes the rule sets that snapshots carry to the validation branches
+    m_ruleEngine = std::make_unique<InterlockingRuleEngine>(dbManager, this);
+    if (!m_ruleEngine->loadBuiltInRules()) {
+        qCritical() << " SAFETY: Failed to load interlocking rules - system may not be safe!";
+    }
+
+    //   CREATE VALIDATION BRANCHES: Signal and point validation are stateless (SignalBranch,
+    //   PointMachineBranch); only the reactive track circuit branch is an object
     m_trackSegmentBranch = std::make_unique<TrackCircuitBranch>(dbManager, this);
-    m_pointBranch = std::make_unique<PointMachineBranch>(dbManager, this);
+    m_validationPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+    m_stateStore = std::make_unique<VersionedStore<InterlockingSnapshot>>();
 
     //   CONNECT SAFETY SIGNALS: TrackCircuitBranch safety signals
     connect(m_trackSegmentBranch.get(), &TrackCircuitBranch::systemFreezeRequired,
@@ -75,12 +146,147 @@ InterlockingService::InterlockingService(DatabaseManager* dbManager, QObject* pa
                                                   QString("Automatic signal protection activated for %1 signals").arg(affectedSignals.size()));
             });
 
+    //   RULE RELOADS: Published from the compiler thread, delivered queued to receivers here
+    if (InterlockingRuleEngine* ruleEngine = getRuleEngine()) {
+        connect(ruleEngine, &InterlockingRuleEngine::rulesReloaded,
+                this, &InterlockingService::interlockingRulesReloaded);
+        connect(ruleEngine, &InterlockingRuleEngine::rulesReloadFailed,
+                this, &InterlockingService::interlockingRulesReloadFailed);
+        connect(ruleEngine, &InterlockingRuleEngine::rulesReloaded,
+                this, &InterlockingService::rebuildAspectEvaluator);
+        connect(ruleEngine, &InterlockingRuleEngine::rulesReloaded, this, [this]() {
+            m_protectionConfigStale = true;
+            queueStateRefresh();
+        });
+    }
+
+    //   BATCH ASPECT EVALUATION: Fold each state change into the SoA state, then recompute all
+    m_aspectEvaluator = std::make_unique<StationAspectEvaluator>();
+
+    //   One subscriber, one re-evaluation per batch however many records it carries
+    QPointer<InterlockingService> self(this);
+    dbManager->eventBus()->subscribe("aspect-evaluator", [self](StationEventBus::Batch batch) {
+        if (!self || !self->m_aspectEvaluator->isCompiled()) return;
+
+        StationEventBus* bus = self->m_dbManager->eventBus();
+        StationAspectEvaluator* evaluator = self->m_aspectEvaluator.get();
+        QSet<quint32> signalsRead;
+        bool changed = false;
+
+        //   PAYLOAD FIRST: Records carry the new value; only whole-row records (NOTIFY) are read
+        //   back, and a signal row at most once per batch
+        for (const StationEventBus::ChangeRecord& record : batch) {
+            const QString& entityId = bus->entityId(record.entity);
+            const bool hasValue = record.field != StationEventBus::Field::Row && record.newValue != StationEventBus::UNKNOWN_VALUE;
+            switch (record.kind) {
+            case StationEventBus::EntityKind::Signal: {
+                using Component = StationAspectEvaluator::AspectComponent;
+                const AspectCode code = static_cast<AspectCode>(record.newValue);
+                if (hasValue && record.field == StationEventBus::Field::MainAspect) {
+                    changed |= evaluator->setSignalAspectComponent(entityId, Component::Main, code);
+                } else if (hasValue && record.field == StationEventBus::Field::CallingOnAspect) {
+                    changed |= evaluator->setSignalAspectComponent(entityId, Component::CallingOn, code);
+                } else if (hasValue && record.field == StationEventBus::Field::LoopAspect) {
+                    changed |= evaluator->setSignalAspectComponent(entityId, Component::Loop, code);
+                } else if (!signalsRead.contains(record.entity)) {
+                    signalsRead.insert(record.entity);
+                    changed |= evaluator->setSignalAspect(entityId, PackedAspect::fromSignalData(self->m_dbManager->getSignalById(entityId)));
+                }
+                break;
+            }
+            case StationEventBus::EntityKind::PointMachine: {
+                QString position = StationEventBus::positionName(record.newValue);
+                if (record.field != StationEventBus::Field::Position || position.isEmpty()) {
+                    position = self->m_dbManager->getPointMachineById(entityId).value("position").toString();
+                }
+                changed |= evaluator->setPointPosition(entityId, position);
+                break;
+            }
+            case StationEventBus::EntityKind::TrackSegment: {
+                const bool isOccupied = record.field == StationEventBus::Field::Occupancy && hasValue
+                                            ? record.newValue != 0
+                                            : self->m_dbManager->getTrackSegmentById(entityId).value("occupied").toBool();
+                changed |= evaluator->setTrackSegmentOccupied(entityId, isOccupied);
+                break;
+            }
+            case StationEventBus::EntityKind::TrackCircuit: {
+                //   Polling and NOTIFY report circuits only: every section takes the circuit's occupancy
+                const bool isOccupied = record.field == StationEventBus::Field::Occupancy && hasValue
+                                            ? record.newValue != 0
+                                            : self->m_dbManager->getTrackCircuitOccupancy(entityId);
+                for (const QString& segmentId : self->m_dbManager->trackSegmentsForCircuit(entityId)) {
+                    changed |= evaluator->setTrackSegmentOccupied(segmentId, isOccupied);
+                }
+                break;
+            }
+            }
+        }
+
+        if (changed) {
+            self->reevaluatePermittedAspects();
+        }
+    });
+
+    //   STATE STORE: Follow the station so validations evaluate the current version without a
+    //   query of their own. Coalesced: a burst of batches queues one incremental refresh.
+    dbManager->eventBus()->subscribe("state-store", [self](StationEventBus::Batch batch) {
+        if (!self || !self->m_isOperational) return;
+
+        //   CONFIGURATION: A whole-row signal change may be a protection edit, not just an aspect
+        for (const StationEventBus::ChangeRecord& record : batch) {
+            if (record.entity == StationEventBus::EntityKind::Signal && record.field == StationEventBus::Field::Row) {
+                self->m_protectionConfigStale = true;
+                break;
+            }
+        }
+        self->queueStateRefresh();
+    });
+
+    //   STAGED PIPELINE: Same outcomes as the synchronous branch, published from the UI stage
+    m_latencyMonitor = std::make_unique<OccupancyLatencyMonitor>(this);
+    connect(m_latencyMonitor.get(), &OccupancyLatencyMonitor::sloViolated,
+            this, &InterlockingService::occupancyLatencySloViolated);
+
+    m_pipeline = std::make_unique<InterlockingPipeline>(this);
+    m_pipeline->setLatencyMonitor(m_latencyMonitor.get());
+
+    connect(m_pipeline.get(), &InterlockingPipeline::enforcementCompleted,
+            this, [this](const QString& trackSegmentId, const QStringList& affectedSignals) {
+                qDebug() << "  Pipelined interlocking completed for track segment" << trackSegmentId;
+                emit automaticProtectionActivated(trackSegmentId,
+                                                  QString("Automatic signal protection activated for %1 signals").arg(affectedSignals.size()));
+                verifyPipelinedProtection(trackSegmentId);
+            });
+
+    connect(m_pipeline.get(), &InterlockingPipeline::enforcementFailed,
+            this, [this](const QString& trackSegmentId, const QString& failedSignals, const QString& error) {
+                handleInterlockingFailure(trackSegmentId, failedSignals, error);
+                verifyPipelinedProtection(trackSegmentId);
+            });
+
+    connect(m_pipeline.get(), &InterlockingPipeline::unprotectedSegmentOccupied,
+            this, [this](const QString& trackSegmentId) {
+                qWarning() << " SAFETY WARNING: No protecting signals found for occupied track segment" << trackSegmentId;
+                verifyPipelinedProtection(trackSegmentId);
+            });
+
+    //   Enforcement always drives the signal to RED; the previous aspect is not carried
+    connect(m_pipeline.get(), &InterlockingPipeline::signalEnforced,
+            this, [this](const QString& signalId) {
+                m_dbManager->eventBus()->publish(StationEventBus::EntityKind::Signal, signalId,
+                                                 StationEventBus::Field::MainAspect, StationEventBus::UNKNOWN_VALUE,
+                                                 static_cast<qint32>(AspectCode::RED));
+            });
+
     qDebug() << "  InterlockingService initialized with all branches connected";
 }
 
 InterlockingService::~InterlockingService() {
     qDebug() << " InterlockingService destructor called";
-    //   Cleanup handled by smart pointers
+    //   Stage threads must be joined before the branches they report to go away
+    if (m_pipeline) {
+        m_pipeline->stop();
+    }
 }
 
 bool InterlockingService::initialize() {
@@ -94,10 +300,182 @@ bool InterlockingService::initialize() {
     m_isOperational = true;
     emit operationalStateChanged(m_isOperational);
 
+    startPipeline();
+    rebuildAspectEvaluator();
+
     qDebug() << "  Interlocking service initialized and operational";
     return true;
 }
 
+void InterlockingService::queueStateRefresh() {
+    if (!m_isOperational || m_stateRefreshQueued) return;
+
+    m_stateRefreshQueued = true;
+    QPointer<InterlockingService> self(this);
+    QMetaObject::invokeMethod(this, [self]() {
+        if (!self) return;
+        self->m_stateRefreshQueued = false;
+        if (self->m_isOperational) {
+            self->refreshState();
+        }
+    }, Qt::QueuedConnection);
+}
+
+void InterlockingService::startPipeline() {
+    if (!m_pipeline || !m_trackSegmentBranch || m_pipeline->isRunning()) {
+        return;
+    }
+
+    auto protectionTable = m_trackSegmentBranch->buildProtectionTable();
+    if (protectionTable.isEmpty()) {
+        qWarning() << " Protection table empty - occupancy reactions stay on the synchronous path";
+        return;
+    }
+
+    if (!m_pipeline->start(m_dbManager->getDatabase().connectionName(), protectionTable)) {
+        qWarning() << " Interlocking pipeline failed to start - occupancy reactions stay on the synchronous path";
+    }
+}
+
+void InterlockingService::rebuildAspectEvaluator() {
+    InterlockingRuleEngine* ruleEngine = getRuleEngine();
+    auto ruleSet = ruleEngine ? ruleEngine->currentRules() : nullptr;
+    if (!ruleSet || !m_aspectEvaluator) {
+        return;
+    }
+
+    QStringList errors;
+    if (!m_aspectEvaluator->compile(*ruleSet, errors)) {
+        qCritical() << " Station aspect evaluator rejected rules version" << ruleSet->version << ":" << errors;
+        return;
+    }
+
+    //   HYDRATE: One station snapshot; incremental updates arrive on the event bus
+    if (m_dbManager && m_dbManager->isConnected()) {
+        const QVariantMap snapshot = m_dbManager->getStationSnapshot();
+
+        for (const QVariant& value : snapshot["signals"].toList()) {
+            const QVariantMap signal = value.toMap();
+            m_aspectEvaluator->setSignalAspect(signal["id"].toString(), PackedAspect::fromSignalData(signal));
+        }
+
+        for (const QVariant& value : snapshot["pointMachines"].toList()) {
+            const QVariantMap machine = value.toMap();
+            m_aspectEvaluator->setPointPosition(machine["id"].toString(), machine["position"].toString());
+        }
+
+        for (const QVariant& value : snapshot["trackSegments"].toList()) {
+            const QVariantMap segment = value.toMap();
+            m_aspectEvaluator->setTrackSegmentOccupied(segment["id"].toString(), segment["occupied"].toBool());
+        }
+    }
+
+    reevaluatePermittedAspects();
+}
+
+void InterlockingService::reevaluatePermittedAspects() {
+    m_aspectEvaluator->evaluate();
+
+    const QStringList changed = m_aspectEvaluator->changedSignals();
+    if (!changed.isEmpty()) {
+        emit permittedAspectsChanged(changed);
+    }
+}
+
+QStringList InterlockingService::getPermittedAspects(const QString& signalId) const {
+    return m_aspectEvaluator ? m_aspectEvaluator->permittedAspects(signalId) : QStringList();
+}
+
+QVariantMap InterlockingService::getPermittedAspectsSnapshot() const {
+    return m_aspectEvaluator ? m_aspectEvaluator->toVariantMap() : QVariantMap();
+}
+
+QVariantMap InterlockingService::crossCheckPermittedAspects() {
+    if (!m_aspectEvaluator || !m_aspectEvaluator->isCompiled() || refreshState() == 0) {
+        return QVariantMap{{"error", "Aspect evaluator or station state not available"}};
+    }
+    const PinnedVersion<InterlockingSnapshot> state = pinState();
+    if (!state->rules) {
+        return QVariantMap{{"error", "Interlocking rules not loaded"}};
+    }
+
+    //   A copy hydrated from the pinned state, so the live evaluator's bus-fed state is untouched
+    StationAspectEvaluator evaluator = *m_aspectEvaluator;
+    for (auto it = state->signalStates.cbegin(); it != state->signalStates.cend(); ++it) {
+        evaluator.setSignalAspect(it.key(), it->packedAspect());
+    }
+    for (auto it = state->pointStates.cbegin(); it != state->pointStates.cend(); ++it) {
+        evaluator.setPointPosition(it.key(), it->position);
+    }
+    for (auto it = state->trackSegments.cbegin(); it != state->trackSegments.cend(); ++it) {
+        evaluator.setTrackSegmentOccupied(it.key(), it->occupied);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    evaluator.evaluate();
+    const qint64 evaluatorNs = timer.nsecsElapsed();
+
+    struct Verdict {
+        QString signalId;
+        QString aspect;
+        bool ruleEngine;
+    };
+    QList<Verdict> verdicts;
+    timer.restart();
+    for (auto it = state->signalStates.cbegin(); it != state->signalStates.cend(); ++it) {
+        if (!state->rules->signalRules.contains(it.key())) continue;
+        for (const QString& aspect : it->possibleAspects) {
+            verdicts.append({it.key(), aspect,
+                             InterlockingRuleEngine::validateInterlockedSignalAspectChange(
+                                 *state, it.key(), it->mainAspect, aspect).isAllowed()});
+        }
+    }
+    const qint64 ruleEngineNs = timer.nsecsElapsed();
+
+    QVariantList disagreements;
+    QSet<QString> signalsChecked;
+    for (const Verdict& verdict : verdicts) {
+        signalsChecked.insert(verdict.signalId);
+        const bool evaluatorAllows = evaluator.isAspectPermitted(verdict.signalId, verdict.aspect);
+        if (evaluatorAllows != verdict.ruleEngine) {
+            disagreements.append(QVariantMap{{"signalId", verdict.signalId}, {"aspect", verdict.aspect},
+                                             {"evaluator", evaluatorAllows}, {"ruleEngine", verdict.ruleEngine}});
+        }
+    }
+    if (!disagreements.isEmpty()) {
+        qCritical() << " SAFETY: Aspect evaluator and rule engine disagree on" << disagreements.size() << "aspects";
+    }
+
+    return QVariantMap{
+        {"rulesVersion", static_cast<qulonglong>(state->rules->version)},
+        {"signalsChecked", signalsChecked.size()},
+        {"aspectsChecked", verdicts.size()},
+        {"disagreements", disagreements},
+        {"evaluatorNs", evaluatorNs},
+        {"ruleEngineNs", ruleEngineNs}
+    };
+}
+
+bool InterlockingService::submitOccupancyChange(const QString& trackSegmentId, bool wasOccupied, bool isOccupied,
+                                                qint64 inputNs) {
+    if (!m_isOperational || !m_pipeline || !m_pipeline->isRunning()) {
+        return false;
+    }
+
+    //   CONSISTENCY: The three-source check runs once the pipeline publishes its outcome,
+    //   so no database query sits between detection and the danger command
+    return m_pipeline->submitOccupancyChange(trackSegmentId, wasOccupied, isOccupied, inputNs);
+}
+
+void InterlockingService::verifyPipelinedProtection(const QString& trackSegmentId) {
+    //   Re-runs the check the synchronous path performs so a data fault still freezes the system
+    if (m_trackSegmentBranch && m_pipeline) {
+        m_trackSegmentBranch->verifyProtectionConsistency(trackSegmentId,
+                                                          m_pipeline->protectingSignals(trackSegmentId));
+    }
+}
+
 // 
 //   VALIDATION METHODS: For operator-initiated actions only
 // 
@@ -113,13 +491,14 @@ ValidationResult InterlockingService::validateMainSignalOperation(
         return ValidationResult::blocked("Interlocking system not operational", "SYSTEM_OFFLINE");
     }
 
-    if (!m_signalBranch) {
-        qCritical() << " CRITICAL: SignalBranch not initialized!";
-        return ValidationResult::blocked("Signal validation not available", "SIGNAL_BRANCH_MISSING");
-    }
-
     //   DELEGATE TO SIGNAL BRANCH
-    auto result = m_signalBranch->validateMainAspectChange(signalId, currentAspect, requestedAspect, operatorId);
+    ValidationRequest request;
+    request.kind = ValidationRequest::Kind::MainAspect;
+    request.entityId = signalId;
+    request.currentState = currentAspect;
+    request.requestedState = requestedAspect;
+    request.operatorId = operatorId;
+    auto result = validateOnSnapshot(request);
 
     //   RECORD PERFORMANCE
     double responseTime = timer.elapsed();
@@ -158,11 +537,6 @@ ValidationResult InterlockingService::validateSubsidiarySignalOperation(
         return ValidationResult::blocked("Interlocking system not operational", "SYSTEM_OFFLINE");
     }
 
-    if (!m_signalBranch) {
-        qCritical() << " CRITICAL: SignalBranch not initialized for subsidiary signal validation!";
-        return ValidationResult::blocked("Signal validation not available", "SIGNAL_BRANCH_MISSING");
-    }
-
     //   VALIDATE ASPECT TYPE
     if (aspectType != "CALLING_ON" && aspectType != "LOOP") {
         qWarning() << " Invalid subsidiary aspect type:" << aspectType;
@@ -172,8 +546,14 @@ ValidationResult InterlockingService::validateSubsidiarySignalOperation(
     }
 
     //   DELEGATE TO SIGNAL BRANCH: Same pattern as main signals
-    auto result = m_signalBranch->validateSubsidiaryAspectChange(
-        signalId, aspectType, currentAspect, requestedAspect, operatorId);
+    ValidationRequest request;
+    request.kind = ValidationRequest::Kind::SubsidiaryAspect;
+    request.entityId = signalId;
+    request.aspectType = aspectType;
+    request.currentState = currentAspect;
+    request.requestedState = requestedAspect;
+    request.operatorId = operatorId;
+    auto result = validateOnSnapshot(request);
 
     //   PERFORMANCE MONITORING
     double responseTime = timer.elapsed();
@@ -206,13 +586,14 @@ ValidationResult InterlockingService::validatePointMachineOperation(
         return ValidationResult::blocked("Interlocking system not operational", "SYSTEM_OFFLINE");
     }
 
-    if (!m_pointBranch) {
-        qCritical() << " CRITICAL: PointMachineBranch not initialized!";
-        return ValidationResult::blocked("Point machine validation not available", "POINT_BRANCH_MISSING");
-    }
-
     //   DELEGATE TO POINT MACHINE BRANCH
-    auto result = m_pointBranch->validatePositionChange(machineId, currentPosition, requestedPosition, operatorId);
+    ValidationRequest request;
+    request.kind = ValidationRequest::Kind::PointPosition;
+    request.entityId = machineId;
+    request.currentState = currentPosition;
+    request.requestedState = requestedPosition;
+    request.operatorId = operatorId;
+    auto result = validateOnSnapshot(request);
 
     //   RECORD PERFORMANCE
     double responseTime = timer.elapsed();
@@ -242,14 +623,16 @@ ValidationResult InterlockingService::validatePairedPointMachineOperation(
         return ValidationResult::blocked("Interlocking system not operational", "SYSTEM_OFFLINE");
     }
 
-    if (!m_pointBranch) {
-        qCritical() << " CRITICAL: PointMachineBranch not initialized!";
-        return ValidationResult::blocked("Point machine validation not available", "POINT_BRANCH_MISSING");
-    }
-
     //   DELEGATE TO POINT MACHINE BRANCH FOR PAIRED VALIDATION
-    auto result = m_pointBranch->validatePairedOperation(
-        machineId, pairedMachineId, currentPosition, pairedCurrentPosition, requestedPosition, operatorId);
+    ValidationRequest request;
+    request.kind = ValidationRequest::Kind::PairedPointPosition;
+    request.entityId = machineId;
+    request.pairedEntityId = pairedMachineId;
+    request.currentState = currentPosition;
+    request.pairedCurrentState = pairedCurrentPosition;
+    request.requestedState = requestedPosition;
+    request.operatorId = operatorId;
+    auto result = validateOnSnapshot(request);
 
     //   RECORD PERFORMANCE
     double responseTime = timer.elapsed();
@@ -264,12 +647,424 @@ ValidationResult InterlockingService::validatePairedPointMachineOperation(
     return result;
 }
 
+// 
+//   SNAPSHOT VALIDATION: Reentrant branches over an immutable state capture
+// 
+
+quint64 InterlockingService::refreshState() {
+    if (!m_dbManager || !m_dbManager->isConnected()) {
+        return 0;
+    }
+
+    //   INCREMENTAL: Only rows changed since the current version come back
+    const qint64 sinceSeq = m_stateLoaded ? m_stateStore->pin()->sequence : 0;
+    QVariantMap rows = m_dbManager->getStationSnapshot(sinceSeq);
+    if (!rows.isEmpty() && rows["seq"].toLongLong() < sinceSeq) {
+        qWarning() << " Interlocking snapshot: change sequence went backwards - reloading whole station";
+        rows = m_dbManager->getStationSnapshot(0);
+    }
+    if (rows.isEmpty()) {
+        qWarning() << " SAFETY: Interlocking state refresh failed";
+        return 0;
+    }
+
+    //   CONFIGURATION: Protected circuits are not in the change rows; reread with every full load
+    //   and after a signal row or rule change. All queries run before the commit so the writer
+    //   lock covers only the in-memory apply.
+    const bool full = rows["full"].toBool() || m_protectionConfigStale;
+    m_protectionConfigStale = false;
+    const QVariantList signalRows = full ? m_dbManager->getAllSignalsList() : QVariantList();
+    const QHash<QString, QStringList> ruleProtectedCircuits =
+        full ? m_dbManager->getAllProtectedTrackCircuitsFromInterlockingRules() : QHash<QString, QStringList>();
+    const InterlockingRuleEngine::RuleSetPtr rules = m_ruleEngine ? m_ruleEngine->currentRules() : nullptr;
+    const QDateTime capturedAt = m_dbManager->clock()->currentDateTime();
+
+    //   COPY-ON-WRITE: The new version shares every hash with the last until the rows detach it
+    const quint64 version = m_stateStore->commit([&](InterlockingSnapshot& state) {
+        state.applyStationRows(rows);
+        if (full) {
+            state.applyProtectionConfiguration(signalRows, ruleProtectedCircuits);
+        }
+        state.rules = rules;
+        state.capturedAt = capturedAt;
+    });
+
+    m_stateLoaded = true;
+    return version;
+}
+
+PinnedVersion<InterlockingSnapshot> InterlockingService::pinState() const {
+    return m_stateStore->pin();
+}
+
+QVariantMap InterlockingService::getStateStoreStatistics() const {
+    QVariantMap stats;
+    stats["loaded"] = m_stateLoaded;
+    stats["version"] = m_stateStore->currentVersion();
+    stats["epoch"] = m_stateStore->epoch();
+    stats["activeReaders"] = m_stateStore->activeReaders();
+    stats["retiredVersions"] = m_stateStore->retiredVersions();
+    stats["reclaimedVersions"] = m_stateStore->reclaimedVersions();
+    stats["sequence"] = m_stateStore->pin()->sequence;
+    return stats;
+}
+
+ValidationResult InterlockingService::evaluate(const InterlockingSnapshot& snapshot, const ValidationRequest& request) {
+    switch (request.kind) {
+    case ValidationRequest::Kind::MainAspect:
+        return SignalBranch::validateMainAspectChange(
+            snapshot, request.entityId, request.currentState, request.requestedState, request.operatorId);
+    case ValidationRequest::Kind::SubsidiaryAspect:
+        return SignalBranch::validateSubsidiaryAspectChange(
+            snapshot, request.entityId, request.aspectType, request.currentState, request.requestedState, request.operatorId);
+    case ValidationRequest::Kind::PointPosition:
+        return PointMachineBranch::validatePositionChange(
+            snapshot, request.entityId, request.currentState, request.requestedState, request.operatorId);
+    case ValidationRequest::Kind::PairedPointPosition:
+        return PointMachineBranch::validatePairedOperation(
+            snapshot, request.entityId, request.pairedEntityId, request.currentState,
+            request.pairedCurrentState, request.requestedState, request.operatorId);
+    }
+    return ValidationResult::blocked("Unknown validation request", "UNKNOWN_REQUEST");
+}
+
+ValidationResult InterlockingService::validateOnSnapshot(const ValidationRequest& request) {
+    if (!ensureStateLoaded()) {
+        return ValidationResult::blocked("Station state not available for validation", "STATE_SNAPSHOT_UNAVAILABLE");
+    }
+    const PinnedVersion<InterlockingSnapshot> state = pinState();
+    InterlockingSnapshot overlay;
+    return evaluate(withPendingCommands(*state, overlay), request);
+}
+
+const InterlockingSnapshot& InterlockingService::withPendingCommands(const InterlockingSnapshot& pinned,
+                                                                     InterlockingSnapshot& overlay) const {
+    const CommandJournal::PendingState pending = m_dbManager->pendingJournalState();
+    if (pending.isEmpty()) {
+        return pinned;
+    }
+
+    //   Copy-on-write: only the hashes that take a pending value detach from the pinned version
+    overlay = pinned;
+    auto applySignal = [&overlay](const QHash<QString, QString>& aspects, QString InterlockingSnapshot::SignalState::*field) {
+        for (auto it = aspects.cbegin(); it != aspects.cend(); ++it) {
+            if (overlay.signalState(it.key())) {
+                overlay.signalStates[it.key()].*field = it.value();
+            }
+        }
+    };
+    applySignal(pending.mainAspects, &InterlockingSnapshot::SignalState::mainAspect);
+    applySignal(pending.callingOnAspects, &InterlockingSnapshot::SignalState::callingOnAspect);
+    applySignal(pending.loopAspects, &InterlockingSnapshot::SignalState::loopAspect);
+
+    for (auto it = pending.pointPositions.cbegin(); it != pending.pointPositions.cend(); ++it) {
+        if (overlay.pointState(it.key())) {
+            overlay.pointStates[it.key()].position = it.value();
+        }
+    }
+    return overlay;
+}
+
+ValidationReadSet InterlockingService::readSetOf(const InterlockingSnapshot& snapshot, const ValidationRequest& request) {
+    ValidationReadSet readSet;
+
+    switch (request.kind) {
+    case ValidationRequest::Kind::MainAspect:
+        //   Both protection sources; the branch refuses the aspect when they disagree
+        if (const InterlockingSnapshot::SignalState* signal = snapshot.signalState(request.entityId)) {
+            readSet.trackCircuitIds = signal->protectedTrackCircuits + signal->ruleProtectedTrackCircuits;
+        }
+        [[fallthrough]];
+    case ValidationRequest::Kind::SubsidiaryAspect:
+        //   Controlling aspects and the point conditions of the controllers' rules
+        if (snapshot.rules) {
+            const auto& signalRules = snapshot.rules->signalRules;
+            const auto signalIt = signalRules.constFind(request.entityId);
+            if (signalIt != signalRules.constEnd()) {
+                for (const QString& controllingSignalId : signalIt->controlledBy) {
+                    readSet.signalIds.append(controllingSignalId);
+                    const auto controllingIt = signalRules.constFind(controllingSignalId);
+                    if (controllingIt == signalRules.constEnd()) continue;
+                    for (const SignalRule& rule : controllingIt->rules) {
+                        for (const SignalRule::Condition& condition : rule.getConditions()) {
+                            if (condition.entityType == "point_machine") {
+                                readSet.pointMachineIds.append(condition.entityId);
+                            } else if (condition.entityType == "track_segment") {
+                                readSet.trackSegmentIds.append(condition.entityId);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        break;
+    case ValidationRequest::Kind::PointPosition:
+    case ValidationRequest::Kind::PairedPointPosition:
+        //   Either position's segments: the requested one is checked, the other is being left
+        for (const QString& machineId : {request.entityId, request.pairedEntityId}) {
+            if (const InterlockingSnapshot::PointState* point = snapshot.pointState(machineId)) {
+                readSet.trackSegmentIds << point->rootTrackSegment << point->normalTrackSegment
+                                        << point->reverseTrackSegment;
+            }
+        }
+        break;
+    }
+
+    for (QStringList* ids : {&readSet.signalIds, &readSet.pointMachineIds,
+                             &readSet.trackCircuitIds, &readSet.trackSegmentIds}) {
+        ids->removeAll(QString());
+        ids->removeAll(request.entityId);
+        ids->removeAll(request.pairedEntityId);
+        ids->removeDuplicates();
+    }
+    return readSet;
+}
+
+ReadSetVersions InterlockingService::versionsOf(const InterlockingSnapshot& snapshot, const ValidationReadSet& readSet) {
+    //   Rows missing from the snapshot are left out; a validation that needed them was refused
+    ReadSetVersions versions;
+    for (const QString& signalId : readSet.signalIds) {
+        if (const InterlockingSnapshot::SignalState* signal = snapshot.signalState(signalId)) {
+            versions.signalVersions.insert(signalId, signal->version);
+        }
+    }
+    for (const QString& machineId : readSet.pointMachineIds) {
+        if (const InterlockingSnapshot::PointState* point = snapshot.pointState(machineId)) {
+            versions.pointMachineVersions.insert(machineId, point->version);
+        }
+    }
+    QStringList circuitIds = readSet.trackCircuitIds;
+    for (const QString& segmentId : readSet.trackSegmentIds) {
+        if (const InterlockingSnapshot::Occupancy* segment = snapshot.trackSegment(segmentId)) {
+            circuitIds.append(segment->circuitId);
+        }
+    }
+    for (const QString& circuitId : circuitIds) {
+        if (const InterlockingSnapshot::Occupancy* circuit = snapshot.trackCircuit(circuitId)) {
+            versions.trackCircuitVersions.insert(circuitId, circuit->version);
+        }
+    }
+    return versions;
+}
+
+ValidationReadSet InterlockingService::validationReadSet(const ValidationRequest& request) {
+    if (!ensureStateLoaded()) {
+        return ValidationReadSet();
+    }
+    return readSetOf(*pinState(), request);
+}
+
+QList<ValidationResult> InterlockingService::validateBatch(const InterlockingSnapshot& snapshot,
+                                                           const QList<ValidationRequest>& requests) {
+    //   Each task writes only its own result slots
+    std::vector<ValidationResult> results(static_cast<size_t>(requests.size()));
+    runOnValidationPool(requests.size(), MIN_REQUESTS_PER_TASK, [&snapshot, &requests, &results](qsizetype i) {
+        results[static_cast<size_t>(i)] = evaluate(snapshot, requests[i]);
+    });
+    return QList<ValidationResult>(results.begin(), results.end());
+}
+
+void InterlockingService::runOnValidationPool(qsizetype count, qsizetype minPerTask,
+                                              const std::function<void(qsizetype)>& work) {
+    //   SMALL BATCHES: Not worth a hand-off
+    const qsizetype taskCount = std::min<qsizetype>(m_validationPool.maxThreadCount(),
+                                                    (count + minPerTask - 1) / minPerTask);
+    if (taskCount <= 1) {
+        for (qsizetype i = 0; i < count; ++i) {
+            work(i);
+        }
+        return;
+    }
+
+    //   FAN OUT: Contiguous slices
+    std::latch done(static_cast<std::ptrdiff_t>(taskCount));
+    const qsizetype sliceSize = (count + taskCount - 1) / taskCount;
+    for (qsizetype task = 0; task < taskCount; ++task) {
+        const qsizetype begin = task * sliceSize;
+        const qsizetype end = std::min(count, begin + sliceSize);
+        m_validationPool.start([&work, &done, begin, end]() {
+            for (qsizetype i = begin; i < end; ++i) {
+                work(i);
+            }
+            done.count_down();
+        });
+    }
+    done.wait();
+}
+
+QVariantList InterlockingService::validateOperations(const QVariantList& requests) {
+    if (!m_isOperational) {
+        const QVariantMap offline = ValidationResult::blocked("Interlocking system not operational", "SYSTEM_OFFLINE").toVariantMap();
+        return QVariantList(requests.size(), offline);
+    }
+
+    QList<ValidationRequest> parsed;
+    QList<qsizetype> parsedIndex;
+    QVariantList results;
+    results.reserve(requests.size());
+
+    for (qsizetype i = 0; i < requests.size(); ++i) {
+        ValidationRequest request;
+        if (ValidationRequest::fromVariantMap(requests[i].toMap(), request)) {
+            parsedIndex.append(i);
+            parsed.append(request);
+            results.append(QVariant());
+        } else {
+            results.append(ValidationResult::blocked("Malformed validation request", "INVALID_REQUEST").toVariantMap());
+        }
+    }
+
+    if (!ensureStateLoaded()) {
+        const QVariantMap unavailable = ValidationResult::blocked(
+            "Station state not available for validation", "STATE_SNAPSHOT_UNAVAILABLE").toVariantMap();
+        return QVariantList(requests.size(), unavailable);
+    }
+
+    //   One pinned version for the whole batch, however long it runs
+    const PinnedVersion<InterlockingSnapshot> state = pinState();
+    InterlockingSnapshot overlay;
+    const QList<ValidationResult> evaluated = validateBatch(withPendingCommands(*state, overlay), parsed);
+    for (qsizetype i = 0; i < evaluated.size(); ++i) {
+        results[parsedIndex[i]] = evaluated[i].toVariantMap();
+    }
+    return results;
+}
+
+// 
+//   SPECULATIVE EVALUATION: What-if checks over a private overlay, no database writes
+// 
+
+SpeculativeOutcome InterlockingService::evaluateSpeculative(const InterlockingSnapshot& snapshot,
+                                                            const SpeculativeChangeSet& changeSet) {
+    SpeculativeOutcome outcome;
+    outcome.candidateId = changeSet.candidateId;
+
+    //   OVERLAY: Shares every hash with the pinned snapshot until a step detaches the one it changes
+    InterlockingSnapshot overlay = snapshot;
+
+    //   READ SET: Whatever the checks read, plus the steps found already in place - the route
+    //   relies on those staying put just as much as on the ones it moves
+    ValidationReadSet readSet;
+    auto readBy = [&snapshot, &readSet](const ValidationRequest& request) {
+        const ValidationReadSet stepReads = readSetOf(snapshot, request);
+        readSet.signalIds += stepReads.signalIds;
+        readSet.pointMachineIds += stepReads.pointMachineIds;
+        readSet.trackCircuitIds += stepReads.trackCircuitIds;
+        readSet.trackSegmentIds += stepReads.trackSegmentIds;
+    };
+
+    //   POINTS FIRST: Protecting signals are still at danger, as they would be in the field
+    for (const auto& [machineId, targetPosition] : changeSet.pointPositions) {
+        const InterlockingSnapshot::PointState* point = overlay.pointState(machineId);
+        const QString currentPosition = point ? point->position : QString();
+
+        //   PAIRED: Crossovers throw together, so validate both ends and move both in the overlay
+        const QString pairedMachineId = point ? point->pairedMachineId : QString();
+        const InterlockingSnapshot::PointState* paired = overlay.pointState(pairedMachineId);
+        if (paired) {
+            outcome.pairedMachines.insert(machineId, pairedMachineId);
+        }
+
+        if (point && currentPosition == targetPosition) {
+            readSet.pointMachineIds.append(machineId);
+            continue;
+        }
+
+        ValidationRequest request;
+        request.kind = paired ? ValidationRequest::Kind::PairedPointPosition : ValidationRequest::Kind::PointPosition;
+        request.entityId = machineId;
+        request.pairedEntityId = paired ? pairedMachineId : QString();
+        request.currentState = currentPosition;
+        request.pairedCurrentState = paired ? paired->position : QString();
+        request.requestedState = targetPosition;
+        request.operatorId = changeSet.operatorId;
+
+        ValidationResult result = evaluate(overlay, request);
+        if (!result.isAllowed()) {
+            outcome.result = result;
+            outcome.blockingEntityId = machineId;
+            return outcome;
+        }
+        readBy(request);
+
+        //   One move per pair: the paired update drives both machines, and a later step for the
+        //   paired machine finds it already in position
+        outcome.requiredPointMoves.append({machineId, currentPosition, targetPosition,
+                                           point ? point->version : -1, paired ? paired->version : -1});
+        overlay.pointStates[machineId].position = targetPosition;
+        if (paired) {
+            overlay.pointStates[pairedMachineId].position = targetPosition;
+        }
+    }
+
+    //   SIGNALS: Checked against the moved points and any aspects already cleared for this route
+    for (const auto& [signalId, targetAspect] : changeSet.signalAspects) {
+        const InterlockingSnapshot::SignalState* signal = overlay.signalState(signalId);
+        if (signal && signal->mainAspect == targetAspect) {
+            readSet.signalIds.append(signalId);
+            continue;
+        }
+
+        ValidationRequest request;
+        request.kind = ValidationRequest::Kind::MainAspect;
+        request.entityId = signalId;
+        request.currentState = signal ? signal->mainAspect : QString();
+        request.requestedState = targetAspect;
+        request.operatorId = changeSet.operatorId;
+
+        ValidationResult result = evaluate(overlay, request);
+        if (!result.isAllowed()) {
+            outcome.result = result;
+            outcome.blockingEntityId = signalId;
+            return outcome;
+        }
+        readBy(request);
+
+        outcome.requiredAspectChanges.append({signalId, targetAspect, signal ? signal->version : -1});
+        overlay.signalStates[signalId].mainAspect = targetAspect;
+    }
+
+    //   Versions as validated: the pinned snapshot's, which the overlay never changes
+    outcome.readVersions = versionsOf(snapshot, readSet);
+    outcome.result = ValidationResult::allowed("Change set permitted on current state");
+    return outcome;
+}
+
+QList<SpeculativeOutcome> InterlockingService::evaluateSpeculativeBatch(const QList<SpeculativeChangeSet>& changeSets) {
+    auto unavailable = [&changeSets](const ValidationResult& result) {
+        QList<SpeculativeOutcome> outcomes;
+        for (const SpeculativeChangeSet& changeSet : changeSets) {
+            SpeculativeOutcome outcome;
+            outcome.candidateId = changeSet.candidateId;
+            outcome.result = result;
+            outcomes.append(outcome);
+        }
+        return outcomes;
+    };
+
+    if (!m_isOperational) {
+        return unavailable(ValidationResult::blocked("Interlocking system not operational", "SYSTEM_OFFLINE"));
+    }
+    if (!ensureStateLoaded()) {
+        return unavailable(ValidationResult::blocked("Station state not available for validation", "STATE_SNAPSHOT_UNAVAILABLE"));
+    }
+
+    const PinnedVersion<InterlockingSnapshot> state = pinState();
+    InterlockingSnapshot overlay;
+    const InterlockingSnapshot& current = withPendingCommands(*state, overlay);
+    std::vector<SpeculativeOutcome> outcomes(static_cast<size_t>(changeSets.size()));
+    runOnValidationPool(changeSets.size(), MIN_CHANGE_SETS_PER_TASK, [&current, &changeSets, &outcomes](qsizetype i) {
+        outcomes[static_cast<size_t>(i)] = evaluateSpeculative(current, changeSets[i]);
+    });
+    return QList<SpeculativeOutcome>(outcomes.begin(), outcomes.end());
+}
+
 // 
 //   REACTIVE INTERLOCKING: Hardware-driven trackSegment occupancy changes
 // 
 
 void InterlockingService::reactToTrackSegmentOccupancyChange(
-    const QString& trackSegmentId, bool wasOccupied, bool isOccupied) {
+    const QString& trackSegmentId, bool wasOccupied, bool isOccupied, qint64 inputNs) {
 
     if (!m_isOperational) {
         qCritical() << " CRITICAL: Interlocking system offline during trackSegment occupancy change!";
@@ -293,7 +1088,27 @@ void InterlockingService::reactToTrackSegmentOccupancyChange(
     //   ENFORCE INTERLOCKING: Only when trackSegment becomes occupied (safety-critical transition)
     if (!wasOccupied && isOccupied) {
         qDebug() << " SAFETY-CRITICAL TRANSITION: Track Segment section" << trackSegmentId << "became occupied";
-        m_trackSegmentBranch->enforceTrackSegmentOccupancyInterlocking(trackSegmentId, wasOccupied, isOccupied);
+
+        //   LATENCY: Synchronous path has no stage boundaries - measured end to end from arrival,
+        //   so the DB commit and queued dispatch ahead of this reaction are counted
+        OccupancyLatencyMonitor::Sample sample;
+        sample.trackSegmentId = trackSegmentId;
+        sample.inputNs = inputNs > 0 ? inputNs : OccupancyLatencyMonitor::nowNs();
+
+        bool enforcementFailed = false;
+        const QMetaObject::Connection failureWatch =
+            connect(m_trackSegmentBranch.get(), &TrackCircuitBranch::interlockingFailure,
+                    this, [&enforcementFailed]() { enforcementFailed = true; }, Qt::DirectConnection);
+
+        const bool enforced = m_trackSegmentBranch->enforceTrackSegmentOccupancyInterlocking(trackSegmentId, wasOccupied, isOccupied);
+        disconnect(failureWatch);
+
+        //   Unprotected or inactive segments enforce nothing and are not timed
+        if (enforced || enforcementFailed) {
+            sample.failed = !enforced;
+            sample.publishedNs = OccupancyLatencyMonitor::nowNs();
+            m_latencyMonitor->record(sample);
+        }
     } else {
         qDebug() << "Non-critical transition for trackSegment section" << trackSegmentId << "- no interlocking action needed";
     }
@@ -320,6 +1135,38 @@ int InterlockingService::getActiveInterlocksCount() const {
     return 0;
 }
 
+QVariantMap InterlockingService::getOccupancyLatencyStatistics() const {
+    return m_latencyMonitor ? m_latencyMonitor->statistics() : QVariantMap();
+}
+
+void InterlockingService::setOccupancyLatencySlo(int sloMs) {
+    if (m_latencyMonitor) {
+        m_latencyMonitor->setSloMs(sloMs);
+    }
+}
+
+void InterlockingService::resetOccupancyLatencyStatistics() {
+    if (m_latencyMonitor) {
+        m_latencyMonitor->reset();
+    }
+}
+
+void InterlockingService::reloadInterlockingRules(const QString& filePath) {
+    if (InterlockingRuleEngine* ruleEngine = getRuleEngine()) {
+        ruleEngine->reloadRulesAsync(filePath);
+    }
+}
+
+bool InterlockingService::watchInterlockingRulesFile(const QString& filePath) {
+    InterlockingRuleEngine* ruleEngine = getRuleEngine();
+    return ruleEngine && ruleEngine->watchRulesFile(filePath);
+}
+
+quint64 InterlockingService::getInterlockingRulesVersion() const {
+    InterlockingRuleEngine* ruleEngine = getRuleEngine();
+    return ruleEngine ? ruleEngine->rulesVersion() : 0;
+}
+
 void InterlockingService::recordResponseTime(double responseTimeMs) {
     std::lock_guard<std::mutex> lock(m_performanceMutex);
     m_responseTimeHistory.push_back(responseTimeMs);
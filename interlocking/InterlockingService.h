@@ -3,15 +3,23 @@
 #include <QElapsedTimer>
 #include <QTimer>
 #include <QDateTime>
+#include <QHash>
+#include <QVariantMap>
+#include <QThreadPool>
+#include <functional>
 #include <memory>
 #include <deque>
 #include <mutex>
 
 class DatabaseManager;
-class SignalBranch;
 class TrackCircuitBranch;
-class PointMachineBranch;
 class InterlockingRuleEngine;
+class InterlockingPipeline;
+class OccupancyLatencyMonitor;
+class StationAspectEvaluator;
+struct InterlockingSnapshot;
+template <typename T> class VersionedStore;
+template <typename T> class PinnedVersion;
 
 class ValidationResult {
     Q_GADGET
@@ -57,6 +65,82 @@ public:
     Q_INVOKABLE QVariantMap toVariantMap() const;
 };
 
+//   VALIDATION REQUEST: One operator action, for batch and what-if evaluation
+struct ValidationRequest {
+    enum class Kind { MainAspect, SubsidiaryAspect, PointPosition, PairedPointPosition };
+
+    Kind kind = Kind::MainAspect;
+    QString entityId;
+    QString pairedEntityId;         //   PairedPointPosition only
+    QString aspectType;             //   SubsidiaryAspect only: CALLING_ON / LOOP
+    QString currentState;
+    QString pairedCurrentState;     //   PairedPointPosition only
+    QString requestedState;
+    QString operatorId = "HMI_USER";
+
+    //   QML form: { kind: "MAIN" | "SUBSIDIARY" | "POINT" | "PAIRED_POINT", entityId, ... }
+    static bool fromVariantMap(const QVariantMap& map, ValidationRequest& request);
+};
+
+//   VALIDATION READ SET: Rows a request's validation reads besides its own target.
+//   Command writers lock them FOR SHARE and recheck their versions before committing.
+struct ValidationReadSet {
+    QStringList signalIds;          //   Controlling signals
+    QStringList pointMachineIds;    //   Rule conditions (points)
+    QStringList trackCircuitIds;    //   Protected circuits
+    QStringList trackSegmentIds;    //   Point segments and segment conditions; their occupancy is their circuit's
+};
+
+//   READ SET VERSIONS: Row versions of a read set, as validated. Rechecked FOR SHARE inside
+//   the write transaction, so a change to any of those rows fails the write.
+struct ReadSetVersions {
+    QHash<QString, int> signalVersions;
+    QHash<QString, int> pointMachineVersions;
+    QHash<QString, int> trackCircuitVersions;     //   Segments resolved to their circuits
+
+    bool operator==(const ReadSetVersions&) const = default;
+    bool isEmpty() const { return signalVersions.isEmpty() && pointMachineVersions.isEmpty() && trackCircuitVersions.isEmpty(); }
+
+    //   The read set the versions cover: the ids they key, circuits standing in for segments
+    ValidationReadSet readSet() const;
+
+    //   Carried through the route batch's QVariantMap payload
+    QVariantMap toVariantMap() const;
+    static ReadSetVersions fromVariantMap(const QVariantMap& map);
+};
+
+//   WHAT-IF CHANGE SET: A candidate route's field changes, checked in order (points, then signals)
+struct SpeculativeChangeSet {
+    QString candidateId;
+    QList<QPair<QString, QString>> pointPositions;  //   machineId -> target position
+    QList<QPair<QString, QString>> signalAspects;   //   signalId -> target main aspect
+    QString operatorId = "ROUTE_SYSTEM";
+};
+
+struct SpeculativeOutcome {
+    struct PointMove {
+        QString machineId;
+        QString currentPosition;
+        QString targetPosition;
+        int expectedVersion = -1;                   //   Row versions the move was validated on
+        int expectedPairedVersion = -1;             //   -1: unpaired
+    };
+
+    struct AspectChange {
+        QString signalId;
+        QString targetAspect;
+        int expectedVersion = -1;
+    };
+
+    QString candidateId;
+    ValidationResult result;
+    QString blockingEntityId;                       //   Empty when allowed
+    QList<PointMove> requiredPointMoves;            //   Only machines not already in position
+    QList<AspectChange> requiredAspectChanges;      //   Only signals not already at the aspect
+    QHash<QString, QString> pairedMachines;         //   Named machine -> the machine that moves with it
+    ReadSetVersions readVersions;                   //   Every row the checks read, including steps already in place
+};
+
 class InterlockingService : public QObject {
     Q_OBJECT
     Q_PROPERTY(bool isOperational READ isOperational NOTIFY operationalStateChanged)
@@ -122,11 +206,69 @@ public:
     Q_INVOKABLE double getAverageResponseTime() const;
     Q_INVOKABLE int getActiveInterlocksCount() const;
 
+    //   OCCUPANCY-TO-DANGER LATENCY SLO
+    Q_INVOKABLE QVariantMap getOccupancyLatencyStatistics() const;
+    Q_INVOKABLE void setOccupancyLatencySlo(int sloMs);
+    Q_INVOKABLE void resetOccupancyLatencyStatistics();
+    OccupancyLatencyMonitor* getLatencyMonitor() const { return m_latencyMonitor.get(); }
+
+    //   INTERLOCKING RULES HOT RELOAD
+    Q_INVOKABLE void reloadInterlockingRules(const QString& filePath);
+    Q_INVOKABLE bool watchInterlockingRulesFile(const QString& filePath);
+    Q_INVOKABLE quint64 getInterlockingRulesVersion() const;
+
+    //   WHOLE-STATION PERMITTED ASPECTS: Recomputed in one batch on every signal/point/occupancy change
+    Q_INVOKABLE QStringList getPermittedAspects(const QString& signalId) const;
+    Q_INVOKABLE QVariantMap getPermittedAspectsSnapshot() const;
+    //   CROSS-CHECK: Both engines on one pinned state, every possible aspect of every ruled
+    //   signal; reports disagreements and the time each engine took for the whole station
+    Q_INVOKABLE QVariantMap crossCheckPermittedAspects();
+
     InterlockingRuleEngine* getRuleEngine() const;
 
+    //   STATION STATE STORE: Multi-version, epoch-reclaimed store of InterlockingSnapshots.
+    //   refreshState() commits a new version from one incremental station query (GUI thread;
+    //   returns 0 when the database is unavailable). pinState() works on any thread: the pinned
+    //   version stays valid and unchanging however long the read, and never delays a commit.
+    quint64 refreshState();
+    PinnedVersion<InterlockingSnapshot> pinState() const;
+    Q_INVOKABLE QVariantMap getStateStoreStatistics() const;
+
+    //   REENTRANT VALIDATION: Pure function of the snapshot and request; safe on any thread
+    static ValidationResult evaluate(const InterlockingSnapshot& snapshot, const ValidationRequest& request);
+
+    //   READ SET: From configuration and rules only, so any loaded version will do
+    static ValidationReadSet readSetOf(const InterlockingSnapshot& snapshot, const ValidationRequest& request);
+    ValidationReadSet validationReadSet(const ValidationRequest& request);
+    static ReadSetVersions versionsOf(const InterlockingSnapshot& snapshot, const ValidationReadSet& readSet);
+    //   Row versions the current state version holds for a read set - the version the next
+    //   validation on this thread evaluates, since only the GUI thread commits new ones
+    ReadSetVersions currentVersionsOf(const ValidationReadSet& readSet) const { return versionsOf(*pinState(), readSet); }
+
+    //   BATCH VALIDATION: Spreads the requests over the validation pool, all against one
+    //   snapshot, and blocks until every result is in (result i answers request i). Emits
+    //   nothing and records no metrics, so it also serves what-if evaluation.
+    QList<ValidationResult> validateBatch(const InterlockingSnapshot& snapshot,
+                                          const QList<ValidationRequest>& requests);
+    Q_INVOKABLE QVariantList validateOperations(const QVariantList& requests);
+
+    //   SPECULATIVE EVALUATION: Applies the change set to a copy-on-write overlay of the
+    //   snapshot one step at a time, validating each step against the overlay as left by the
+    //   steps before it. Nothing is written to the database; safe on any thread.
+    static SpeculativeOutcome evaluateSpeculative(const InterlockingSnapshot& snapshot,
+                                                  const SpeculativeChangeSet& changeSet);
+    //   Refreshes and pins the current state, then evaluates every change set in parallel (GUI thread)
+    QList<SpeculativeOutcome> evaluateSpeculativeBatch(const QList<SpeculativeChangeSet>& changeSets);
+
+    //   PIPELINED REACTION: Hand an occupancy change to the staged pipeline.
+    //   Returns false when the caller must use reactToTrackSegmentOccupancyChange instead.
+    //   inputNs: when the hardware report arrived (OccupancyLatencyMonitor::nowNs()), 0 = now.
+    bool submitOccupancyChange(const QString& trackSegmentId, bool wasOccupied, bool isOccupied, qint64 inputNs = 0);
+
 public slots:
     //   REACTIVE INTERLOCKING: Called when hardware detects trackSegment occupancy changes
-    void reactToTrackSegmentOccupancyChange(const QString& trackSegmentId, bool wasOccupied, bool isOccupied);
+    void reactToTrackSegmentOccupancyChange(const QString& trackSegmentId, bool wasOccupied, bool isOccupied,
+                                            qint64 inputNs = 0);
 
 signals:
     //   OPERATIONAL SIGNALS
@@ -139,6 +281,10 @@ signals:
     //   SAFETY SIGNALS
     void criticalSafetyViolation(const QString& entityId, const QString& violation);
     void systemFreezeRequired(const QString& trackSegmentId, const QString& reason, const QString& details);
+    void occupancyLatencySloViolated(const QString& trackSegmentId, double totalMs, const QVariantMap& breakdown);
+    void interlockingRulesReloaded(quint64 version, const QString& sourcePath);
+    void interlockingRulesReloadFailed(const QString& sourcePath, const QStringList& errors);
+    void permittedAspectsChanged(const QStringList& signalIds);
 
 private slots:
     //   FAILURE HANDLING: Internal slot for handling critical failures
@@ -147,9 +293,11 @@ private slots:
 
 private:
     DatabaseManager* m_dbManager;
-    std::unique_ptr<SignalBranch> m_signalBranch;
+    std::unique_ptr<InterlockingRuleEngine> m_ruleEngine;
     std::unique_ptr<TrackCircuitBranch> m_trackSegmentBranch;
-    std::unique_ptr<PointMachineBranch> m_pointBranch;
+    std::unique_ptr<OccupancyLatencyMonitor> m_latencyMonitor;
+    std::unique_ptr<InterlockingPipeline> m_pipeline;
+    std::unique_ptr<StationAspectEvaluator> m_aspectEvaluator;
 
     //   PERFORMANCE MONITORING
     bool m_isOperational = false;
@@ -158,9 +306,36 @@ private:
     static constexpr size_t MAX_RESPONSE_HISTORY = 1000;
     static constexpr int TARGET_RESPONSE_TIME_MS = 50;
 
+    //   STATE STORE: Versions of the station state; the next refresh starts from the current sequence
+    std::unique_ptr<VersionedStore<InterlockingSnapshot>> m_stateStore;
+    bool m_stateLoaded = false;
+    bool m_stateRefreshQueued = false;                      //   One deferred refresh covers every batch until it runs
+    bool m_protectionConfigStale = true;                    //   Reread protected circuits on the next refresh
+    static constexpr int MIN_REQUESTS_PER_TASK = 8;
+    static constexpr int MIN_CHANGE_SETS_PER_TASK = 1;     //   Each is a whole route's worth of checks
+
     //   HELPER METHODS
     void recordResponseTime(double responseTimeMs);
     void logPerformanceWarning(const QString& operation, double responseTimeMs);
+    void startPipeline();
+    void queueStateRefresh();
+    //   Validations read the current version; only the first one loads the station
+    bool ensureStateLoaded() { return m_stateLoaded || refreshState() != 0; }
+    //   Three-source consistency check for a segment, run on the pipeline's published outcome
+    void verifyPipelinedProtection(const QString& trackSegmentId);
+    void rebuildAspectEvaluator();
+    void reevaluatePermittedAspects();
+    ValidationResult validateOnSnapshot(const ValidationRequest& request);
+    //   JOURNAL OVERLAY: The pinned state with acknowledged but unshipped commands applied, so
+    //   dependents validate against what the operator was told. Returns pinned itself when
+    //   nothing is pending, otherwise fills and returns overlay.
+    const InterlockingSnapshot& withPendingCommands(const InterlockingSnapshot& pinned,
+                                                    InterlockingSnapshot& overlay) const;
+    //   Runs work(0..count-1) over the validation pool and waits; a single slice runs inline
+    void runOnValidationPool(qsizetype count, qsizetype minPerTask, const std::function<void(qsizetype)>& work);
+
+    //   Declared last: drained before the members above go away
+    QThreadPool m_validationPool;
 };
 
 Q_DECLARE_METATYPE(ValidationResult)
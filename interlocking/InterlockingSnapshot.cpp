@@ -0,0 +1,100 @@
+#include "InterlockingSnapshot.h"
+
+//
+//   LOOKUPS
+//
+
+const InterlockingSnapshot::SignalState* InterlockingSnapshot::signalState(const QString& signalId) const {
+    auto it = signalStates.constFind(signalId);
+    return it == signalStates.cend() ? nullptr : &it.value();
+}
+
+const InterlockingSnapshot::PointState* InterlockingSnapshot::pointState(const QString& machineId) const {
+    auto it = pointStates.constFind(machineId);
+    return it == pointStates.cend() ? nullptr : &it.value();
+}
+
+const InterlockingSnapshot::Occupancy* InterlockingSnapshot::trackCircuit(const QString& circuitId) const {
+    auto it = trackCircuits.constFind(circuitId);
+    return it == trackCircuits.cend() ? nullptr : &it.value();
+}
+
+const InterlockingSnapshot::Occupancy* InterlockingSnapshot::trackSegment(const QString& segmentId) const {
+    auto it = trackSegments.constFind(segmentId);
+    return it == trackSegments.cend() ? nullptr : &it.value();
+}
+
+//
+//   CAPTURE
+//
+
+void InterlockingSnapshot::applyStationRows(const QVariantMap& stationSnapshot) {
+    sequence = stationSnapshot["seq"].toLongLong();
+
+    if (stationSnapshot["full"].toBool()) {
+        //   FULL: Entities missing from the rows are gone; protection lists are not in the
+        //   rows and survive for signals that remain
+        QHash<QString, SignalState> previousSignals = signalStates;
+        signalStates.clear();
+        pointStates.clear();
+        trackCircuits.clear();
+        trackSegments.clear();
+        for (const QVariant& value : stationSnapshot["signals"].toList()) {
+            const QString signalId = value.toMap()["id"].toString();
+            if (const auto previous = previousSignals.constFind(signalId); previous != previousSignals.cend()) {
+                signalStates.insert(signalId, previous.value());
+            }
+        }
+    }
+
+    for (const QVariant& value : stationSnapshot["signals"].toList()) {
+        const QVariantMap row = value.toMap();
+        SignalState& signal = signalStates[row["id"].toString()];
+        signal.type = row["type"].toString();
+        signal.isActive = row["isActive"].toBool();
+        signal.possibleAspects = row["possibleAspects"].toStringList();
+        signal.mainAspect = row.value("currentAspect", "RED").toString();
+        signal.callingOnAspect = row.value("callingOnAspect", "OFF").toString();
+        signal.loopAspect = row.value("loopAspect", "OFF").toString();
+        signal.version = row["version"].toInt();
+    }
+
+    for (const QVariant& value : stationSnapshot["pointMachines"].toList()) {
+        const QVariantMap row = value.toMap();
+        PointState& point = pointStates[row["id"].toString()];
+        point.position = row["position"].toString();
+        point.operatingStatus = row["operatingStatus"].toString();
+        point.rootTrackSegment = row["rootTrackSegment"].toMap()["trackSegmentId"].toString();
+        point.normalTrackSegment = row["normalTrackSegment"].toMap()["trackSegmentId"].toString();
+        point.reverseTrackSegment = row["reverseTrackSegment"].toMap()["trackSegmentId"].toString();
+        point.pairedMachineId = row["pairedEntity"].toString();
+        point.version = row["version"].toInt();
+    }
+
+    for (const QVariant& value : stationSnapshot["trackCircuits"].toList()) {
+        const QVariantMap row = value.toMap();
+        trackCircuits.insert(row["id"].toString(),
+                             Occupancy{row["occupied"].toBool(), row["occupiedBy"].toString(), row["version"].toInt(), QString()});
+    }
+
+    for (const QVariant& value : stationSnapshot["trackSegments"].toList()) {
+        const QVariantMap row = value.toMap();
+        trackSegments.insert(row["id"].toString(),
+                             Occupancy{row["occupied"].toBool(), row["occupiedBy"].toString(), 0, row["circuitId"].toString()});
+    }
+}
+
+void InterlockingSnapshot::applyProtectionConfiguration(const QVariantList& signalRows,
+                                                        const QHash<QString, QStringList>& ruleProtectedCircuits) {
+    for (const QVariant& value : signalRows) {
+        const QVariantMap row = value.toMap();
+        auto signal = signalStates.find(row["id"].toString());
+        if (signal != signalStates.end()) {
+            signal->protectedTrackCircuits = row["protectedTrackCircuits"].toStringList();
+        }
+    }
+
+    for (auto signal = signalStates.begin(); signal != signalStates.end(); ++signal) {
+        signal->ruleProtectedTrackCircuits = ruleProtectedCircuits.value(signal.key());
+    }
+}
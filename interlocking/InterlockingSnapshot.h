@@ -0,0 +1,78 @@
+#pragma once
+#include <QDateTime>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include "InterlockingRuleEngine.h"
+#include "PackedAspect.h"
+
+//   INTERLOCKING SNAPSHOT
+//
+//   Everything the validation branches read, captured at one station change sequence:
+//   signal aspects and capabilities, point positions and connections, circuit and segment
+//   occupancy, protected-circuit configuration and the rule set in force. Published as a
+//   version of InterlockingService's state store; once published it is never written, so
+//   any number of threads can validate against it without locks or database access.
+//
+//   A snapshot is a plain value: copying one shares its hashes until the copy is changed,
+//   so a what-if overlay costs only the entries it modifies.
+struct InterlockingSnapshot {
+    struct SignalState {
+        QString type;
+        bool isActive = false;
+        QStringList possibleAspects;
+        QString mainAspect = "RED";
+        QString callingOnAspect = "OFF";
+        QString loopAspect = "OFF";
+        QStringList protectedTrackCircuits;         //   signals.protected_track_circuits
+        QStringList ruleProtectedTrackCircuits;     //   interlocking_rules PROTECTING / MUST_BE_CLEAR
+        int version = 0;                            //   Row version, for compare-and-set writers
+
+        PackedAspect packedAspect() const {
+            return PackedAspect::fromState(mainAspect, callingOnAspect, loopAspect);
+        }
+    };
+
+    struct PointState {
+        QString position;
+        QString operatingStatus;
+        QString rootTrackSegment;
+        QString normalTrackSegment;
+        QString reverseTrackSegment;
+        QString pairedMachineId;                    //   point_machines.paired_entity; empty when unpaired
+        int version = 0;
+
+        //   Same rule as the v_point_machines_complete availability column
+        bool isActive() const { return operatingStatus != "FAILED" && operatingStatus != "MAINTENANCE"; }
+    };
+
+    struct Occupancy {
+        bool occupied = false;
+        QString occupiedBy;
+        int version = 0;                            //   The circuit row's version
+        QString circuitId;                          //   Segments only: the circuit they read occupancy from
+    };
+
+    qint64 sequence = 0;                            //   getStationSnapshot change sequence
+    QDateTime capturedAt;
+    InterlockingRuleEngine::RuleSetPtr rules;
+
+    QHash<QString, SignalState> signalStates;
+    QHash<QString, PointState> pointStates;
+    QHash<QString, Occupancy> trackCircuits;
+    QHash<QString, Occupancy> trackSegments;
+
+    //   LOOKUPS: nullptr when the entity is not in the station
+    const SignalState* signalState(const QString& signalId) const;
+    const PointState* pointState(const QString& machineId) const;
+    const Occupancy* trackCircuit(const QString& circuitId) const;
+    const Occupancy* trackSegment(const QString& segmentId) const;
+
+    //   CAPTURE (GUI thread, before publication)
+    //   Folds getStationSnapshot() rows into this state; a "full" snapshot replaces it
+    void applyStationRows(const QVariantMap& stationSnapshot);
+    //   Protected-circuit configuration from getAllSignalsList() and the interlocking rules table
+    void applyProtectionConfiguration(const QVariantList& signalRows,
+                                      const QHash<QString, QStringList>& ruleProtectedCircuits);
+};
@@ -0,0 +1,179 @@
+#include "OccupancyLatencyMonitor.h"
+#include <QDebug>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+//
+//   LatencyHistogram Implementation
+//
+
+void LatencyHistogram::record(qint64 micros) {
+    micros = std::max<qint64>(micros, 0);
+
+    const int bucket = micros == 0 ? 0
+                                   : std::min(BUCKET_COUNT - 1,
+                                              static_cast<int>(std::bit_width(static_cast<quint64>(micros))) - 1);
+
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sumMicros.fetch_add(static_cast<quint64>(micros), std::memory_order_relaxed);
+
+    qint64 currentMax = m_maxMicros.load(std::memory_order_relaxed);
+    while (micros > currentMax &&
+           !m_maxMicros.compare_exchange_weak(currentMax, micros, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sumMicros.store(0, std::memory_order_relaxed);
+    m_maxMicros.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::meanMs() const {
+    const quint64 samples = count();
+    if (samples == 0) return 0.0;
+    return static_cast<double>(m_sumMicros.load(std::memory_order_relaxed)) / samples / 1000.0;
+}
+
+double LatencyHistogram::maxMs() const {
+    return m_maxMicros.load(std::memory_order_relaxed) / 1000.0;
+}
+
+double LatencyHistogram::percentileMs(double percentile) const {
+    const quint64 samples = count();
+    if (samples == 0) return 0.0;
+
+    const quint64 rank = static_cast<quint64>(std::clamp(percentile, 0.0, 1.0) * samples);
+    quint64 seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen > rank || seen == samples) {
+            //   Bucket upper bound, capped at the observed maximum
+            return std::min(static_cast<double>(quint64(1) << (i + 1)) / 1000.0, maxMs());
+        }
+    }
+    return maxMs();
+}
+
+QVariantMap LatencyHistogram::toVariantMap() const {
+    QVariantMap map;
+    map["count"] = count();
+    map["meanMs"] = meanMs();
+    map["p50Ms"] = percentileMs(0.50);
+    map["p99Ms"] = percentileMs(0.99);
+    map["p999Ms"] = percentileMs(0.999);
+    map["maxMs"] = maxMs();
+
+    QVariantList buckets;
+    for (const auto& bucket : m_buckets) {
+        buckets.append(bucket.load(std::memory_order_relaxed));
+    }
+    map["bucketsLog2Us"] = buckets;
+    return map;
+}
+
+//
+//   OccupancyLatencyMonitor Implementation
+//
+
+OccupancyLatencyMonitor::OccupancyLatencyMonitor(QObject* parent)
+    : QObject(parent) {
+}
+
+qint64 OccupancyLatencyMonitor::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void OccupancyLatencyMonitor::record(const Sample& sample) {
+    //   STAGE TIMES: A stage missing either stamp is absent (the synchronous path has no stage
+    //   boundaries) and is left out of its histogram rather than charged to a neighbour
+    if (hasStage(sample.inputNs, sample.decisionNs)) {
+        m_decisionHistogram.record((sample.decisionNs - sample.inputNs) / 1000);
+    }
+    if (hasStage(sample.decisionNs, sample.commitNs)) {
+        m_commitHistogram.record((sample.commitNs - sample.decisionNs) / 1000);
+    }
+    if (hasStage(sample.commitNs, sample.publishedNs)) {
+        m_publicationHistogram.record((sample.publishedNs - sample.commitNs) / 1000);
+    }
+
+    //   End to end is stamped by both paths
+    const qint64 totalMicros = hasStage(sample.inputNs, sample.publishedNs)
+                                   ? (sample.publishedNs - sample.inputNs) / 1000 : 0;
+    m_totalHistogram.record(totalMicros);
+
+    if (sample.failed) {
+        m_failedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const double totalMs = totalMicros / 1000.0;
+    if (totalMs > sloMs()) {
+        m_violationCount.fetch_add(1, std::memory_order_relaxed);
+
+        QVariantMap breakdown = breakdownFor(sample);
+        qWarning() << " OCCUPANCY-TO-DANGER SLO VIOLATION:" << sample.trackSegmentId
+                   << totalMs << "ms (SLO:" << sloMs() << "ms)" << breakdown;
+        emit sloViolated(sample.trackSegmentId, totalMs, breakdown);
+    }
+
+    emit statisticsChanged();
+}
+
+void OccupancyLatencyMonitor::setSloMs(int sloMs) {
+    if (sloMs <= 0) {
+        qWarning() << " Ignoring invalid occupancy-to-danger SLO:" << sloMs << "ms";
+        return;
+    }
+
+    if (m_sloMs.exchange(sloMs, std::memory_order_relaxed) != sloMs) {
+        qDebug() << "Occupancy-to-danger SLO set to" << sloMs << "ms";
+        emit sloChanged(sloMs);
+    }
+}
+
+QVariantMap OccupancyLatencyMonitor::statistics() const {
+    QVariantMap stats;
+    stats["sloMs"] = sloMs();
+    stats["violations"] = violationCount();
+    stats["failedEnforcements"] = failedCount();
+    stats["decision"] = m_decisionHistogram.toVariantMap();
+    stats["commit"] = m_commitHistogram.toVariantMap();
+    stats["publication"] = m_publicationHistogram.toVariantMap();
+    stats["total"] = m_totalHistogram.toVariantMap();
+    return stats;
+}
+
+void OccupancyLatencyMonitor::reset() {
+    m_decisionHistogram.reset();
+    m_commitHistogram.reset();
+    m_publicationHistogram.reset();
+    m_totalHistogram.reset();
+    m_violationCount.store(0, std::memory_order_relaxed);
+    m_failedCount.store(0, std::memory_order_relaxed);
+    emit statisticsChanged();
+}
+
+QVariantMap OccupancyLatencyMonitor::breakdownFor(const Sample& sample) {
+    QVariantMap breakdown;
+    breakdown["trackSegmentId"] = sample.trackSegmentId;
+    breakdown["signalCount"] = sample.signalCount;
+    breakdown["failed"] = sample.failed;
+
+    //   Absent stages are left out, not reported as 0 ms
+    auto addStage = [&breakdown](const char* key, qint64 fromNs, qint64 toNs) {
+        if (hasStage(fromNs, toNs)) {
+            breakdown[key] = (toNs - fromNs) / 1.0e6;
+        }
+    };
+    addStage("decisionMs", sample.inputNs, sample.decisionNs);
+    addStage("commitMs", sample.decisionNs, sample.commitNs);
+    addStage("publicationMs", sample.commitNs, sample.publishedNs);
+    addStage("totalMs", sample.inputNs, sample.publishedNs);
+    return breakdown;
+}
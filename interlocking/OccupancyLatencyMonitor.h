@@ -0,0 +1,89 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QVariantMap>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+//   LATENCY HISTOGRAM: Lock-free, log2-bucketed (bucket i covers [2^i, 2^(i+1)) microseconds).
+//   Safe to record from any thread; percentiles report the bucket upper bound.
+class LatencyHistogram {
+public:
+    static constexpr int BUCKET_COUNT = 32;
+
+    void record(qint64 micros);
+    void reset();
+
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    double meanMs() const;
+    double maxMs() const;
+    double percentileMs(double percentile) const;
+
+    QVariantMap toVariantMap() const;
+
+private:
+    std::array<std::atomic<quint64>, BUCKET_COUNT> m_buckets{};
+    std::atomic<quint64> m_count{0};
+    std::atomic<quint64> m_sumMicros{0};
+    std::atomic<qint64> m_maxMicros{0};
+};
+
+//   OCCUPANCY-TO-DANGER SLO MONITOR
+//
+//   Times the path from an occupancy input arriving to its protecting signals being
+//   published at RED, split into stages: decision, DB commit and UI publication.
+//   Every sample, failed enforcements included, lands in per-stage histograms; samples
+//   whose end-to-end time exceeds the SLO raise sloViolated() with the per-stage breakdown.
+class OccupancyLatencyMonitor : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(int sloMs READ sloMs WRITE setSloMs NOTIFY sloChanged)
+    Q_PROPERTY(quint64 violationCount READ violationCount NOTIFY statisticsChanged)
+
+public:
+    //   Timestamps are steady-clock nanoseconds from nowNs(); 0 marks a stage boundary not stamped
+    struct Sample {
+        QString trackSegmentId;
+        int signalCount = 0;
+        qint64 inputNs = 0;
+        qint64 decisionNs = 0;
+        qint64 commitNs = 0;
+        qint64 publishedNs = 0;
+        bool failed = false;                    //   Enforcement failed - timed all the same
+    };
+
+    explicit OccupancyLatencyMonitor(QObject* parent = nullptr);
+
+    static qint64 nowNs();
+
+    //   THREAD-SAFE: Called from the pipeline publication stage or the synchronous path
+    void record(const Sample& sample);
+
+    int sloMs() const { return m_sloMs.load(std::memory_order_relaxed); }
+    void setSloMs(int sloMs);
+    quint64 violationCount() const { return m_violationCount.load(std::memory_order_relaxed); }
+    quint64 failedCount() const { return m_failedCount.load(std::memory_order_relaxed); }
+
+    Q_INVOKABLE QVariantMap statistics() const;
+    Q_INVOKABLE void reset();
+
+signals:
+    void sloViolated(const QString& trackSegmentId, double totalMs, const QVariantMap& breakdown);
+    void sloChanged(int sloMs);
+    void statisticsChanged();
+
+private:
+    static constexpr int DEFAULT_SLO_MS = 50;
+
+    static bool hasStage(qint64 fromNs, qint64 toNs) { return fromNs > 0 && toNs > 0; }
+    static QVariantMap breakdownFor(const Sample& sample);
+
+    std::atomic<int> m_sloMs{DEFAULT_SLO_MS};
+    std::atomic<quint64> m_violationCount{0};
+    std::atomic<quint64> m_failedCount{0};
+
+    LatencyHistogram m_decisionHistogram;
+    LatencyHistogram m_commitHistogram;
+    LatencyHistogram m_publicationHistogram;
+    LatencyHistogram m_totalHistogram;
+};
@@ -0,0 +1,123 @@
+#pragma once
+#include <QString>
+#include <QVariantMap>
+#include <cstdint>
+
+//   ASPECT CODES: Values match the railway_config.signal_aspects ids seeded by DatabaseInitializer
+enum class AspectCode : quint8 {
+    UNKNOWN = 0,
+    RED = 1,
+    YELLOW = 2,
+    GREEN = 3,
+    SINGLE_YELLOW = 4,
+    DOUBLE_YELLOW = 5,
+    WHITE = 6,
+    BLUE = 7,
+    OFF = 8
+};
+
+//   PACKED COMPOSITE ASPECT
+//
+//   Main, calling-on and loop aspects packed into one word (8 bits each). Rule aspects
+//   carry a mask: a plain "GREEN" only constrains the main aspect, while a composite
+//   "RED_CALLING_LOOP" pins all three. Matching a signal's state is one AND + compare.
+class PackedAspect {
+public:
+    constexpr PackedAspect() = default;
+
+    static constexpr quint32 MAIN_MASK = 0x0000FFu;
+    static constexpr quint32 FULL_MASK = 0xFFFFFFu;
+
+    //   Current signal state (fully specified; missing components read as OFF)
+    static PackedAspect fromState(const QString& mainAspect, const QString& callingOnAspect, const QString& loopAspect) {
+        return PackedAspect(pack(codeFromString(mainAspect),
+                                 componentCode(callingOnAspect),
+                                 componentCode(loopAspect)),
+                            FULL_MASK);
+    }
+
+    static PackedAspect fromSignalData(const QVariantMap& signalData) {
+        return fromState(signalData.value("currentAspect", "RED").toString(),
+                         signalData.value("callingOnAspect", "OFF").toString(),
+                         signalData.value("loopAspect", "OFF").toString());
+    }
+
+    //   Rule "when_aspect" notation: MAIN[_CALLING][_LOOP]
+    static PackedAspect fromRuleAspect(const QString& ruleAspect) {
+        QString main = ruleAspect;
+        const bool callingOn = main.contains("_CALLING");
+        const bool loop = main.contains("_LOOP");
+
+        if (!callingOn && !loop) {
+            return PackedAspect(pack(codeFromString(main), AspectCode::UNKNOWN, AspectCode::UNKNOWN), MAIN_MASK);
+        }
+
+        main.remove("_CALLING").remove("_LOOP");
+        return PackedAspect(pack(main.isEmpty() ? AspectCode::RED : codeFromString(main),
+                                 callingOn ? AspectCode::WHITE : AspectCode::OFF,
+                                 loop ? AspectCode::YELLOW : AspectCode::OFF),
+                            FULL_MASK);
+    }
+
+    constexpr bool matches(PackedAspect state) const { return (state.m_bits & m_mask) == m_bits; }
+    constexpr bool isValid() const { return mainCode() != AspectCode::UNKNOWN; }
+
+    constexpr AspectCode mainCode() const { return static_cast<AspectCode>(m_bits & 0xFFu); }
+    constexpr AspectCode callingOnCode() const { return static_cast<AspectCode>((m_bits >> 8) & 0xFFu); }
+    constexpr AspectCode loopCode() const { return static_cast<AspectCode>((m_bits >> 16) & 0xFFu); }
+    constexpr quint32 bits() const { return m_bits; }
+    constexpr quint32 mask() const { return m_mask; }
+
+    constexpr bool operator==(const PackedAspect&) const = default;
+
+    //   Rule notation, for diagnostics only
+    QString toString() const {
+        QString text = codeToString(mainCode());
+        if (callingOnCode() == AspectCode::WHITE) text += "_CALLING";
+        if (loopCode() == AspectCode::YELLOW) text += "_LOOP";
+        return text;
+    }
+
+    static AspectCode codeFromString(const QString& aspect) {
+        if (aspect == QLatin1String("RED")) return AspectCode::RED;
+        if (aspect == QLatin1String("YELLOW")) return AspectCode::YELLOW;
+        if (aspect == QLatin1String("GREEN")) return AspectCode::GREEN;
+        if (aspect == QLatin1String("SINGLE_YELLOW")) return AspectCode::SINGLE_YELLOW;
+        if (aspect == QLatin1String("DOUBLE_YELLOW")) return AspectCode::DOUBLE_YELLOW;
+        if (aspect == QLatin1String("WHITE")) return AspectCode::WHITE;
+        if (aspect == QLatin1String("BLUE")) return AspectCode::BLUE;
+        if (aspect == QLatin1String("OFF")) return AspectCode::OFF;
+        return AspectCode::UNKNOWN;
+    }
+
+    static QString codeToString(AspectCode code) {
+        switch (code) {
+        case AspectCode::RED: return QStringLiteral("RED");
+        case AspectCode::YELLOW: return QStringLiteral("YELLOW");
+        case AspectCode::GREEN: return QStringLiteral("GREEN");
+        case AspectCode::SINGLE_YELLOW: return QStringLiteral("SINGLE_YELLOW");
+        case AspectCode::DOUBLE_YELLOW: return QStringLiteral("DOUBLE_YELLOW");
+        case AspectCode::WHITE: return QStringLiteral("WHITE");
+        case AspectCode::BLUE: return QStringLiteral("BLUE");
+        case AspectCode::OFF: return QStringLiteral("OFF");
+        case AspectCode::UNKNOWN: break;
+        }
+        return QStringLiteral("UNKNOWN");
+    }
+
+private:
+    constexpr PackedAspect(quint32 bits, quint32 mask) : m_bits(bits & mask), m_mask(mask) {}
+
+    static constexpr quint32 pack(AspectCode main, AspectCode callingOn, AspectCode loop) {
+        return static_cast<quint32>(main)
+               | (static_cast<quint32>(callingOn) << 8)
+               | (static_cast<quint32>(loop) << 16);
+    }
+
+    static AspectCode componentCode(const QString& aspect) {
+        return aspect.isEmpty() ? AspectCode::OFF : codeFromString(aspect);
+    }
+
+    quint32 m_bits = 0;
+    quint32 m_mask = 0;
+};
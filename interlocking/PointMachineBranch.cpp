@@ -1,23 +1,21 @@
 #include "PointMachineBranch.h"
-#include "../database/DatabaseManager.h"
 #include <QDebug>
 #include <QDateTime>
 
-PointMachineBranch::PointMachineBranch(DatabaseManager* dbManager, QObject* parent)
-    : QObject(parent), m_dbManager(dbManager) {}
-
 ValidationResult PointMachineBranch::validatePositionChange(
-    const QString& machineId, const QString& currentPosition,
+    const InterlockingSnapshot& snapshot, const QString& machineId, const QString& currentPosition,
     const QString& requestedPosition, const QString& operatorId) {
 
+    Q_UNUSED(operatorId);
+
     qDebug() << "Validating point machine operation:" << machineId
              << "from" << currentPosition << "to" << requestedPosition;
 
     // 1. Basic point machine validation
-    auto existsResult = checkPointMachineExists(machineId);
+    auto existsResult = checkPointMachineExists(snapshot, machineId);
     if (!existsResult.isAllowed()) return existsResult;
 
-    auto activeResult = checkPointMachineActive(machineId);
+    auto activeResult = checkPointMachineActive(snapshot, machineId);
     if (!activeResult.isAllowed()) return activeResult;
 
     // 2. Check if change is actually needed
@@ -26,35 +24,35 @@ ValidationResult PointMachineBranch::validatePositionChange(
     }
 
     // 3. Operational status validation
-    auto operationalResult = checkOperationalStatus(machineId);
+    auto operationalResult = checkOperationalStatus(snapshot, machineId);
     if (!operationalResult.isAllowed()) return operationalResult;
 
     // 4. Locking status validation
-    auto lockingResult = checkLockingStatus(machineId);
+    auto lockingResult = checkLockingStatus(snapshot, machineId);
     if (!lockingResult.isAllowed()) return lockingResult;
 
     // 5. Time-based locking validation
-    auto timeLockResult = checkTimeLocking(machineId);
+    auto timeLockResult = checkTimeLocking(snapshot, machineId);
     if (!timeLockResult.isAllowed()) return timeLockResult;
 
     // 6. Detection locking validation
-    auto detectionResult = checkDetectionLocking(machineId);
+    auto detectionResult = checkDetectionLocking(snapshot, machineId);
     if (!detectionResult.isAllowed()) return detectionResult;
 
     // 7. Protecting signals validation
-    auto signalResult = checkProtectingSignals(machineId, requestedPosition);
+    auto signalResult = checkProtectingSignals(snapshot, machineId, requestedPosition);
     if (!signalResult.isAllowed()) return signalResult;
 
     // 8. Track Segment occupancy validation
-    auto trackSegmentResult = checkTrackSegmentOccupancy(machineId, requestedPosition);
+    auto trackSegmentResult = checkTrackSegmentOccupancy(snapshot, machineId, requestedPosition);
     if (!trackSegmentResult.isAllowed()) return trackSegmentResult;
 
     // 9. Conflicting point machines validation
-    auto conflictResult = checkConflictingPoints(machineId, requestedPosition);
+    auto conflictResult = checkConflictingPoints(snapshot, machineId, requestedPosition);
     if (!conflictResult.isAllowed()) return conflictResult;
 
     // 10. Route conflicts validation
-    auto routeResult = checkRouteConflicts(machineId, requestedPosition);
+    auto routeResult = checkRouteConflicts(snapshot, machineId, requestedPosition);
     if (!routeResult.isAllowed()) return routeResult;
 
     return ValidationResult::allowed("All point machine validations passed");
@@ -62,6 +60,7 @@ ValidationResult PointMachineBranch::validatePositionChange(
 
 // === NEW: PAIRED OPERATION VALIDATION ===
 ValidationResult PointMachineBranch::validatePairedOperation(
+    const InterlockingSnapshot& snapshot,
     const QString& machineId,
     const QString& pairedMachineId,
     const QString& currentPosition,
@@ -74,13 +73,13 @@ ValidationResult PointMachineBranch::validatePairedOperation(
              << "to position:" << newPosition;
 
     // === STEP 1: Validate both machines individually ===
-    auto result1 = validatePositionChange(machineId, currentPosition, newPosition, operatorId);
+    auto result1 = validatePositionChange(snapshot, machineId, currentPosition, newPosition, operatorId);
     if (!result1.isAllowed()) {
         qDebug() << " Primary machine validation failed:" << result1.getReason();
         return result1;
     }
 
-    auto result2 = validatePositionChange(pairedMachineId, pairedCurrentPosition, newPosition, operatorId);
+    auto result2 = validatePositionChange(snapshot, pairedMachineId, pairedCurrentPosition, newPosition, operatorId);
     if (!result2.isAllowed()) {
         qDebug() << " Paired machine validation failed:" << result2.getReason();
         return result2;
@@ -89,11 +88,11 @@ ValidationResult PointMachineBranch::validatePairedOperation(
     // === STEP 2: Paired-specific validations ===
 
     // Check combined track segment occupancy
-    auto pairedTrackResult = checkPairedTrackSegmentOccupancy(machineId, pairedMachineId, newPosition);
+    auto pairedTrackResult = checkPairedTrackSegmentOccupancy(snapshot, machineId, pairedMachineId, newPosition);
     if (!pairedTrackResult.isAllowed()) return pairedTrackResult;
 
     // Check paired conflicts
-    auto pairedConflictResult = checkPairedConflicts(machineId, pairedMachineId, newPosition);
+    auto pairedConflictResult = checkPairedConflicts(snapshot, machineId, pairedMachineId, newPosition);
     if (!pairedConflictResult.isAllowed()) return pairedConflictResult;
 
     qDebug() << "  Paired operation validation passed for" << machineId << "+" << pairedMachineId;
@@ -102,19 +101,20 @@ ValidationResult PointMachineBranch::validatePairedOperation(
 
 // === NEW: PAIRED-SPECIFIC VALIDATIONS ===
 ValidationResult PointMachineBranch::checkPairedTrackSegmentOccupancy(
+    const InterlockingSnapshot& snapshot,
     const QString& machineId,
     const QString& pairedMachineId,
     const QString& newPosition) {
 
     QStringList combinedAffectedSegments = getCombinedAffectedTrackSegments(
-        machineId, pairedMachineId, newPosition);
+        snapshot, machineId, pairedMachineId, newPosition);
 
     for (const QString& segmentId : combinedAffectedSegments) {
-        auto segmentData = m_dbManager->getTrackSegmentById(segmentId);
-        if (!segmentData.isEmpty() && segmentData["occupied"].toBool()) {
+        const InterlockingSnapshot::Occupancy* segment = snapshot.trackSegment(segmentId);
+        if (segment && segment->occupied) {
             return ValidationResult::blocked(
                        QString("Cannot operate paired machines %1+%2: combined affected track segment %3 is occupied by %4")
-                           .arg(machineId, pairedMachineId, segmentId, segmentData["occupiedBy"].toString()),
+                           .arg(machineId, pairedMachineId, segmentId, segment->occupiedBy),
                        "PAIRED_OPERATION_TRACK_OCCUPIED"
                        ).addAffectedEntity(segmentId);
         }
@@ -124,13 +124,14 @@ ValidationResult PointMachineBranch::checkPairedTrackSegmentOccupancy(
 }
 
 ValidationResult PointMachineBranch::checkPairedConflicts(
+    const InterlockingSnapshot& snapshot,
     const QString& machineId,
     const QString& pairedMachineId,
     const QString& newPosition) {
 
     // Check if operating both machines simultaneously creates geometric conflicts
-    QStringList machine1Conflicts = getConflictingPointMachines(machineId);
-    QStringList machine2Conflicts = getConflictingPointMachines(pairedMachineId);
+    QStringList machine1Conflicts = getConflictingPointMachines(snapshot, machineId);
+    QStringList machine2Conflicts = getConflictingPointMachines(snapshot, pairedMachineId);
 
     // Remove the paired machines from each other's conflict lists
     machine1Conflicts.removeAll(pairedMachineId);
@@ -138,9 +139,8 @@ ValidationResult PointMachineBranch::checkPairedConflicts(
 
     // Check conflicts for machine 1
     for (const QString& conflictingMachineId : machine1Conflicts) {
-        auto conflictingData = m_dbManager->getPointMachineById(conflictingMachineId);
-        if (!conflictingData.isEmpty()) {
-            QString conflictingPosition = conflictingData["position"].toString();
+        if (const InterlockingSnapshot::PointState* conflicting = snapshot.pointState(conflictingMachineId)) {
+            QString conflictingPosition = conflicting->position;
             if (conflictingPosition != "NORMAL") {
                 return ValidationResult::blocked(
                            QString("Cannot operate paired machines %1+%2: %1 conflicts with %3 in %4 position")
@@ -153,9 +153,8 @@ ValidationResult PointMachineBranch::checkPairedConflicts(
 
     // Check conflicts for machine 2
     for (const QString& conflictingMachineId : machine2Conflicts) {
-        auto conflictingData = m_dbManager->getPointMachineById(conflictingMachineId);
-        if (!conflictingData.isEmpty()) {
-            QString conflictingPosition = conflictingData["position"].toString();
+        if (const InterlockingSnapshot::PointState* conflicting = snapshot.pointState(conflictingMachineId)) {
+            QString conflictingPosition = conflicting->position;
             if (conflictingPosition != "NORMAL") {
                 return ValidationResult::blocked(
                            QString("Cannot operate paired machines %1+%2: %2 conflicts with %3 in %4 position")
@@ -170,21 +169,21 @@ ValidationResult PointMachineBranch::checkPairedConflicts(
 }
 
 // === NEW: PAIRED HELPER METHODS ===
-QString PointMachineBranch::getCurrentPointPosition(const QString& machineId) {
-    auto pmData = m_dbManager->getPointMachineById(machineId);
-    if (!pmData.isEmpty()) {
-        return pmData["position"].toString();
+QString PointMachineBranch::getCurrentPointPosition(const InterlockingSnapshot& snapshot, const QString& machineId) {
+    if (const InterlockingSnapshot::PointState* point = snapshot.pointState(machineId)) {
+        return point->position;
     }
     return QString();
 }
 
 QStringList PointMachineBranch::getCombinedAffectedTrackSegments(
+    const InterlockingSnapshot& snapshot,
     const QString& machineId,
     const QString& pairedMachineId,
     const QString& position) {
 
-    QStringList machine1Segments = getAffectedTrackSegments(machineId, position);
-    QStringList machine2Segments = getAffectedTrackSegments(pairedMachineId, position);
+    QStringList machine1Segments = getAffectedTrackSegments(snapshot, machineId, position);
+    QStringList machine2Segments = getAffectedTrackSegments(snapshot, pairedMachineId, position);
 
     // Combine and remove duplicates
     QStringList combined = machine1Segments + machine2Segments;
@@ -194,31 +193,29 @@ QStringList PointMachineBranch::getCombinedAffectedTrackSegments(
 }
 
 // === EXISTING VALIDATION METHODS (unchanged) ===
-ValidationResult PointMachineBranch::checkPointMachineExists(const QString& machineId) {
-    auto pmData = m_dbManager->getPointMachineById(machineId);
-    if (pmData.isEmpty()) {
+ValidationResult PointMachineBranch::checkPointMachineExists(const InterlockingSnapshot& snapshot, const QString& machineId) {
+    if (!snapshot.pointState(machineId)) {
         return ValidationResult::blocked("Point machine not found: " + machineId, "POINT_MACHINE_NOT_FOUND");
     }
     return ValidationResult::allowed();
 }
 
-ValidationResult PointMachineBranch::checkPointMachineActive(const QString& machineId) {
-    auto pmData = m_dbManager->getPointMachineById(machineId);
-    if (pmData.isEmpty()) {
+ValidationResult PointMachineBranch::checkPointMachineActive(const InterlockingSnapshot& snapshot, const QString& machineId) {
+    const InterlockingSnapshot::PointState* point = snapshot.pointState(machineId);
+    if (!point) {
         return ValidationResult::blocked("Point machine not found: " + machineId, "POINT_MACHINE_NOT_FOUND");
     }
 
-    //  Check if the map contains isActive field, if not assume active
-    if (pmData.contains("isActive") && !pmData["isActive"].toBool()) {
+    //  Availability derives from operating status (FAILED / MAINTENANCE are inactive)
+    if (!point->isActive()) {
         return ValidationResult::blocked("Point machine is not active: " + machineId, "POINT_MACHINE_INACTIVE");
     }
 
-    // If no isActive field exists, consider the machine active (since it exists in DB)
     return ValidationResult::allowed();
 }
 
-ValidationResult PointMachineBranch::checkOperationalStatus(const QString& machineId) {
-    auto pmState = getPointMachineState(machineId);
+ValidationResult PointMachineBranch::checkOperationalStatus(const InterlockingSnapshot& snapshot, const QString& machineId) {
+    auto pmState = getPointMachineState(snapshot, machineId);
 
     if (pmState.operatingStatus == "IN_TRANSITION") {
         return ValidationResult::blocked(
@@ -244,8 +241,8 @@ ValidationResult PointMachineBranch::checkOperationalStatus(const QString& machi
     return ValidationResult::allowed();
 }
 
-ValidationResult PointMachineBranch::checkLockingStatus(const QString& machineId) {
-    auto pmState = getPointMachineState(machineId);
+ValidationResult PointMachineBranch::checkLockingStatus(const InterlockingSnapshot& snapshot, const QString& machineId) {
+    auto pmState = getPointMachineState(snapshot, machineId);
 
     if (pmState.isLocked) {
         return ValidationResult::blocked(
@@ -257,11 +254,11 @@ ValidationResult PointMachineBranch::checkLockingStatus(const QString& machineId
     return ValidationResult::allowed();
 }
 
-ValidationResult PointMachineBranch::checkTimeLocking(const QString& machineId) {
-    auto pmState = getPointMachineState(machineId);
+ValidationResult PointMachineBranch::checkTimeLocking(const InterlockingSnapshot& snapshot, const QString& machineId) {
+    auto pmState = getPointMachineState(snapshot, machineId);
 
     if (pmState.timeLockingActive) {
-        QDateTime now = QDateTime::currentDateTime();
+        QDateTime now = snapshot.capturedAt;
         if (pmState.timeLockExpiry > now) {
             return ValidationResult::blocked(
                 QString("Point machine %1 is time-locked until %2")
@@ -274,13 +271,13 @@ ValidationResult PointMachineBranch::checkTimeLocking(const QString& machineId)
     return ValidationResult::allowed();
 }
 
-ValidationResult PointMachineBranch::checkDetectionLocking(const QString& machineId) {
-    auto pmState = getPointMachineState(machineId);
+ValidationResult PointMachineBranch::checkDetectionLocking(const InterlockingSnapshot& snapshot, const QString& machineId) {
+    auto pmState = getPointMachineState(snapshot, machineId);
 
     // Check if any detection locks are active
     for (const QString& lockingTrackSegmentId : pmState.detectionLocks) {
-        auto trackSegmentData = m_dbManager->getTrackSegmentById(lockingTrackSegmentId);
-        if (!trackSegmentData.isEmpty() && trackSegmentData["occupied"].toBool()) {
+        const InterlockingSnapshot::Occupancy* trackSegment = snapshot.trackSegment(lockingTrackSegmentId);
+        if (trackSegment && trackSegment->occupied) {
             return ValidationResult::blocked(
                        QString("Point machine %1 is detection-locked by occupied trackSegment %2")
                            .arg(machineId, lockingTrackSegmentId),
@@ -292,16 +289,15 @@ ValidationResult PointMachineBranch::checkDetectionLocking(const QString& machin
     return ValidationResult::allowed();
 }
 
-ValidationResult PointMachineBranch::checkProtectingSignals(const QString& machineId, const QString& requestedPosition) {
-    QStringList protectingSignals = getProtectingSignals(machineId);
+ValidationResult PointMachineBranch::checkProtectingSignals(const InterlockingSnapshot& snapshot, const QString& machineId, const QString& requestedPosition) {
+    QStringList protectingSignals = getProtectingSignals(snapshot, machineId);
 
     if (!protectingSignals.isEmpty()) {
-        if (!areAllProtectingSignalsAtRed(protectingSignals)) {
+        if (!areAllProtectingSignalsAtRed(snapshot, protectingSignals)) {
             QStringList nonRedSignals;
             for (const QString& signalId : protectingSignals) {
-                auto signalData = m_dbManager->getSignalById(signalId);
-                if (!signalData.isEmpty()) {
-                    QString aspect = signalData["currentAspect"].toString();
+                if (const InterlockingSnapshot::SignalState* signal = snapshot.signalState(signalId)) {
+                    QString aspect = signal->mainAspect;
                     if (aspect != "RED") {
                         nonRedSignals.append(QString("%1(%2)").arg(signalId, aspect));
                     }
@@ -319,15 +315,15 @@ ValidationResult PointMachineBranch::checkProtectingSignals(const QString& machi
     return ValidationResult::allowed();
 }
 
-ValidationResult PointMachineBranch::checkTrackSegmentOccupancy(const QString& machineId, const QString& requestedPosition) {
-    QStringList affectedTrackSegments = getAffectedTrackSegments(machineId, requestedPosition);
+ValidationResult PointMachineBranch::checkTrackSegmentOccupancy(const InterlockingSnapshot& snapshot, const QString& machineId, const QString& requestedPosition) {
+    QStringList affectedTrackSegments = getAffectedTrackSegments(snapshot, machineId, requestedPosition);
 
     for (const QString& trackSegmentId : affectedTrackSegments) {
-        auto trackSegmentData = m_dbManager->getTrackSegmentById(trackSegmentId);
-        if (!trackSegmentData.isEmpty() && trackSegmentData["occupied"].toBool()) {
+        const InterlockingSnapshot::Occupancy* trackSegment = snapshot.trackSegment(trackSegmentId);
+        if (trackSegment && trackSegment->occupied) {
             return ValidationResult::blocked(
                        QString("Cannot operate point machine %1: affected trackSegment %2 is occupied by %3")
-                           .arg(machineId, trackSegmentId, trackSegmentData["occupiedBy"].toString()),
+                           .arg(machineId, trackSegmentId, trackSegment->occupiedBy),
                        "AFFECTED_TRACK_SEGMENT_OCCUPIED"
                        ).addAffectedEntity(trackSegmentId);
         }
@@ -336,13 +332,12 @@ ValidationResult PointMachineBranch::checkTrackSegmentOccupancy(const QString& m
     return ValidationResult::allowed();
 }
 
-ValidationResult PointMachineBranch::checkConflictingPoints(const QString& machineId, const QString& requestedPosition) {
-    QStringList conflictingMachines = getConflictingPointMachines(machineId);
+ValidationResult PointMachineBranch::checkConflictingPoints(const InterlockingSnapshot& snapshot, const QString& machineId, const QString& requestedPosition) {
+    QStringList conflictingMachines = getConflictingPointMachines(snapshot, machineId);
 
     for (const QString& conflictingMachineId : conflictingMachines) {
-        auto conflictingPMData = m_dbManager->getPointMachineById(conflictingMachineId);
-        if (!conflictingPMData.isEmpty()) {
-            QString conflictingPosition = conflictingPMData["position"].toString();
+        if (const InterlockingSnapshot::PointState* conflicting = snapshot.pointState(conflictingMachineId)) {
+            QString conflictingPosition = conflicting->position;
 
             // Implement specific conflict rules based on your layout
             if (conflictingPosition != "NORMAL") {
@@ -358,8 +353,8 @@ ValidationResult PointMachineBranch::checkConflictingPoints(const QString& machi
     return ValidationResult::allowed();
 }
 
-ValidationResult PointMachineBranch::checkRouteConflicts(const QString& machineId, const QString& requestedPosition) {
-    auto routeConflict = analyzeRouteImpact(machineId, requestedPosition);
+ValidationResult PointMachineBranch::checkRouteConflicts(const InterlockingSnapshot& snapshot, const QString& machineId, const QString& requestedPosition) {
+    auto routeConflict = analyzeRouteImpact(snapshot, machineId, requestedPosition);
 
     if (routeConflict.hasConflict) {
         return ValidationResult::blocked(
@@ -373,14 +368,14 @@ ValidationResult PointMachineBranch::checkRouteConflicts(const QString& machineI
 }
 
 // === EXISTING HELPER METHODS (unchanged) ===
-PointMachineBranch::PointMachineState PointMachineBranch::getPointMachineState(const QString& machineId) {
+PointMachineBranch::PointMachineState PointMachineBranch::getPointMachineState(const InterlockingSnapshot& snapshot, const QString& machineId) {
     PointMachineState state;
-    auto pmData = m_dbManager->getPointMachineById(machineId);
+    const InterlockingSnapshot::PointState* point = snapshot.pointState(machineId);
 
-    if (!pmData.isEmpty()) {
-        state.currentPosition = pmData["position"].toString();
-        state.operatingStatus = pmData["operatingStatus"].toString();
-        state.isActive = pmData["isActive"].toBool();
+    if (point) {
+        state.currentPosition = point->position;
+        state.operatingStatus = point->operatingStatus;
+        state.isActive = point->isActive();
 
         // Default values for fields not yet in database
         state.isLocked = false;
@@ -392,29 +387,23 @@ PointMachineBranch::PointMachineState PointMachineBranch::getPointMachineState(c
     return state;
 }
 
-QStringList PointMachineBranch::getProtectingSignals(const QString& machineId) {
-    auto pmData = m_dbManager->getPointMachineById(machineId);
-    if (!pmData.isEmpty()) {
+QStringList PointMachineBranch::getProtectingSignals(const InterlockingSnapshot& snapshot, const QString& machineId) {
+    if (snapshot.pointState(machineId)) {
         // TODO: Add protected_signals field to database schema
         // return pmData["protectedSignals"].toStringList();
     }
     return QStringList();
 }
 
-QStringList PointMachineBranch::getAffectedTrackSegments(const QString& machineId, const QString& position) {
-    auto pmData = m_dbManager->getPointMachineById(machineId);
-    if (!pmData.isEmpty()) {
-        QVariantMap rootTrackSegment = pmData["rootTrackSegment"].toMap();
-        QVariantMap normalTrackSegment = pmData["normalTrackSegment"].toMap();
-        QVariantMap reverseTrackSegment = pmData["reverseTrackSegment"].toMap();
-
+QStringList PointMachineBranch::getAffectedTrackSegments(const InterlockingSnapshot& snapshot, const QString& machineId, const QString& position) {
+    if (const InterlockingSnapshot::PointState* point = snapshot.pointState(machineId)) {
         QStringList trackSegments;
-        trackSegments.append(rootTrackSegment["trackSegmentId"].toString());
+        trackSegments.append(point->rootTrackSegment);
 
         if (position == "NORMAL") {
-            trackSegments.append(normalTrackSegment["trackSegmentId"].toString());
+            trackSegments.append(point->normalTrackSegment);
         } else {
-            trackSegments.append(reverseTrackSegment["trackSegmentId"].toString());
+            trackSegments.append(point->reverseTrackSegment);
         }
 
         return trackSegments;
@@ -422,20 +411,18 @@ QStringList PointMachineBranch::getAffectedTrackSegments(const QString& machineI
     return QStringList();
 }
 
-QStringList PointMachineBranch::getConflictingPointMachines(const QString& machineId) {
-    auto pmData = m_dbManager->getPointMachineById(machineId);
-    if (!pmData.isEmpty()) {
+QStringList PointMachineBranch::getConflictingPointMachines(const InterlockingSnapshot& snapshot, const QString& machineId) {
+    if (snapshot.pointState(machineId)) {
         // TODO: Add conflicting_points field to database schema
         // return pmData["conflictingPoints"].toStringList();
     }
     return QStringList();
 }
 
-bool PointMachineBranch::areAllProtectingSignalsAtRed(const QStringList& signalIds) {
+bool PointMachineBranch::areAllProtectingSignalsAtRed(const InterlockingSnapshot& snapshot, const QStringList& signalIds) {
     for (const QString& signalId : signalIds) {
-        auto signalData = m_dbManager->getSignalById(signalId);
-        if (!signalData.isEmpty()) {
-            QString aspect = signalData["currentAspect"].toString();
+        if (const InterlockingSnapshot::SignalState* signal = snapshot.signalState(signalId)) {
+            QString aspect = signal->mainAspect;
             if (aspect != "RED") {
                 return false;
             }
@@ -445,7 +432,7 @@ bool PointMachineBranch::areAllProtectingSignalsAtRed(const QStringList& signalI
 }
 
 PointMachineBranch::RouteConflictInfo PointMachineBranch::analyzeRouteImpact(
-    const QString& machineId, const QString& requestedPosition) {
+    const InterlockingSnapshot& snapshot, const QString& machineId, const QString& requestedPosition) {
 
     RouteConflictInfo info;
     info.hasConflict = false;
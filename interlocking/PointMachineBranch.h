@@ -1,74 +1,75 @@
 #pragma once
-#include <QObject>
 #include <QDateTime>
 #include "InterlockingService.h"
+#include "InterlockingSnapshot.h"
 
-class DatabaseManager;
-
-class PointMachineBranch : public QObject {
-    Q_OBJECT
-
+//   POINT MACHINE BRANCH
+//
+//   Reentrant point machine validators over an InterlockingSnapshot; no state between calls.
+class PointMachineBranch {
 public:
-    explicit PointMachineBranch(DatabaseManager* dbManager, QObject* parent = nullptr);
+    PointMachineBranch() = delete;
 
     // === PRIMARY VALIDATION METHODS ===
-    ValidationResult validatePositionChange(const QString& machineId,
-                                            const QString& currentPosition,
-                                            const QString& requestedPosition,
-                                            const QString& operatorId);
+    static ValidationResult validatePositionChange(const InterlockingSnapshot& snapshot,
+                                                   const QString& machineId,
+                                                   const QString& currentPosition,
+                                                   const QString& requestedPosition,
+                                                   const QString& operatorId);
 
     // === NEW: PAIRED OPERATION VALIDATION ===
-    ValidationResult validatePairedOperation(const QString& machineId,
-                                             const QString& pairedMachineId,
-                                             const QString& currentPosition,
-                                             const QString& pairedCurrentPosition,
-                                             const QString& newPosition,
-                                             const QString& operatorId);
+    static ValidationResult validatePairedOperation(const InterlockingSnapshot& snapshot,
+                                                    const QString& machineId,
+                                                    const QString& pairedMachineId,
+                                                    const QString& currentPosition,
+                                                    const QString& pairedCurrentPosition,
+                                                    const QString& newPosition,
+                                                    const QString& operatorId);
 
 private:
-    DatabaseManager* m_dbManager;
-
     // === CORE VALIDATION RULES ===
-    ValidationResult checkPointMachineExists(const QString& machineId);
-    ValidationResult checkPointMachineActive(const QString& machineId);
-    ValidationResult checkOperationalStatus(const QString& machineId);
-    ValidationResult checkLockingStatus(const QString& machineId);
-    ValidationResult checkProtectingSignals(const QString& machineId, const QString& requestedPosition);
-    ValidationResult checkTrackSegmentOccupancy(const QString& machineId, const QString& requestedPosition);
-    ValidationResult checkRouteConflicts(const QString& machineId, const QString& requestedPosition);
-    ValidationResult checkTimeLocking(const QString& machineId);
-    ValidationResult checkDetectionLocking(const QString& machineId);
-    ValidationResult checkConflictingPoints(const QString& machineId, const QString& requestedPosition);
+    static ValidationResult checkPointMachineExists(const InterlockingSnapshot& snapshot, const QString& machineId);
+    static ValidationResult checkPointMachineActive(const InterlockingSnapshot& snapshot, const QString& machineId);
+    static ValidationResult checkOperationalStatus(const InterlockingSnapshot& snapshot, const QString& machineId);
+    static ValidationResult checkLockingStatus(const InterlockingSnapshot& snapshot, const QString& machineId);
+    static ValidationResult checkProtectingSignals(const InterlockingSnapshot& snapshot, const QString& machineId, const QString& requestedPosition);
+    static ValidationResult checkTrackSegmentOccupancy(const InterlockingSnapshot& snapshot, const QString& machineId, const QString& requestedPosition);
+    static ValidationResult checkRouteConflicts(const InterlockingSnapshot& snapshot, const QString& machineId, const QString& requestedPosition);
+    //   Expiry is compared with the snapshot's capture time, not the wall clock
+    static ValidationResult checkTimeLocking(const InterlockingSnapshot& snapshot, const QString& machineId);
+    static ValidationResult checkDetectionLocking(const InterlockingSnapshot& snapshot, const QString& machineId);
+    static ValidationResult checkConflictingPoints(const InterlockingSnapshot& snapshot, const QString& machineId, const QString& requestedPosition);
 
     // === NEW: PAIRED-SPECIFIC VALIDATIONS ===
-    ValidationResult checkPairedTrackSegmentOccupancy(const QString& machineId,
-                                                      const QString& pairedMachineId,
-                                                      const QString& newPosition);
-    ValidationResult checkPairedConflicts(const QString& machineId,
-                                          const QString& pairedMachineId,
-                                          const QString& newPosition);
+    static ValidationResult checkPairedTrackSegmentOccupancy(const InterlockingSnapshot& snapshot,
+                                                             const QString& machineId,
+                                                             const QString& pairedMachineId,
+                                                             const QString& newPosition);
+    static ValidationResult checkPairedConflicts(const InterlockingSnapshot& snapshot,
+                                                 const QString& machineId,
+                                                 const QString& pairedMachineId,
+                                                 const QString& newPosition);
 
     // === HELPER METHODS ===
-    QStringList getProtectingSignals(const QString& machineId);
-    QStringList getAffectedTrackSegments(const QString& machineId, const QString& position);
-    QStringList getConflictingPointMachines(const QString& machineId);
-    bool areAllProtectingSignalsAtRed(const QStringList& signalIds);
-    bool areAffectedTrackSegmentsClear(const QStringList& trackSegmentIds);
-    bool isInTransition(const QString& machineId);
+    static QStringList getProtectingSignals(const InterlockingSnapshot& snapshot, const QString& machineId);
+    static QStringList getAffectedTrackSegments(const InterlockingSnapshot& snapshot, const QString& machineId, const QString& position);
+    static QStringList getConflictingPointMachines(const InterlockingSnapshot& snapshot, const QString& machineId);
+    static bool areAllProtectingSignalsAtRed(const InterlockingSnapshot& snapshot, const QStringList& signalIds);
 
     // === NEW: PAIRED HELPER METHODS ===
-    QString getCurrentPointPosition(const QString& machineId);
-    QStringList getCombinedAffectedTrackSegments(const QString& machineId,
-                                                 const QString& pairedMachineId,
-                                                 const QString& position);
+    static QString getCurrentPointPosition(const InterlockingSnapshot& snapshot, const QString& machineId);
+    static QStringList getCombinedAffectedTrackSegments(const InterlockingSnapshot& snapshot,
+                                                        const QString& machineId,
+                                                        const QString& pairedMachineId,
+                                                        const QString& position);
 
     // === DATA STRUCTURES ===
     struct PointMachineState {
         QString currentPosition;
         QString operatingStatus;
-        bool isLocked;
-        bool isActive;
-        bool timeLockingActive;
+        bool isLocked = false;
+        bool isActive = false;
+        bool timeLockingActive = false;
         QDateTime timeLockExpiry;
         QStringList detectionLocks;
     };
@@ -79,6 +80,6 @@ private:
         QString conflictReason;
     };
 
-    PointMachineState getPointMachineState(const QString& machineId);
-    RouteConflictInfo analyzeRouteImpact(const QString& machineId, const QString& requestedPosition);
+    static PointMachineState getPointMachineState(const InterlockingSnapshot& snapshot, const QString& machineId);
+    static RouteConflictInfo analyzeRouteImpact(const InterlockingSnapshot& snapshot, const QString& machineId, const QString& requestedPosition);
 };
@@ -1,59 +1,45 @@
 #include "SignalBranch.h"
-#include "../database/DatabaseManager.h"
 #include "InterlockingRuleEngine.h"
 #include <QDebug>
 
-SignalBranch::SignalBranch(DatabaseManager* dbManager, QObject* parent)
-    : QObject(parent), m_dbManager(dbManager) {
-
-    if (!dbManager) {
-        qCritical() << " SAFETY: SignalBranch initialized with null DatabaseManager!";
-        // Consider throwing or handling this critical error
-    }
-
-    // ? INITIALIZE RULE ENGINE
-    m_ruleEngine = std::make_unique<InterlockingRuleEngine>(dbManager, this);
-
-    if (!m_ruleEngine->loadRulesFromResource()) {
-        qCritical() << " SAFETY: Failed to load interlocking rules - system may not be safe!";
-        // Consider setting a safety flag or refusing to operate
-    }
-}
-
 ValidationResult SignalBranch::validateMainAspectChange(
-    const QString& signalId, const QString& currentAspect,
+    const InterlockingSnapshot& snapshot, const QString& signalId, const QString& currentAspect,
     const QString& requestedAspect, const QString& operatorId) {
 
+    Q_UNUSED(operatorId);
+
     // 1. Check if signal is active
-    auto activeResult = checkSignalActive(signalId);
+    auto activeResult = checkSignalActive(snapshot, signalId);
     if (!activeResult.isAllowed()) return activeResult;
 
     // 2. Basic transition validation
-    auto basicResult = validateBasicTransition(signalId, currentAspect, requestedAspect);
+    auto basicResult = validateBasicTransition(snapshot, signalId, currentAspect, requestedAspect);
     if (!basicResult.isAllowed()) return basicResult;
 
     // 3. ? UPDATED: Track Circuit protection validation
-    auto trackCircuitResult = checkTrackCircuitProtection(signalId, requestedAspect);
+    auto trackCircuitResult = checkTrackCircuitProtection(snapshot, signalId, requestedAspect);
     if (!trackCircuitResult.isAllowed()) return trackCircuitResult;
 
     // 4. Interlocked signals validation
-    auto interlockResult = checkInterlockedSignals(signalId, currentAspect, requestedAspect);
+    auto interlockResult = checkInterlockedSignals(snapshot, signalId, currentAspect, requestedAspect);
     if (!interlockResult.isAllowed()) return interlockResult;
 
     return ValidationResult::allowed("All signal validations passed");
 }
 
 ValidationResult SignalBranch::validateSubsidiaryAspectChange(
-    const QString& signalId, const QString& aspectType,
+    const InterlockingSnapshot& snapshot, const QString& signalId, const QString& aspectType,
     const QString& currentAspect, const QString& requestedAspect,
     const QString& operatorId) {
 
+    Q_UNUSED(operatorId);
+
     qDebug() << " SIGNAL BRANCH: Subsidiary signal validation:" << signalId
              << "Type:" << aspectType
              << "Transition:" << currentAspect << "?" << requestedAspect;
 
     // ? 1. Check if signal exists and is active
-    auto activeResult = checkSignalActive(signalId);
+    auto activeResult = checkSignalActive(snapshot, signalId);
     if (!activeResult.isAllowed()) return activeResult;
 
     // ? 2. Validate aspect type and transition rules
@@ -62,13 +48,13 @@ ValidationResult SignalBranch::validateSubsidiaryAspectChange(
 
     // ? 3. Check calling-on specific safety rules
     if (aspectType == "CALLING_ON") {
-        auto callingOnResult = validateCallingOnSafetyRules(signalId, currentAspect, requestedAspect);
+        auto callingOnResult = validateCallingOnSafetyRules(snapshot, signalId, currentAspect, requestedAspect);
         if (!callingOnResult.isAllowed()) return callingOnResult;
     }
 
     // ? 4. Check loop signal specific rules
     if (aspectType == "LOOP") {
-        auto loopResult = validateLoopSignalRules(signalId, currentAspect, requestedAspect);
+        auto loopResult = validateLoopSignalRules(snapshot, signalId, currentAspect, requestedAspect);
         if (!loopResult.isAllowed()) return loopResult;
     }
 
@@ -117,14 +103,14 @@ ValidationResult SignalBranch::validateSubsidiaryTransition(
 }
 
 ValidationResult SignalBranch::validateCallingOnSafetyRules(
-    const QString& signalId, const QString& currentAspect, const QString& requestedAspect) {
+    const InterlockingSnapshot& snapshot, const QString& signalId, const QString& currentAspect, const QString& requestedAspect) {
 
     qDebug() << "? CALLING-ON VALIDATION:" << signalId
              << "Current:" << currentAspect << "? Requested:" << requestedAspect;
 
     // ? RULE 1: Calling-on can only be cleared when main signal is at danger
     if (requestedAspect == "WHITE") {
-        QString mainAspect = getCurrentMainSignalAspect(signalId);
+        QString mainAspect = getCurrentMainSignalAspect(snapshot, signalId);
         if (mainAspect.isEmpty()) {
             return ValidationResult::blocked(
                 QString("Cannot determine main signal aspect for %1").arg(signalId),
@@ -142,17 +128,12 @@ ValidationResult SignalBranch::validateCallingOnSafetyRules(
 
         // ? RULE 2: Check interlocking for the resulting composite aspect
         QString predictedCompositeAspect = predictCompositeAspectAfterSubsidiaryChange(
-            signalId, "CALLING_ON", requestedAspect);
+            snapshot, signalId, "CALLING_ON", requestedAspect);
 
         qDebug() << " Predicted composite aspect after calling-on change:" << predictedCompositeAspect;
 
-        if (!m_ruleEngine) {
-            qWarning() << "? Rule engine not available for calling-on validation";
-            return ValidationResult::blocked("Interlocking rule engine not available", "RULE_ENGINE_MISSING");
-        }
-
-        auto interlockingResult = m_ruleEngine->validateInterlockedSignalAspectChange(
-            signalId, mainAspect, predictedCompositeAspect);
+        auto interlockingResult = InterlockingRuleEngine::validateInterlockedSignalAspectChange(
+            snapshot, signalId, mainAspect, predictedCompositeAspect);
 
         if (!interlockingResult.isAllowed()) {
             qDebug() << "? Calling-on activation blocked by interlocking:" << interlockingResult.getReason();
@@ -174,7 +155,7 @@ ValidationResult SignalBranch::validateCallingOnSafetyRules(
 }
 
 ValidationResult SignalBranch::validateLoopSignalRules(
-    const QString& signalId, const QString& currentAspect, const QString& requestedAspect) {
+    const InterlockingSnapshot& snapshot, const QString& signalId, const QString& currentAspect, const QString& requestedAspect) {
 
     qDebug() << " LOOP SIGNAL VALIDATION:" << signalId
              << "Current loop:" << currentAspect << "? Requested:" << requestedAspect;
@@ -193,19 +174,13 @@ ValidationResult SignalBranch::validateLoopSignalRules(
 
         // ? PREDICT: What will the composite aspect be after this change?
         QString predictedCompositeAspect = predictCompositeAspectAfterSubsidiaryChange(
-            signalId, "LOOP", requestedAspect);
+            snapshot, signalId, "LOOP", requestedAspect);
 
         qDebug() << " Predicted composite aspect after loop change:" << predictedCompositeAspect;
 
-        // ? VALIDATE: Use interlocking rule engine to check if this composite aspect is allowed
-        if (!m_ruleEngine) {
-            qWarning() << "? Rule engine not available for loop signal validation";
-            return ValidationResult::blocked("Interlocking rule engine not available", "RULE_ENGINE_MISSING");
-        }
-
         // ? INTERLOCKING: Check if the predicted composite aspect is allowed
-        auto interlockingResult = m_ruleEngine->validateInterlockedSignalAspectChange(
-            signalId, getCurrentMainSignalAspect(signalId), predictedCompositeAspect);
+        auto interlockingResult = InterlockingRuleEngine::validateInterlockedSignalAspectChange(
+            snapshot, signalId, getCurrentMainSignalAspect(snapshot, signalId), predictedCompositeAspect);
 
         if (!interlockingResult.isAllowed()) {
             qDebug() << "? Loop signal activation blocked by interlocking:" << interlockingResult.getReason();
@@ -227,16 +202,16 @@ ValidationResult SignalBranch::validateLoopSignalRules(
 }
 
 QString SignalBranch::predictCompositeAspectAfterSubsidiaryChange(
-    const QString& signalId, const QString& aspectType, const QString& newSubsidiaryAspect) {
+    const InterlockingSnapshot& snapshot, const QString& signalId, const QString& aspectType, const QString& newSubsidiaryAspect) {
 
     qDebug() << " PREDICTING composite aspect for" << signalId
              << "after changing" << aspectType << "to" << newSubsidiaryAspect;
 
     // ? GET: Current signal state
-    auto signalData = m_dbManager->getSignalById(signalId);
-    QString currentMainAspect = signalData.value("currentAspect", "RED").toString();
-    QString currentCallingOn = signalData.value("callingOnAspect", "OFF").toString();
-    QString currentLoop = signalData.value("loopAspect", "OFF").toString();
+    const InterlockingSnapshot::SignalState* signal = snapshot.signalState(signalId);
+    QString currentMainAspect = signal ? signal->mainAspect : QString("RED");
+    QString currentCallingOn = signal ? signal->callingOnAspect : QString("OFF");
+    QString currentLoop = signal ? signal->loopAspect : QString("OFF");
 
     qDebug() << "  Current state - Main:" << currentMainAspect
              << "Calling-On:" << currentCallingOn
@@ -290,20 +265,19 @@ ValidationResult SignalBranch::checkSubsidiaryInterlocking(
     return ValidationResult::allowed("No subsidiary interlocking violations");
 }
 
-QString SignalBranch::getCurrentMainSignalAspect(const QString& signalId) {
-    if (!m_dbManager || !m_dbManager->isConnected()) {
-        qWarning() << "? Cannot get main signal aspect: Database not connected";
+QString SignalBranch::getCurrentMainSignalAspect(const InterlockingSnapshot& snapshot, const QString& signalId) {
+    const InterlockingSnapshot::SignalState* signal = snapshot.signalState(signalId);
+    if (!signal) {
+        qWarning() << "? Cannot get main signal aspect: Signal not in snapshot" << signalId;
         return QString();
     }
 
-    return m_dbManager->getCurrentSignalAspect(signalId);
+    return signal->mainAspect;
 }
 
 ValidationResult SignalBranch::validateBasicTransition(
-    const QString& signalId, const QString& currentAspect, const QString& requestedAspect) {
-
-    // Store signal ID for transition validation
-    m_currentSignalId = signalId;
+    const InterlockingSnapshot& snapshot, const QString& signalId,
+    const QString& currentAspect, const QString& requestedAspect) {
 
     //   ENHANCED: Special handling for RED→RED transitions
     if (currentAspect == requestedAspect) {
@@ -321,7 +295,7 @@ ValidationResult SignalBranch::validateBasicTransition(
     }
 
     // Check if transition is valid
-    if (!isValidAspectTransition(currentAspect, requestedAspect)) {
+    if (!isValidAspectTransition(snapshot, signalId, currentAspect, requestedAspect)) {
         return ValidationResult::blocked(
             QString("Invalid aspect transition from %1 to %2 for signal %3")
                 .arg(currentAspect, requestedAspect, signalId),
@@ -330,17 +304,16 @@ ValidationResult SignalBranch::validateBasicTransition(
     }
 
     // Get signal data to check capabilities
-    auto signalData = m_dbManager->getSignalById(signalId);
-    if (signalData.isEmpty()) {
+    const InterlockingSnapshot::SignalState* signal = snapshot.signalState(signalId);
+    if (!signal) {
         return ValidationResult::blocked("Signal not found: " + signalId, "SIGNAL_NOT_FOUND");
     }
 
     //   SAFETY: Validate aspect is supported by this signal type
-    QStringList possibleAspects = signalData["possibleAspects"].toStringList();
-    if (!possibleAspects.contains(requestedAspect)) {
+    if (!signal->possibleAspects.contains(requestedAspect)) {
         return ValidationResult::blocked(
             QString("Aspect %1 not supported by %2 signal %3")
-                .arg(requestedAspect, signalData["type"].toString(), signalId),
+                .arg(requestedAspect, signal->type, signalId),
             "ASPECT_NOT_SUPPORTED"
             );
     }
@@ -349,14 +322,15 @@ ValidationResult SignalBranch::validateBasicTransition(
 }
 
 // ? UPDATED: Track Circuit Protection Method
-ValidationResult SignalBranch::checkTrackCircuitProtection(const QString& signalId, const QString& requestedAspect) {
+ValidationResult SignalBranch::checkTrackCircuitProtection(const InterlockingSnapshot& snapshot,
+                                                          const QString& signalId, const QString& requestedAspect) {
     // ? SAFETY: Only check track circuit protection for proceed aspects
     if (requestedAspect == "RED") {
         return ValidationResult::allowed("RED aspect - no track circuit protection required");
     }
 
     // ? SAFETY: Comprehensive protected track circuits validation
-    auto validation = validateProtectedTrackCircuits(signalId);
+    auto validation = validateProtectedTrackCircuits(snapshot, signalId);
 
     if (!validation.isValid) {
         return ValidationResult::blocked(
@@ -372,25 +346,26 @@ ValidationResult SignalBranch::checkTrackCircuitProtection(const QString& signal
 }
 
 ValidationResult SignalBranch::checkInterlockedSignals(
+    const InterlockingSnapshot& snapshot,
     const QString& signalId,
     const QString& currentAspect,
     const QString& requestedAspect) {
 
-    if (!m_ruleEngine) {
-        qCritical() << " SAFETY: Rule engine not initialized!";
+    if (!snapshot.rules) {
+        qCritical() << " SAFETY: Interlocking rules missing from snapshot!";
         return ValidationResult::blocked("Interlocking system not available", "RULE_ENGINE_MISSING");
     }
 
-    return m_ruleEngine->validateInterlockedSignalAspectChange(signalId, currentAspect, requestedAspect);
+    return InterlockingRuleEngine::validateInterlockedSignalAspectChange(snapshot, signalId, currentAspect, requestedAspect);
 }
 
-ValidationResult SignalBranch::checkSignalActive(const QString& signalId) {
-    auto signalData = m_dbManager->getSignalById(signalId);
-    if (signalData.isEmpty()) {
+ValidationResult SignalBranch::checkSignalActive(const InterlockingSnapshot& snapshot, const QString& signalId) {
+    const InterlockingSnapshot::SignalState* signal = snapshot.signalState(signalId);
+    if (!signal) {
         return ValidationResult::blocked("Signal not found: " + signalId, "SIGNAL_NOT_FOUND");
     }
 
-    if (!signalData["isActive"].toBool()) {
+    if (!signal->isActive) {
         return ValidationResult::blocked("Signal is not active: " + signalId, "SIGNAL_INACTIVE");
     }
 
@@ -398,9 +373,9 @@ ValidationResult SignalBranch::checkSignalActive(const QString& signalId) {
 }
 
 // ? UPDATED: Public API method for track circuits
-QStringList SignalBranch::getProtectedTrackCircuits(const QString& signalId) {
+QStringList SignalBranch::getProtectedTrackCircuits(const InterlockingSnapshot& snapshot, const QString& signalId) {
     // ? SAFETY: Use comprehensive validation for safety-critical track circuit protection
-    auto validation = validateProtectedTrackCircuits(signalId);
+    auto validation = validateProtectedTrackCircuits(snapshot, signalId);
 
     if (!validation.isValid) {
         qCritical() << " SAFETY CRITICAL: Protected track circuits validation failed for signal"
@@ -416,25 +391,17 @@ QStringList SignalBranch::getProtectedTrackCircuits(const QString& signalId) {
     return validation.protectedTrackSegments; // Keep field name for compatibility
 }
 
-QStringList SignalBranch::getInterlockedSignals(const QString& signalId) {
-    auto signalData = m_dbManager->getSignalById(signalId);
-    if (!signalData.isEmpty()) {
-        // This should come from your existing interlocked_with field
-        return signalData["interlockedWith"].toStringList();
-    }
-    return QStringList();
-}
-
-bool SignalBranch::isValidAspectTransition(const QString& from, const QString& to) {
+bool SignalBranch::isValidAspectTransition(const InterlockingSnapshot& snapshot, const QString& signalId,
+                                           const QString& from, const QString& to) {
     //   SPECIAL CASE: Allow RED to RED transitions with warning (safety redundancy)
     if (from == to) {
         if (from == "RED" && to == "RED") {
             qWarning() << " [SAFETY_REDUNDANCY] Setting signal to RED when already RED:"
-                       << m_currentSignalId << "- allowed for safety but may indicate logic issue";
+                       << signalId << "- allowed for safety but may indicate logic issue";
             return true;  // Allow RED→RED with warning
         } else {
             qDebug() << "[TRANSITION_BLOCKED] Same aspect transition blocked:"
-                     << m_currentSignalId << from << "→" << to
+                     << signalId << from << "→" << to
                      << "- no change needed for non-RED aspects";
             return false; // Block all other same-aspect transitions
         }
@@ -445,13 +412,11 @@ bool SignalBranch::isValidAspectTransition(const QString& from, const QString& t
 
     //   Get signal capabilities from database to validate transition
     // This prevents invalid capability transitions
-    auto signalData = m_dbManager->getSignalById(m_currentSignalId);
-    if (signalData.isEmpty()) return false;
-
-    QStringList supportedAspects = signalData["possibleAspects"].toStringList();
+    const InterlockingSnapshot::SignalState* signal = snapshot.signalState(signalId);
+    if (!signal) return false;
 
     //   SAFETY: Cannot transition to unsupported aspect
-    if (!supportedAspects.contains(to)) {
+    if (!signal->possibleAspects.contains(to)) {
         qDebug() << "BLOCKED: Signal doesn't support aspect" << to;
         return false;
     }
@@ -515,13 +480,18 @@ bool SignalBranch::isDangerousInterGroupTransition(
 }
 
 // ? UPDATED: Main validation method for track circuits
-SignalBranch::ProtectedTrackSegmentsValidation SignalBranch::validateProtectedTrackCircuits(const QString& signalId) {
+SignalBranch::ProtectedTrackSegmentsValidation SignalBranch::validateProtectedTrackCircuits(
+    const InterlockingSnapshot& snapshot, const QString& signalId) {
     ProtectedTrackSegmentsValidation result;
     result.isValid = false;
 
-    // ? UPDATED: Get protected track circuits from two sources
-    QStringList trackCircuitsFromSignalData = getProtectedTrackCircuitsFromSignalData(signalId);
-    QStringList trackCircuitsFromInterlockingRules = getProtectedTrackCircuitsFromInterlockingRules(signalId);
+    // ? UPDATED: Get protected track circuits from two sources (both captured in the snapshot)
+    const InterlockingSnapshot::SignalState* signal = snapshot.signalState(signalId);
+    if (!signal) {
+        qWarning() << " Signal data not found for:" << signalId;
+    }
+    QStringList trackCircuitsFromSignalData = signal ? signal->protectedTrackCircuits : QStringList();
+    QStringList trackCircuitsFromInterlockingRules = signal ? signal->ruleProtectedTrackCircuits : QStringList();
 
     qDebug() << " SAFETY AUDIT: Protected track circuits for signal" << signalId;
     qDebug() << "   From signal data:" << trackCircuitsFromSignalData;
@@ -542,7 +512,7 @@ SignalBranch::ProtectedTrackSegmentsValidation SignalBranch::validateProtectedTr
     }
 
     // ? UPDATED: Check track circuit occupancy status
-    if (!validateTrackCircuitOccupancy(authoritative, result)) {
+    if (!validateTrackCircuitOccupancy(snapshot, authoritative, result)) {
         return result;
     }
 
@@ -556,42 +526,6 @@ SignalBranch::ProtectedTrackSegmentsValidation SignalBranch::validateProtectedTr
     return result;
 }
 
-// ? UPDATED: Get protected track circuits from signal data
-QStringList SignalBranch::getProtectedTrackCircuitsFromSignalData(const QString& signalId) {
-    auto signalData = m_dbManager->getSignalById(signalId);
-    if (signalData.isEmpty()) {
-        qWarning() << " Signal data not found for:" << signalId;
-        return QStringList();
-    }
-
-    //    The data is already parsed as QStringList in convertSignalRowToVariant()
-    QVariant protectedTrackCircuitsVar = signalData["protectedTrackCircuits"];
-
-    //  DEBUG: Log what we actually got
-    qDebug() << " [SIGNAL] Protected circuits variant type:" << protectedTrackCircuitsVar.typeName()
-             << "value:" << protectedTrackCircuitsVar;
-
-    if (protectedTrackCircuitsVar.canConvert<QStringList>()) {
-        QStringList result = protectedTrackCircuitsVar.toStringList();
-        qDebug() << "  [SIGNAL] Extracted protected circuits:" << result;
-        return result;
-    }
-
-    qDebug() << " [SIGNAL] Could not convert to QStringList";
-    return QStringList();
-}
-
-// ? UPDATED: Use DatabaseManager API instead of direct SQL
-QStringList SignalBranch::getProtectedTrackCircuitsFromInterlockingRules(const QString& signalId) {
-    if (!m_dbManager) {
-        qCritical() << " SAFETY CRITICAL: DatabaseManager not available for interlocking rules query";
-        return QStringList();
-    }
-
-    // ? CRITICAL: Use DatabaseManager API instead of direct database access
-    return m_dbManager->getProtectedTrackCircuitsFromInterlockingRules(signalId);
-}
-
 // ? UPDATED: Track circuit consistency validation
 bool SignalBranch::validateTrackCircuitConsistency(
     const QStringList& fromSignalData,
@@ -631,23 +565,23 @@ bool SignalBranch::validateTrackCircuitConsistency(
 
 // ? UPDATED: Track circuit occupancy validation
 bool SignalBranch::validateTrackCircuitOccupancy(
+    const InterlockingSnapshot& snapshot,
     const QStringList& protectedTrackCircuits,
     ProtectedTrackSegmentsValidation& result) {
 
     QStringList occupiedCircuits;
 
     for (const QString& circuitId : protectedTrackCircuits) {
-        // ? CRITICAL: Use DatabaseManager API instead of direct database access
-        auto circuitData = m_dbManager->getTrackCircuitById(circuitId);
-        if (circuitData.isEmpty()) {
+        const InterlockingSnapshot::Occupancy* circuit = snapshot.trackCircuit(circuitId);
+        if (!circuit) {
             result.errorReason = QString("Protected track circuit %1 not found in database").arg(circuitId);
             qCritical() << " SAFETY CRITICAL: Protected track circuit not found:" << circuitId;
             return false;
         }
 
-        if (circuitData["occupied"].toBool()) {
+        if (circuit->occupied) {
             occupiedCircuits.append(circuitId);
-            QString occupiedBy = circuitData["occupiedBy"].toString();
+            QString occupiedBy = circuit->occupiedBy;
 
             qWarning() << " SAFETY: Protected track circuit" << circuitId
                        << "is occupied by" << occupiedBy;
@@ -1,30 +1,33 @@
 #pragma once
-#include <QObject>
-#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
 #include "InterlockingService.h"
-#include "InterlockingRuleEngine.h"
+#include "InterlockingSnapshot.h"
 
-class DatabaseManager;
-
-class SignalBranch : public QObject {
-    Q_OBJECT
-
-public:
+//   SIGNAL BRANCH
+//
+//   Reentrant signal validators: each call reads only the snapshot and its arguments and
+//   keeps no state between calls, so validations can run concurrently on any thread.
+class SignalBranch {
 public:
-    InterlockingRuleEngine* getRuleEngine() const { return m_ruleEngine.get(); }
-    explicit SignalBranch(DatabaseManager* dbManager, QObject* parent = nullptr);
+    SignalBranch() = delete;
 
     //   Main validation interface
-    ValidationResult validateMainAspectChange(const QString& signalId,
-                                              const QString& currentAspect,
-                                              const QString& requestedAspect,
-                                              const QString& operatorId);
-
-    ValidationResult validateSubsidiaryAspectChange(const QString& signalId,
-                                                    const QString& aspectType,
-                                                    const QString& currentAspect,
-                                                    const QString& requestedAspect,
-                                                    const QString& operatorId);
+    static ValidationResult validateMainAspectChange(const InterlockingSnapshot& snapshot,
+                                                     const QString& signalId,
+                                                     const QString& currentAspect,
+                                                     const QString& requestedAspect,
+                                                     const QString& operatorId);
+
+    static ValidationResult validateSubsidiaryAspectChange(const InterlockingSnapshot& snapshot,
+                                                           const QString& signalId,
+                                                           const QString& aspectType,
+                                                           const QString& currentAspect,
+                                                           const QString& requestedAspect,
+                                                           const QString& operatorId);
+
+    //   Protected track circuits, empty when the sources disagree or a circuit is unknown
+    static QStringList getProtectedTrackCircuits(const InterlockingSnapshot& snapshot, const QString& signalId);
 
 private:
 
@@ -36,20 +39,6 @@ private:
         BLOCK_SIGNALS        // PURPLE (future)
     };
 
-    enum class InterlockingType {
-        OPPOSING_SIGNALS,
-        CONFLICTING_ROUTES,
-        SEQUENTIAL_DEPENDENCY,
-        HOME_STARTER_PAIR
-    };
-
-    struct SignalCapabilities {
-        QStringList supportedAspects;
-        SignalGroup primaryGroup;
-        bool supportsCallingOn;
-        bool supportsLoop;
-    };
-
     //   UPDATED: Now handles track circuits (keeping struct name for compatibility)
     struct ProtectedTrackSegmentsValidation {
         bool isValid;
@@ -59,81 +48,67 @@ private:
         QStringList occupiedTrackSegments;   //   NOTE: Field name kept for compatibility - contains occupied circuits
     };
 
-    ValidationResult validateBasicTransition(const QString& signalId,
-                                             const QString& currentAspect,
-                                             const QString& requestedAspect);
+    static ValidationResult validateBasicTransition(const InterlockingSnapshot& snapshot,
+                                                    const QString& signalId,
+                                                    const QString& currentAspect,
+                                                    const QString& requestedAspect);
 
     //   UPDATED: Now validates track circuit protection
-    ValidationResult checkTrackCircuitProtection(const QString& signalId,
-                                                 const QString& requestedAspect);
-
-    ValidationResult checkInterlockedSignals(const QString& signalId,
-                                             const QString& currentAspect,
-                                             const QString& requestedAspect);
+    static ValidationResult checkTrackCircuitProtection(const InterlockingSnapshot& snapshot,
+                                                        const QString& signalId,
+                                                        const QString& requestedAspect);
 
-    ValidationResult checkSignalActive(const QString& signalId);
+    static ValidationResult checkInterlockedSignals(const InterlockingSnapshot& snapshot,
+                                                    const QString& signalId,
+                                                    const QString& currentAspect,
+                                                    const QString& requestedAspect);
 
-    ValidationResult validateSubsidiaryTransition(const QString& signalId,
-                                                  const QString& aspectType,
-                                                  const QString& currentAspect,
-                                                  const QString& requestedAspect);
+    static ValidationResult checkSignalActive(const InterlockingSnapshot& snapshot, const QString& signalId);
 
-    ValidationResult validateCallingOnSafetyRules(const QString& signalId,
-                                                  const QString& currentAspect,
-                                                  const QString& requestedAspect);
+    static ValidationResult validateSubsidiaryTransition(const QString& signalId,
+                                                         const QString& aspectType,
+                                                         const QString& currentAspect,
+                                                         const QString& requestedAspect);
 
-    ValidationResult validateLoopSignalRules(const QString& signalId,
-                                             const QString& currentAspect,
-                                             const QString& requestedAspect);
+    static ValidationResult validateCallingOnSafetyRules(const InterlockingSnapshot& snapshot,
+                                                         const QString& signalId,
+                                                         const QString& currentAspect,
+                                                         const QString& requestedAspect);
 
-    ValidationResult checkSubsidiaryInterlocking(const QString& signalId,
-                                                 const QString& aspectType,
-                                                 const QString& currentAspect,
-                                                 const QString& requestedAspect);
+    static ValidationResult validateLoopSignalRules(const InterlockingSnapshot& snapshot,
+                                                    const QString& signalId,
+                                                    const QString& currentAspect,
+                                                    const QString& requestedAspect);
 
-    QString getCurrentMainSignalAspect(const QString& signalId);
-    QString predictCompositeAspectAfterSubsidiaryChange(const QString& signalId,
+    static ValidationResult checkSubsidiaryInterlocking(const QString& signalId,
                                                         const QString& aspectType,
-                                                        const QString& newSubsidiaryAspect);
+                                                        const QString& currentAspect,
+                                                        const QString& requestedAspect);
 
+    static QString getCurrentMainSignalAspect(const InterlockingSnapshot& snapshot, const QString& signalId);
+    static QString predictCompositeAspectAfterSubsidiaryChange(const InterlockingSnapshot& snapshot,
+                                                               const QString& signalId,
+                                                               const QString& aspectType,
+                                                               const QString& newSubsidiaryAspect);
 
     //   UPDATED: Now validates track circuits instead of track segments
-    ProtectedTrackSegmentsValidation validateProtectedTrackCircuits(const QString& signalId);
-
-    //   UPDATED: Gets protected track circuits from signal data
-    QStringList getProtectedTrackCircuitsFromSignalData(const QString& signalId);
-
-    //   UPDATED: Gets protected track circuits from interlocking rules via DatabaseManager
-    QStringList getProtectedTrackCircuitsFromInterlockingRules(const QString& signalId);
+    static ProtectedTrackSegmentsValidation validateProtectedTrackCircuits(const InterlockingSnapshot& snapshot,
+                                                                           const QString& signalId);
 
     //   UPDATED: Validates track circuit consistency between sources
-    bool validateTrackCircuitConsistency(const QStringList& fromSignalData,
-                                         const QStringList& fromInterlockingRules,
-                                         ProtectedTrackSegmentsValidation& result);
+    static bool validateTrackCircuitConsistency(const QStringList& fromSignalData,
+                                                const QStringList& fromInterlockingRules,
+                                                ProtectedTrackSegmentsValidation& result);
 
     //   UPDATED: Validates track circuit occupancy status
-    bool validateTrackCircuitOccupancy(const QStringList& protectedTrackCircuits,
-                                       ProtectedTrackSegmentsValidation& result);
-
-public:
-    //   UPDATED: Public API now returns protected track circuits
-    QStringList getProtectedTrackCircuits(const QString& signalId);
-    QStringList getInterlockedSignals(const QString& signalId);
-
-private:
-
-    bool isValidAspectTransition(const QString& from, const QString& to);
-    SignalGroup determineSignalGroup(const QString& aspect);
-    bool isDangerousInterGroupTransition(SignalGroup fromGroup, SignalGroup toGroup,
-                                         const QString& fromAspect, const QString& toAspect);
-
-
-    bool supportsAspect(const QString& signalId, const QString& aspect);
-    int getAspectPrecedence(const QString& aspect);
-    InterlockingType determineInterlockingType(const QString& signal1Id, const QString& signal2Id);
-
-
-    DatabaseManager* m_dbManager;
-    QString m_currentSignalId;  // Context for validation
-    std::unique_ptr<InterlockingRuleEngine> m_ruleEngine;
+    static bool validateTrackCircuitOccupancy(const InterlockingSnapshot& snapshot,
+                                              const QStringList& protectedTrackCircuits,
+                                              ProtectedTrackSegmentsValidation& result);
+
+    static bool isValidAspectTransition(const InterlockingSnapshot& snapshot,
+                                        const QString& signalId,
+                                        const QString& from, const QString& to);
+    static SignalGroup determineSignalGroup(const QString& aspect);
+    static bool isDangerousInterGroupTransition(SignalGroup fromGroup, SignalGroup toGroup,
+                                                const QString& fromAspect, const QString& toAspect);
 };
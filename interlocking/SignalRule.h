@@ -3,6 +3,7 @@
 #include <QStringList>
 #include <QVariantMap>
 #include <memory>
+#include "PackedAspect.h"
 
 class SignalRule {
 public:
@@ -25,6 +26,7 @@ public:
                const QList<AllowedSignal>& allowedSignals);
 
     QString getWhenAspect() const { return m_whenAspect; }
+    PackedAspect getPackedWhenAspect() const { return m_packedWhenAspect; }
     const QList<Condition>& getConditions() const { return m_conditions; }
     const QList<AllowedSignal>& getAllowedSignals() const { return m_allowedSignals; }
 
@@ -33,12 +35,13 @@ public:
 
 private:
     QString m_whenAspect;
+    PackedAspect m_packedWhenAspect;    //   Parsed once; evaluation never re-reads the string
     QList<Condition> m_conditions;
     QList<AllowedSignal> m_allowedSignals;
 
-    //   PERFORMANCE: Pre-computed lookup map
-    mutable QHash<QString, QStringList> m_aspectLookupCache;
-    mutable bool m_cacheBuilt = false;
+    //   PERFORMANCE: Pre-computed lookup map, built in the constructor so a published
+    //   rule set is never written to while other threads validate against it
+    QHash<QString, QStringList> m_aspectLookupCache;
 
-    void buildLookupCache() const;
+    void buildLookupCache();
 };
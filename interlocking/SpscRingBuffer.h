@@ -0,0 +1,80 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+//   LOCK-FREE SPSC RING BUFFER: Bounded queue between exactly one producer thread
+//   and exactly one consumer thread. Capacity must be a power of two so the slot
+//   index is a mask instead of a modulo. Neither side ever blocks or allocates;
+//   a full queue is reported to the producer, which decides whether to retry.
+template <typename T, std::size_t Capacity>
+class SpscRingBuffer {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRingBuffer capacity must be a power of two");
+
+public:
+    SpscRingBuffer() = default;
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    //   PRODUCER SIDE: Returns false when the queue is full (item is left untouched)
+    bool tryPush(T&& item) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail >= Capacity) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail >= Capacity) {
+                return false;
+            }
+        }
+
+        m_slots[head & MASK] = std::move(item);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(const T& item) {
+        T copy(item);
+        return tryPush(std::move(copy));
+    }
+
+    //   CONSUMER SIDE: Returns false when the queue is empty
+    bool tryPop(T& out) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_cachedHead) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail == m_cachedHead) {
+                return false;
+            }
+        }
+
+        out = std::move(m_slots[tail & MASK]);
+        m_slots[tail & MASK] = T();  // Drop shared payloads (QString etc.) eagerly
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    //   MONITORING: Approximate when called concurrently with push/pop
+    std::size_t sizeApprox() const {
+        const std::size_t head = m_head.load(std::memory_order_acquire);
+        const std::size_t tail = m_tail.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    bool emptyApprox() const { return sizeApprox() == 0; }
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    static constexpr std::size_t MASK = Capacity - 1;
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    //   PRODUCER-OWNED: Write index plus a private copy of the last seen read index
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_head{0};
+    std::size_t m_cachedTail = 0;
+
+    //   CONSUMER-OWNED: Read index plus a private copy of the last seen write index
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_tail{0};
+    std::size_t m_cachedHead = 0;
+
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> m_slots{};
+};
@@ -0,0 +1,280 @@
+#include "StationAspectEvaluator.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+
+//
+//   COMPILATION
+//
+
+bool StationAspectEvaluator::compile(const InterlockingRuleEngine::RuleSet& ruleSet, QStringList& errors) {
+    *this = StationAspectEvaluator();
+
+    //   Deterministic signal order regardless of QHash iteration
+    QStringList signalIds = ruleSet.signalRules.keys();
+    std::sort(signalIds.begin(), signalIds.end());
+
+    for (const QString& signalId : signalIds) {
+        m_signalIndex.insert(signalId, static_cast<int>(m_signalIds.size()));
+        m_signalIds.push_back(signalId);
+    }
+
+    auto indexOf = [](QHash<QString, int>& index, const QString& id) {
+        auto it = index.find(id);
+        if (it == index.end()) {
+            it = index.insert(id, static_cast<int>(index.size()));
+        }
+        return it.value();
+    };
+
+    //   PAIRS: one per (target, controller) the target actually consults, contiguous per target
+    QHash<QPair<int, int>, int> pairIndex;
+    m_signalMode.resize(m_signalIds.size(), MODE_ALL);
+    m_pairBegin.resize(m_signalIds.size(), 0);
+    m_pairEnd.resize(m_signalIds.size(), 0);
+
+    int pairCount = 0;
+    for (int target = 0; target < static_cast<int>(m_signalIds.size()); ++target) {
+        const auto& info = *ruleSet.signalRules.constFind(m_signalIds[target]);
+        const QString controlMode = info.controlMode.trimmed().toUpper();
+
+        m_signalMode[target] = info.isIndependent ? MODE_ALL : (controlMode == "OR" ? MODE_OR : MODE_AND);
+        m_pairBegin[target] = pairCount;
+
+        if (!info.isIndependent) {
+            for (const QString& controllerId : info.controlledBy) {
+                const int controller = m_signalIndex.value(controllerId, -1);
+                if (controller < 0 || pairIndex.contains({target, controller})) {
+                    continue; // Unknown controllers are skipped, as in the single-signal path
+                }
+                pairIndex.insert({target, controller}, pairCount++);
+            }
+        }
+
+        m_pairEnd[target] = pairCount;
+    }
+    m_pairMask.resize(pairCount, 0);
+
+    //   RULES, CONDITIONS AND EDGES
+    for (int controller = 0; controller < static_cast<int>(m_signalIds.size()); ++controller) {
+        const auto& info = *ruleSet.signalRules.constFind(m_signalIds[controller]);
+
+        for (const SignalRule& rule : info.rules) {
+            const int ruleIndex = static_cast<int>(m_ruleController.size());
+            const PackedAspect whenAspect = rule.getPackedWhenAspect();
+
+            //   Mirror PackedAspect::matches(): (state & mask) == bits
+            m_ruleController.push_back(controller);
+            m_ruleWhenBits.push_back(whenAspect.bits());
+            m_ruleWhenMask.push_back(whenAspect.mask());
+
+            for (const SignalRule::Condition& condition : rule.getConditions()) {
+                if (condition.entityType == "point_machine") {
+                    m_pointConditionRule.push_back(ruleIndex);
+                    m_pointConditionPoint.push_back(indexOf(m_pointIndex, condition.entityId));
+                    m_pointConditionPosition.push_back(condition.requiredState == "REVERSE" ? POSITION_REVERSE
+                                                                                            : POSITION_NORMAL);
+                } else if (condition.entityType == "track_segment") {
+                    m_segmentConditionRule.push_back(ruleIndex);
+                    m_segmentConditionSegment.push_back(indexOf(m_segmentIndex, condition.entityId));
+                    m_segmentConditionOccupied.push_back(condition.requiredState == "OCCUPIED" ? 1 : 0);
+                }
+            }
+
+            for (const SignalRule::AllowedSignal& allowed : rule.getAllowedSignals()) {
+                const int target = m_signalIndex.value(allowed.signalId, -1);
+                const int pair = target < 0 ? -1 : pairIndex.value({target, controller}, -1);
+                if (pair < 0) {
+                    continue; // Target does not consult this controller
+                }
+
+                AspectMask allowedMask = 0;
+                for (const QString& aspect : allowed.allowedAspects) {
+                    if (!m_aspectIndex.contains(aspect)) {
+                        if (m_aspectVocabulary.size() >= MAX_ASPECT_VOCABULARY) {
+                            errors.append(QString("More than %1 distinct aspects in rule set").arg(MAX_ASPECT_VOCABULARY));
+                            return false;
+                        }
+                        m_aspectIndex.insert(aspect, static_cast<int>(m_aspectVocabulary.size()));
+                        m_aspectVocabulary.append(aspect);
+                    }
+                    allowedMask |= AspectMask(1) << m_aspectIndex.value(aspect);
+                }
+
+                m_edgeRule.push_back(ruleIndex);
+                m_edgePair.push_back(pair);
+                m_edgeAllowed.push_back(allowedMask);
+            }
+        }
+    }
+
+    //   INITIAL STATE: All signals at danger, points unknown (conditions fail), segments occupied
+    //   until reported - a segment the station never reports reads occupied, as in the rule engine
+    m_signalState.assign(m_signalIds.size(), PackedAspect::fromState("RED", "OFF", "OFF").bits());
+    m_pointPosition.assign(m_pointIndex.size(), POSITION_UNKNOWN);
+    m_segmentOccupied.assign(m_segmentIndex.size(), 1);
+    m_ruleLive.assign(m_ruleController.size(), 0);
+    m_permitted.assign(m_signalIds.size(), 0);
+    m_previousPermitted.assign(m_signalIds.size(), 0);
+
+    m_compiled = true;
+    m_compiledVersion = ruleSet.version;
+
+    qDebug() << " [AspectEvaluator] Compiled" << m_signalIds.size() << "signals," << m_ruleController.size()
+             << "rules," << m_edgeRule.size() << "edges," << m_aspectVocabulary.size() << "aspects";
+    return true;
+}
+
+//
+//   STATE INPUT
+//
+
+bool StationAspectEvaluator::setSignalAspect(const QString& signalId, PackedAspect state) {
+    const int index = m_signalIndex.value(signalId, -1);
+    if (index < 0) return false;
+    m_signalState[index] = state.bits();
+    return true;
+}
+
+bool StationAspectEvaluator::setSignalAspectComponent(const QString& signalId, AspectComponent component,
+                                                      AspectCode code) {
+    const int index = m_signalIndex.value(signalId, -1);
+    if (index < 0) return false;
+    const int shift = static_cast<int>(component);
+    m_signalState[index] = (m_signalState[index] & ~(0xFFu << shift)) | (static_cast<quint32>(code) << shift);
+    return true;
+}
+
+bool StationAspectEvaluator::setPointPosition(const QString& machineId, const QString& position) {
+    const int index = m_pointIndex.value(machineId, -1);
+    if (index < 0) return false;
+    m_pointPosition[index] = position == "NORMAL" ? POSITION_NORMAL
+                             : position == "REVERSE" ? POSITION_REVERSE
+                                                     : POSITION_UNKNOWN;
+    return true;
+}
+
+bool StationAspectEvaluator::setTrackSegmentOccupied(const QString& segmentId, bool occupied) {
+    const int index = m_segmentIndex.value(segmentId, -1);
+    if (index < 0) return false;
+    m_segmentOccupied[index] = occupied ? 1 : 0;
+    return true;
+}
+
+//
+//   EVALUATION
+//
+
+void StationAspectEvaluator::evaluate() {
+    if (!m_compiled) return;
+
+    const auto started = std::chrono::steady_clock::now();
+    m_previousPermitted.swap(m_permitted);
+
+    //   PASS 1: Rule activation - controller state against the rule's when-aspect
+    const size_t ruleCount = m_ruleController.size();
+    for (size_t r = 0; r < ruleCount; ++r) {
+        const quint32 state = m_signalState[m_ruleController[r]];
+        m_ruleLive[r] = static_cast<quint8>((state & m_ruleWhenMask[r]) == m_ruleWhenBits[r]);
+    }
+
+    //   PASS 2: Conditions - any unmet condition disables its rule
+    const size_t pointConditionCount = m_pointConditionRule.size();
+    for (size_t c = 0; c < pointConditionCount; ++c) {
+        const quint8 met = m_pointPosition[m_pointConditionPoint[c]] == m_pointConditionPosition[c];
+        m_ruleLive[m_pointConditionRule[c]] &= met;
+    }
+
+    const size_t segmentConditionCount = m_segmentConditionRule.size();
+    for (size_t c = 0; c < segmentConditionCount; ++c) {
+        const quint8 met = m_segmentOccupied[m_segmentConditionSegment[c]] == m_segmentConditionOccupied[c];
+        m_ruleLive[m_segmentConditionRule[c]] &= met;
+    }
+
+    //   PASS 3: Edges - live rules contribute their allowed aspects to (target, controller)
+    std::fill(m_pairMask.begin(), m_pairMask.end(), AspectMask(0));
+    const size_t edgeCount = m_edgeRule.size();
+    for (size_t e = 0; e < edgeCount; ++e) {
+        const AspectMask live = AspectMask(0) - AspectMask(m_ruleLive[m_edgeRule[e]]);
+        m_pairMask[m_edgePair[e]] |= m_edgeAllowed[e] & live;
+    }
+
+    //   PASS 4: Combine controllers per signal (AND: all must allow, OR: any may allow)
+    const size_t signalTotal = m_signalIds.size();
+    for (size_t s = 0; s < signalTotal; ++s) {
+        AspectMask andMask = ALL_ASPECTS;
+        AspectMask orMask = 0;
+        for (qint32 p = m_pairBegin[s]; p < m_pairEnd[s]; ++p) {
+            andMask &= m_pairMask[p];
+            orMask |= m_pairMask[p];
+        }
+
+        const quint8 mode = m_signalMode[s];
+        m_permitted[s] = mode == MODE_OR ? orMask : (mode == MODE_AND ? andMask : ALL_ASPECTS);
+    }
+
+    m_lastEvaluationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - started).count();
+}
+
+//
+//   RESULTS
+//
+
+StationAspectEvaluator::AspectMask StationAspectEvaluator::permittedMask(const QString& signalId) const {
+    const int index = m_signalIndex.value(signalId, -1);
+    return index < 0 ? 0 : m_permitted[index];
+}
+
+QStringList StationAspectEvaluator::permittedAspects(const QString& signalId) const {
+    return masksToAspects(permittedMask(signalId));
+}
+
+bool StationAspectEvaluator::isAspectPermitted(const QString& signalId, const QString& aspect) const {
+    const int index = m_signalIndex.value(signalId, -1);
+    if (index < 0) return false;
+    if (m_permitted[index] == ALL_ASPECTS) return true;
+
+    const int bit = m_aspectIndex.value(aspect, -1);
+    return bit >= 0 && (m_permitted[index] & (AspectMask(1) << bit)) != 0;
+}
+
+QStringList StationAspectEvaluator::changedSignals() const {
+    QStringList changed;
+    for (size_t s = 0; s < m_permitted.size(); ++s) {
+        if (m_permitted[s] != m_previousPermitted[s]) {
+            changed.append(m_signalIds[s]);
+        }
+    }
+    return changed;
+}
+
+QStringList StationAspectEvaluator::masksToAspects(AspectMask mask) const {
+    if (mask == ALL_ASPECTS) {
+        return QStringList{"*"}; // Independent / unrestricted
+    }
+
+    QStringList aspects;
+    for (int bit = 0; bit < m_aspectVocabulary.size(); ++bit) {
+        if (mask & (AspectMask(1) << bit)) {
+            aspects.append(m_aspectVocabulary[bit]);
+        }
+    }
+    return aspects;
+}
+
+QVariantMap StationAspectEvaluator::toVariantMap() const {
+    QVariantMap permitted;
+    for (size_t s = 0; s < m_signalIds.size(); ++s) {
+        permitted[m_signalIds[s]] = masksToAspects(m_permitted[s]);
+    }
+
+    QVariantMap map;
+    map["rulesVersion"] = m_compiledVersion;
+    map["signalCount"] = signalCount();
+    map["ruleCount"] = static_cast<int>(m_ruleController.size());
+    map["edgeCount"] = static_cast<int>(m_edgeRule.size());
+    map["lastEvaluationUs"] = m_lastEvaluationNs / 1000.0;
+    map["permittedAspects"] = permitted;
+    return map;
+}
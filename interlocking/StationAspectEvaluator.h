@@ -0,0 +1,106 @@
+#pragma once
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <cstdint>
+#include <vector>
+#include "InterlockingRuleEngine.h"
+#include "PackedAspect.h"
+
+//   STATION ASPECT EVALUATOR
+//
+//   Batch form of InterlockingRuleEngine::validateControllingSignals. A compiled rule set is
+//   flattened into index arrays (rules, point/segment conditions, allow-edges) and station
+//   state is held as structure-of-arrays: packed signal aspects, point positions, segment
+//   occupancy. evaluate() then recomputes the permitted-aspect bitmask of every signal in
+//   four straight-line passes with no string work, hashing or allocation.
+//
+//   Not thread-safe: owned and driven by a single thread (InterlockingService).
+class StationAspectEvaluator {
+public:
+    using AspectMask = quint64;
+    static constexpr int MAX_ASPECT_VOCABULARY = 64;
+    static constexpr AspectMask ALL_ASPECTS = ~AspectMask(0);
+
+    //   COMPILATION: Replaces tables and resets state to RED / unknown positions / occupied
+    bool compile(const InterlockingRuleEngine::RuleSet& ruleSet, QStringList& errors);
+    bool isCompiled() const { return m_compiled; }
+    quint64 compiledVersion() const { return m_compiledVersion; }
+
+    //   STATE INPUT: Returns false for entities no rule refers to
+    enum class AspectComponent : quint8 { Main = 0, CallingOn = 8, Loop = 16 };     //   Bit offset in PackedAspect
+    bool setSignalAspect(const QString& signalId, PackedAspect state);
+    //   One component from a change record's value; the other two keep their current state
+    bool setSignalAspectComponent(const QString& signalId, AspectComponent component, AspectCode code);
+    bool setPointPosition(const QString& machineId, const QString& position);
+    bool setTrackSegmentOccupied(const QString& segmentId, bool occupied);
+
+    //   FULL-STATION RECOMPUTE
+    void evaluate();
+
+    //   RESULTS (from the last evaluate())
+    AspectMask permittedMask(const QString& signalId) const;
+    QStringList permittedAspects(const QString& signalId) const;
+    bool isAspectPermitted(const QString& signalId, const QString& aspect) const;
+    QStringList changedSignals() const;
+
+    int signalCount() const { return static_cast<int>(m_signalIds.size()); }
+    qint64 lastEvaluationNs() const { return m_lastEvaluationNs; }
+    QVariantMap toVariantMap() const;
+
+private:
+    enum ControlMode : quint8 { MODE_ALL = 0, MODE_AND = 1, MODE_OR = 2 };
+
+    static constexpr quint8 POSITION_NORMAL = 0;
+    static constexpr quint8 POSITION_REVERSE = 1;
+    static constexpr quint8 POSITION_UNKNOWN = 0xFF;
+
+    QStringList masksToAspects(AspectMask mask) const;
+
+    bool m_compiled = false;
+    quint64 m_compiledVersion = 0;
+    qint64 m_lastEvaluationNs = 0;
+
+    //   Index maps (compile time only; evaluate() never touches them)
+    std::vector<QString> m_signalIds;
+    QHash<QString, int> m_signalIndex;
+    QHash<QString, int> m_pointIndex;
+    QHash<QString, int> m_segmentIndex;
+    QStringList m_aspectVocabulary;
+    QHash<QString, int> m_aspectIndex;
+
+    //   STATE (SoA)
+    std::vector<quint32> m_signalState;         //   PackedAspect bits per signal
+    std::vector<quint8> m_pointPosition;        //   POSITION_* per point machine
+    std::vector<quint8> m_segmentOccupied;      //   0/1 per track segment
+
+    //   RULES: one entry per controller rule
+    std::vector<qint32> m_ruleController;
+    std::vector<quint32> m_ruleWhenBits;
+    std::vector<quint32> m_ruleWhenMask;
+    std::vector<quint8> m_ruleLive;
+
+    //   CONDITIONS: flattened, each points back at its rule
+    std::vector<qint32> m_pointConditionRule;
+    std::vector<qint32> m_pointConditionPoint;
+    std::vector<quint8> m_pointConditionPosition;
+    std::vector<qint32> m_segmentConditionRule;
+    std::vector<qint32> m_segmentConditionSegment;
+    std::vector<quint8> m_segmentConditionOccupied;
+
+    //   ALLOW EDGES: rule -> (target, controller) pair, with the aspects it allows
+    std::vector<qint32> m_edgeRule;
+    std::vector<qint32> m_edgePair;
+    std::vector<AspectMask> m_edgeAllowed;
+    std::vector<AspectMask> m_pairMask;
+
+    //   PER-SIGNAL COMBINATION: pairs [begin, end) combined by control mode
+    std::vector<quint8> m_signalMode;
+    std::vector<qint32> m_pairBegin;
+    std::vector<qint32> m_pairEnd;
+
+    //   RESULTS
+    std::vector<AspectMask> m_permitted;
+    std::vector<AspectMask> m_previousPermitted;
+};
@@ -0,0 +1,200 @@
+#include "StationShard.h"
+#include "StationData.h"
+#include <QDebug>
+
+StationShard::StationShard(const QString& stationId, const QString& rulesPath, const CircuitSegments& circuitSegments,
+                           QObject* parent)
+    : QObject(parent)
+    , m_stationId(stationId)
+    , m_rulesPath(rulesPath)
+    , m_circuitSegments(circuitSegments)
+{
+}
+
+StationShard::CircuitSegments StationShard::builtInCircuitSegments() {
+    //   Occupancy arrives per circuit, rule conditions are per segment: circuit -> segments
+    //   mapping is fixed by the station layout (as in TrackCircuitFilter)
+    using namespace RailFlux::Station;
+    CircuitSegments circuitSegments;
+    for (const TrackSegmentDef& segment : Generated::TRACK_SEGMENTS) {
+        if (!segment.circuitId.empty()) {
+            circuitSegments[toQString(segment.circuitId)].append(toQString(segment.id));
+        }
+    }
+    return circuitSegments;
+}
+
+bool StationShard::start() {
+    QStringList errors;
+    m_rules = m_rulesPath.isEmpty() ? InterlockingRuleEngine::builtInRuleSet()
+                                    : InterlockingRuleEngine::compileRulesFile(m_rulesPath, errors);
+
+    if (m_rules && !m_rules->stationId.isEmpty() && m_rules->stationId != m_stationId) {
+        errors.append(QString("Rules file is for station %1, not %2").arg(m_rules->stationId, m_stationId));
+    }
+
+    const bool success = m_rules && errors.isEmpty() && m_evaluator.compile(*m_rules, errors);
+    if (success) {
+        reevaluate();
+        qDebug() << " [StationShard" << m_stationId << "] Started with" << m_evaluator.signalCount() << "signals";
+    } else {
+        qCritical() << " [StationShard" << m_stationId << "] Failed to start:" << errors;
+    }
+
+    emit started(m_stationId, success, errors);
+    return success;
+}
+
+void StationShard::addBoundaryLink(const BoundaryLink& link) {
+    m_boundaries.insert(link.localCircuitId, link);
+}
+
+void StationShard::setRouteTable(const QHash<QString, QStringList>& routes) {
+    m_routes = routes;
+}
+
+//
+//   STATE INPUT
+//
+
+void StationShard::applyOccupancy(const QString& circuitId, bool isOccupied) {
+    m_eventsProcessed.fetch_add(1, std::memory_order_relaxed);
+
+    const bool wasOccupied = m_localOccupied.value(circuitId, false);
+    m_localOccupied.insert(circuitId, isOccupied);
+
+    QSet<QString> heldChanged;
+    refreshOccupancy(circuitId, heldChanged);
+
+    //   Tell the neighbour about our end of the shared block section
+    auto boundary = m_boundaries.constFind(circuitId);
+    if (boundary != m_boundaries.constEnd() && wasOccupied != isOccupied) {
+        emit boundaryOccupancyChanged(m_stationId, boundary->remoteStationId, boundary->remoteCircuitId, isOccupied);
+    }
+
+    reevaluate(heldChanged);
+}
+
+void StationShard::applyRemoteBlockOccupancy(const QString& localCircuitId, bool isOccupied) {
+    m_eventsProcessed.fetch_add(1, std::memory_order_relaxed);
+
+    if (!m_boundaries.contains(localCircuitId)) {
+        qWarning() << " [StationShard" << m_stationId << "] Block message for non-boundary circuit" << localCircuitId;
+        return;
+    }
+
+    if (isOccupied) {
+        m_remoteOccupied.insert(localCircuitId);
+    } else {
+        m_remoteOccupied.remove(localCircuitId);
+    }
+
+    QSet<QString> heldChanged;
+    refreshOccupancy(localCircuitId, heldChanged);
+    reevaluate(heldChanged);
+}
+
+void StationShard::applySignalAspect(const QString& signalId, PackedAspect state) {
+    m_eventsProcessed.fetch_add(1, std::memory_order_relaxed);
+    if (m_evaluator.setSignalAspect(signalId, state)) {
+        reevaluate();
+    }
+}
+
+void StationShard::applyPointPosition(const QString& machineId, const QString& position) {
+    m_eventsProcessed.fetch_add(1, std::memory_order_relaxed);
+    if (m_evaluator.setPointPosition(machineId, position)) {
+        reevaluate();
+    }
+}
+
+bool StationShard::isEffectivelyOccupied(const QString& circuitId) const {
+    return m_localOccupied.value(circuitId, false) || m_remoteOccupied.contains(circuitId);
+}
+
+void StationShard::refreshOccupancy(const QString& circuitId, QSet<QString>& heldChanged) {
+    const bool occupied = isEffectivelyOccupied(circuitId);
+
+    //   Every segment of the circuit reads the circuit's occupancy
+    const auto segments = m_circuitSegments.constFind(circuitId);
+    if (segments == m_circuitSegments.constEnd()) {
+        m_evaluator.setTrackSegmentOccupied(circuitId, occupied);
+    } else {
+        for (const QString& segmentId : *segments) {
+            m_evaluator.setTrackSegmentOccupied(segmentId, occupied);
+        }
+    }
+
+    auto boundary = m_boundaries.constFind(circuitId);
+    if (boundary == m_boundaries.constEnd() || boundary->exitSignalId.isEmpty()) {
+        return;
+    }
+
+    //   No line clear into an occupied block section
+    const bool wasHeld = m_heldSignals.contains(boundary->exitSignalId);
+    if (occupied && !wasHeld) {
+        m_heldSignals.insert(boundary->exitSignalId);
+        heldChanged.insert(boundary->exitSignalId);
+    } else if (!occupied && wasHeld) {
+        m_heldSignals.remove(boundary->exitSignalId);
+        heldChanged.insert(boundary->exitSignalId);
+    }
+}
+
+//
+//   EVALUATION
+//
+
+void StationShard::reevaluate(const QSet<QString>& heldChanged) {
+    if (!m_evaluator.isCompiled()) return;
+
+    m_evaluator.evaluate();
+    m_lastEvaluationNs.store(m_evaluator.lastEvaluationNs(), std::memory_order_relaxed);
+
+    QSet<QString> changed = heldChanged;
+    for (const QString& signalId : m_evaluator.changedSignals()) {
+        changed.insert(signalId);
+    }
+    if (changed.isEmpty()) return;
+
+    QVariantMap permitted;
+    for (const QString& signalId : changed) {
+        permitted[signalId] = publishedAspects(signalId);
+    }
+    emit permittedAspectsChanged(m_stationId, permitted);
+}
+
+QStringList StationShard::publishedAspects(const QString& signalId) const {
+    if (m_heldSignals.contains(signalId)) {
+        return QStringList{"RED"};
+    }
+    return m_evaluator.permittedAspects(signalId);
+}
+
+//
+//   ROUTES
+//
+
+void StationShard::checkRoute(const QString& sourceSignalId, const QString& destSignalId) {
+    m_eventsProcessed.fetch_add(1, std::memory_order_relaxed);
+
+    auto route = m_routes.constFind(routeKey(sourceSignalId, destSignalId));
+    if (route == m_routes.constEnd()) {
+        emit routeChecked(m_stationId, sourceSignalId, destSignalId, false, "NO_SUCH_ROUTE");
+        return;
+    }
+
+    for (const QString& circuitId : route.value()) {
+        if (isEffectivelyOccupied(circuitId)) {
+            emit routeChecked(m_stationId, sourceSignalId, destSignalId, false, "OCCUPIED:" + circuitId);
+            return;
+        }
+    }
+
+    if (m_heldSignals.contains(sourceSignalId)) {
+        emit routeChecked(m_stationId, sourceSignalId, destSignalId, false, "BLOCK_OCCUPIED");
+        return;
+    }
+
+    emit routeChecked(m_stationId, sourceSignalId, destSignalId, true, QString());
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <atomic>
+#include "InterlockingRuleEngine.h"
+#include "StationAspectEvaluator.h"
+
+//   STATION SHARD
+//
+//   One station's interlocking state, rules and route table. A shard is pinned to a
+//   worker thread by CorridorInterlockingHost and is only ever touched from that thread:
+//   the host posts work to it and listens to its signals, so shards share nothing.
+//
+//   BLOCK INTERFACES: A boundary circuit is the local end of a block section shared with
+//   an adjacent station. Its effective occupancy is local OR remote, and while it is
+//   occupied the exit signal into it is held at RED. Local changes on a boundary are
+//   reported through boundaryOccupancyChanged() for the host to forward.
+class StationShard : public QObject {
+    Q_OBJECT
+
+public:
+    struct BoundaryLink {
+        QString localCircuitId;
+        QString exitSignalId;
+        QString remoteStationId;
+        QString remoteCircuitId;
+    };
+
+    //   CIRCUIT LAYOUT: circuit ID -> the station's track segment IDs on that circuit
+    using CircuitSegments = QHash<QString, QStringList>;
+
+    //   Empty rulesPath: use the rule set generated at build time. circuitSegments is this
+    //   station's own layout; a circuit missing from it stands for a segment of the same ID.
+    StationShard(const QString& stationId, const QString& rulesPath, const CircuitSegments& circuitSegments,
+                 QObject* parent = nullptr);
+
+    //   Layout of the station generated at build time
+    static CircuitSegments builtInCircuitSegments();
+
+    QString stationId() const { return m_stationId; }
+
+    //   THREAD-SAFE COUNTERS
+    quint64 eventsProcessed() const { return m_eventsProcessed.load(std::memory_order_relaxed); }
+    qint64 lastEvaluationNs() const { return m_lastEvaluationNs.load(std::memory_order_relaxed); }
+
+    //   SHARD THREAD ONLY
+    bool start();
+    void addBoundaryLink(const BoundaryLink& link);
+    void setRouteTable(const QHash<QString, QStringList>& routes);
+
+    void applyOccupancy(const QString& circuitId, bool isOccupied);
+    void applyRemoteBlockOccupancy(const QString& localCircuitId, bool isOccupied);
+    void applySignalAspect(const QString& signalId, PackedAspect state);
+    void applyPointPosition(const QString& machineId, const QString& position);
+    void checkRoute(const QString& sourceSignalId, const QString& destSignalId);
+
+    static QString routeKey(const QString& sourceSignalId, const QString& destSignalId) {
+        return sourceSignalId + "->" + destSignalId;
+    }
+
+signals:
+    void started(const QString& stationId, bool success, const QStringList& errors);
+    void permittedAspectsChanged(const QString& stationId, const QVariantMap& permittedAspects);
+    void boundaryOccupancyChanged(const QString& stationId, const QString& remoteStationId,
+                                  const QString& remoteCircuitId, bool isOccupied);
+    void routeChecked(const QString& stationId, const QString& sourceSignalId, const QString& destSignalId,
+                      bool available, const QString& reason);
+
+private:
+    bool isEffectivelyOccupied(const QString& circuitId) const;
+    void refreshOccupancy(const QString& circuitId, QSet<QString>& heldChanged);
+    void reevaluate(const QSet<QString>& heldChanged = QSet<QString>());
+    QStringList publishedAspects(const QString& signalId) const;
+
+    QString m_stationId;
+    QString m_rulesPath;
+    InterlockingRuleEngine::RuleSetPtr m_rules;
+    StationAspectEvaluator m_evaluator;
+
+    QHash<QString, QStringList> m_routes;           //   routeKey() -> circuit path
+    QHash<QString, BoundaryLink> m_boundaries;      //   Local boundary circuit -> link
+    CircuitSegments m_circuitSegments;              //   Circuit -> segments named by rule conditions
+    QHash<QString, bool> m_localOccupied;
+    QSet<QString> m_remoteOccupied;
+    QSet<QString> m_heldSignals;
+
+    std::atomic<quint64> m_eventsProcessed{0};
+    std::atomic<qint64> m_lastEvaluationNs{0};
+};
@@ -18,14 +18,14 @@ TrackCircuitBranch::TrackCircuitBranch(DatabaseManager* dbManager, QObject* pare
 //   MAIN REACTIVE ENFORCEMENT METHOD
 // 
 
-void TrackCircuitBranch::enforceTrackSegmentOccupancyInterlocking(
+bool TrackCircuitBranch::enforceTrackSegmentOccupancyInterlocking(
     const QString& trackSegmentId, bool wasOccupied, bool isOccupied) {
 
     //   SAFETY: Only react to critical transition (trackSegment becoming occupied)
     if (wasOccupied || !isOccupied) {
         qDebug() << "No interlocking action needed for track segment" << trackSegmentId
                  << "- transition:" << wasOccupied << "→" << isOccupied;
-        return;
+        return false;
     }
 
     qDebug() << " AUTOMATIC INTERLOCKING TRIGGERED: Track segment" << trackSegmentId
@@ -36,13 +36,13 @@ void TrackCircuitBranch::enforceTrackSegmentOccupancyInterlocking(
     if (!existsResult.isAllowed()) {
         qCritical() << " CRITICAL: Track segment" << trackSegmentId << "not found during interlocking enforcement!";
         handleInterlockingFailure(trackSegmentId, "N/A", "Track segment not found: " + existsResult.getReason());
-        return;
+        return false;
     }
 
     auto activeResult = checkTrackSegmentActive(trackSegmentId);
     if (!activeResult.isAllowed()) {
         qWarning() << " Track segment" << trackSegmentId << "is not active - skipping interlocking enforcement";
-        return;
+        return false;
     }
 
     //   SAFETY: Get protecting signals from multiple sources for redundancy
@@ -51,7 +51,7 @@ void TrackCircuitBranch::enforceTrackSegmentOccupancyInterlocking(
     if (protectingSignals.isEmpty()) {
         qWarning() << " SAFETY WARNING: No protecting signals found for occupied track segment" << trackSegmentId;
         qWarning() << " This could indicate a configuration error or unprotected track segment";
-        return;
+        return false;
     }
 
     qDebug() << "ENFORCING PROTECTION: Setting" << protectingSignals.size()
@@ -69,6 +69,8 @@ void TrackCircuitBranch::enforceTrackSegmentOccupancyInterlocking(
         qCritical() << " AUTOMATIC INTERLOCKING FAILED for track segment" << trackSegmentId;
         // handleInterlockingFailure is called within enforceMultipleSignalsToRed
     }
+
+    return allSucceeded;
 }
 
 // 
@@ -91,6 +93,58 @@ ValidationResult TrackCircuitBranch::checkTrackSegmentActive(const QString& trac
     return ValidationResult::allowed("Track segment is active");
 }
 
+QHash<QString, QStringList> TrackCircuitBranch::buildProtectionTable() {
+    QHash<QString, QStringList> table;
+    if (!m_dbManager) return table;
+
+    //   SAFETY: Same three-source resolution (and consistency check) as the synchronous path
+    const QVariantList trackSegments = m_dbManager->getTrackSegmentsList();
+    for (const QVariant& segmentVar : trackSegments) {
+        const QVariantMap segment = segmentVar.toMap();
+        const QString trackSegmentId = segment["id"].toString();
+        if (trackSegmentId.isEmpty() || !segment["isActive"].toBool()) {
+            continue;
+        }
+
+        QStringList protectingSignals = getProtectingSignalsFromThreeSources(trackSegmentId);
+        if (!protectingSignals.isEmpty()) {
+            table.insert(trackSegmentId, protectingSignals);
+        }
+    }
+
+    qDebug() << "  Protection table built for" << table.size() << "of" << trackSegments.size() << "track segments";
+    return table;
+}
+
+bool TrackCircuitBranch::verifyProtectionConsistency(const QString& trackSegmentId, const QStringList& tableSignals) {
+    //   Inactive segments are skipped by the synchronous path and left out of the table
+    if (!checkTrackSegmentActive(trackSegmentId).isAllowed()) {
+        return true;
+    }
+
+    //   SAFETY: Same three-source check the synchronous path runs on every occupancy (freezes on mismatch)
+    QStringList currentSignals = getProtectingSignalsFromThreeSources(trackSegmentId);
+    QStringList enforcedSignals = tableSignals;
+    currentSignals.sort();
+    enforcedSignals.sort();
+
+    if (currentSignals == enforcedSignals) {
+        return true;
+    }
+
+    //   STALE TABLE: Configuration changed after the pipeline started - it enforced the wrong set
+    QString reason = QString("CRITICAL DATA INCONSISTENCY: Pipeline protection table stale for track segment %1").arg(trackSegmentId);
+    QString details = QString("Pipeline enforced: %1 | Current sources: %2")
+                          .arg(enforcedSignals.join(","), currentSignals.join(","));
+
+    qCritical() << " CRITICAL SYSTEM FAULT: Protection table mismatch for track segment" << trackSegmentId;
+    qCritical() << "   " << details;
+
+    logCriticalFailure(trackSegmentId, details);
+    emitSystemFreeze(trackSegmentId, reason, details);
+    return false;
+}
+
 // 
 //   TRACK SEGMENT SEGMENT STATE AND PROTECTION METHODS
 // 
@@ -305,11 +359,8 @@ QStringList TrackCircuitBranch::getProtectingSignalsFromTrackSegments(const QStr
 bool TrackCircuitBranch::enforceSignalToRed(const QString& signalId, const QString& reason) {
     qDebug() << "ENFORCING RED: Signal" << signalId << "Reason:" << reason;
 
-    //   SAFETY: Check if signal is already RED to avoid unnecessary operations
-    if (verifySignalIsRed(signalId)) {
-        qDebug() << "  Signal" << signalId << "already RED - no action needed";
-        return true;
-    }
+    //   SAFETY: Written even when already RED, so the signal's row version moves on and
+    //   commands validated before this occupancy fail their compare-and-set
 
     //   FORCE: Use database manager to set signal to RED (bypasses normal validation)
     bool success = m_dbManager->updateSignalAspect(signalId, "MAIN", "RED");
@@ -318,7 +369,7 @@ bool TrackCircuitBranch::enforceSignalToRed(const QString& signalId, const QStri
         qDebug() << "  ENFORCED: Signal" << signalId << "set to RED";
 
         //   VERIFY: Double-check that signal is actually RED
-        QThread::msleep(50); // Brief delay to ensure database update is committed
+        m_dbManager->clock()->sleep(50); // Brief delay to ensure database update is committed
         if (!verifySignalIsRed(signalId)) {
             qCritical() << " VERIFICATION FAILED: Signal" << signalId << "not confirmed RED after enforcement!";
             return false;
@@ -6,6 +6,7 @@
 #include <QStringList>
 #include <QSqlQuery>
 #include <QDateTime>
+#include <QHash>
 #include "InterlockingService.h"  //   Use existing ValidationResult
 
 class DatabaseManager;
@@ -17,13 +18,21 @@ class TrackCircuitBranch : public QObject
 public:
     explicit TrackCircuitBranch(DatabaseManager* dbManager, QObject* parent = nullptr);
 
-    //   MAIN FUNCTION: Reactive enforcement when trackSegment becomes occupied
-    void enforceTrackSegmentOccupancyInterlocking(const QString& trackSegmentId, bool wasOccupied, bool isOccupied);
+    //   MAIN FUNCTION: Reactive enforcement when trackSegment becomes occupied.
+    //   Returns true only when protecting signals were confirmed at RED.
+    bool enforceTrackSegmentOccupancyInterlocking(const QString& trackSegmentId, bool wasOccupied, bool isOccupied);
 
     //   UTILITY: Basic trackSegment section checks (for safety verification)
     ValidationResult checkTrackSegmentExists(const QString& trackSegmentId);
     ValidationResult checkTrackSegmentActive(const QString& trackSegmentId);
 
+    //   PIPELINE SUPPORT: Resolve protecting signals for every segment once, up front
+    QHash<QString, QStringList> buildProtectionTable();
+
+    //   PIPELINE SUPPORT: Per-occupancy three-source consistency check against the signals the
+    //   pipeline enforced from its table. Emits systemFreezeRequired on any mismatch.
+    bool verifyProtectionConsistency(const QString& trackSegmentId, const QStringList& tableSignals);
+
 signals:
     void systemFreezeRequired(const QString& trackSegmentId, const QString& reason, const QString& details);
     void automaticInterlockingCompleted(const QString& trackSegmentId, const QStringList& affectedSignals);
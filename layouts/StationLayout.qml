@@ -25,12 +25,17 @@ Rectangle {
     property var advanceStarterSignalsModel: []
     property var pointMachinesModel: []
     property var textLabelsModel: []
+    property var allSignalsModel: []
+
+    //  Change sequence of the last snapshot applied; incremental syncs ask for rows after it
+    property double stationSnapshotSeq: 0
 
     // App timing properties
     property var appStartTime: new Date()
     property string appUptime: "00:00:00"
 
     //  NEW: Data refresh functions (replaces signalRefreshTrigger)
+    //  Full load and resync: one snapshot query for every entity type
     function refreshAllData() {
         if (!dbManager || !dbManager.isConnected) {
             console.log("Database not connected - cannot refresh data")
@@ -38,10 +43,57 @@ Rectangle {
         }
 
         console.log("Refreshing all station data from database")
-        refreshTrackSegmentData()
-        refreshSignalData()
-        refreshPointMachineData()
-        refreshTextLabelData()
+        var snapshot = dbManager.getStationSnapshot(0)
+        if (snapshot.seq === undefined) return
+
+        trackSegmentsModel = snapshot.trackSegments
+        applySignalModels(snapshot.signals)
+        pointMachinesModel = snapshot.pointMachines
+        textLabelsModel = snapshot.textLabels
+        stationSnapshotSeq = snapshot.seq
+    }
+
+    //  Incremental: only rows changed since the last snapshot, merged in by id
+    function syncStationData() {
+        if (!dbManager || !dbManager.isConnected) return
+        if (stationSnapshotSeq <= 0) {
+            refreshAllData()
+            return
+        }
+
+        var snapshot = dbManager.getStationSnapshot(stationSnapshotSeq)
+        if (snapshot.seq === undefined) return
+        if (snapshot.seq < stationSnapshotSeq) {
+            //  Sequence went backwards: database was re-initialised
+            refreshAllData()
+            return
+        }
+
+        if (snapshot.trackSegments.length > 0)
+            trackSegmentsModel = mergeById(trackSegmentsModel, snapshot.trackSegments)
+        if (snapshot.signals.length > 0)
+            applySignalModels(mergeById(allSignalsModel, snapshot.signals))
+        if (snapshot.pointMachines.length > 0)
+            pointMachinesModel = mergeById(pointMachinesModel, snapshot.pointMachines)
+        stationSnapshotSeq = snapshot.seq
+    }
+
+    function mergeById(rows, changedRows) {
+        var merged = rows.slice()
+        var index = {}
+        for (var i = 0; i < merged.length; i++) {
+            index[merged[i].id] = i
+        }
+        for (var j = 0; j < changedRows.length; j++) {
+            var row = changedRows[j]
+            if (index[row.id] !== undefined) {
+                merged[index[row.id]] = row
+            } else {
+                index[row.id] = merged.length
+                merged.push(row)
+            }
+        }
+        return merged
     }
 
     function getTrackSegmentDataById(trackSegmentId) {
@@ -63,38 +115,14 @@ Rectangle {
         return "NORMAL"; // Safe default
     }
 
-    function refreshTrackSegmentData() {
-        if (!dbManager || !dbManager.isConnected) return
-
-        console.log("Refreshing trackSegment segments from database")
-        trackSegmentsModel = dbManager.getTrackSegmentsList()
-        console.log("Loaded", trackSegmentsModel.length, "trackSegment segments")
-    }
-
-    function refreshSignalData() {
-        if (!dbManager || !dbManager.isConnected) return
-
-        console.log("Refreshing signals from database")
-        var allSignals = dbManager.getAllSignalsList()
+    function applySignalModels(allSignals) {
+        allSignalsModel = allSignals
 
         // Filter signals by type
         outerSignalsModel = allSignals.filter(signal => signal.type === "OUTER")
         homeSignalsModel = allSignals.filter(signal => signal.type === "HOME")
         starterSignalsModel = allSignals.filter(signal => signal.type === "STARTER")
         advanceStarterSignalsModel = allSignals.filter(signal => signal.type === "ADVANCED_STARTER")
-
-        console.log("Loaded signals - Outer:", outerSignalsModel.length,
-                   "Home:", homeSignalsModel.length,
-                   "Starter:", starterSignalsModel.length,
-                   "Advanced:", advanceStarterSignalsModel.length)
-    }
-
-    function refreshPointMachineData() {
-        if (!dbManager || !dbManager.isConnected) return
-
-        console.log("Refreshing point machines from database")
-        pointMachinesModel = dbManager.getAllPointMachinesList()
-        console.log("Loaded", pointMachinesModel.length, "point machines")
     }
 
     function refreshTextLabelData() {
@@ -350,8 +378,10 @@ Rectangle {
                 homeSignalsModel = []
                 starterSignalsModel = []
                 advanceStarterSignalsModel = []
+                allSignalsModel = []
                 pointMachinesModel = []
                 textLabelsModel = []
+                stationSnapshotSeq = 0
                 hasInitialDataLoaded = false  //  Reset for next connection
             }
         }
@@ -366,23 +396,7 @@ Rectangle {
         //  Handle database polling updates
         function onDataUpdated() {
             console.log("StationLayout: Database data updated (polling)")
-            refreshAllData()
-        }
-
-        //  Handle real-time notifications (if available)
-        function onTrackSegmentUpdated(segmentId) {
-            console.log("StationLayout: Track segment updated:", segmentId)
-            refreshTrackSegmentData()
-        }
-
-        function onSignalUpdated(signalId) {
-            console.log("StationLayout: Signal updated:", signalId)
-            refreshSignalData()
-        }
-
-        function onPointMachineUpdated(machineId) {
-            console.log("StationLayout: Point machine updated:", machineId)
-            refreshPointMachineData()
+            syncStationData()
         }
 
         function onPairedMachinesUpdated(machineIds) {
@@ -401,19 +415,17 @@ Rectangle {
             }
 
         //  Handle batch updates
+        //  Several of these can fire for one batch; the first sync picks up every change
         function onTrackSegmentsChanged() {
-            console.log("StationLayout: Track Segment segments changed")
-            refreshTrackSegmentData()
+            syncStationData()
         }
 
         function onSignalsChanged() {
-            console.log("StationLayout: Signals changed")
-            refreshSignalData()
+            syncStationData()
         }
 
         function onPointMachinesChanged() {
-            console.log("StationLayout: Point machines changed")
-            refreshPointMachineData()
+            syncStationData()
         }
 
         function onTextLabelsChanged() {
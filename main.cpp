@@ -1,11 +1,18 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include <QPointer>
 #include <QIcon>
 #include "database/DatabaseManager.h"
+#include "database/StationEventBus.h"
 #include "database/DatabaseInitializer.h"
 #include "interlocking/InterlockingService.h"
+#include "interlocking/CorridorInterlockingHost.h"
 #include "route/RouteAssignmentService.h"
+#include "route/AutoRouteSetter.h"
+#include "describer/TrainDescriber.h"
+#include "simulation/TrainSimulator.h"
+#include "StationData.h"
 
 int main(int argc, char *argv[])
 {
@@ -33,11 +40,38 @@ int main(int argc, char *argv[])
 
     using namespace RailFlux::Route;
     RouteAssignmentService* routeAssignmentService = new RouteAssignmentService(&app);
+    TrainDescriber* trainDescriber = new TrainDescriber(&app);
+
+    // Station time source: wall clock, RAILFLUX_CLOCK=scaled:<rate> for accelerated runs, or
+    // RAILFLUX_CLOCK=virtual for deterministic runs driven by the simulator
+    Clock* stationClock = Clock::fromEnvironment(&app);
+    dbManager->setClock(stationClock);
+    trainDescriber->setClock(stationClock);
+
+    // Automatic route setting from the timetable and the describer's train positions
+    AutoRouteSetter* autoRouteSetter = new AutoRouteSetter(routeAssignmentService, trainDescriber, &app);
+    autoRouteSetter->setClock(stationClock);
+
+    // Lab traffic: simulated trains feed occupancy through the normal input path
+    TrainSimulator* trainSimulator = new TrainSimulator(dbManager, &app);
+    trainSimulator->setClock(stationClock);
+
+    // Corridor of station shards; defaults to this station alone. The local station's shard is
+    // the only one this process feeds, so a corridor without it is a configuration error.
+    const QString localStationId = RailFlux::Station::toQString(RailFlux::Station::Generated::STATION_ID);
+    const QString corridorFile = qEnvironmentVariable("RAILFLUX_CORRIDOR_FILE");
+    CorridorInterlockingHost* corridorHost = new CorridorInterlockingHost(&app);
+    if (!corridorHost->loadCorridor(corridorFile) || !corridorHost->stationIds().contains(localStationId)) {
+        qCritical() << "FATAL: Corridor" << corridorFile << "could not be loaded or does not host local station"
+                    << localStationId;
+        return -1;
+    }
 
-    // Minimal service composition - only DatabaseManager needed
+    // Minimal service composition - database plus interlocking for what-if scans
     qDebug() << "Setting up RouteAssignmentService with minimal dependencies...";
     routeAssignmentService->setServices(
-        dbManager
+        dbManager,
+        interlockingService
         );
 
     // Set only essential context properties for QML access
@@ -45,18 +79,102 @@ int main(int argc, char *argv[])
     engine.rootContext()->setContextProperty("globalDatabaseInitializer", dbInitializer);
     engine.rootContext()->setContextProperty("globalInterlockingService", interlockingService);
     engine.rootContext()->setContextProperty("globalRouteAssignmentService", routeAssignmentService);
+    engine.rootContext()->setContextProperty("globalTrainDescriber", trainDescriber);
+    engine.rootContext()->setContextProperty("globalTrainSimulator", trainSimulator);
+    engine.rootContext()->setContextProperty("globalCorridorHost", corridorHost);
+    engine.rootContext()->setContextProperty("globalAutoRouteSetter", autoRouteSetter);
 
     dbManager->setInterlockingService(interlockingService);
 
+    // Train describer follows committed occupancy and assigned routes
+    QObject::connect(routeAssignmentService, &RouteAssignmentService::routeAssigned,
+                     trainDescriber, &TrainDescriber::onRouteAssigned);
+
+    // Describer and corridor read station changes off the event bus; the local station's
+    // shard is fed from this database, other shards from their own interfaces
+    dbManager->eventBus()->subscribe("describer-corridor",
+        [dbManager, trainDescriber = QPointer<TrainDescriber>(trainDescriber),
+         corridorHost = QPointer<CorridorInterlockingHost>(corridorHost), localStationId](StationEventBus::Batch batch) {
+            StationEventBus* bus = dbManager->eventBus();
+            for (const StationEventBus::ChangeRecord& record : batch) {
+                const QString& entityId = bus->entityId(record.entity);
+                switch (record.kind) {
+                case StationEventBus::EntityKind::TrackCircuit: {
+                    if (record.field != StationEventBus::Field::Occupancy || record.newValue == StationEventBus::UNKNOWN_VALUE) break;
+                    const bool isOccupied = record.newValue != 0;
+                    if (trainDescriber) trainDescriber->onTrackCircuitOccupancyChanged(entityId, isOccupied);
+                    if (corridorHost) corridorHost->submitOccupancy(localStationId, entityId, isOccupied);
+                    break;
+                }
+                case StationEventBus::EntityKind::Signal: {
+                    if (!corridorHost) break;
+                    const QVariantMap signal = dbManager->getSignalById(entityId);
+                    corridorHost->submitSignalAspect(localStationId, entityId,
+                                                     signal.value("currentAspect").toString(),
+                                                     signal.value("callingOnAspect").toString(),
+                                                     signal.value("loopAspect").toString());
+                    break;
+                }
+                case StationEventBus::EntityKind::PointMachine: {
+                    if (!corridorHost) break;
+                    QString position = StationEventBus::positionName(record.newValue);
+                    if (position.isEmpty()) {
+                        position = dbManager->getPointMachineById(entityId).value("position").toString();
+                    }
+                    corridorHost->submitPointPosition(localStationId, entityId, position);
+                    break;
+                }
+                case StationEventBus::EntityKind::TrackSegment:
+                    break;
+                }
+            }
+        });
+
+    // Optional on-disk interlocking rules, hot-reloaded on change
+    const QString rulesFile = qEnvironmentVariable("RAILFLUX_RULES_FILE");
+    if (!rulesFile.isEmpty()) {
+        interlockingService->watchInterlockingRulesFile(rulesFile);
+    }
+
     // Minimal database connection callback
     QObject::connect(dbManager, &DatabaseManager::connectionStateChanged,
-                     [dbManager, interlockingService, routeAssignmentService](bool connected) {
+                     [dbManager, interlockingService, routeAssignmentService, trainDescriber, trainSimulator,
+                      autoRouteSetter, trafficAdded = false](bool connected) mutable {
                          if (connected) {
                              qDebug() << "Database connected, initializing services...";
 
                              // Initialize core services only
                              interlockingService->initialize();
                              routeAssignmentService->initialize();
+                             trainDescriber->setInitialOccupancy(dbManager->getAllTrackCircuitStates());
+
+                             // RAILFLUX_TIMETABLE_FILE=<json> runs ARS from startup without operator input
+                             const QString timetableFile = qEnvironmentVariable("RAILFLUX_TIMETABLE_FILE");
+                             if (!timetableFile.isEmpty() && !autoRouteSetter->isEnabled()
+                                 && autoRouteSetter->loadTimetableFile(timetableFile) > 0) {
+                                 autoRouteSetter->setEnabled(true);
+                             }
+
+                             // RAILFLUX_SIM_TRAINS=<count> starts simulated traffic (RAILFLUX_SIM_HEADWAY_MS apart),
+                             // injected on the first connection only; a reconnect resumes the same traffic
+                             const int simulatedTrains = qEnvironmentVariableIntValue("RAILFLUX_SIM_TRAINS");
+                             if (simulatedTrains > 0 && trainSimulator->start() && !trafficAdded) {
+                                 bool headwayOk = false;
+                                 const int headwayMs = qEnvironmentVariableIntValue("RAILFLUX_SIM_HEADWAY_MS", &headwayOk);
+                                 trainSimulator->addTraffic(simulatedTrains, headwayOk ? headwayMs : 60000);
+                                 trafficAdded = true;
+
+                                 // RAILFLUX_SIM_RUN_MS=<ms> drives a virtual clock through that much
+                                 // scenario time once this callback has returned
+                                 const qint64 runMs = qEnvironmentVariableIntValue("RAILFLUX_SIM_RUN_MS");
+                                 if (runMs > 0) {
+                                     QMetaObject::invokeMethod(trainSimulator, [trainSimulator, runMs]() {
+                                         if (!trainSimulator->runFor(runMs)) {
+                                             qWarning() << "RAILFLUX_SIM_RUN_MS needs RAILFLUX_CLOCK=virtual";
+                                         }
+                                     }, Qt::QueuedConnection);
+                                 }
+                             }
 
                              // Basic health check
                              if (!routeAssignmentService->isOperational()) {
@@ -96,8 +214,12 @@ int main(int argc, char *argv[])
                      });
 
     // Cleanup on application exit
-    QObject::connect(&app, &QCoreApplication::aboutToQuit, [dbManager]() {
+    // Clock users stop first: app children are destroyed in creation order, so the clock and
+    // database would be gone before ARS's and the simulator's own destructors ran
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, [dbManager, autoRouteSetter, trainSimulator]() {
         qDebug() << "Application shutting down, cleaning up database...";
+        autoRouteSetter->setEnabled(false);
+        trainSimulator->stop();
         dbManager->cleanup();
         dbManager->stopPolling();
     });
@@ -0,0 +1,450 @@
+#include "AutoRouteSetter.h"
+#include "RouteAssignmentService.h"
+#include "../describer/TrainDescriber.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <algorithm>
+#include <utility>
+
+namespace RailFlux::Route {
+
+AutoRouteSetter::AutoRouteSetter(RouteAssignmentService* routeService, TrainDescriber* describer, QObject* parent)
+    : QObject(parent)
+    , m_routeService(routeService)
+    , m_describer(describer)
+{
+    if (m_describer) {
+        // Every train move, entry, exit, interpose or rename changes the model
+        connect(m_describer, &QAbstractItemModel::dataChanged, this, &AutoRouteSetter::onDescriberChanged);
+        connect(m_describer, &QAbstractItemModel::rowsInserted, this, &AutoRouteSetter::onDescriberChanged);
+        connect(m_describer, &QAbstractItemModel::rowsRemoved, this, &AutoRouteSetter::onDescriberChanged);
+    }
+}
+
+AutoRouteSetter::~AutoRouteSetter() {
+    //   Normally disabled on aboutToQuit; a clock destroyed first has no timers left to cancel
+    if (m_clock) {
+        cancelTimers();
+    }
+}
+
+void AutoRouteSetter::setClock(Clock* clock) {
+    if (!clock || clock == m_clock) return;
+    cancelTimers();
+    m_clock = clock;
+    if (m_enabled) {
+        //   Retry times were on the old clock
+        m_trainsMoved = true;
+        scheduleEvaluation();
+    }
+}
+
+//
+//   TIMETABLE
+//
+
+int AutoRouteSetter::loadTimetable(const QVariantList& services) {
+    if (!m_routeService) {
+        qWarning() << " [ARS] No route service - timetable not loaded";
+        return 0;
+    }
+
+    int accepted = 0;
+    for (const QVariant& serviceValue : services) {
+        const QVariantMap service = serviceValue.toMap();
+        TrainPlan plan;
+        plan.headcode = service["headcode"].toString();
+        plan.priority = service.value("priority", "NORMAL").toString().toUpper();
+        if (plan.headcode.isEmpty()) {
+            qWarning() << " [ARS] Timetable entry without headcode skipped";
+            continue;
+        }
+
+        for (const QVariant& routeValue : service["routes"].toList()) {
+            const QVariantMap route = routeValue.toMap();
+            RouteStep step;
+            step.sourceSignalId = route["sourceSignalId"].toString();
+            step.destSignalId = route["destSignalId"].toString();
+            step.direction = route.value("direction", "UP").toString();
+            step.notBefore = QDateTime::fromString(route["notBefore"].toString(), Qt::ISODate);
+
+            const QVariantMap definition = m_routeService->getRouteDefinition(step.sourceSignalId, step.destSignalId);
+            if (definition.isEmpty()) {
+                qWarning() << " [ARS]" << plan.headcode << "route" << step.sourceSignalId << "->"
+                           << step.destSignalId << "has no definition - skipped";
+                continue;
+            }
+            for (const QString& circuit : definition["path"].toStringList() + definition["overlapCircuits"].toStringList()) {
+                step.circuits.insert(circuit);
+            }
+
+            plan.steps.append(step);
+            ++accepted;
+        }
+
+        for (RouteStep& step : plan.steps) {
+            computeApproaches(step);
+        }
+        m_plans.insert(plan.headcode, plan);
+    }
+
+    qDebug() << " [ARS] Timetable loaded:" << accepted << "routes for" << m_plans.size() << "trains";
+    if (m_enabled) {
+        scheduleEvaluation();
+    }
+    return accepted;
+}
+
+int AutoRouteSetter::loadTimetableFile(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << " [ARS] Cannot open timetable file" << filePath << ":" << file.errorString();
+        return 0;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !document.isArray()) {
+        qWarning() << " [ARS] Timetable file" << filePath << "is not a JSON array:" << error.errorString();
+        return 0;
+    }
+    return loadTimetable(document.array().toVariantList());
+}
+
+void AutoRouteSetter::clearTimetable() {
+    m_plans.clear();
+}
+
+//   Breadth-first from the route's first circuit away from the route: distance 1 is the berth
+//   a train stands in at the entrance signal
+void AutoRouteSetter::computeApproaches(RouteStep& step) const {
+    step.approachDistance.clear();
+    if (!m_describer || !m_routeService) return;
+
+    const QStringList path = m_routeService->getRouteDefinition(step.sourceSignalId, step.destSignalId)["path"].toStringList();
+    if (path.isEmpty()) return;
+
+    const int depth = std::max(m_requestBerths, m_lookAheadBerths);
+    QSet<QString> visited(path.cbegin(), path.cend());
+    QStringList frontier{path.first()};
+    for (int distance = 1; distance <= depth && !frontier.isEmpty(); ++distance) {
+        QStringList next;
+        for (const QString& berth : frontier) {
+            for (const QString& neighbour : m_describer->adjacentBerths(berth)) {
+                if (visited.contains(neighbour)) continue;
+                visited.insert(neighbour);
+                step.approachDistance.insert(neighbour, distance);
+                next.append(neighbour);
+            }
+        }
+        frontier = next;
+    }
+}
+
+//
+//   CONFIGURATION
+//
+
+void AutoRouteSetter::setEnabled(bool enabled) {
+    if (enabled == m_enabled) return;
+    m_enabled = enabled;
+
+    if (m_enabled) {
+        m_trainsMoved = true;
+        scheduleEvaluation();
+    } else {
+        cancelTimers();
+    }
+    qDebug() << " [ARS]" << (m_enabled ? "Enabled" : "Disabled");
+    emit enabledChanged();
+}
+
+void AutoRouteSetter::setRequestBerths(int berths) {
+    berths = std::clamp(berths, 1, MAX_LOOK_AHEAD_BERTHS);
+    if (berths == m_requestBerths) return;
+    m_requestBerths = berths;
+    m_lookAheadBerths = std::max(m_lookAheadBerths, m_requestBerths);
+    for (TrainPlan& plan : m_plans) {
+        for (RouteStep& step : plan.steps) computeApproaches(step);
+    }
+    emit windowsChanged();
+}
+
+void AutoRouteSetter::setLookAheadBerths(int berths) {
+    berths = std::clamp(berths, m_requestBerths, MAX_LOOK_AHEAD_BERTHS);
+    if (berths == m_lookAheadBerths) return;
+    m_lookAheadBerths = berths;
+    for (TrainPlan& plan : m_plans) {
+        for (RouteStep& step : plan.steps) computeApproaches(step);
+    }
+    emit windowsChanged();
+}
+
+//
+//   CYCLE
+//
+
+void AutoRouteSetter::onDescriberChanged() {
+    //   A train moved: whatever refused a route may have cleared, so the next cycle skips backoff
+    m_trainsMoved = true;
+    scheduleEvaluation();
+}
+
+void AutoRouteSetter::scheduleEvaluation() {
+    if (!m_enabled || m_evaluationTimer != 0) return;
+
+    //   Coalesced: a burst of describer changes costs one cycle
+    m_evaluationTimer = m_clock->schedule(0, [this]() {
+        m_evaluationTimer = 0;
+        evaluate();
+    });
+}
+
+void AutoRouteSetter::scheduleRetry(qint64 delayMs) {
+    if (m_retryTimer != 0) m_clock->cancel(m_retryTimer);
+    m_retryTimer = 0;
+    if (!m_enabled || delayMs < 0) return;
+
+    m_retryTimer = m_clock->schedule(delayMs, [this]() {
+        m_retryTimer = 0;
+        evaluate();
+    });
+}
+
+void AutoRouteSetter::cancelTimers() {
+    if (m_evaluationTimer != 0) m_clock->cancel(m_evaluationTimer);
+    if (m_retryTimer != 0) m_clock->cancel(m_retryTimer);
+    m_evaluationTimer = 0;
+    m_retryTimer = 0;
+}
+
+void AutoRouteSetter::hold(TrainPlan& plan, const QString& reason) {
+    ++plan.attempts;
+    if (reason == plan.lastReason) return;
+
+    //   Reported once per reason, not once per retry
+    plan.lastReason = reason;
+    const RouteStep& step = plan.steps[plan.next];
+    emit routeHeld(plan.headcode, step.sourceSignalId, step.destSignalId, reason);
+}
+
+void AutoRouteSetter::refuse(TrainPlan& plan, const QString& reason, qint64 nowMs) {
+    //   BACKOFF: A refusal that train movement does not clear is not worth retrying every second
+    const int doublings = std::min(plan.refusals, 5);
+    plan.retryAtMs = nowMs + std::min<qint64>(static_cast<qint64>(RETRY_MS) << doublings, MAX_RETRY_MS);
+    ++plan.refusals;
+    hold(plan, reason);
+}
+
+AutoRouteSetter::TrainPlan* AutoRouteSetter::planFor(const Candidate& candidate) {
+    auto plan = m_plans.find(candidate.headcode);
+    if (plan == m_plans.end() || plan->next != candidate.step || plan->next >= plan->steps.size()) {
+        return nullptr;
+    }
+    return &plan.value();
+}
+
+void AutoRouteSetter::evaluate() {
+    if (!m_enabled || !m_routeService || !m_describer || m_plans.isEmpty()) return;
+
+    QElapsedTimer timer;
+    timer.start();
+    ++m_cycles;
+
+    const bool trainsMoved = std::exchange(m_trainsMoved, false);
+    const qint64 nowMs = m_clock->elapsedMs();
+    const QDateTime now = m_clock->currentDateTime();
+    qint64 wakeInMs = -1;                       //   Earliest retry or not-before among trains in range
+    auto wakeIn = [&wakeInMs](qint64 delayMs) {
+        delayMs = std::max<qint64>(0, delayMs);
+        wakeInMs = wakeInMs < 0 ? delayMs : std::min(wakeInMs, delayMs);
+    };
+
+    // =====================================
+    // WHERE EVERY TIMETABLED TRAIN IS NOW
+    // =====================================
+    QHash<QString, QString> berthOf;
+    for (int row = 0; row < m_describer->rowCount(); ++row) {
+        const QModelIndex index = m_describer->index(row);
+        const QString headcode = m_describer->data(index, TrainDescriber::HeadcodeRole).toString();
+        if (m_plans.contains(headcode)) {
+            berthOf.insert(headcode, m_describer->data(index, TrainDescriber::BerthRole).toString());
+        }
+    }
+
+    // =====================================
+    // DUE ROUTES AND LOOK-AHEAD DEMAND
+    // =====================================
+    QList<Candidate> due;
+    QList<Candidate> upcoming;
+    for (TrainPlan& plan : m_plans) {
+        if (plan.next >= plan.steps.size()) continue;
+        const QString berth = berthOf.value(plan.headcode);
+        if (berth.isEmpty()) continue;
+
+        const RouteStep& step = plan.steps[plan.next];
+        const int distance = step.approachDistance.value(berth, -1);
+        if (distance < 0) continue;
+
+        const Candidate candidate{plan.headcode, plan.next, RouteAssignmentService::priorityRank(plan.priority), distance};
+        const bool timeReached = !step.notBefore.isValid() || now >= step.notBefore;
+        if (distance <= m_requestBerths && timeReached) {
+            if (trainsMoved) plan.retryAtMs = 0;
+            if (plan.retryAtMs > nowMs) {
+                wakeIn(plan.retryAtMs - nowMs);
+                continue;
+            }
+            due.append(candidate);
+        } else if (distance <= m_lookAheadBerths) {
+            upcoming.append(candidate);
+            if (distance <= m_requestBerths) wakeIn(now.msecsTo(step.notBefore));
+        }
+    }
+
+    //   Most urgent first: priority, then nearest the entrance, then earliest booked
+    auto moreUrgent = [this](const Candidate& a, const Candidate& b) {
+        if (a.rank != b.rank) return a.rank > b.rank;
+        if (a.distance != b.distance) return a.distance < b.distance;
+        return m_plans[a.headcode].steps[a.step].notBefore < m_plans[b.headcode].steps[b.step].notBefore;
+    };
+    std::stable_sort(due.begin(), due.end(), moreUrgent);
+
+    // =====================================
+    // HOLD ROUTES THAT WOULD BLOCK A MORE IMPORTANT TRAIN
+    // =====================================
+    QVariantList requests;
+    QList<Candidate> requested;
+    for (const Candidate& candidate : due) {
+        TrainPlan& plan = m_plans[candidate.headcode];
+        const RouteStep& step = plan.steps[candidate.step];
+
+        const Candidate* heldFor = nullptr;
+        for (const Candidate& other : upcoming) {
+            if (other.rank <= candidate.rank) continue;
+            if (step.circuits.intersects(m_plans[other.headcode].steps[other.step].circuits)) {
+                heldFor = &other;
+                break;
+            }
+        }
+        if (heldFor) {
+            //   Released by the other train's movement, which schedules the next cycle
+            ++m_lookAheadHolds;
+            hold(plan, "LOOK_AHEAD: held for " + heldFor->headcode);
+            continue;
+        }
+
+        requests.append(QVariantMap{
+            {"requestId", plan.headcode + "/" + QString::number(candidate.step)},
+            {"sourceSignalId", step.sourceSignalId},
+            {"destSignalId", step.destSignalId},
+            {"direction", step.direction},
+            {"requestedBy", "ARS"},
+            {"priority", plan.priority}
+        });
+        requested.append(candidate);
+    }
+
+    // =====================================
+    // ONE BATCH THROUGH THE NORMAL ROUTE PATH
+    // =====================================
+    if (!requests.isEmpty()) {
+        m_routesRequested += requests.size();
+        const QVariantList results = m_routeService->requestRoutes(requests);
+
+        for (qsizetype i = 0; i < results.size() && i < requested.size(); ++i) {
+            const QVariantMap result = results[i].toMap();
+            const QVariantMap request = requests[i].toMap();
+
+            //   REENTRANCY: The timetable may have changed while the batch ran - look the plan up again
+            TrainPlan* plan = planFor(requested[i]);
+            if (!result["success"].toBool()) {
+                ++m_routesRefused;
+                QString reason = result["error"].toString();
+                if (result.contains("conflictsWith")) reason += ": " + result["conflictsWith"].toString();
+                if (plan) {
+                    refuse(*plan, reason, nowMs);
+                    wakeIn(plan->retryAtMs - nowMs);
+                }
+                continue;
+            }
+
+            ++m_routesSet;
+            const QString routeId = result["routeId"].toString();
+            emit routeSet(requested[i].headcode, routeId, request["sourceSignalId"].toString(),
+                          request["destSignalId"].toString());
+
+            plan = planFor(requested[i]);
+            if (!plan) {
+                qWarning() << " [ARS] Route" << routeId << "set for" << requested[i].headcode
+                           << "after its timetable entry changed";
+                continue;
+            }
+
+            plan->routeIds.append(routeId);
+            plan->lastReason.clear();
+            plan->attempts = 0;
+            plan->refusals = 0;
+            plan->retryAtMs = 0;
+            if (++plan->next >= plan->steps.size()) {
+                emit serviceCompleted(plan->headcode);
+            }
+        }
+    }
+
+    scheduleRetry(wakeInMs);
+
+    m_lastCycleMs = timer.nsecsElapsed() / 1e6;
+    if (!due.isEmpty()) {
+        qDebug() << " [ARS] Cycle:" << due.size() << "due," << requests.size() << "requested in" << m_lastCycleMs << "ms";
+    }
+}
+
+//
+//   QUERIES
+//
+
+QVariantList AutoRouteSetter::getPlan() const {
+    QVariantList plans;
+    for (const TrainPlan& plan : m_plans) {
+        QVariantMap entry;
+        entry["headcode"] = plan.headcode;
+        entry["priority"] = plan.priority;
+        entry["routesSet"] = plan.routeIds;
+        entry["remaining"] = static_cast<int>(plan.steps.size() - plan.next);
+        entry["lastReason"] = plan.lastReason;
+        entry["attempts"] = plan.attempts;
+        if (plan.next < plan.steps.size()) {
+            const RouteStep& step = plan.steps[plan.next];
+            entry["nextSourceSignalId"] = step.sourceSignalId;
+            entry["nextDestSignalId"] = step.destSignalId;
+            entry["notBefore"] = step.notBefore;
+        }
+        plans.append(entry);
+    }
+    return plans;
+}
+
+QVariantMap AutoRouteSetter::statistics() const {
+    int activeTrains = 0;
+    for (const TrainPlan& plan : m_plans) {
+        if (plan.next < plan.steps.size()) ++activeTrains;
+    }
+
+    return QVariantMap{
+        {"enabled", m_enabled},
+        {"trains", static_cast<int>(m_plans.size())},
+        {"activeTrains", activeTrains},
+        {"cycles", m_cycles},
+        {"routesRequested", m_routesRequested},
+        {"routesSet", m_routesSet},
+        {"routesRefused", m_routesRefused},
+        {"lookAheadHolds", m_lookAheadHolds},
+        {"lastCycleMs", m_lastCycleMs}
+    };
+}
+
+} // namespace RailFlux::Route
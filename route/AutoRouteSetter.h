@@ -0,0 +1,153 @@
+#pragma once
+
+#include <QObject>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
+#include "../core/Clock.h"
+
+class TrainDescriber;
+
+namespace RailFlux::Route {
+
+class RouteAssignmentService;
+
+//   AUTOMATIC ROUTE SETTING (ARS)
+//
+//   Sets each train's timetabled routes without operator input. A timetable gives every
+//   headcode an ordered list of routes (entrance signal -> exit signal, optional not-before
+//   time); the train describer gives where each headcode is now.
+//
+//   JUST IN TIME: A route is requested once its train is within requestBerths circuits in
+//   rear of the entrance and its not-before time has passed - late enough not to lock the
+//   junction for a train still far off, early enough for the driver to see a proceed aspect.
+//
+//   LOOK-AHEAD: A due route is held back while a higher-priority train within lookAheadBerths
+//   of one of its own routes needs any of the same circuits, so a slow train does not take
+//   a junction an express is about to need. Due routes are then submitted most urgent first
+//   in one RouteAssignmentService::requestRoutes batch: the same interlocking, resource and
+//   commit path as operator routes, one transaction per cycle however many trains are due.
+//
+//   Cycles run on describer changes (coalesced), which retry every refused route since a
+//   train has moved. Without movement a refused route is retried on the station clock after
+//   RETRY_MS, doubling per refusal up to MAX_RETRY_MS; a one-shot timer is armed only for the
+//   earliest such retry or not-before time. Owned and driven by the GUI thread.
+class AutoRouteSetter : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(bool enabled READ isEnabled WRITE setEnabled NOTIFY enabledChanged)
+    Q_PROPERTY(int requestBerths READ requestBerths WRITE setRequestBerths NOTIFY windowsChanged)
+    Q_PROPERTY(int lookAheadBerths READ lookAheadBerths WRITE setLookAheadBerths NOTIFY windowsChanged)
+
+public:
+    AutoRouteSetter(RouteAssignmentService* routeService, TrainDescriber* describer, QObject* parent = nullptr);
+    ~AutoRouteSetter();
+
+    //   Not-before times and retries are on this clock
+    void setClock(Clock* clock);
+
+    //   TIMETABLE: [{ headcode, priority?, routes: [{ sourceSignalId, destSignalId, direction?,
+    //   notBefore? (ISO date-time) }] }]. Replaces the plan of every headcode it names; returns
+    //   the number of routes accepted (routes with no definition are skipped with a warning).
+    Q_INVOKABLE int loadTimetable(const QVariantList& services);
+    Q_INVOKABLE int loadTimetableFile(const QString& filePath);
+    Q_INVOKABLE void clearTimetable();
+
+    bool isEnabled() const { return m_enabled; }
+    void setEnabled(bool enabled);
+
+    int requestBerths() const { return m_requestBerths; }
+    void setRequestBerths(int berths);
+    int lookAheadBerths() const { return m_lookAheadBerths; }
+    void setLookAheadBerths(int berths);
+
+    //   QUERIES
+    Q_INVOKABLE QVariantList getPlan() const;
+    Q_INVOKABLE QVariantMap statistics() const;
+
+public slots:
+    //   One ARS cycle now; normally driven by describer changes and the retry timer
+    void evaluate();
+
+signals:
+    void enabledChanged();
+    void windowsChanged();
+    void routeSet(const QString& headcode, const QString& routeId, const QString& sourceSignal, const QString& destSignal);
+    void routeHeld(const QString& headcode, const QString& sourceSignal, const QString& destSignal, const QString& reason);
+    void serviceCompleted(const QString& headcode);
+
+private:
+    static constexpr int DEFAULT_REQUEST_BERTHS = 2;
+    static constexpr int DEFAULT_LOOK_AHEAD_BERTHS = 5;
+    static constexpr int MAX_LOOK_AHEAD_BERTHS = 20;
+    static constexpr int RETRY_MS = 1000;
+    static constexpr int MAX_RETRY_MS = 30000;
+
+    struct RouteStep {
+        QString sourceSignalId;
+        QString destSignalId;
+        QString direction;
+        QDateTime notBefore;                    //   Invalid: as soon as the train is in range
+        QSet<QString> circuits;                 //   Path and overlap
+        QHash<QString, int> approachDistance;   //   Berth in rear -> circuits to the entrance
+    };
+
+    struct TrainPlan {
+        QString headcode;
+        QString priority;
+        QList<RouteStep> steps;
+        int next = 0;                           //   First step not yet set
+        QStringList routeIds;
+        QString lastReason;
+        int attempts = 0;
+        int refusals = 0;                       //   Consecutive refusals of the next step
+        qint64 retryAtMs = 0;                   //   Clock time before which a refused step waits
+    };
+
+    //   Keyed by headcode, never by plan address: requestRoutes emits synchronously, and a
+    //   receiver may load or clear the timetable underneath the cycle
+    struct Candidate {
+        QString headcode;
+        int step;                               //   plan.next when chosen
+        int rank;
+        int distance;
+    };
+
+    void computeApproaches(RouteStep& step) const;
+    void onDescriberChanged();
+    void scheduleEvaluation();
+    void scheduleRetry(qint64 delayMs);
+    void cancelTimers();
+    void hold(TrainPlan& plan, const QString& reason);
+    void refuse(TrainPlan& plan, const QString& reason, qint64 nowMs);
+    //   The plan still waiting on the candidate's step, or nullptr if it was replaced or removed
+    TrainPlan* planFor(const Candidate& candidate);
+
+    QPointer<RouteAssignmentService> m_routeService;
+    QPointer<TrainDescriber> m_describer;
+    QPointer<Clock> m_clock = Clock::system();
+
+    bool m_enabled = false;
+    int m_requestBerths = DEFAULT_REQUEST_BERTHS;
+    int m_lookAheadBerths = DEFAULT_LOOK_AHEAD_BERTHS;
+    QHash<QString, TrainPlan> m_plans;          //   Headcode -> plan
+
+    Clock::TimerId m_evaluationTimer = 0;
+    Clock::TimerId m_retryTimer = 0;
+    bool m_trainsMoved = false;                 //   Describer changed since the last cycle
+
+    //   STATISTICS
+    quint64 m_cycles = 0;
+    quint64 m_routesRequested = 0;
+    quint64 m_routesSet = 0;
+    quint64 m_routesRefused = 0;
+    quint64 m_lookAheadHolds = 0;
+    double m_lastCycleMs = 0.0;
+};
+
+} // namespace RailFlux::Route
@@ -1,5 +1,6 @@
 #include "RouteAssignmentService.h"
 #include "../database/DatabaseManager.h"
+#include "../interlocking/InterlockingService.h"
 
 #include <QSqlQuery>
 #include <QSqlError>
@@ -9,9 +10,23 @@
 #include <QUuid>
 #include <QtMath>
 #include <algorithm>
+#include <numeric>
 
 namespace RailFlux::Route {
 
+namespace {
+
+// "{A,B}" text form of a PostgreSQL array, as getRoutesByState returns it
+QStringList fromPgArray(const QString& text) {
+    QString body = text.trimmed();
+    if (body.startsWith('{') && body.endsWith('}')) {
+        body = body.mid(1, body.length() - 2);
+    }
+    return body.isEmpty() ? QStringList() : body.split(',');
+}
+
+} // namespace
+
 RouteAssignmentService::RouteAssignmentService(QObject* parent)
     : QObject(parent)
 {
@@ -22,9 +37,11 @@ RouteAssignmentService::~RouteAssignmentService() {
 }
 
 void RouteAssignmentService::setServices(
-    DatabaseManager* dbManager
+    DatabaseManager* dbManager,
+    InterlockingService* interlockingService
 ) {
     m_dbManager = dbManager;
+    m_interlockingService = interlockingService;
 }
 
 void RouteAssignmentService::initialize() {
@@ -83,8 +100,9 @@ QString RouteAssignmentService::requestRoute(
     // =====================================
     // SIMULATE PROCESSING TIME
     // =====================================
-    // Sleep for realistic processing time (optional)
-    QThread::msleep(static_cast<unsigned long>(hardcodedRoute.simulatedProcessingTime));
+    // Sleep for realistic processing time (optional), on the station clock
+    Clock* clock = m_dbManager ? m_dbManager->clock() : Clock::system();
+    clock->sleep(static_cast<qint64>(hardcodedRoute.simulatedProcessingTime));
 
     // =====================================
     // APPLY HARDCODED ROUTE CHANGES
@@ -114,6 +132,240 @@ QString RouteAssignmentService::requestRoute(
     }
 }
 
+QVariantList RouteAssignmentService::requestRoutes(const QVariantList& requests) {
+    QElapsedTimer timer;
+    timer.start();
+
+    struct BatchEntry {
+        QString requestId;
+        QString sourceSignalId;
+        QString destSignalId;
+        QString direction;
+        QString requestedBy;
+        QString priority;
+        HardcodedRoute route;
+        QString error;
+        QString conflictsWith;
+        QString routeId;
+        QStringList lockedPointMachines;
+        QVariantList pointMoves;
+        QVariantList signalAspects;
+        QVariantMap readVersions;           // As validated; rechecked inside the commit
+        QStringList pairedMachines;         // Move with the route's machines, so claimed with them
+    };
+
+    QList<BatchEntry> entries;
+    entries.reserve(requests.size());
+    for (const QVariant& value : requests) {
+        const QVariantMap request = value.toMap();
+        BatchEntry entry;
+        entry.requestId = request.value("requestId", generateRequestId()).toString();
+        entry.routeId = generateRequestId();     // Allocated up front, as requestRoute does, so failures report it too
+        entry.sourceSignalId = request["sourceSignalId"].toString();
+        entry.destSignalId = request["destSignalId"].toString();
+        entry.direction = request.value("direction", "UP").toString();
+        entry.requestedBy = request.value("requestedBy", "timetable").toString();
+        entry.priority = request.value("priority", "NORMAL").toString();
+        entry.route = findHardcodedRoute(entry.sourceSignalId, entry.destSignalId);
+        if (!m_isOperational || !m_dbManager) {
+            entry.error = "SERVICE_NOT_OPERATIONAL";
+        } else if (entry.route.reachability == "BLOCKED") {
+            entry.error = entry.route.blockedReason;
+        }
+        entries.append(entry);
+    }
+    m_totalRequests += entries.size();
+
+    // =====================================
+    // STEP 1: INTERLOCKING - ALL ROUTES IN PARALLEL ON ONE STATE VERSION
+    // =====================================
+    if (m_interlockingService) {
+        QList<SpeculativeChangeSet> changeSets;
+        QList<qsizetype> entryIndex;
+        for (qsizetype i = 0; i < entries.size(); ++i) {
+            if (entries[i].error.isEmpty()) {
+                entryIndex.append(i);
+                changeSets.append(buildChangeSet(entries[i].route, entries[i].requestId));
+            }
+        }
+
+        const QList<SpeculativeOutcome> outcomes = m_interlockingService->evaluateSpeculativeBatch(changeSets);
+        for (qsizetype i = 0; i < outcomes.size(); ++i) {
+            BatchEntry& entry = entries[entryIndex[i]];
+            if (!outcomes[i].result.isAllowed()) {
+                entry.error = outcomes[i].result.getRuleId().isEmpty() ? outcomes[i].result.getReason()
+                                                                       : outcomes[i].result.getRuleId();
+                entry.conflictsWith = outcomes[i].blockingEntityId;
+                continue;
+            }
+            // Only what the check found out of place, each with the version it was validated on
+            for (const auto& move : outcomes[i].requiredPointMoves) {
+                entry.pointMoves.append(QVariantMap{{"machineId", move.machineId}, {"position", move.targetPosition},
+                                                    {"expectedVersion", move.expectedVersion},
+                                                    {"expectedPairedVersion", move.expectedPairedVersion}});
+            }
+            for (const auto& change : outcomes[i].requiredAspectChanges) {
+                entry.signalAspects.append(QVariantMap{{"signalId", change.signalId}, {"aspect", change.targetAspect},
+                                                       {"expectedVersion", change.expectedVersion}});
+            }
+            entry.readVersions = outcomes[i].readVersions.toVariantMap();
+            entry.pairedMachines = outcomes[i].pairedMachines.values();
+        }
+    } else {
+        // No what-if check available: every setting is sent; the server still checks each one
+        for (BatchEntry& entry : entries) {
+            for (auto it = entry.route.pointMachineSettings.begin(); it != entry.route.pointMachineSettings.end(); ++it) {
+                entry.pointMoves.append(QVariantMap{{"machineId", it.key()}, {"position", it.value()}});
+            }
+            for (const auto& [signalId, aspect] : buildChangeSet(entry.route, entry.requestId).signalAspects) {
+                entry.signalAspects.append(QVariantMap{{"signalId", signalId}, {"aspect", aspect}});
+            }
+        }
+    }
+
+    // =====================================
+    // STEP 2: RESOURCE MODEL - ROUTES HOLDING RESOURCES, THEN EACH OTHER BY PRIORITY
+    // =====================================
+    // Every state that still holds circuits, locks or signals, as route_circuits and
+    // route_point_locks count them; ACTIVE alone misses reserved and part-released routes
+    QHash<QString, QString> claims;     // "C:circuit" / "P:machine" / "S:signal" -> holder
+    if (m_dbManager && m_isOperational) {
+        for (const QString& state : {QStringLiteral("RESERVED"), QStringLiteral("ACTIVE"), QStringLiteral("PARTIALLY_RELEASED")}) {
+            for (const QVariant& value : m_dbManager->getRoutesByState(state)) {
+                const QVariantMap held = value.toMap();
+                const QString holder = "route " + held["id"].toString();
+                for (const QString& circuit : fromPgArray(held["assignedCircuits"].toString())
+                                                  + fromPgArray(held["overlapCircuits"].toString())) {
+                    claims.insert("C:" + circuit, holder);
+                }
+                for (const QString& machine : fromPgArray(held["lockedPointMachines"].toString())) {
+                    claims.insert("P:" + machine, holder);
+                }
+                claims.insert("S:" + held["sourceSignalId"].toString(), holder);
+                claims.insert("S:" + held["destSignalId"].toString(), holder);
+            }
+        }
+    }
+
+    QList<qsizetype> order(entries.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&entries](qsizetype a, qsizetype b) {
+        return priorityRank(entries[a].priority) > priorityRank(entries[b].priority);
+    });
+
+    QVariantList batch;
+    QList<qsizetype> batchIndex;
+    for (qsizetype i : order) {
+        BatchEntry& entry = entries[i];
+        if (!entry.error.isEmpty()) continue;
+
+        QStringList resources;
+        for (const QString& circuit : entry.route.path + entry.route.overlapCircuits) {
+            resources.append("C:" + circuit);
+        }
+        for (auto it = entry.route.pointMachineSettings.begin(); it != entry.route.pointMachineSettings.end(); ++it) {
+            resources.append("P:" + it.key());
+        }
+        for (const QString& machineId : entry.pairedMachines) {
+            if (!entry.route.pointMachineSettings.contains(machineId)) resources.append("P:" + machineId);
+        }
+        QStringList routeSignals = entry.route.signalAspects.keys();
+        for (const QString& signalId : QStringList{entry.sourceSignalId, entry.destSignalId}) {
+            if (!routeSignals.contains(signalId)) routeSignals.append(signalId);
+        }
+        for (const QString& signalId : routeSignals) {
+            resources.append("S:" + signalId);
+        }
+
+        for (const QString& resource : resources) {
+            if (claims.contains(resource)) {
+                entry.error = "RESOURCE_CONFLICT";
+                entry.conflictsWith = claims.value(resource) + " (" + resource.mid(2) + ")";
+                break;
+            }
+        }
+        if (!entry.error.isEmpty()) continue;
+
+        for (const QString& resource : resources) {
+            claims.insert(resource, "request " + entry.requestId);
+        }
+
+        batch.append(QVariantMap{
+            {"routeId", entry.routeId},
+            {"sourceSignalId", entry.sourceSignalId},
+            {"destSignalId", entry.destSignalId},
+            {"direction", entry.direction},
+            {"assignedCircuits", entry.route.path},
+            {"overlapCircuits", entry.route.overlapCircuits},
+            {"pointMoves", entry.pointMoves},
+            {"signalAspects", entry.signalAspects},
+            {"readVersions", entry.readVersions},
+            {"priority", priorityRank(entry.priority)}
+        });
+        batchIndex.append(i);
+    }
+
+    // =====================================
+    // STEP 3: COMMIT COMPATIBLE ROUTES IN ONE TRANSACTION
+    // =====================================
+    if (!batch.isEmpty()) {
+        const QVariantList committed = m_dbManager->applyRouteBatch(batch, "ROUTE_BATCH");
+        for (qsizetype i = 0; i < committed.size(); ++i) {
+            const QVariantMap outcome = committed[i].toMap();
+            if (!outcome["success"].toBool()) {
+                entries[batchIndex[i]].error = outcome["error"].toString();
+            }
+        }
+    }
+
+    // =====================================
+    // STEP 4: PER-REQUEST RESULTS, IN SUBMISSION ORDER
+    // =====================================
+    QVariantList results;
+    results.reserve(entries.size());
+    int committedCount = 0;
+    for (const BatchEntry& entry : entries) {
+        QVariantMap result{{"requestId", entry.requestId}, {"success", entry.error.isEmpty()}};
+        if (entry.error.isEmpty()) {
+            result["routeId"] = entry.routeId;
+            emit routeAssigned(entry.routeId, entry.sourceSignalId, entry.destSignalId, entry.route.path);
+            m_successfulRoutes++;
+            committedCount++;
+        } else {
+            result["error"] = entry.error;
+            if (!entry.conflictsWith.isEmpty()) result["conflictsWith"] = entry.conflictsWith;
+            emit routeFailed(entry.routeId, entry.error);
+            m_failedRoutes++;
+        }
+        results.append(result);
+    }
+
+    qDebug() << "[ROUTE_BATCH]" << committedCount << "of" << entries.size()
+             << "routes committed in" << timer.elapsed() << "ms";
+    return results;
+}
+
+QVariantMap RouteAssignmentService::getRouteDefinition(const QString& sourceSignalId, const QString& destSignalId) const {
+    for (const auto& route : m_hardcodedRoutes.routesBySource.value(sourceSignalId)) {
+        if (route.destSignalId == destSignalId) {
+            return QVariantMap{
+                {"path", route.path},
+                {"overlapCircuits", route.overlapCircuits},
+                {"signalAspects", route.signalAspects},
+                {"pointMachines", route.pointMachineSettings}
+            };
+        }
+    }
+    return QVariantMap();
+}
+
+int RouteAssignmentService::priorityRank(const QString& priority) {
+    if (priority == "EMERGENCY") return 300;
+    if (priority == "HIGH") return 200;
+    if (priority == "LOW") return 50;
+    return 100;
+}
+
 // Utility methods
 QString RouteAssignmentService::generateRequestId() const {
     return QUuid::createUuid().toString(QUuid::WithoutBraces);
@@ -153,6 +405,7 @@ QVariantMap RouteAssignmentService::formatScanResults(const QList<DestinationCan
         candidateMap["required_pm_actions"] = pmActions;
 
         candidateMap["conflicts"] = QVariantList(candidate.conflicts.begin(), candidate.conflicts.end());
+        candidateMap["telemetry"] = candidate.telemetry;
 
         if (candidate.reachability == "REACHABLE_CLEAR") {
             reachableClear.append(candidateMap);
@@ -483,6 +736,8 @@ RouteAssignmentService::performDestinationScan(
         candidates.append(createCandidate("DEFAULT_02", "Default Dest 2", "BLOCKED"));
     }
 
+    evaluateCandidateReachability(sourceSignalId, candidates);
+
     // =====================================
     // MAINTAIN ORIGINAL SORTING LOGIC
     // =====================================
@@ -508,4 +763,89 @@ RouteAssignmentService::performDestinationScan(
     return candidates;
 }
 
+void RouteAssignmentService::evaluateCandidateReachability(
+    const QString& sourceSignalId,
+    QList<DestinationCandidate>& candidates) {
+
+    if (!m_interlockingService) {
+        return;
+    }
+
+    QElapsedTimer whatIfTimer;
+    whatIfTimer.start();
+
+    // =====================================
+    // BUILD ONE CHANGE SET PER KNOWN ROUTE
+    // =====================================
+    QList<SpeculativeChangeSet> changeSets;
+    QList<qsizetype> candidateIndex;
+    for (qsizetype i = 0; i < candidates.size(); ++i) {
+        const HardcodedRoute route = findHardcodedRoute(sourceSignalId, candidates[i].destSignalId);
+        if (route.reachability == "BLOCKED") {
+            continue;   // No route definition - keep the static verdict
+        }
+
+        candidateIndex.append(i);
+        changeSets.append(buildChangeSet(route, candidates[i].destSignalId));
+    }
+
+    if (changeSets.isEmpty()) {
+        return;
+    }
+
+    // =====================================
+    // EVALUATE ALL ROUTES IN PARALLEL
+    // =====================================
+    const QList<SpeculativeOutcome> outcomes = m_interlockingService->evaluateSpeculativeBatch(changeSets);
+    const double whatIfMs = whatIfTimer.nsecsElapsed() / 1e6;
+
+    for (qsizetype i = 0; i < outcomes.size(); ++i) {
+        const SpeculativeOutcome& outcome = outcomes[i];
+        DestinationCandidate& candidate = candidates[candidateIndex[i]];
+
+        candidate.requiredPMActions.clear();
+        candidate.conflicts.clear();
+        candidate.telemetry["what_if_ms"] = whatIfMs;
+
+        if (!outcome.result.isAllowed()) {
+            candidate.reachability = "BLOCKED";
+            candidate.blockedReason = outcome.result.getRuleId().isEmpty()
+                                          ? QString("INTERLOCKING")
+                                          : outcome.result.getRuleId();
+            candidate.conflicts.append(outcome.blockingEntityId.isEmpty()
+                                           ? outcome.result.getReason()
+                                           : outcome.blockingEntityId + ": " + outcome.result.getReason());
+            continue;
+        }
+
+        for (const auto& move : outcome.requiredPointMoves) {
+            DestinationCandidate::RequiredPMAction action;
+            action.machineId = move.machineId;
+            action.currentPosition = move.currentPosition;
+            action.targetPosition = move.targetPosition;
+            candidate.requiredPMActions.append(action);
+        }
+        candidate.blockedReason.clear();
+        candidate.reachability = candidate.requiredPMActions.isEmpty() ? "REACHABLE_CLEAR" : "REACHABLE_REQUIRES_PM";
+    }
+}
+
+SpeculativeChangeSet RouteAssignmentService::buildChangeSet(const HardcodedRoute& route, const QString& candidateId) {
+    SpeculativeChangeSet changeSet;
+    changeSet.candidateId = candidateId;
+    for (auto it = route.pointMachineSettings.begin(); it != route.pointMachineSettings.end(); ++it) {
+        changeSet.pointPositions.append({it.key(), it.value().toString()});
+    }
+    // Source signal last, so it is cleared against the rest of the route as set
+    for (auto it = route.signalAspects.begin(); it != route.signalAspects.end(); ++it) {
+        if (it.key() != route.sourceSignalId) {
+            changeSet.signalAspects.append({it.key(), it.value().toString()});
+        }
+    }
+    if (route.signalAspects.contains(route.sourceSignalId)) {
+        changeSet.signalAspects.append({route.sourceSignalId, route.signalAspects.value(route.sourceSignalId).toString()});
+    }
+    return changeSet;
+}
+
 } // namespace RailFlux::Route
@@ -18,6 +18,8 @@
 
 // Forward declarations
 class DatabaseManager;
+class InterlockingService;
+struct SpeculativeChangeSet;
 
 namespace RailFlux::Route {
 
@@ -109,7 +111,8 @@ public:
 
     // Service composition - must be called after construction
     void setServices(
-        DatabaseManager* dbManager
+        DatabaseManager* dbManager,
+        InterlockingService* interlockingService = nullptr
         );
 
     // Properties
@@ -132,13 +135,25 @@ public:
         const QString& priority = "NORMAL"
         );
 
+    //   BATCH API: Each request is { sourceSignalId, destSignalId, direction?, requestedBy?,
+    //   priority?, requestId? }. All requests are checked against the interlocking and against
+    //   the resources held by active routes and by each other (higher priority first, then
+    //   submission order); compatible routes are committed in one transaction. Returns one
+    //   { requestId, success, routeId | error, conflictsWith? } per request, in order.
+    Q_INVOKABLE QVariantList requestRoutes(const QVariantList& requests);
+
+    //   ROUTE DEFINITIONS: { path, overlapCircuits, signalAspects, pointMachines }, empty if undefined
+    Q_INVOKABLE QVariantMap getRouteDefinition(const QString& sourceSignalId, const QString& destSignalId) const;
+    //   route_assignments.priority for a request priority name (EMERGENCY, HIGH, NORMAL, LOW)
+    static int priorityRank(const QString& priority);
+
 public slots:
     void initialize();
 
 signals:
     void operationalStateChanged();
     void routeAssigned(const QString& routeId, const QString& sourceSignal, const QString& destSignal, const QStringList& path);
-    void routeFailed(const QString& requestId, const QString& reason);
+    void routeFailed(const QString& routeId, const QString& reason);
 
 private:
     // === CLEARANCE CHECK STRUCTURES ===
@@ -154,6 +169,11 @@ private:
         const QString& direction
         );
     QVariantMap formatScanResults(const QList<DestinationCandidate>& candidates);
+    //   WHAT-IF REACHABILITY: Replaces the static verdict of every candidate with a known route
+    //   by a speculative interlocking check of that route's point moves and aspects
+    void evaluateCandidateReachability(const QString& sourceSignalId, QList<DestinationCandidate>& candidates);
+    //   Point moves first, then signal aspects with the source signal last
+    static SpeculativeChangeSet buildChangeSet(const HardcodedRoute& route, const QString& candidateId);
 
     // Utility methods
     QString generateRequestId() const;
@@ -167,6 +187,7 @@ private:
 private:
     // Service dependencies (composed services)
     DatabaseManager* m_dbManager = nullptr;
+    InterlockingService* m_interlockingService = nullptr;
 
     // Operational state
     bool m_isOperational = false;
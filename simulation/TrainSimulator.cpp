@@ -0,0 +1,727 @@
+#include "TrainSimulator.h"
+#include "StationData.h"
+#include "../database/DatabaseManager.h"
+#include "../database/StationEventBus.h"
+#include "../interlocking/PackedAspect.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QSet>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+bool isDanger(AspectCode code) {
+    //   Unknown is treated as danger: a train never runs on an aspect it could not read
+    return code == AspectCode::RED || code == AspectCode::UNKNOWN;
+}
+
+double kmhToMps(double kmh) {
+    return kmh / 3.6;
+}
+}
+
+TrainSimulator::TrainSimulator(DatabaseManager* dbManager, QObject* parent)
+    : QObject(parent)
+    , m_dbManager(dbManager)
+{
+    buildTrackGraph();
+    placeSignals();
+}
+
+TrainSimulator::~TrainSimulator() {
+    //   Normally stopped on aboutToQuit; with the clock or database already gone there is
+    //   nothing left to cancel timers on or clear occupancy in
+    if (m_clock && m_dbManager) {
+        stop();
+    }
+}
+
+void TrainSimulator::setClock(Clock* clock) {
+    if (!clock || clock == m_clock) return;
+
+    if (m_running) {
+        qWarning() << " [TrainSimulator] Clock not changed while running";
+        return;
+    }
+    m_clock = clock;
+}
+
+//
+//   TRACK GRAPH
+//
+
+void TrainSimulator::buildTrackGraph() {
+    using namespace RailFlux::Station;
+
+    for (const TrackCircuitDef& def : Generated::TRACK_CIRCUITS) {
+        m_circuitIndex.insert(toQString(def.id), static_cast<int>(m_circuits.size()));
+        Circuit& circuit = m_circuits.emplace_back();
+        circuit.id = toQString(def.id);
+        circuit.speedMps = kmhToMps(DEFAULT_CIRCUIT_SPEED_KMH);
+    }
+
+    const auto& segments = Generated::TRACK_SEGMENTS;
+    for (const TrackSegmentDef& def : segments) {
+        m_segmentIndex.insert(toQString(def.id), static_cast<int>(m_segments.size()));
+        Segment& segment = m_segments.emplace_back();
+        segment.id = toQString(def.id);
+        segment.circuit = def.circuitId.empty() ? -1 : m_circuitIndex.value(toQString(def.circuitId), -1);
+        segment.gridLength = std::hypot(def.endRow - def.startRow, def.endCol - def.startCol);
+        segment.lengthM = segment.gridLength * DEFAULT_METERS_PER_GRID_UNIT;
+    }
+    m_segmentOccupants.assign(m_segments.size(), 0);
+
+    //   Points: root end leads to the normal or reverse leg, whichever the point is set to
+    QSet<QPair<int, int>> pointEnds;
+    auto endOf = [](const PointConnectionDef& connection) {
+        return connection.connectionEnd == std::string_view("END") ? END : START;
+    };
+
+    for (const PointMachineDef& machine : Generated::POINT_MACHINES) {
+        const int point = static_cast<int>(m_points.size());
+        m_pointIndex.insert(toQString(machine.id), point);
+        PointState& state = m_points.emplace_back();
+        state.id = toQString(machine.id);
+        state.reverse = machine.position == std::string_view("REVERSE");
+
+        const int root = m_segmentIndex.value(toQString(machine.root.trackSegmentId), -1);
+        if (root < 0) continue;
+        const SegmentEnd rootEnd = endOf(machine.root);
+        pointEnds.insert({root, rootEnd});
+
+        for (const bool reverse : {false, true}) {
+            const PointConnectionDef& leg = reverse ? machine.reverse : machine.normal;
+            const int legSegment = m_segmentIndex.value(toQString(leg.trackSegmentId), -1);
+            if (legSegment < 0) continue;
+            const SegmentEnd legEnd = endOf(leg);
+            pointEnds.insert({legSegment, legEnd});
+
+            m_segments[root].links[rootEnd].push_back({legSegment, legEnd, point, reverse});
+            m_segments[legSegment].links[legEnd].push_back({root, rootEnd, point, reverse});
+        }
+    }
+
+    //   Plain track: segment ends that abut, except where a point defines the connection
+    auto endPoint = [&segments](int segment, SegmentEnd end) {
+        const TrackSegmentDef& def = segments[static_cast<size_t>(segment)];
+        return end == START ? std::pair{def.startRow, def.startCol} : std::pair{def.endRow, def.endCol};
+    };
+
+    const int count = static_cast<int>(m_segments.size());
+    for (int a = 0; a < count; ++a) {
+        for (int b = a + 1; b < count; ++b) {
+            for (const SegmentEnd endA : {START, END}) {
+                for (const SegmentEnd endB : {START, END}) {
+                    if (pointEnds.contains({a, endA}) || pointEnds.contains({b, endB})) continue;
+
+                    const auto [rowA, colA] = endPoint(a, endA);
+                    const auto [rowB, colB] = endPoint(b, endB);
+                    if (std::hypot(rowA - rowB, colA - colB) <= ADJACENCY_TOLERANCE) {
+                        m_segments[a].links[endA].push_back({b, endB});
+                        m_segments[b].links[endB].push_back({a, endA});
+                    }
+                }
+            }
+        }
+    }
+
+    //   Entries: unreported boundary segments with one open end
+    for (int i = 0; i < count; ++i) {
+        const Segment& segment = m_segments[i];
+        if (segment.circuit >= 0) continue;
+        const bool startOpen = segment.links[START].empty();
+        const bool endOpen = segment.links[END].empty();
+        if (startOpen != endOpen) {
+            m_entries.push_back({i, startOpen ? START : END});
+        }
+    }
+
+    qDebug() << " [TrainSimulator] Track graph:" << m_segments.size() << "segments," << m_entries.size() << "entries";
+}
+
+void TrainSimulator::placeSignals() {
+    using namespace RailFlux::Station;
+    const auto& segments = Generated::TRACK_SEGMENTS;
+
+    for (const SignalDef& def : Generated::SIGNALS) {
+        const int signal = static_cast<int>(m_signals.size());
+        m_signalIndex.insert(toQString(def.id), signal);
+        SignalState& state = m_signals.emplace_back();
+        state.id = toQString(def.id);
+        state.atDanger = isDanger(PackedAspect::codeFromString(toQString(def.currentAspect)));
+        if (!def.isActive) continue;
+
+        //   Nearest reported segment to the signal post
+        int nearest = -1;
+        double nearestDistance = 0.0;
+        double nearestT = 0.0;
+        for (size_t i = 0; i < segments.size(); ++i) {
+            if (m_segments[i].circuit < 0 || m_segments[i].gridLength <= 0.0) continue;
+
+            const TrackSegmentDef& segment = segments[i];
+            const double dRow = segment.endRow - segment.startRow;
+            const double dCol = segment.endCol - segment.startCol;
+            const double t = std::clamp(((def.row - segment.startRow) * dRow + (def.col - segment.startCol) * dCol)
+                                        / (dRow * dRow + dCol * dCol), 0.0, 1.0);
+            const double distance = std::hypot(def.row - (segment.startRow + t * dRow), def.col - (segment.startCol + t * dCol));
+            if (nearest < 0 || distance < nearestDistance) {
+                nearest = static_cast<int>(i);
+                nearestDistance = distance;
+                nearestT = t;
+            }
+        }
+        if (nearest < 0) continue;
+
+        //   UP reads towards increasing column
+        const TrackSegmentDef& segment = segments[static_cast<size_t>(nearest)];
+        const bool facesStartToEnd = (def.direction == std::string_view("UP")) == (segment.endCol >= segment.startCol);
+        const SegmentEnd entryEnd = facesStartToEnd ? START : END;
+        double fraction = facesStartToEnd ? nearestT : 1.0 - nearestT;
+
+        const QString circuitId = m_circuits[m_segments[nearest].circuit].id;
+        if (toQStringList(def.protectedTrackCircuits).contains(circuitId)) {
+            fraction = 0.0;
+        }
+
+        std::vector<StopSignal>& stops = m_segments[nearest].stops[entryEnd];
+        stops.push_back({signal, fraction});
+        std::sort(stops.begin(), stops.end(), [](const StopSignal& a, const StopSignal& b) { return a.fraction < b.fraction; });
+    }
+}
+
+bool TrainSimulator::loadDynamicState() {
+    if (!m_dbManager || !m_dbManager->isConnected()) return false;
+
+    //   Circuit lengths are shared out over their segments by drawn length
+    std::vector<double> circuitLengthM(m_circuits.size(), DEFAULT_CIRCUIT_LENGTH_M);
+    for (const QVariant& row : m_dbManager->getTrackCircuitsList()) {
+        const QVariantMap circuit = row.toMap();
+        const int index = m_circuitIndex.value(circuit.value("id").toString(), -1);
+        if (index < 0) continue;
+
+        const double lengthM = circuit.value("lengthMeters").toDouble();
+        const double speedKmh = circuit.value("maxSpeedKmh").toDouble();
+        if (lengthM > 0.0) circuitLengthM[index] = lengthM;
+        m_circuits[index].speedMps = kmhToMps(speedKmh > 0.0 ? speedKmh : DEFAULT_CIRCUIT_SPEED_KMH);
+    }
+
+    std::vector<double> circuitGrid(m_circuits.size(), 0.0);
+    for (const Segment& segment : m_segments) {
+        if (segment.circuit >= 0) circuitGrid[segment.circuit] += segment.gridLength;
+    }
+
+    double reportedM = 0.0, reportedGrid = 0.0;
+    for (size_t i = 0; i < m_circuits.size(); ++i) {
+        if (circuitGrid[i] <= 0.0) continue;
+        reportedM += circuitLengthM[i];
+        reportedGrid += circuitGrid[i];
+    }
+    const double metersPerGridUnit = reportedGrid > 0.0 ? reportedM / reportedGrid : DEFAULT_METERS_PER_GRID_UNIT;
+
+    for (Segment& segment : m_segments) {
+        segment.lengthM = segment.circuit >= 0 && circuitGrid[segment.circuit] > 0.0
+            ? circuitLengthM[segment.circuit] * segment.gridLength / circuitGrid[segment.circuit]
+            : segment.gridLength * metersPerGridUnit;
+        segment.lengthM = std::max(segment.lengthM, 1.0);
+    }
+
+    for (const QVariant& row : m_dbManager->getAllSignalsList()) {
+        const QVariantMap signal = row.toMap();
+        const int index = m_signalIndex.value(signal.value("id").toString(), -1);
+        if (index >= 0) {
+            m_signals[index].atDanger = isDanger(PackedAspect::codeFromString(signal.value("currentAspect").toString()));
+        }
+    }
+
+    for (const QVariant& row : m_dbManager->getAllPointMachinesList()) {
+        const QVariantMap machine = row.toMap();
+        const int index = m_pointIndex.value(machine.value("id").toString(), -1);
+        if (index >= 0) {
+            m_points[index].reverse = machine.value("position").toString() == QLatin1String("REVERSE");
+        }
+    }
+
+    return true;
+}
+
+//
+//   LIFECYCLE
+//
+
+bool TrainSimulator::start() {
+    if (m_running) return true;
+
+    if (!loadDynamicState()) {
+        qWarning() << " [TrainSimulator] Not started: database not connected";
+        return false;
+    }
+
+    StationEventBus* bus = m_dbManager->eventBus();
+    m_busSubscription = bus->subscribe("train-simulator", [this, bus](StationEventBus::Batch batch) {
+        bool changed = false;
+        for (const StationEventBus::ChangeRecord& record : batch) {
+            const QString& entityId = bus->entityId(record.entity);
+
+            if (record.kind == StationEventBus::EntityKind::Signal) {
+                const int index = m_signalIndex.value(entityId, -1);
+                if (index < 0) continue;
+                if (record.field == StationEventBus::Field::MainAspect && record.newValue != StationEventBus::UNKNOWN_VALUE) {
+                    m_signals[index].atDanger = isDanger(static_cast<AspectCode>(record.newValue));
+                } else if (record.field == StationEventBus::Field::Row) {
+                    const QString aspect = m_dbManager->getSignalById(entityId).value("currentAspect").toString();
+                    m_signals[index].atDanger = isDanger(PackedAspect::codeFromString(aspect));
+                } else {
+                    continue;
+                }
+                changed = true;
+            } else if (record.kind == StationEventBus::EntityKind::PointMachine) {
+                const int index = m_pointIndex.value(entityId, -1);
+                if (index < 0) continue;
+                QString position = StationEventBus::positionName(record.newValue);
+                if (position.isEmpty()) {
+                    position = m_dbManager->getPointMachineById(entityId).value("position").toString();
+                }
+                m_points[index].reverse = position == QLatin1String("REVERSE");
+                changed = true;
+            }
+        }
+        if (changed) onStationChanges();
+    });
+
+    m_running = true;
+    m_startedMs = m_clock->elapsedMs();
+    emit runningChanged();
+
+    qDebug() << " [TrainSimulator] Started (clock rate" << m_clock->rate() << ")";
+    return true;
+}
+
+void TrainSimulator::stop() {
+    if (!m_running) return;
+
+    for (Clock::TimerId timer : m_trafficTimers) m_clock->cancel(timer);
+    for (Clock::TimerId timer : std::as_const(m_entryTimers)) m_clock->cancel(timer);
+    m_trafficTimers.clear();
+    m_entryTimers.clear();
+    m_entryQueues.clear();
+
+    beginPlanning();
+    for (auto& [id, train] : m_trains) {
+        if (train.timer != 0) m_clock->cancel(train.timer);
+        for (const PathElement& element : train.path) {
+            if (element.segment != NO_SEGMENT) release(element.segment);
+        }
+    }
+    m_trains.clear();
+    m_changesDeferred = false;
+    endPlanning();
+
+    if (m_dbManager && m_busSubscription >= 0) {
+        m_dbManager->eventBus()->unsubscribe(m_busSubscription);
+    }
+    m_busSubscription = -1;
+    m_running = false;
+
+    qDebug() << " [TrainSimulator] Stopped after" << m_trainsEntered << "trains," << m_movementEvents << "events";
+    emit trainCountChanged();
+    emit runningChanged();
+}
+
+void TrainSimulator::endPlanning() {
+    if (--m_planningDepth == 0 && m_changesDeferred) {
+        m_changesDeferred = false;
+        onStationChanges();
+    }
+}
+
+bool TrainSimulator::runFor(qint64 durationMs) {
+    VirtualClock* clock = qobject_cast<VirtualClock*>(m_clock);
+    if (!clock) return false;
+
+    for (qint64 remaining = durationMs; remaining > 0; remaining -= STEP_MS) {
+        clock->advance(std::min<qint64>(remaining, STEP_MS));
+        QCoreApplication::processEvents();
+    }
+    return true;
+}
+
+//
+//   TRAFFIC
+//
+
+QStringList TrainSimulator::entrySegments() const {
+    QStringList ids;
+    for (const auto& [segment, end] : m_entries) {
+        ids.append(m_segments[segment].id);
+    }
+    return ids;
+}
+
+bool TrainSimulator::addTrain(const QString& headcode, const QString& entrySegmentId, double lengthMeters, double maxSpeedKmh) {
+    if (!m_running) {
+        qWarning() << " [TrainSimulator] Not running - train" << headcode << "not added";
+        return false;
+    }
+
+    const int segment = m_segmentIndex.value(entrySegmentId, -1);
+    const bool isEntry = std::any_of(m_entries.begin(), m_entries.end(),
+                                     [segment](const auto& entry) { return entry.first == segment; });
+    if (!isEntry || lengthMeters <= 0.0 || maxSpeedKmh <= 0.0) {
+        qWarning() << " [TrainSimulator] Invalid train" << headcode << "at" << entrySegmentId;
+        return false;
+    }
+
+    m_entryQueues[segment].push_back({headcode, lengthMeters, kmhToMps(maxSpeedKmh)});
+    tryEnter(segment);
+    return true;
+}
+
+int TrainSimulator::addTraffic(int count, int headwayMs, double lengthMeters, double maxSpeedKmh) {
+    if (!m_running || m_entries.empty() || count <= 0) return 0;
+
+    for (int i = 0; i < count; ++i) {
+        const QString entry = m_segments[m_entries[static_cast<size_t>(m_nextTrafficEntry++) % m_entries.size()].first].id;
+        const QString headcode = QStringLiteral("S%1").arg(m_nextHeadcode++, 4, 10, QLatin1Char('0'));
+
+        if (i == 0 || headwayMs <= 0) {
+            addTrain(headcode, entry, lengthMeters, maxSpeedKmh);
+            continue;
+        }
+        m_trafficTimers.push_back(m_clock->schedule(static_cast<qint64>(i) * headwayMs,
+            [this, headcode, entry, lengthMeters, maxSpeedKmh]() {
+                addTrain(headcode, entry, lengthMeters, maxSpeedKmh);
+            }));
+    }
+    return count;
+}
+
+bool TrainSimulator::tryEnter(int entrySegment) {
+    std::deque<PendingEntry>& queue = m_entryQueues[entrySegment];
+    if (queue.empty()) return false;
+
+    auto retryLater = [this, entrySegment]() {
+        if (m_entryTimers.contains(entrySegment)) return;
+        m_entryTimers.insert(entrySegment, m_clock->schedule(HOLD_RECHECK_MS, [this, entrySegment]() {
+            m_entryTimers.remove(entrySegment);
+            tryEnter(entrySegment);
+        }));
+    };
+
+    if (m_segmentOccupants[entrySegment] > 0) {
+        retryLater();
+        return false;
+    }
+
+    const PendingEntry pending = queue.front();
+    queue.pop_front();
+
+    const auto entry = std::find_if(m_entries.begin(), m_entries.end(),
+                                    [entrySegment](const auto& e) { return e.first == entrySegment; });
+
+    //   The train runs in from off the area: its body starts on a virtual approach element
+    Train train;
+    train.id = m_nextTrainId++;
+    train.headcode = pending.headcode;
+    train.lengthM = pending.lengthM;
+    train.maxSpeedMps = pending.maxSpeedMps;
+    train.path.push_back({NO_SEGMENT, START, 0.0, pending.lengthM});
+    train.path.push_back({entrySegment, entry->second, pending.lengthM, m_segments[entrySegment].lengthM});
+    train.headM = train.limitM = pending.lengthM;
+    train.lastUpdateMs = train.enteredMs = m_clock->elapsedMs();
+
+    beginPlanning();
+    occupy(entrySegment);
+    Train& placed = m_trains.emplace(train.id, std::move(train)).first->second;
+
+    ++m_trainsEntered;
+    m_peakTrains = std::max(m_peakTrains, trainCount());
+    emit trainEntered(placed.headcode, m_segments[entrySegment].id);
+    emit trainCountChanged();
+
+    plan(placed);
+    endPlanning();
+
+    //   Handlers run during planning may have queued more trains; look the queue up again
+    if (!m_entryQueues.value(entrySegment).empty()) retryLater();
+    return true;
+}
+
+//
+//   MOVEMENT
+//
+
+void TrainSimulator::settle(Train& train) {
+    const qint64 now = m_clock->elapsedMs();
+    const double advanced = std::min(train.speedMps * static_cast<double>(now - train.lastUpdateMs) / 1000.0,
+                                     train.limitM - train.headM);
+    if (advanced > 0.0) {
+        train.headM += advanced;
+        m_distanceRunM += advanced;
+    }
+    train.lastUpdateMs = now;
+}
+
+void TrainSimulator::step(quint32 trainId) {
+    auto it = m_trains.find(trainId);
+    if (it == m_trains.end()) return;
+
+    Train& train = it->second;
+    train.timer = 0;
+    ++m_movementEvents;
+
+    beginPlanning();
+    settle(train);
+    plan(train);
+    endPlanning();
+}
+
+void TrainSimulator::plan(Train& train) {
+    const double tailM = train.headM - train.lengthM;
+
+    //   TAIL: Release every element the tail has cleared
+    while (train.path.size() > 1) {
+        const PathElement& last = train.path.front();
+        if (tailM + POSITION_EPSILON_M < last.startM + last.lengthM) break;
+        if (last.segment != NO_SEGMENT) {
+            train.exitSegment = last.segment;
+            release(last.segment);
+        }
+        train.path.pop_front();
+    }
+
+    if (train.state == TrainState::Exiting && train.path.size() == 1) {
+        const QString headcode = train.headcode;
+        const QString exitId = train.exitSegment != NO_SEGMENT ? m_segments[train.exitSegment].id : QString();
+        if (train.timer != 0) m_clock->cancel(train.timer);
+        m_trains.erase(train.id);
+        ++m_trainsExited;
+        emit trainExited(headcode, exitId);
+        emit trainCountChanged();
+        return;
+    }
+
+    //   HEAD: At the end of its element, claim the next one or stop short of it
+    const PathElement head = train.path.back();
+    const double headEndM = head.startM + head.lengthM;
+    if (train.state != TrainState::Exiting && train.headM + POSITION_EPSILON_M >= headEndM) {
+        QString blockedReason;
+        const Link* link = nextLink(head, blockedReason);
+
+        if (!link && !blockedReason.isEmpty()) {
+            hold(train, blockedReason, HOLD_RECHECK_MS);
+            return;
+        }
+
+        if (!link) {
+            //   Open end of a boundary segment: run off the area
+            train.path.push_back({NO_SEGMENT, START, headEndM, train.lengthM + 1.0});
+            train.state = TrainState::Exiting;
+        } else {
+            const Segment& next = m_segments[link->segment];
+            if (m_segmentOccupants[link->segment] > 0) {
+                hold(train, QStringLiteral("Segment %1 occupied").arg(next.id), HOLD_RECHECK_MS);
+                return;
+            }
+            for (const StopSignal& stop : next.stops[link->entryEnd]) {
+                if (stop.fraction > 0.0) break;
+                if (m_signals[stop.signal].atDanger) {
+                    hold(train, QStringLiteral("Signal %1 at danger").arg(m_signals[stop.signal].id), HOLD_RECHECK_MS);
+                    return;
+                }
+            }
+            train.path.push_back({link->segment, link->entryEnd, headEndM, next.lengthM});
+            occupy(link->segment);
+        }
+    }
+
+    //   NEXT EVENT: Nearest of head boundary, tail release and a signal at danger ahead
+    const PathElement& current = train.path.back();
+    double distanceM = current.startM + current.lengthM - train.headM;
+    if (train.path.size() > 1) {
+        const PathElement& last = train.path.front();
+        distanceM = std::min(distanceM, last.startM + last.lengthM - (train.headM - train.lengthM));
+    }
+
+    if (current.segment != NO_SEGMENT) {
+        for (const StopSignal& stop : m_segments[current.segment].stops[current.entryEnd]) {
+            if (stop.fraction <= 0.0 || !m_signals[stop.signal].atDanger) continue;
+
+            const double stopM = current.startM + stop.fraction * current.lengthM;
+            const bool standingAtIt = std::abs(stopM - train.headM) <= POSITION_EPSILON_M && train.speedMps == 0.0;
+            if (standingAtIt) {
+                hold(train, QStringLiteral("Signal %1 at danger").arg(m_signals[stop.signal].id), HOLD_RECHECK_MS);
+                return;
+            }
+            if (stopM > train.headM + POSITION_EPSILON_M) {
+                distanceM = std::min(distanceM, stopM - train.headM);
+                break;
+            }
+        }
+    }
+
+    distanceM = std::max(distanceM, POSITION_EPSILON_M);
+    train.speedMps = headSpeedMps(train);
+    train.limitM = train.headM + distanceM;
+    if (train.state == TrainState::Held) {
+        train.state = TrainState::Running;
+        train.holdReason.clear();
+    }
+    reschedule(train, std::max<qint64>(1, static_cast<qint64>(std::ceil(distanceM / train.speedMps * 1000.0))));
+}
+
+void TrainSimulator::hold(Train& train, const QString& reason, int recheckMs) {
+    train.speedMps = 0.0;
+    train.limitM = train.headM;
+
+    if (train.state != TrainState::Held || train.holdReason != reason) {
+        train.state = TrainState::Held;
+        train.holdReason = reason;
+        ++m_holds;
+        emit trainHeld(train.headcode, reason);
+    }
+    reschedule(train, recheckMs);
+}
+
+void TrainSimulator::reschedule(Train& train, qint64 delayMs) {
+    if (train.timer != 0) m_clock->cancel(train.timer);
+
+    const quint32 id = train.id;
+    train.timer = m_clock->schedule(delayMs, [this, id]() { step(id); });
+}
+
+const TrainSimulator::Link* TrainSimulator::nextLink(const PathElement& head, QString& blockedReason) const {
+    const SegmentEnd exitEnd = head.entryEnd == START ? END : START;
+    const std::vector<Link>& links = m_segments[head.segment].links[exitEnd];
+    if (links.empty()) {
+        if (m_segments[head.segment].circuit >= 0) {
+            blockedReason = QStringLiteral("End of line at %1").arg(m_segments[head.segment].id);
+        }
+        return nullptr;
+    }
+
+    //   Facing points pick the set leg; trailing points set against the train stop it
+    for (const Link& link : links) {
+        if (link.point < 0 || m_points[link.point].reverse == link.reverse) {
+            return &link;
+        }
+    }
+    blockedReason = QStringLiteral("Points %1 set against").arg(m_points[links.front().point].id);
+    return nullptr;
+}
+
+double TrainSimulator::headSpeedMps(const Train& train) const {
+    const int segment = train.path.back().segment;
+    if (segment == NO_SEGMENT || m_segments[segment].circuit < 0) return train.maxSpeedMps;
+    return std::min(train.maxSpeedMps, m_circuits[m_segments[segment].circuit].speedMps);
+}
+
+void TrainSimulator::onStationChanges() {
+    if (m_planningDepth > 0) {
+        m_changesDeferred = true;
+        return;
+    }
+
+    //   Held trains move off after the driver reacts; running trains re-plan now, so a
+    //   signal replaced to danger ahead of them is respected
+    std::vector<quint32> running;
+    for (auto& [id, train] : m_trains) {
+        if (train.state == TrainState::Held) {
+            reschedule(train, DRIVER_REACTION_MS);
+        } else {
+            running.push_back(id);
+        }
+    }
+
+    beginPlanning();
+    for (quint32 id : running) {
+        auto it = m_trains.find(id);
+        if (it == m_trains.end()) continue;
+        settle(it->second);
+        plan(it->second);
+    }
+    endPlanning();
+}
+
+//
+//   OCCUPANCY
+//
+
+void TrainSimulator::occupy(int segment) {
+    const int circuit = m_segments[segment].circuit;
+    if (++m_segmentOccupants[segment] == 1 && circuit >= 0 && ++m_circuits[circuit].occupants == 1) {
+        reportCircuit(circuit, true);
+    }
+}
+
+void TrainSimulator::release(int segment) {
+    const int circuit = m_segments[segment].circuit;
+    if (--m_segmentOccupants[segment] == 0 && circuit >= 0 && --m_circuits[circuit].occupants == 0) {
+        reportCircuit(circuit, false);
+    }
+}
+
+void TrainSimulator::reportCircuit(int circuit, bool isOccupied) {
+    ++m_occupancyReports;
+    if (!m_dbManager->updateTrackCircuitOccupancy(m_circuits[circuit].id, isOccupied)) {
+        qWarning() << " [TrainSimulator] Occupancy report failed:" << m_circuits[circuit].id << isOccupied;
+    }
+}
+
+//
+//   QUERIES
+//
+
+QVariantList TrainSimulator::getTrains() const {
+    QVariantList trains;
+    for (const auto& [id, train] : m_trains) {
+        QStringList circuits;
+        for (const PathElement& element : train.path) {
+            if (element.segment == NO_SEGMENT) continue;
+            const int circuit = m_segments[element.segment].circuit;
+            if (circuit >= 0 && !circuits.contains(m_circuits[circuit].id)) circuits.append(m_circuits[circuit].id);
+        }
+
+        const int headSegment = train.path.back().segment;
+        QVariantMap map;
+        map["id"] = id;
+        map["headcode"] = train.headcode;
+        map["headSegment"] = headSegment == NO_SEGMENT ? QString() : m_segments[headSegment].id;
+        map["occupiedCircuits"] = circuits;
+        map["state"] = train.state == TrainState::Held ? QStringLiteral("HELD")
+                     : train.state == TrainState::Exiting ? QStringLiteral("EXITING") : QStringLiteral("RUNNING");
+        map["holdReason"] = train.holdReason;
+        map["speedKmh"] = train.speedMps * 3.6;
+        map["lengthMeters"] = train.lengthM;
+        map["distanceRunMeters"] = train.headM - train.lengthM;
+        map["secondsInArea"] = (m_clock->elapsedMs() - train.enteredMs) / 1000.0;
+        trains.append(map);
+    }
+    return trains;
+}
+
+QVariantMap TrainSimulator::statistics() const {
+    int queued = 0;
+    for (const std::deque<PendingEntry>& queue : m_entryQueues) {
+        queued += static_cast<int>(queue.size());
+    }
+    int held = 0;
+    for (const auto& [id, train] : m_trains) {
+        if (train.state == TrainState::Held) ++held;
+    }
+
+    QVariantMap stats;
+    stats["running"] = m_running;
+    stats["clockRate"] = m_clock->rate();
+    stats["simulatedSeconds"] = m_running ? (m_clock->elapsedMs() - m_startedMs) / 1000.0 : 0.0;
+    stats["trainsInArea"] = trainCount();
+    stats["trainsHeld"] = held;
+    stats["trainsQueued"] = queued;
+    stats["peakTrains"] = m_peakTrains;
+    stats["trainsEntered"] = static_cast<qulonglong>(m_trainsEntered);
+    stats["trainsExited"] = static_cast<qulonglong>(m_trainsExited);
+    stats["movementEvents"] = static_cast<qulonglong>(m_movementEvents);
+    stats["holds"] = static_cast<qulonglong>(m_holds);
+    stats["occupancyReports"] = static_cast<qulonglong>(m_occupancyReports);
+    stats["distanceRunKm"] = m_distanceRunM / 1000.0;
+    return stats;
+}
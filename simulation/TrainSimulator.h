@@ -0,0 +1,224 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
+#include <deque>
+#include <map>
+#include <vector>
+#include "../core/Clock.h"
+
+class DatabaseManager;
+
+//   TRAIN MOVEMENT SIMULATOR
+//
+//   Moves trains over the station's track segment graph and feeds the resulting
+//   occupancy through DatabaseManager::updateTrackCircuitOccupancy, the same path (flicker
+//   filter, interlocking reaction, event bus) that field inputs take. For lab load tests.
+//
+//   MODEL: A train is a head position plus a length, laid over a path of segments. Segment
+//   lengths come from the circuit's length_meters (shared out by drawn length) and speed
+//   is min(train maximum, circuit max_speed_kmh). Trains run at constant speed between
+//   events and stop dead at:
+//     - a main signal at RED facing the train (signals protecting the circuit they stand
+//       in are moved back to that circuit's entry, so the train stops in rear of it),
+//     - trailing points set against the train, or a buffer stop,
+//     - a segment still occupied by another simulated train.
+//   Held trains re-check after HOLD_RECHECK_MS, or DRIVER_REACTION_MS after any signal or
+//   point change. Trains enter at open-ended boundary segments and leave through them.
+//
+//   DISCRETE EVENTS: Each train has exactly one pending Clock timer, due at its next head
+//   segment boundary, tail release or signal. Nothing ticks, so with a VirtualClock
+//   (runFor) hundreds of trains cost only their events. Owned and driven by the GUI thread.
+class TrainSimulator : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(bool running READ isRunning NOTIFY runningChanged)
+    Q_PROPERTY(int trainCount READ trainCount NOTIFY trainCountChanged)
+
+public:
+    explicit TrainSimulator(DatabaseManager* dbManager, QObject* parent = nullptr);
+    ~TrainSimulator();
+
+    //   Time source for movement; set before start()
+    void setClock(Clock* clock);
+
+    //   LIFECYCLE: start() loads circuit lengths/speeds, aspects and point positions from the
+    //   database; stop() removes every train and clears the occupancy it was holding
+    Q_INVOKABLE bool start();
+    Q_INVOKABLE void stop();
+    bool isRunning() const { return m_running; }
+
+    //   TRAFFIC: A train whose entry segment is occupied waits its turn there
+    Q_INVOKABLE QStringList entrySegments() const;
+    Q_INVOKABLE bool addTrain(const QString& headcode, const QString& entrySegmentId,
+                              double lengthMeters = DEFAULT_TRAIN_LENGTH_M,
+                              double maxSpeedKmh = DEFAULT_TRAIN_SPEED_KMH);
+    //   count trains, headwayMs apart, alternating over the entry segments; returns the number queued
+    Q_INVOKABLE int addTraffic(int count, int headwayMs,
+                               double lengthMeters = DEFAULT_TRAIN_LENGTH_M,
+                               double maxSpeedKmh = DEFAULT_TRAIN_SPEED_KMH);
+
+    //   VIRTUAL TIME: Advances a VirtualClock by durationMs in STEP_MS slices, letting queued
+    //   interlocking work and event bus flushes run between slices. False on any other clock.
+    Q_INVOKABLE bool runFor(qint64 durationMs);
+
+    //   QUERIES
+    int trainCount() const { return static_cast<int>(m_trains.size()); }
+    Q_INVOKABLE QVariantList getTrains() const;
+    Q_INVOKABLE QVariantMap statistics() const;
+
+signals:
+    void runningChanged();
+    void trainCountChanged();
+    void trainEntered(const QString& headcode, const QString& segmentId);
+    void trainExited(const QString& headcode, const QString& segmentId);
+    void trainHeld(const QString& headcode, const QString& reason);
+
+private:
+    static constexpr double DEFAULT_TRAIN_LENGTH_M = 200.0;
+    static constexpr double DEFAULT_TRAIN_SPEED_KMH = 100.0;
+    static constexpr double DEFAULT_CIRCUIT_LENGTH_M = 100.0;
+    static constexpr double DEFAULT_CIRCUIT_SPEED_KMH = 80.0;
+    static constexpr double DEFAULT_METERS_PER_GRID_UNIT = 5.0;
+    static constexpr double ADJACENCY_TOLERANCE = 1.5;      //   Grid units between abutting segment ends
+    static constexpr double POSITION_EPSILON_M = 0.001;
+    static constexpr int HOLD_RECHECK_MS = 500;
+    static constexpr int DRIVER_REACTION_MS = 1500;
+    static constexpr int STEP_MS = 100;
+    static constexpr int NO_SEGMENT = -1;                   //   Off the modelled area (entry/exit run)
+
+    enum SegmentEnd { START = 0, END = 1 };
+
+    struct Link {
+        int segment;
+        SegmentEnd entryEnd;
+        int point = -1;                 //   Point machine whose position the link needs
+        bool reverse = false;
+    };
+
+    struct StopSignal {
+        int signal;
+        double fraction;                //   Of the segment length, from the end a train enters by
+    };
+
+    struct Segment {
+        QString id;
+        int circuit = -1;
+        double lengthM = 0.0;
+        double gridLength = 0.0;
+        std::vector<Link> links[2];     //   Successors when leaving by START / END
+        std::vector<StopSignal> stops[2];   //   Signals met when entered by START / END
+    };
+
+    struct Circuit {
+        QString id;
+        double speedMps = 0.0;
+        int occupants = 0;              //   Segment occupations by simulated trains
+    };
+
+    struct SignalState {
+        QString id;
+        bool atDanger = true;
+    };
+
+    struct PointState {
+        QString id;
+        bool reverse = false;
+    };
+
+    struct PathElement {
+        int segment;
+        SegmentEnd entryEnd;
+        double startM;                  //   Distance along the train's run where it begins
+        double lengthM;
+    };
+
+    enum class TrainState { Running, Held, Exiting };
+
+    struct Train {
+        quint32 id = 0;
+        QString headcode;
+        double lengthM = 0.0;
+        double maxSpeedMps = 0.0;
+        std::deque<PathElement> path;   //   Tail first
+        double headM = 0.0;
+        double limitM = 0.0;            //   Head position of the pending event; settle() never passes it
+        double speedMps = 0.0;
+        qint64 lastUpdateMs = 0;
+        TrainState state = TrainState::Running;
+        QString holdReason;
+        Clock::TimerId timer = 0;
+        qint64 enteredMs = 0;
+        int exitSegment = NO_SEGMENT;
+    };
+
+    struct PendingEntry {
+        QString headcode;
+        double lengthM;
+        double maxSpeedMps;
+    };
+
+    void buildTrackGraph();
+    void placeSignals();
+    bool loadDynamicState();
+    void onStationChanges();
+    void beginPlanning() { ++m_planningDepth; }
+    void endPlanning();
+
+    //   MOVEMENT
+    void settle(Train& train);
+    void step(quint32 trainId);
+    void plan(Train& train);
+    void hold(Train& train, const QString& reason, int recheckMs);
+    void reschedule(Train& train, qint64 delayMs);
+    bool tryEnter(int entrySegment);
+    const Link* nextLink(const PathElement& head, QString& blockedReason) const;
+    double headSpeedMps(const Train& train) const;
+
+    //   OCCUPANCY
+    void occupy(int segment);
+    void release(int segment);
+    void reportCircuit(int circuit, bool isOccupied);
+
+    //   Weak: at exit either may be destroyed before the simulator
+    QPointer<DatabaseManager> m_dbManager;
+    QPointer<Clock> m_clock = Clock::system();
+    bool m_running = false;
+    int m_busSubscription = -1;
+    qint64 m_startedMs = 0;
+
+    //   Occupancy reports can flush the event bus synchronously; changes seen mid-plan wait for it
+    int m_planningDepth = 0;
+    bool m_changesDeferred = false;
+
+    std::vector<Segment> m_segments;
+    std::vector<Circuit> m_circuits;
+    std::vector<SignalState> m_signals;
+    std::vector<PointState> m_points;
+    QHash<QString, int> m_segmentIndex;
+    QHash<QString, int> m_circuitIndex;
+    QHash<QString, int> m_signalIndex;
+    QHash<QString, int> m_pointIndex;
+    std::vector<int> m_segmentOccupants;
+    std::vector<std::pair<int, SegmentEnd>> m_entries;     //   Boundary segment, end trains come in by
+
+    std::map<quint32, Train> m_trains;      //   Ordered: wake-ups run in a deterministic order
+    QHash<int, std::deque<PendingEntry>> m_entryQueues;
+    QHash<int, Clock::TimerId> m_entryTimers;
+    std::vector<Clock::TimerId> m_trafficTimers;
+    quint32 m_nextTrainId = 1;
+    quint32 m_nextHeadcode = 1;
+    int m_nextTrafficEntry = 0;
+
+    //   STATISTICS
+    quint64 m_trainsEntered = 0;
+    quint64 m_trainsExited = 0;
+    quint64 m_movementEvents = 0;
+    quint64 m_holds = 0;
+    quint64 m_occupancyReports = 0;
+    double m_distanceRunM = 0.0;
+    int m_peakTrains = 0;
+};
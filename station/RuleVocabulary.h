@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include "../interlocking/PackedAspect.h"
+
+//   RULE VOCABULARY
+//
+//   The one definition of what a signal interlocking rule may say, shared by the build-time
+//   generator (tools/stationgen) and the runtime rule compiler, so a rules file stationgen
+//   accepts is never rejected on hot reload and vice versa.
+
+namespace RailFlux::Station {
+
+inline const QStringList& validControlModes() {
+    static const QStringList modes = {"", "AND", "OR"};
+    return modes;
+}
+
+inline const QStringList& validPointPositions() {
+    static const QStringList positions = {"NORMAL", "REVERSE"};
+    return positions;
+}
+
+inline bool isValidControlMode(const QString& controlMode) {
+    return validControlModes().contains(controlMode.trimmed().toUpper());
+}
+
+inline bool isValidPointPosition(const QString& position) {
+    return validPointPositions().contains(position);
+}
+
+//   when_aspect notation MAIN[_CALLING][_LOOP]; valid when the main aspect is a known code
+inline bool isValidRuleAspect(const QString& ruleAspect) {
+    return PackedAspect::fromRuleAspect(ruleAspect).isValid();
+}
+
+} // namespace RailFlux::Station
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <span>
+#include <string_view>
+
+//   STATION TABLES
+//
+//   Record types for the station description compiled at build time by tools/stationgen.
+//   The generated StationData.h defines constexpr arrays of these records, so the whole
+//   layout and rule set sit in read-only memory and nothing is parsed at startup.
+//   Empty string views stand for SQL NULL / "not set".
+
+namespace RailFlux::Station {
+
+using IdList = std::span<const std::string_view>;
+
+struct TrackCircuitDef {
+    std::string_view id;
+    std::string_view name;
+    bool assigned;
+    bool overlap;
+    IdList protectingSignals;
+};
+
+struct TrackSegmentDef {
+    std::string_view id;
+    double startRow;
+    double startCol;
+    double endRow;
+    double endCol;
+    std::string_view circuitId;
+    bool assigned;
+    bool overlap;
+    IdList protectingSignals;
+};
+
+struct SignalDef {
+    std::string_view id;
+    std::string_view name;
+    std::string_view type;
+    double row;
+    double col;
+    std::string_view direction;
+    std::string_view currentAspect;
+    int aspectCount;
+    IdList possibleAspects;
+    std::string_view callingOnAspect;
+    std::string_view loopAspect;
+    std::string_view loopSignalConfiguration;
+    IdList protectedTrackCircuits;
+    bool isActive;
+    std::string_view location;
+};
+
+struct PointConnectionDef {
+    std::string_view trackSegmentId;
+    std::string_view connectionEnd;
+    std::string_view json;              //   Pre-serialized jsonb column value
+};
+
+struct PointMachineDef {
+    std::string_view id;
+    std::string_view name;
+    std::string_view position;
+    std::string_view operatingStatus;
+    std::string_view pairedEntity;
+    std::string_view hostTrackCircuit;
+    double junctionRow;
+    double junctionCol;
+    PointConnectionDef root;
+    PointConnectionDef normal;
+    PointConnectionDef reverse;
+};
+
+struct TextLabelDef {
+    std::string_view text;
+    double row;
+    double col;
+    int fontSize;
+};
+
+struct InterlockingRuleDef {
+    std::string_view name;
+    std::string_view sourceEntityType;
+    std::string_view sourceEntityId;
+    std::string_view targetEntityType;
+    std::string_view targetEntityId;
+    std::string_view targetConstraint;
+    std::string_view ruleType;
+    int priority;
+};
+
+//   SIGNAL INTERLOCKING RULES: Mirror of signal_interlocking_rules.json
+
+struct RuleConditionDef {
+    std::string_view entityType;
+    std::string_view entityId;
+    std::string_view requiredState;
+};
+
+struct AllowedSignalDef {
+    std::string_view signalId;
+    IdList aspects;
+};
+
+struct SignalRuleDef {
+    std::string_view whenAspect;
+    std::span<const RuleConditionDef> conditions;
+    std::span<const AllowedSignalDef> allows;
+};
+
+struct SignalInterlockingDef {
+    std::string_view signalId;
+    std::string_view type;
+    bool independent;
+    std::string_view controlMode;
+    IdList controlledBy;
+    std::span<const SignalRuleDef> rules;
+};
+
+//   CONVERSION HELPERS: Only at the Qt boundary
+
+inline QString toQString(std::string_view text) {
+    return QString::fromUtf8(text.data(), static_cast<qsizetype>(text.size()));
+}
+
+inline QStringList toQStringList(IdList ids) {
+    QStringList list;
+    list.reserve(static_cast<qsizetype>(ids.size()));
+    for (std::string_view id : ids) {
+        list.append(toQString(id));
+    }
+    return list;
+}
+
+//   PostgreSQL TEXT[] literal, e.g. {HM001,ST003}
+inline QString toPgArrayLiteral(IdList ids) {
+    return "{" + toQStringList(ids).join(",") + "}";
+}
+
+} // namespace RailFlux::Station
@@ -0,0 +1,478 @@
+//   STATIONGEN
+//
+//   Build-time generator: reads the station description (station_layout.json) and the
+//   signal interlocking rules (signal_interlocking_rules.json), cross-checks them, and
+//   writes a header of constexpr tables (see station/StationTables.h for the record types).
+//
+//   Usage: stationgen <station_layout.json> <signal_interlocking_rules.json> <output.h>
+//
+//   Any inconsistency fails the build, so a broken layout never reaches the binary.
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QStringList>
+#include <QTextStream>
+#include "../../station/RuleVocabulary.h"
+
+namespace {
+
+QStringList g_errors;
+
+void fail(const QString& message) {
+    g_errors.append(message);
+}
+
+bool readJson(const QString& path, QJsonObject& out) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fail(QString("%1: cannot open (%2)").arg(path, file.errorString()));
+        return false;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+        fail(QString("%1: invalid JSON at offset %2: %3")
+                 .arg(path).arg(parseError.offset).arg(parseError.errorString()));
+        return false;
+    }
+
+    out = doc.object();
+    return true;
+}
+
+//
+//   C++ EMISSION HELPERS
+//
+
+QString cppString(const QString& text) {
+    QString escaped;
+    escaped.reserve(text.size() + 2);
+    escaped += '"';
+    for (QChar ch : text) {
+        if (ch == '"' || ch == '\\') {
+            escaped += '\\';
+            escaped += ch;
+        } else if (ch == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += ch;
+        }
+    }
+    escaped += '"';
+    return escaped;
+}
+
+QString cppString(const QJsonValue& value) {
+    return value.isString() ? cppString(value.toString()) : QStringLiteral("{}");
+}
+
+QString cppDouble(double value) {
+    QString text = QString::number(value, 'g', 17);
+    if (!text.contains('.') && !text.contains('e')) {
+        text += ".0";
+    }
+    return text;
+}
+
+QString cppBool(bool value) {
+    return value ? QStringLiteral("true") : QStringLiteral("false");
+}
+
+QStringList stringList(const QJsonValue& value) {
+    QStringList list;
+    for (const QJsonValue& item : value.toArray()) {
+        list.append(item.toString());
+    }
+    return list;
+}
+
+class HeaderWriter {
+public:
+    //   Emits a named backing array and returns the expression that views it ("{}" when empty)
+    QString idList(const QString& name, const QStringList& ids) {
+        if (ids.isEmpty()) {
+            return QStringLiteral("{}");
+        }
+
+        QStringList literals;
+        for (const QString& id : ids) {
+            literals.append(cppString(id));
+        }
+
+        m_detail += QString("inline constexpr std::array<std::string_view, %1> %2 = {%3};\n")
+                        .arg(ids.size()).arg(name, literals.join(", "));
+        return "detail::" + name;
+    }
+
+    QString table(const QString& name, const QString& type, const QStringList& rows, bool inDetail) {
+        QString text = QString("inline constexpr std::array<%1, %2> %3 = {{\n")
+                           .arg(type).arg(rows.size()).arg(name);
+        for (const QString& row : rows) {
+            text += "    " + row + ",\n";
+        }
+        text += "}};\n";
+
+        if (inDetail) {
+            m_detail += text;
+            return "detail::" + name;
+        }
+
+        m_public += text + "\n";
+        return name;
+    }
+
+    void constant(const QString& declaration) {
+        m_public += declaration + "\n";
+    }
+
+    QString render(const QStringList& sources) const {
+        QString out;
+        QTextStream stream(&out);
+        stream << "// Generated by stationgen from " << sources.join(" and ") << " - do not edit.\n"
+               << "#pragma once\n\n"
+               << "#include \"StationTables.h\"\n"
+               << "#include <array>\n\n"
+               << "namespace RailFlux::Station::Generated {\n\n"
+               << "namespace detail {\n" << m_detail << "} // namespace detail\n\n"
+               << m_public
+               << "} // namespace RailFlux::Station::Generated\n";
+        return out;
+    }
+
+private:
+    QString m_detail;
+    QString m_public;
+};
+
+QSet<QString> collectIds(const QJsonArray& items, const QString& category) {
+    QSet<QString> ids;
+    for (const QJsonValue& item : items) {
+        const QString id = item.toObject()["id"].toString();
+        if (id.isEmpty()) {
+            fail(QString("%1: entry without id").arg(category));
+        } else if (ids.contains(id)) {
+            fail(QString("%1: duplicate id %2").arg(category, id));
+        }
+        ids.insert(id);
+    }
+    return ids;
+}
+
+void checkRefs(const QString& owner, const QStringList& refs, const QSet<QString>& known, const QString& kind) {
+    for (const QString& ref : refs) {
+        if (!known.contains(ref)) {
+            fail(QString("%1: unknown %2 %3").arg(owner, kind, ref));
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    if (args.size() != 4) {
+        QTextStream(stderr) << "Usage: stationgen <station_layout.json> <signal_interlocking_rules.json> <output.h>\n";
+        return 2;
+    }
+
+    QJsonObject layout;
+    QJsonObject rulesRoot;
+    if (!readJson(args[1], layout) || !readJson(args[2], rulesRoot)) {
+        for (const QString& error : g_errors) QTextStream(stderr) << "stationgen: " << error << "\n";
+        return 1;
+    }
+
+    const QJsonArray circuits = layout["track_circuits"].toArray();
+    const QJsonArray segments = layout["track_segments"].toArray();
+    const QJsonArray signalArray = layout["signals"].toArray();
+    const QJsonArray points = layout["point_machines"].toArray();
+    const QJsonArray labels = layout["text_labels"].toArray();
+    const QJsonArray interlockingRules = layout["interlocking_rules"].toArray();
+    const QJsonObject signalRules = rulesRoot["signal_interlocking_rules"].toObject();
+
+    const QSet<QString> circuitIds = collectIds(circuits, "track_circuits");
+    const QSet<QString> segmentIds = collectIds(segments, "track_segments");
+    const QSet<QString> signalIds = collectIds(signalArray, "signals");
+    const QSet<QString> pointIds = collectIds(points, "point_machines");
+
+    if (rulesRoot["station_id"].toString() != layout["station_id"].toString()) {
+        fail(QString("station_id mismatch: layout %1, rules %2")
+                 .arg(layout["station_id"].toString(), rulesRoot["station_id"].toString()));
+    }
+
+    HeaderWriter writer;
+    writer.constant(QString("inline constexpr std::string_view STATION_ID = %1;")
+                        .arg(cppString(layout["station_id"])));
+    writer.constant(QString("inline constexpr std::string_view STATION_NAME = %1;\n")
+                        .arg(cppString(layout["station_name"])));
+
+    //   TRACK CIRCUITS
+    QStringList rows;
+    for (int i = 0; i < circuits.size(); ++i) {
+        const QJsonObject circuit = circuits[i].toObject();
+        const QString id = circuit["id"].toString();
+        const QStringList protecting = stringList(circuit["protecting_signals"]);
+        checkRefs("track circuit " + id, protecting, signalIds, "signal");
+
+        rows.append(QString("{%1, %2, %3, %4, %5}")
+                        .arg(cppString(id), cppString(circuit["name"]),
+                             cppBool(circuit["assigned"].toBool()), cppBool(circuit["overlap"].toBool()),
+                             writer.idList(QString("circuit%1_protectingSignals").arg(i), protecting)));
+    }
+    writer.table("TRACK_CIRCUITS", "TrackCircuitDef", rows, false);
+
+    //   TRACK SEGMENTS
+    rows.clear();
+    for (int i = 0; i < segments.size(); ++i) {
+        const QJsonObject segment = segments[i].toObject();
+        const QString id = segment["id"].toString();
+        const QStringList protecting = stringList(segment["protecting_signals"]);
+        checkRefs("track segment " + id, protecting, signalIds, "signal");
+        if (segment["circuit_id"].isString()) {
+            checkRefs("track segment " + id, {segment["circuit_id"].toString()}, circuitIds, "track circuit");
+        }
+
+        const QJsonObject start = segment["start"].toObject();
+        const QJsonObject end = segment["end"].toObject();
+        rows.append(QString("{%1, %2, %3, %4, %5, %6, %7, %8, %9}")
+                        .arg(cppString(id),
+                             cppDouble(start["row"].toDouble()), cppDouble(start["col"].toDouble()),
+                             cppDouble(end["row"].toDouble()), cppDouble(end["col"].toDouble()),
+                             cppString(segment["circuit_id"]),
+                             cppBool(segment["assigned"].toBool()), cppBool(segment["overlap"].toBool()),
+                             writer.idList(QString("segment%1_protectingSignals").arg(i), protecting)));
+    }
+    writer.table("TRACK_SEGMENTS", "TrackSegmentDef", rows, false);
+
+    //   SIGNALS
+    rows.clear();
+    for (int i = 0; i < signalArray.size(); ++i) {
+        const QJsonObject signal = signalArray[i].toObject();
+        const QString id = signal["id"].toString();
+        const QStringList protectedCircuits = stringList(signal["protected_track_circuits"]);
+        checkRefs("signal " + id, protectedCircuits, circuitIds, "track circuit");
+
+        const QStringList possibleAspects = stringList(signal["possible_aspects"]);
+        if (!possibleAspects.contains(signal["current_aspect"].toString())) {
+            fail(QString("signal %1: current_aspect %2 not in possible_aspects")
+                     .arg(id, signal["current_aspect"].toString()));
+        }
+
+        rows.append(QString("{%1, %2, %3, %4, %5, %6, %7, %8, %9, %10, %11, %12, %13, %14, %15}")
+                        .arg(cppString(id), cppString(signal["name"]), cppString(signal["type"]),
+                             cppDouble(signal["row"].toDouble()), cppDouble(signal["col"].toDouble()),
+                             cppString(signal["direction"]), cppString(signal["current_aspect"]),
+                             QString::number(signal["aspect_count"].toInt(2)),
+                             writer.idList(QString("signal%1_possibleAspects").arg(i), possibleAspects))
+                        .arg(cppString(signal["calling_on_aspect"].toString("OFF")),
+                             cppString(signal["loop_aspect"].toString("OFF")),
+                             cppString(signal["loop_signal_configuration"].toString("UR")),
+                             writer.idList(QString("signal%1_protectedTrackCircuits").arg(i), protectedCircuits),
+                             cppBool(signal["active"].toBool(true)), cppString(signal["location"])));
+    }
+    writer.table("SIGNALS", "SignalDef", rows, false);
+
+    //   POINT MACHINES
+    auto connection = [&](const QString& pointId, const QJsonObject& point, const QString& key) {
+        const QJsonObject conn = point[key].toObject();
+        const QString segmentId = conn["track_segment"].toString();
+        checkRefs(QString("point machine %1 (%2)").arg(pointId, key), {segmentId}, segmentIds, "track segment");
+
+        //   Same shape the DB and QML have always consumed
+        const QJsonObject jsonb{
+            {"trackSegmentId", segmentId},
+            {"connectionEnd", conn["end"].toString()},
+            {"offset", QJsonObject{{"row", 0}, {"col", 0}}}
+        };
+        const QString json = QString::fromUtf8(QJsonDocument(jsonb).toJson(QJsonDocument::Compact));
+        return QString("{%1, %2, %3}").arg(cppString(segmentId), cppString(conn["end"]), cppString(json));
+    };
+
+    rows.clear();
+    for (const QJsonValue& value : points) {
+        const QJsonObject point = value.toObject();
+        const QString id = point["id"].toString();
+        if (point["paired_entity"].isString()) {
+            checkRefs("point machine " + id, {point["paired_entity"].toString()}, pointIds, "point machine");
+        }
+        if (point["host_track_circuit"].isString()) {
+            checkRefs("point machine " + id, {point["host_track_circuit"].toString()}, circuitIds, "track circuit");
+        }
+
+        const QJsonObject junction = point["junction"].toObject();
+        rows.append(QString("{%1, %2, %3, %4, %5, %6, %7, %8,\n     %9,\n     %10,\n     %11}")
+                        .arg(cppString(id), cppString(point["name"]), cppString(point["position"]),
+                             cppString(point["operating_status"].toString("CONNECTED")),
+                             cppString(point["paired_entity"]), cppString(point["host_track_circuit"]),
+                             cppDouble(junction["row"].toDouble()), cppDouble(junction["col"].toDouble()),
+                             connection(id, point, "root"))
+                        .arg(connection(id, point, "normal"), connection(id, point, "reverse")));
+    }
+    writer.table("POINT_MACHINES", "PointMachineDef", rows, false);
+
+    //   TEXT LABELS
+    rows.clear();
+    for (const QJsonValue& value : labels) {
+        const QJsonObject label = value.toObject();
+        rows.append(QString("{%1, %2, %3, %4}")
+                        .arg(cppString(label["text"]), cppDouble(label["row"].toDouble()),
+                             cppDouble(label["col"].toDouble()), QString::number(label["font_size"].toInt(12))));
+    }
+    writer.table("TEXT_LABELS", "TextLabelDef", rows, false);
+
+    //   INTERLOCKING RULES (protection / opposing relationships)
+    auto knownIdsFor = [&](const QString& entityType) -> const QSet<QString>* {
+        if (entityType == "SIGNAL") return &signalIds;
+        if (entityType == "TRACK_CIRCUIT") return &circuitIds;
+        if (entityType == "POINT_MACHINE") return &pointIds;
+        return nullptr;
+    };
+
+    rows.clear();
+    for (const QJsonValue& value : interlockingRules) {
+        const QJsonObject rule = value.toObject();
+        const QJsonObject source = rule["source"].toObject();
+        const QJsonObject target = rule["target"].toObject();
+
+        for (const QJsonObject& entity : {source, target}) {
+            const QSet<QString>* known = knownIdsFor(entity["type"].toString());
+            if (!known) {
+                fail(QString("interlocking rule '%1': unknown entity type %2")
+                         .arg(rule["name"].toString(), entity["type"].toString()));
+            } else {
+                checkRefs("interlocking rule '" + rule["name"].toString() + "'",
+                          {entity["id"].toString()}, *known, entity["type"].toString().toLower());
+            }
+        }
+
+        rows.append(QString("{%1, %2, %3, %4, %5, %6, %7, %8}")
+                        .arg(cppString(rule["name"]), cppString(source["type"]), cppString(source["id"]),
+                             cppString(target["type"]), cppString(target["id"]), cppString(rule["constraint"]),
+                             cppString(rule["type"]), QString::number(rule["priority"].toInt())));
+    }
+    writer.table("INTERLOCKING_RULES", "InterlockingRuleDef", rows, false);
+
+    //   SIGNAL INTERLOCKING RULES: Same vocabulary as the runtime rule compiler
+    using namespace RailFlux::Station;
+
+    QStringList signalRows;
+    int signalIndex = 0;
+    for (auto it = signalRules.begin(); it != signalRules.end(); ++it, ++signalIndex) {
+        const QString signalId = it.key();
+        const QJsonObject signal = it.value().toObject();
+        const QString owner = "rules for " + signalId;
+        const QString prefix = QString("rules%1").arg(signalIndex);
+
+        checkRefs(owner, {signalId}, signalIds, "signal");
+        const QStringList controlledBy = stringList(signal["controlled_by"]);
+        checkRefs(owner + " (controlled_by)", controlledBy, signalIds, "signal");
+
+        const QString controlMode = signal["control_mode"].toString();
+        if (!isValidControlMode(controlMode)) {
+            fail(QString("%1: invalid control_mode '%2'").arg(owner, controlMode));
+        }
+
+        QStringList ruleRows;
+        const QJsonArray ruleArray = signal["rules"].toArray();
+        for (int r = 0; r < ruleArray.size(); ++r) {
+            const QJsonObject rule = ruleArray[r].toObject();
+            const QString rulePrefix = QString("%1_rule%2").arg(prefix).arg(r);
+
+            if (rule["when_aspect"].toString().isEmpty()) {
+                fail(QString("%1: rule %2 without when_aspect").arg(owner).arg(r));
+            } else if (!isValidRuleAspect(rule["when_aspect"].toString())) {
+                fail(QString("%1: rule %2 has unknown when_aspect %3").arg(owner).arg(r).arg(rule["when_aspect"].toString()));
+            }
+
+            QStringList conditionRows;
+            for (const QJsonValue& conditionValue : rule["conditions"].toArray()) {
+                const QJsonObject condition = conditionValue.toObject();
+                if (condition.contains("point_machine")) {
+                    const QString pointId = condition["point_machine"].toString();
+                    const QString position = condition["position"].toString();
+                    checkRefs(owner, {pointId}, pointIds, "point machine");
+                    if (!isValidPointPosition(position)) {
+                        fail(QString("%1: point machine %2 has invalid position '%3'").arg(owner, pointId, position));
+                    }
+                    conditionRows.append(QString("{\"point_machine\", %1, %2}")
+                                             .arg(cppString(pointId), cppString(position)));
+                } else if (condition.contains("track_segment")) {
+                    const QString segmentId = condition["track_segment"].toString();
+                    checkRefs(owner, {segmentId}, segmentIds, "track segment");
+                    conditionRows.append(QString("{\"track_segment\", %1, %2}")
+                                             .arg(cppString(segmentId), cppString(condition["occupancy"])));
+                } else {
+                    fail(QString("%1: unrecognised condition %2").arg(owner, condition.keys().join(",")));
+                }
+            }
+
+            QStringList allowRows;
+            const QJsonObject allows = rule["allows"].toObject();
+            int allowIndex = 0;
+            for (auto allowIt = allows.begin(); allowIt != allows.end(); ++allowIt, ++allowIndex) {
+                const QStringList aspects = stringList(allowIt.value());
+                checkRefs(owner + " (allows)", {allowIt.key()}, signalIds, "signal");
+                if (!signalRules.contains(allowIt.key())) {
+                    fail(QString("%1: allows %2 which has no rules entry").arg(owner, allowIt.key()));
+                }
+                if (aspects.isEmpty()) {
+                    fail(QString("%1: empty aspect list for %2").arg(owner, allowIt.key()));
+                }
+                allowRows.append(QString("{%1, %2}")
+                                     .arg(cppString(allowIt.key()),
+                                          writer.idList(QString("%1_allow%2_aspects").arg(rulePrefix).arg(allowIndex),
+                                                        aspects)));
+            }
+
+            const QString conditions = conditionRows.isEmpty()
+                ? QStringLiteral("{}")
+                : writer.table(rulePrefix + "_conditions", "RuleConditionDef", conditionRows, true);
+            const QString allowed = allowRows.isEmpty()
+                ? QStringLiteral("{}")
+                : writer.table(rulePrefix + "_allows", "AllowedSignalDef", allowRows, true);
+
+            ruleRows.append(QString("{%1, %2, %3}").arg(cppString(rule["when_aspect"]), conditions, allowed));
+        }
+
+        const QString rules = ruleRows.isEmpty()
+            ? QStringLiteral("{}")
+            : writer.table(prefix, "SignalRuleDef", ruleRows, true);
+        const QString controllers = writer.idList(prefix + "_controlledBy", controlledBy);
+
+        signalRows.append(QString("{%1, %2, %3, %4, %5, %6}")
+                              .arg(cppString(signalId), cppString(signal["type"]),
+                                   cppBool(signal["independent"].toBool(false)), cppString(controlMode),
+                                   controllers, rules));
+    }
+    writer.table("SIGNAL_INTERLOCKING", "SignalInterlockingDef", signalRows, false);
+
+    if (!g_errors.isEmpty()) {
+        for (const QString& error : g_errors) {
+            QTextStream(stderr) << "stationgen: " << error << "\n";
+        }
+        return 1;
+    }
+
+    const QString header = writer.render({QFileInfo(args[1]).fileName(), QFileInfo(args[2]).fileName()});
+
+    //   Leave the file untouched when nothing changed, so dependents are not rebuilt
+    QFile output(args[3]);
+    if (output.open(QIODevice::ReadOnly) && output.readAll() == header.toUtf8()) {
+        return 0;
+    }
+    output.close();
+
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QTextStream(stderr) << "stationgen: cannot write " << args[3] << ": " << output.errorString() << "\n";
+        return 1;
+    }
+    output.write(header.toUtf8());
+    return 0;
+}